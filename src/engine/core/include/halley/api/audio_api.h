@@ -242,9 +242,11 @@ namespace Halley
 			float gain = 1;
 			float pitch = 1;
 			float mixAmount = 0;
+			float renderTime = 0; // In microseconds, for the last buffer
 			uint32_t paused = 0;
 			uint8_t dstChannels = 0;
 			bool playing = true;
+			bool virtualVoice = false;
 			std::array<float, 8> channelMix;
 		};
 
@@ -263,6 +265,13 @@ namespace Halley
 
 		Vector<EmitterData> emitters;
 		AudioListenerData listener;
+		float voiceRenderTime = 0; // In microseconds, summed across all voice workers
+		size_t numVoiceWorkers = 0;
+		size_t numActiveVoices = 0;
+		size_t numVirtualVoices = 0;
+		float expressionEvalTime = 0; // In microseconds, summed across all voice workers
+		size_t numExpressionsEvaluated = 0;
+		size_t numExpressionsCached = 0;
 	};
 
 	class IAudioDebugDataListener {
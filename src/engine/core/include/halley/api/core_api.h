@@ -31,6 +31,7 @@ namespace Halley
 		public:
 			virtual ~IProfileCallback() = default;
 			virtual Time getThreshold() const { return 0.0; }
+			virtual bool shouldCaptureFrame() { return true; } // Called before each frame; the profiler only records when a callback wants it
 			virtual void onProfileData(std::shared_ptr<ProfilerData> data) = 0;
 		};
 
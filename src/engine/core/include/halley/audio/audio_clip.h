@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include "halley/resources/resource.h"
 #include "halley/resources/resource_data.h"
 #include "halley/api/audio_api.h"
@@ -52,6 +53,8 @@ namespace Halley
 		size_t sampleLength = 0;
 		size_t loopPoint = 0;
 		mutable size_t streamPos = 0;
+		mutable size_t streamBufferPos = 0;
+		mutable std::mutex streamMutex;
 		uint8_t numChannels = 0;
 		bool streaming = false;
 
@@ -189,6 +189,8 @@ namespace Halley
 		void setPitch(Range<float> pitch);
 		bool isSingleton() const;
 		void setSingleton(bool value);
+		std::optional<int> getPriority() const;
+		void setPriority(std::optional<int> value);
 
 		void serialize(Serializer& s) const override;
 		void deserialize(Deserializer& s) override;
@@ -200,6 +202,7 @@ namespace Halley
 		Range<float> playGain;
 		Range<float> playPitch;
 		float delay = 0;
+		std::optional<int> priority;
 	};
 
 	class AudioEventActionStop final : public AudioEventActionObject
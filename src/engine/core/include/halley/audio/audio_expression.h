@@ -3,6 +3,7 @@
 #include "halley/maths/interpolation_curve.h"
 #include "halley/maths/vector2.h"
 #include "halley/text/string_converter.h"
+#include "audio_parameter_ids.h"
 
 namespace Halley {
 	class AudioProperties;
@@ -50,11 +51,17 @@ namespace Halley {
         InterpolationCurve points;
         float gain = 1;
 
+        // Interned from id and value, call updateIds() after changing those
+        AudioParameterId paramId = AudioParameterIds::invalid;
+        AudioParameterId valueId = AudioParameterIds::invalid;
+
         AudioExpressionTerm() = default;
         AudioExpressionTerm(AudioExpressionTermType type);
         AudioExpressionTerm(const ConfigNode& node);
         ConfigNode toConfigNode() const;
 
+        void updateIds();
+
         float evaluate(const AudioEmitter& emitter) const;
         float evaluateSwitch(const AudioEmitter& emitter) const;
         float evaluateVariable(const AudioEmitter& emitter) const;
@@ -84,10 +91,18 @@ namespace Halley {
 
 	class AudioExpression {
     public:
+        // Per-instance cache of the last evaluation, valid until any switch or variable changes on the emitter (or its fallbacks)
+        struct Cache {
+            const AudioEmitter* emitter = nullptr;
+            uint64_t version = 0;
+            float value = 0;
+        };
+
         void load(const ConfigNode& node);
         ConfigNode toConfigNode() const;
 
         float evaluate(const AudioEmitter& emitter) const;
+        float evaluate(const AudioEmitter& emitter, Cache& cache, bool& cached) const;
 		void validate(const AudioProperties& audioProperties, const String& breadCrumbs) const;
 
         void serialize(Serializer& s) const;
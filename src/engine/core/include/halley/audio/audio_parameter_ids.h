@@ -0,0 +1,24 @@
+#pragma once
+#include "halley/text/halleystring.h"
+
+namespace Halley {
+	using AudioParameterId = uint32_t;
+
+	// Interns audio switch names, switch values and variable names into small integers, so that emitters can store them in dense arrays
+	// and expressions can compare them without touching strings on the audio thread. IDs are global and live for the whole process.
+	class AudioParameterIds {
+	public:
+		enum class Kind : uint8_t {
+			Switch,
+			SwitchValue,
+			Variable
+		};
+
+		static constexpr AudioParameterId invalid = 0; // Never assigned to any name
+		static constexpr AudioParameterId emptySwitchValue = 1; // ID of the empty string as a switch value, which unset switches read as
+
+		static AudioParameterId getId(Kind kind, const String& name);
+		static AudioParameterId tryGetId(Kind kind, const String& name); // Returns invalid if the name was never interned
+		static const String& getName(Kind kind, AudioParameterId id);
+	};
+}
@@ -16,5 +16,9 @@ namespace Halley
 		virtual bool isReady() const { return true; }
 		virtual bool getAudioData(size_t numSamples, AudioMultiChannelSamples dst) = 0;
 		virtual void restart() = 0;
+
+		// Advances playback as if getAudioData had been called, but without generating any samples. Used by virtual voices.
+		virtual bool canSkip() const { return false; }
+		virtual bool skipAudioData(size_t numSamples) { return true; }
 	};
 }
@@ -1,5 +1,9 @@
 #pragma once
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <functional>
 #include <halley/text/halleystring.h>
 #include "executor.h"
@@ -72,5 +76,58 @@ namespace Halley
 		{
 			foreach(ExecutionQueue::getDefault(), begin, end, f);
 		}
+
+		// Runs f(0) ... f(n - 1) on the CPU executor. The calling thread takes items as well, and helpers which only start once all items were taken
+		// exit straight away, so this doesn't deadlock when called from a task already running on that executor (e.g. from a resource loading task).
+		template <typename F>
+		void parallelFor(size_t n, F f)
+		{
+			const size_t nThreads = Executors::hasInstance() ? Executors::getCPU().threadCount() : 0;
+			if (n <= 1 || nThreads == 0) {
+				for (size_t i = 0; i < n; ++i) {
+					f(i);
+				}
+				return;
+			}
+
+			struct State {
+				std::atomic<size_t> next = 0;
+				std::atomic<size_t> done = 0;
+				std::mutex mutex;
+				std::condition_variable finished;
+				std::exception_ptr exception;
+			};
+			auto state = std::make_shared<State>();
+
+			// Late helpers never dereference f, as there's nothing left for them to claim
+			auto work = [state, n, fn = &f] ()
+			{
+				for (size_t i = state->next++; i < n; i = state->next++) {
+					try {
+						(*fn)(i);
+					} catch (...) {
+						std::unique_lock lock(state->mutex);
+						if (!state->exception) {
+							state->exception = std::current_exception();
+						}
+					}
+					if (++state->done == n) {
+						std::unique_lock lock(state->mutex);
+						state->finished.notify_all();
+					}
+				}
+			};
+
+			for (size_t i = 0; i < std::min(n - 1, nThreads); ++i) {
+				Concurrent::execute(Executors::getCPU(), work);
+			}
+			work();
+
+			std::unique_lock lock(state->mutex);
+			state->finished.wait(lock, [&] { return state->done == n; });
+			if (state->exception) {
+				std::rethrow_exception(state->exception);
+			}
+		}
 	}
 }
@@ -50,6 +50,7 @@ namespace Halley
 
 		static Executors& get();
 		static void setInstance(Executors& e);
+		static bool hasInstance();
 
 		static ExecutionQueue& getCPU() { return instance->cpu; }
 		static ExecutionQueue& getCPUAux() { return instance->cpuAux; }
@@ -52,10 +52,24 @@ namespace Halley
 		void* data;
 	};
 
+	class BinPackSearchResult
+	{
+	public:
+		Vector<BinPackResult> results;
+		Vector2i size; // Bounds of the packed rects, rounded up to powers of two if those were requested
+		float occupancy = 0; // Percentage of size covered by entries
+	};
+
 	class BinPack
 	{
 	public:
 		static std::optional<Vector<BinPackResult>> pack(const Vector<BinPackEntry>& entries, Vector2i binSize);
 		static std::optional<Vector<BinPackResult>> fastPack(const Vector<BinPackEntry>& entries, Vector2i binSize);
+
+		// MaxRects with the best short side fit heuristic. Much tighter than fastPack, and still quick enough for a few thousand entries
+		static std::optional<Vector<BinPackResult>> maxRectsPack(const Vector<BinPackEntry>& entries, Vector2i binSize);
+
+		// Tries bin sizes up to maxSize with maxRectsPack (in parallel, on the CPU executor) and returns the packing with the smallest resulting size
+		static std::optional<BinPackSearchResult> packSmallest(const Vector<BinPackEntry>& entries, Vector2i maxSize, bool powerOfTwo);
 	};
 }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "temp_allocator.h"
+#include "vector.h"
+
+namespace Halley {
+	// Linear allocator for temporaries that don't outlive the current frame, e.g.:
+	//
+	//     auto toRemove = FrameAllocator::makeVector<EntityId>();
+	//
+	// Each thread gets its own pool the first time it asks for one, so this is safe to use from tasks without locking,
+	// as long as the containers don't leave the thread that created them. A pool is rewound the first time its thread
+	// uses it in a new frame, but only if nothing allocated from it is still alive; pages are kept, so in steady state
+	// nothing here touches the heap.
+	class FrameAllocator {
+	public:
+		struct Stats {
+			size_t bytesUsed = 0;
+			size_t numAllocations = 0;
+			size_t bytesReserved = 0;
+			size_t numThreads = 0;
+		};
+
+		static TempMemoryPool& get();
+
+		template <typename T>
+		static VectorTemp<T> makeVector()
+		{
+			return VectorTemp<T>(get());
+		}
+
+		// Called by Core at the start of each frame
+		static void startFrame();
+
+		// Usage during the previous frame, summed over all threads. Threads only report when they next use their
+		// pool, so work done on a worker thread might be counted a frame late.
+		static Stats getLastFrameStats();
+	};
+}
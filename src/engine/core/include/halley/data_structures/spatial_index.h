@@ -0,0 +1,86 @@
+#pragma once
+
+#include "hash_map.h"
+#include "vector.h"
+#include "halley/entity/entity_id.h"
+#include "halley/maths/rect.h"
+#include "halley/maths/ray.h"
+#include <gsl/gsl>
+
+namespace Halley {
+	// Loose grid over Rect4f bounds, mapping to entities.
+	// Each rect lives in the cell containing its centre, and queries are grown by a cell to catch rects overlapping from neighbours.
+	// Rects larger than a cell are kept in a separate list which is always tested.
+	// Queries are const and don't touch any shared state, so any number of threads can query at once, as long as nobody is modifying it.
+	// Overlap tests are inclusive, so zero-sized rects (points) can be found too.
+	class SpatialIndex {
+	public:
+		struct Query {
+			enum class Type : uint8_t {
+				Rect,
+				Circle,
+				Ray
+			};
+
+			Type type = Type::Rect;
+			Rect4f rect;
+			Vector2f centre;
+			float radius = 0;
+			Ray ray;
+			float maxDistance = 0;
+
+			static Query makeRect(Rect4f rect);
+			static Query makeCircle(Vector2f centre, float radius);
+			static Query makeRay(Ray ray, float maxDistance);
+		};
+
+		explicit SpatialIndex(float cellSize = 256.0f);
+
+		void set(EntityId id, Rect4f rect);
+		bool remove(EntityId id);
+		void clear();
+
+		bool contains(EntityId id) const;
+		std::optional<Rect4f> getRect(EntityId id) const;
+		size_t size() const;
+		float getCellSize() const;
+
+		// Results are appended to the output, in no particular order, except for rays, which are sorted by distance along the ray
+		void query(const Query& query, Vector<EntityId>& results) const;
+		void queryRect(Rect4f rect, Vector<EntityId>& results) const;
+		void queryCircle(Vector2f centre, float radius, Vector<EntityId>& results) const;
+		void queryRay(Ray ray, float maxDistance, Vector<EntityId>& results) const;
+
+		// Runs all queries, in parallel on the CPU executor if there's enough of them. results[i] gets the results of queries[i].
+		void query(gsl::span<const Query> queries, Vector<Vector<EntityId>>& results) const;
+
+	private:
+		struct CellEntry {
+			Rect4f rect;
+			EntityId id;
+		};
+
+		struct Location {
+			Vector2i cell;
+			uint32_t index = 0;
+			bool large = false;
+		};
+
+		using Cell = Vector<CellEntry>;
+
+		float cellSize;
+		float invCellSize;
+		HashMap<Vector2i, Cell> cells;
+		Cell largeEntries;
+		HashMap<EntityId, Location> locations;
+
+		bool isLarge(Rect4f rect) const;
+		Vector2i getCell(Vector2f pos) const;
+		Vector<CellEntry>& getContainer(const Location& location);
+		void insert(EntityId id, Rect4f rect, Location& location);
+		void erase(const Location& location);
+
+		template <typename F>
+		void visit(Rect4f bounds, F f) const;
+	};
+}
@@ -7,6 +7,13 @@
 namespace Halley {
 	class TempMemoryPool {
 	public:
+		// Totals since the last reset, across all pages
+		struct Stats {
+			size_t bytesUsed = 0;
+			size_t numAllocations = 0;
+			size_t bytesReserved = 0;
+		};
+
 		TempMemoryPool(size_t capacity, bool allowPaging = true);
 		~TempMemoryPool();
 
@@ -16,10 +23,14 @@ namespace Halley {
 		void reset();
 		void resize(size_t size);
 
+		bool isInUse() const;
+		Stats getStats() const;
+
 	private:
 		size_t capacity = 0;
 		size_t pos = 0;
 		size_t allocated = 0;
+		size_t numAllocations = 0;
 		char* data = nullptr;
 
 		bool allowPaging = false;
@@ -59,6 +70,18 @@ namespace Halley {
 			return pool->deallocate(p, n * sizeof(T));
 		}
 
+		template<class U>
+		bool operator==(const PoolAllocator<U, Pool>& other) const noexcept
+		{
+			return pool == other.pool;
+		}
+
+		template<class U>
+		bool operator!=(const PoolAllocator<U, Pool>& other) const noexcept
+		{
+			return pool != other.pool;
+		}
+
 		Pool* pool;
 	};
 
@@ -7,6 +7,7 @@
 namespace Halley
 {
 	class DevConClient;
+	class DevConProfilerStream;
 
 	namespace DevCon {
 		class UpdateInterestMsg;
@@ -56,6 +57,7 @@ namespace Halley
 		void update(Time t);
 
 		DevConInterest& getInterest() const;
+		DevConProfilerStream& getProfilerStream() const;
 
 	protected:
 		void onReceiveReloadAssets(const DevCon::ReloadAssetsMsg& msg);
@@ -74,6 +76,7 @@ namespace Halley
 		std::shared_ptr<MessageQueue> queue;
 
 		std::unique_ptr<DevConInterest> interest;
+		std::unique_ptr<DevConProfilerStream> profilerStream;
 
 		void connect();
 		void log(LoggerLevel level, const std::string_view msg) override;
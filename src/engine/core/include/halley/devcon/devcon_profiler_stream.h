@@ -0,0 +1,125 @@
+#pragma once
+#include "halley/api/core_api.h"
+#include "halley/data_structures/config_node.h"
+#include "halley/support/profiler.h"
+#include "halley/time/halleytime.h"
+#include <functional>
+
+namespace Halley
+{
+	class DevConInterest;
+	class DevConServer;
+	class HalleyAPI;
+	class INetworkServiceStatsListener;
+	class NetworkSession;
+
+	// One message of the "profiler" DevCon interest, sent as a single Bytes node.
+	// Frame times and counters cover every frame since the previous sample, but only one frame (the sampled one) has its events and system times.
+	class DevConProfilerSample
+	{
+	public:
+		struct Event {
+			uint16_t nameIdx = 0;
+			uint8_t threadIdx = 0;
+			ProfilerEventType type = ProfilerEventType::Game;
+			int16_t depth = 0;
+			int64_t startTime = 0; // Nanoseconds since the start of the sampled frame
+			int64_t duration = 0;
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		struct NetworkStats {
+			uint64_t sentBytesPerSecond = 0;
+			uint64_t receivedBytesPerSecond = 0;
+			uint64_t sentPacketsPerSecond = 0;
+			uint64_t receivedPacketsPerSecond = 0;
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		uint32_t numFrames = 0;
+		int64_t averageFrameTime = 0;
+		int64_t maxFrameTime = 0;
+		uint64_t ramUsage = 0;
+		uint64_t vramUsage = 0;
+		std::optional<NetworkStats> network;
+
+		int64_t sampledFrameTime = 0;
+		Vector<std::pair<String, int64_t>> systemTimes;
+		Vector<String> threadNames;
+		Vector<String> eventNames;
+		Vector<Event> events;
+
+		ConfigNode toConfigNode() const;
+		static std::optional<DevConProfilerSample> fromConfigNode(const ConfigNode& node);
+
+		void serialize(Serializer& s) const;
+		void deserialize(Deserializer& s);
+	};
+
+	// Serves the "profiler" DevCon interest from the game side. Parameters:
+	//   interval: seconds between samples (default 1)
+	//   maxEvents: events sent from each sampled frame, longest first (default 256, 0 for none)
+	//   minEventTime: events shorter than this, in microseconds, aren't sent (default 20)
+	// The profiler only records the sampled frames, and nothing at all when nobody is listening.
+	class DevConProfilerStream final : private CoreAPI::IProfileCallback
+	{
+	public:
+		constexpr static const char* interestId = "profiler";
+
+		DevConProfilerStream(const HalleyAPI& api, DevConInterest& interest);
+		~DevConProfilerStream() override;
+
+		void update(Time t);
+
+		void setNetworkStats(NetworkSession& session);
+		void setNetworkStats(INetworkServiceStatsListener* stats);
+
+	private:
+		struct Settings {
+			Time interval = 1.0;
+			size_t maxEvents = 256;
+			int64_t minEventTime = 20'000;
+		};
+
+		const HalleyAPI& api;
+		DevConInterest& interest;
+		INetworkServiceStatsListener* networkStats = nullptr;
+
+		bool registered = false;
+		bool captureRequested = false;
+		Settings settings;
+		Time timeSinceSample = 0;
+		uint32_t numFrames = 0;
+		Time totalFrameTime = 0;
+		Time maxFrameTime = 0;
+		std::optional<DevConProfilerSample> pendingSample;
+
+		void setRegistered(bool registered);
+		void updateSettings();
+
+		bool shouldCaptureFrame() override;
+		void onProfileData(std::shared_ptr<ProfilerData> data) override;
+		void sendSample(DevConProfilerSample sample);
+	};
+
+	// Subscribes a DevConServer (e.g. the editor's) to the profiler stream of every connected game, decoding the samples
+	class DevConProfilerListener
+	{
+	public:
+		using Callback = std::function<void(size_t connectionId, const DevConProfilerSample& sample)>;
+
+		DevConProfilerListener(DevConServer& server, Callback callback, Time interval = 1.0, int maxEvents = 256);
+		~DevConProfilerListener();
+
+		DevConProfilerListener(const DevConProfilerListener& other) = delete;
+		DevConProfilerListener& operator=(const DevConProfilerListener& other) = delete;
+
+	private:
+		DevConServer& server;
+		uint32_t handle;
+	};
+}
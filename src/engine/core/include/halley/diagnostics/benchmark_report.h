@@ -0,0 +1,22 @@
+#pragma once
+#include "halley/file_formats/json_forward.h"
+#include "halley/file/path.h"
+#include "halley/data_structures/vector.h"
+#include "halley/text/halleystring.h"
+#include <gsl/gsl>
+#include <optional>
+
+namespace Halley
+{
+	// Helpers shared by the headless benchmark stages, which are started from the command line by halley-cmd
+	class BenchmarkReport
+	{
+	public:
+		static std::optional<String> getArgument(gsl::span<const String> args, std::string_view name);
+
+		// Returns mean, p50, p90, p99 and max, in milliseconds
+		static JSONValue makeTimeStats(Vector<int64_t> nanoseconds);
+
+		static void write(const JSONValue& report, const Path& path);
+	};
+}
@@ -5,6 +5,7 @@
 #include "stats_view.h"
 #include "halley/api/core_api.h"
 #include "halley/api/system_api.h"
+#include "halley/graphics/material/material_intern_cache.h"
 #include "halley/net/connection/ack_unreliable_connection_stats.h"
 #include "halley/support/profiler.h"
 
@@ -109,6 +110,7 @@ namespace Halley
 		const Sprite whitebox;
 
 		SystemAPI::MemoryUsage memoryUsage;
+		MaterialInternCache::Stats materialStats;
 		Time memoryUsageRefreshTime = 1;
 
 		void drawHeader(Painter& painter, bool simple);
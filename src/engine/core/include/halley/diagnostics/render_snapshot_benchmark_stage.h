@@ -0,0 +1,48 @@
+#pragma once
+#include "halley/stage/stage.h"
+#include "halley/api/core_api.h"
+#include "halley/file/path.h"
+
+namespace Halley
+{
+	class RenderSnapshot;
+
+	// Replays a saved RenderSnapshot once per frame, timing the CPU cost of submitting it to the Painter, and writes a JSON report.
+	// Core creates this instead of the game's first stage when started with --replay-snapshot (see halley-cmd replay-snapshot).
+	// Meant to run headless, where the dummy video backend makes this independent of the GPU and driver.
+	class RenderSnapshotBenchmarkStage final : public Stage, private CoreAPI::IProfileCallback
+	{
+	public:
+		struct Options {
+			Path snapshot;
+			int warmupFrames = 60;
+			int frames = 600;
+			bool batched = false;
+			Path output = "snapshot_benchmark.json";
+
+			static std::optional<Options> fromArguments(gsl::span<const String> args);
+			Vector<String> toArguments() const;
+		};
+
+		explicit RenderSnapshotBenchmarkStage(Options options);
+		~RenderSnapshotBenchmarkStage() override;
+
+		void init() override;
+		void onVariableUpdate(Time t) override;
+		void onRender(RenderContext& rc) const override;
+
+	private:
+		Options options;
+		std::unique_ptr<RenderSnapshot> snapshot;
+
+		mutable int curFrame = 0;
+		mutable Vector<int64_t> replayTimes;
+		Vector<int64_t> drawCallTimes;
+		Vector<int64_t> projectionTimes;
+		uint64_t peakMemory = 0;
+
+		bool isMeasuring() const;
+		void onProfileData(std::shared_ptr<ProfilerData> data) override;
+		void writeReport() const;
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "entity_stage.h"
+#include "halley/api/core_api.h"
+#include "halley/file/path.h"
+
+namespace Halley
+{
+	class World;
+	class EntityFactory;
+
+	// Loads a scene into a headless world and runs a fixed number of ticks on it, writing timings to a JSON report.
+	// Core creates this instead of the game's first stage when started with --benchmark-scene (see halley-cmd benchmark).
+	// Each variable update of Core runs exactly one fixed and one variable step, so the tick count doesn't depend on wall time.
+	class BenchmarkStage final : public EntityStage, private CoreAPI::IProfileCallback
+	{
+	public:
+		struct Options {
+			String scene;
+			String stage = "stages/game_world";
+			std::optional<String> systemTag;
+			int warmupTicks = 60;
+			int ticks = 600;
+			uint32_t seed = 0;
+			Path output = "benchmark.json";
+
+			static std::optional<Options> fromArguments(gsl::span<const String> args);
+			Vector<String> toArguments() const;
+		};
+
+		explicit BenchmarkStage(Options options);
+		~BenchmarkStage() override;
+
+		void init() override;
+		void onVariableUpdate(Time t) override;
+		void onRender(RenderContext& rc) const override;
+
+	private:
+		Options options;
+		std::unique_ptr<World> world;
+		std::shared_ptr<EntityFactory> factory;
+		int curTick = 0;
+
+		Vector<int64_t> tickTimes;
+		HashMap<String, Vector<int64_t>> systemTimes;
+		size_t minEntities = std::numeric_limits<size_t>::max();
+		size_t maxEntities = 0;
+		uint64_t peakMemory = 0;
+		Vector<size_t> frameAllocatorBytes;
+		size_t frameAllocatorAllocations = 0;
+		size_t frameAllocatorReserved = 0;
+
+		bool isMeasuring() const;
+		void onProfileData(std::shared_ptr<ProfilerData> data) override;
+		void writeReport() const;
+	};
+}
@@ -23,6 +23,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/entity/entity_scene.h"
 #include "halley/entity/entity_factory.h"
 #include "halley/entity/entity_stage.h"
+#include "halley/entity/benchmark_stage.h"
 
 #include "halley/entity/services/debug_draw_service.h"
 #include "halley/entity/services/dev_service.h"
@@ -31,6 +32,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/entity/services/screen_service.h"
 #include "halley/entity/services/scripting_service.h"
 #include "halley/entity/services/session_service.h"
+#include "halley/entity/services/spatial_index_service.h"
 
 #include "halley/diagnostics/audio_view.h"
 #include "halley/diagnostics/frame_debugger.h"
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "halley/entity/service.h"
+#include "halley/data_structures/spatial_index.h"
+
+namespace Halley {
+	// Shared spatial index of entity bounds, so systems can do proximity and visibility queries without scanning families.
+	// Typical use is for one system to call update() on every entity it tracks each frame, followed by removeStale(),
+	// and any number of systems (or threads) to query getIndex() afterwards.
+	class SpatialIndexService : public Service {
+	public:
+		explicit SpatialIndexService(float cellSize = 256.0f);
+
+		// Only calls getRect() if the entity is new or its revision changed since the last update (e.g. Transform2DComponent::getRevision())
+		template <typename F>
+		void update(EntityId id, uint16_t revision, F getRect)
+		{
+			auto [iter, inserted] = tracked.emplace(id, Tracked());
+			auto& entry = iter->second;
+			entry.generation = generation;
+			if (inserted || entry.dirty || entry.revision != revision) {
+				entry.revision = revision;
+				entry.dirty = false;
+				index.set(id, getRect());
+			}
+		}
+
+		// Forces the entity's rect to be re-evaluated on its next update, e.g. if something other than its transform changed its bounds
+		void invalidate(EntityId id);
+		void remove(EntityId id);
+		void clear();
+
+		// Removes every entity which wasn't updated since the last call
+		void removeStale();
+
+		const SpatialIndex& getIndex() const;
+
+	private:
+		struct Tracked {
+			uint16_t revision = 0;
+			uint32_t generation = 0;
+			bool dirty = false;
+		};
+
+		SpatialIndex index;
+		HashMap<EntityId, Tracked> tracked;
+		uint32_t generation = 0;
+	};
+}
+
+using SpatialIndexService = Halley::SpatialIndexService;
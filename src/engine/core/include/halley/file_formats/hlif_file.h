@@ -14,13 +14,22 @@ namespace Halley {
         	Image::Format format;
         };
 
+        // V1 compresses the whole image as a single block. V2 splits it into horizontal tiles which are filtered and compressed independently,
+        // so they can be decoded in parallel.
+        enum class Version {
+	        V1,
+            V2
+        };
+
         static void decode(Image& dst, gsl::span<const gsl::byte> data);
-        static Bytes encode(const Image& image, std::string_view name = {}, bool lz4hc = true);
+        static Bytes encode(const Image& image, std::string_view name = {}, bool lz4hc = true, Version version = Version::V2);
         static Info getInfo(gsl::span<const gsl::byte> data);
         static bool isHLIF(gsl::span<const gsl::byte> data);
+        static std::optional<Version> getVersion(gsl::span<const gsl::byte> data);
 
     private:
      	constexpr static uint8_t hlifId[8] = "HLIFv01";
+     	constexpr static uint8_t hlifIdV2[8] = "HLIFv02";
 
     	enum class Format : uint8_t {
 			RGBA,
@@ -44,6 +53,12 @@ namespace Halley {
             uint8_t reserved = 0;
 		};
 
+        // Follows the header in V2, then the compressed size of the palette block and of each tile (uint32_t each), then the blocks themselves
+        struct TileHeader {
+	        uint16_t tileHeight = 0;
+            uint16_t numTiles = 0;
+        };
+
     public:
     	// Same as PNG
         enum class LineEncoding: uint8_t {
@@ -72,8 +87,16 @@ namespace Halley {
 
         static std::optional<std::pair<Vector<Palette>, Bytes>> makePalettes(gsl::span<const int> pixels, std::string_view name = {});
         static void optimizePalettes(gsl::span<Palette> palettes, gsl::span<uint8_t> pixels);
-        static void applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst);
+        static void applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst, size_t firstPixel = 0);
         static void deltaEncodePalettes(gsl::span<Palette> palettes);
         static void deltaDecodePalettes(gsl::span<Palette> palettes);
+
+        static Header makeHeader(const Image& image);
+        static Image::Format getImageFormat(const Header& header);
+        static Bytes compressBlock(gsl::span<uint8_t> data, gsl::span<uint8_t> lineData, gsl::span<uint8_t> pixelData, Vector2i size, int bpp, bool lz4hc);
+        static void decodeV1(Image& dst, const Header& header, gsl::span<const gsl::byte> bytes);
+        static void decodeV2(Image& dst, const Header& header, gsl::span<const gsl::byte> bytes);
+        static Bytes encodeV1(Header header, gsl::span<const Palette> palettes, gsl::span<const uint8_t> pixels, Vector2i size, int bpp, bool lz4hc);
+        static Bytes encodeV2(Header header, gsl::span<const Palette> palettes, gsl::span<const uint8_t> pixels, Vector2i size, int bpp, bool lz4hc);
     };
 }
@@ -71,6 +71,7 @@ namespace Halley
 		void removeStartFrameCallback(IStartFrameCallback* callback) override;
 
 		Future<std::unique_ptr<RenderSnapshot>> requestRenderSnapshot() override;
+		void captureRenderSnapshot(Path path);
 
 		int getExitCode() const { return exitCode; }
 
@@ -128,6 +129,7 @@ namespace Halley
 		std::unique_ptr<BaseFrameData> frameDataRender;
 
 		bool initialized = false;
+		bool headless = false;
 		bool running = true;
 		bool hasError = false;
 		bool hasConsole = false;
@@ -138,6 +140,8 @@ namespace Halley
 
 		Vector<IProfileCallback*> profileCallbacks;
 		Vector<Promise<std::unique_ptr<RenderSnapshot>>> pendingSnapshots;
+		std::optional<Path> snapshotCapturePath;
+		int snapshotCaptureFrame = 0;
 
 		Vector<IStartFrameCallback*> startFrameCallbacks;
 		
@@ -62,6 +62,7 @@ namespace Halley
 
 		virtual std::unique_ptr<ISceneEditor> createSceneEditorInterface();
 		virtual std::unique_ptr<IEditorCustomTools> createEditorCustomToolsInterface();
+		virtual void setupBenchmarkWorld(World& world);
 		virtual std::unique_ptr<AssetPreviewGenerator> createAssetPreviewGenerator(const HalleyAPI& api, Resources& resources, IGameEditorData* gameEditorData);
 		virtual std::unique_ptr<UIFactory> createUIFactory(const HalleyAPI& api, Resources& resources, I18N& i18n);
 		virtual std::unique_ptr<ScriptNodeTypeCollection> createScriptNodeTypeCollection();
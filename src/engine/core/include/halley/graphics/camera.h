@@ -31,6 +31,8 @@
 namespace Halley {
 
 	class RenderTarget;
+	class Serializer;
+	class Deserializer;
 
 	enum class CameraType
 	{
@@ -76,6 +78,9 @@ namespace Halley {
 
 		Rect4f getClippingRectangle() const;
 
+		void serialize(Serializer& s) const;
+		void deserialize(Deserializer& s);
+
 	private:
 		friend class Painter;
 
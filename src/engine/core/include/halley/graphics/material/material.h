@@ -105,6 +105,7 @@ namespace Halley
 
 		gsl::span<const MaterialDataBlock> getDataBlocks() const;
 		gsl::span<MaterialDataBlock> getDataBlocks();
+		bool setDataBlockData(size_t blockIdx, gsl::span<const gsl::byte> data); // Raw overwrite, used to restore serialized snapshots
 
 		void setPassEnabled(int pass, bool enabled);
 		bool isPassEnabled(int pass) const;
@@ -180,6 +181,10 @@ namespace Halley
 
 		bool isValid() const;
 
+		// Shares the updated material with identical ones through MaterialInternCache when this updater commits.
+		// Interning hashes the material and takes a global lock, so only request it for materials that will stay unchanged for a while.
+		MaterialUpdater& intern();
+
 		MaterialUpdater& set(std::string_view name, const std::shared_ptr<const Texture>& texture);
 		MaterialUpdater& set(std::string_view name, const std::shared_ptr<Texture>& texture);
 		MaterialUpdater& set(std::string_view name, const SpriteResource& sprite);
@@ -213,6 +218,7 @@ namespace Halley
 	private:
 		std::shared_ptr<const Material>* orig = nullptr;
 		std::shared_ptr<Material> material;
+		bool internOnCommit = false;
 
 		const Material& getCurrentMaterial() const;
 		const Material& getOriginalMaterial() const;
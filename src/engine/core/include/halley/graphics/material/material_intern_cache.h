@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "halley/data_structures/hash_map.h"
+#include "halley/data_structures/vector.h"
+
+namespace Halley
+{
+	class Material;
+
+	// Hash-conses materials, so that sprites with identical materials end up sharing one instance.
+	// Interned materials must never be modified again (MaterialUpdater always clones before writing).
+	// Sprites intern the materials they build from a definition, MaterialUpdater only does it when asked to (see MaterialUpdater::intern()).
+	class MaterialInternCache {
+	public:
+		struct Stats {
+			size_t internCalls = 0;
+			size_t hits = 0;
+			size_t uniqueMaterials = 0; // Live interned materials
+			size_t references = 0; // Live references to interned materials
+			size_t bytesSaved = 0; // Estimated memory saved by sharing, across live materials
+		};
+
+		static MaterialInternCache& get();
+
+		// Returns an existing equivalent material if there is one, otherwise registers and returns this one.
+		// The material passed must not be referenced (or modified) anywhere else.
+		std::shared_ptr<const Material> intern(std::shared_ptr<const Material> material);
+
+		void clear();
+		Stats getStats() const;
+
+	private:
+		mutable std::mutex mutex;
+		HashMap<uint64_t, Vector<std::weak_ptr<const Material>>> materials;
+		size_t internCalls = 0;
+		size_t hits = 0;
+		size_t insertionsSinceSweep = 0;
+
+		static bool isSame(const Material& a, const Material& b);
+		static size_t getMaterialSize(const Material& material);
+		void sweep();
+	};
+}
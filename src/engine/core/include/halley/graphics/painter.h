@@ -86,6 +86,10 @@ namespace Halley
 		// vertPosOffset is the offset, in bytes, from the start of each vertex's data, to a Vector2f which will be filled with the vertex's position in 0-1 space.
 		void drawSprites(const std::shared_ptr<const Material>& material, size_t numSprites, const void* vertexData);
 
+		// Expands the single-vertex-per-sprite data taken by drawSprites into the four-vertex-per-sprite data taken by drawQuads.
+		// dst must have space for numSprites * 4 * definition.getVertexStride() bytes.
+		static void expandSpriteVertices(const MaterialDefinition& definition, size_t numSprites, const void* src, void* dst);
+
 		// Draw one sliced sprite. Slices -> x = left, y = top, z = right, w = bottom, in [0..1] space relative to the texture
 		void drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData);
 
@@ -117,10 +121,12 @@ namespace Halley
 		size_t getNumDrawCalls() const { return nDrawCalls; }
 		size_t getNumVertices() const { return nVertices; }
 		size_t getNumTriangles() const { return nTriangles; }
+		size_t getNumUniqueMaterials() const { return frameMaterials.size(); }
 
 		size_t getPrevDrawCalls() const { return prevDrawCalls; }
 		size_t getPrevVertices() const { return prevVertices; }
 		size_t getPrevTriangles() const { return prevTriangles; }
+		size_t getPrevUniqueMaterials() const { return prevUniqueMaterials; }
 
 		void setLogging(bool logging);
 
@@ -199,6 +205,8 @@ namespace Halley
 		size_t prevDrawCalls = 0;
 		size_t prevVertices = 0;
 		size_t prevTriangles = 0;
+		size_t prevUniqueMaterials = 0;
+		HashSet<const Material*> frameMaterials;
 		bool logging = true;
 
 		Vector<IndexType> stdQuadIndexCache;
@@ -13,6 +13,7 @@ namespace Halley {
 
     class RenderContext;
     class RenderTarget;
+    class Resources;
 
 	enum class TargetBufferType {
 		Colour,
@@ -75,6 +76,7 @@ namespace Halley {
         };
 
         RenderSnapshot();
+        ~RenderSnapshot() override;
 
         void start();
         void end();
@@ -93,6 +95,18 @@ namespace Halley {
 
         PlaybackResult playback(Painter& painter, std::optional<size_t> maxCommands, TargetBufferType blitType = TargetBufferType::Colour, std::shared_ptr<const MaterialDefinition> debugMaterial = {}) const;
 
+        // Plays back every command for benchmarking, without blitting the result. If batched is set, draws are resubmitted through
+        // Painter::draw, so batching and flushPending are measured as well.
+        void replay(Painter& painter, bool batched) const;
+
+        size_t getNumDrawCalls() const;
+        size_t getNumTriangles() const;
+
+        // Saves a finished snapshot, e.g. to attach to a bug report. Render targets are only stored by name and size, and materials and
+        // textures by asset id, so loading requires the same game assets. Timestamps are not saved.
+        Bytes toBytes() const;
+        static std::unique_ptr<RenderSnapshot> fromBytes(gsl::span<const gsl::byte> bytes, Resources& resources);
+
         void addPendingTimestamp() override;
         void onTimestamp(TimestampType type, size_t idx, uint64_t value) override;
 
@@ -127,6 +141,7 @@ namespace Halley {
         Vector<SetClipData> setClipDatas;
         Vector<ClearData> clearDatas;
         Vector<DrawData> drawDatas;
+        Vector<std::unique_ptr<RenderTarget>> loadedRenderTargets;
 
     	std::atomic<int> pendingTimestamps;
         uint64_t startTime = 0;
@@ -49,6 +49,8 @@ namespace Halley
 
 	class Sprite
 	{
+		friend class RetainedSpriteLayer;
+
 	public:
 		struct RectInfo {
 			Vector2f pivot;
@@ -8,9 +8,9 @@
 
 #include "ipainter.h"
 #include "halley/data_structures/hash_map.h"
-#include "halley/data_structures/temp_allocator.h"
 #include "halley/entity/services/dev_service.h"
 #include "halley/time/halleytime.h"
+#include "halley/graphics/sprite/sprite.h"
 
 namespace Halley
 {
@@ -26,7 +26,8 @@ namespace Halley
 		SpriteCached,
 		TextRef,
 		TextCached,
-		Callback
+		Callback,
+		Retained
 	};
 
 	class SpritePainterEntry
@@ -62,6 +63,42 @@ namespace Halley
 		std::optional<Rect4f> clip;
 	};
 
+	// A set of sprites that rarely changes (e.g. tile maps and static decor). Its draw order, batches and vertex data are built
+	// once and reused every frame, until the layer is modified or invalidated.
+	class RetainedSpriteLayer {
+	public:
+		struct Batch {
+			std::shared_ptr<const Material> material;
+			Vector<char> vertices; // Quad vertices, ready for Painter::drawQuads
+			size_t numVertices = 0;
+			Vector<Sprite> sprites; // Only used by sprites that can't be retained (sliced, clipped or with auto variables), which are drawn as usual
+			Rect4f bounds;
+		};
+
+		struct Batches {
+			Vector<Batch> batches;
+			std::optional<Rect4f> bounds;
+		};
+
+		void add(const Sprite& sprite, float tieBreaker = 0);
+		void add(gsl::span<const Sprite> sprites, float tieBreaker = 0);
+		void clear();
+		void invalidate();
+
+		size_t size() const;
+		bool isDirty() const;
+
+		// Rebuilds if needed. Batches already handed out are never modified, so they can be drawn while the layer changes.
+		const std::shared_ptr<const Batches>& getBatches();
+
+	private:
+		Vector<Sprite> sprites;
+		Vector<float> tieBreakers;
+		std::shared_ptr<const Batches> batches;
+
+		std::shared_ptr<const Batches> build() const;
+	};
+
 	class MaterialUpdater;
 
 	class SpritePainterMaterialParamUpdater {
@@ -105,6 +142,9 @@ namespace Halley
 		void add(SpritePainterEntry::Callback callback, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
 		void add(Rect4f bounds);
 
+		// The layer is built (if needed) when added, and is drawn as a single unit at the given layer
+		void add(RetainedSpriteLayer& retained, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
+
 		void draw(SpriteMaskBase mask, Painter& painter) override;
 		std::optional<Rect4f> getBounds() const;
 
@@ -115,19 +155,19 @@ namespace Halley
 		Vector<Sprite> cachedSprites;
 		Vector<TextRenderer> cachedText;
 		Vector<SpritePainterEntry::Callback> callbacks;
+		Vector<std::shared_ptr<const RetainedSpriteLayer::Batches>> retainedLayers;
 		Vector<Rect4f> extraBounds;
 		bool dirty = false;
 		bool forceCopy = false;
 		bool waitForSpriteLoad = true;
 		SpritePainterMaterialParamUpdater paramUpdater;
 
-		mutable TempMemoryPool memoryPool;
-
 		void draw(gsl::span<const Sprite> sprite, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 		void draw(gsl::span<const TextRenderer> text, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 		void draw(const SpritePainterEntry::Callback& callback, Painter& painter, const std::optional<Rect4f>& clip) const;
+		void draw(const RetainedSpriteLayer::Batches& retained, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 
-		Vector<uint32_t> getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const;
-		Vector<uint32_t> getSpriteDrawOrderReordered(int mask, Rect4f view) const;
+		VectorTemp<uint32_t> getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const;
+		VectorTemp<uint32_t> getSpriteDrawOrderReordered(int mask, Rect4f view) const;
 	};
 }
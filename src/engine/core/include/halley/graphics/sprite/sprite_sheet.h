@@ -102,7 +102,9 @@ namespace Halley
 			Vector<String> filenames;
 			String origFilename;
 			String group;
+			bool allowRotation = false; // Lets the packer store it rotated in the atlas, for materials that handle textureRotation
 
+			bool canRotate() const;
 			bool operator==(const ImageData& other) const;
 			bool operator!=(const ImageData& other) const;
 
@@ -10,6 +10,8 @@ namespace Halley
 {
 	class Deserializer;
 	class Serializer;
+	class IFontGlyphRasterizer;
+	class VideoAPI;
 
 	class Font final : public Resource
 	{
@@ -24,6 +26,10 @@ namespace Halley
 			Vector2f verticalBearing;
 			Vector2f advance;
 			HashMap<int32_t, Vector2f> kerning;
+
+			// Range of this glyph's entries in the owning font's kerning pair table
+			uint32_t kerningStart = 0;
+			uint32_t kerningCount = 0;
 			
 			Glyph();
 			Glyph(const Glyph& other) = default;
@@ -43,6 +49,11 @@ namespace Halley
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize);
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize, float distanceFieldSmoothRadius, Vector<String> fallback, bool floorGlyphPosition);
 
+		// Creates a font with no baked glyphs, which rasterizes glyphs into a fixed-size atlas on demand and evicts the least recently used ones when it's full.
+		// Meant as a fallback of a baked font (see addFallback), for scripts with too many characters to bake them all (e.g. CJK). The atlas should be large enough
+		// for all the characters visible at once, or they'll keep evicting each other.
+		static std::shared_ptr<Font> makeDynamic(String name, std::shared_ptr<IFontGlyphRasterizer> rasterizer, Vector2i atlasSize, Resources& resources, VideoAPI& video);
+
 		static std::unique_ptr<Font> loadResource(ResourceLoader& loader);
 		constexpr static AssetType getAssetType() { return AssetType::Font; }
 		void reload(Resource&& resource) override;
@@ -50,7 +61,10 @@ namespace Halley
 
 		std::pair<const Glyph&, const Font&> getGlyph(int code) const;
 		const Glyph& getGlyphHere(int code) const;
+		const Glyph* tryGetGlyphHere(int code) const;
 		const Font& getFontForGlyph(int code) const;
+		Vector2f getKerning(const Glyph& prev, int32_t next) const; // prev must be a glyph of this font
+		std::pair<Rect4f, Vector2f> getGlyphImage(const Glyph& glyph) const; // Texture area and size of a glyph of this font. Use this rather than glyph.area and glyph.size, as dynamic glyphs move around.
 		float getLineHeightAtSize(float size) const;
 		float getAscenderDistance() const;
 		float getHeight() const;
@@ -63,6 +77,13 @@ namespace Halley
 		bool shouldFloorGlyphPosition() const;
 
 		void addGlyph(const Glyph& glyph);
+		void addFallback(std::shared_ptr<const Font> font);
+
+		bool isDynamic() const;
+
+		// Uploads glyphs rasterized since the last call, for this font and its fallbacks. Call from the thread doing text layout, before generating sprites.
+		// Returns a value which changes whenever glyphs were added or evicted, i.e. whenever sprites using dynamic glyphs need to be regenerated.
+		uint64_t updateDynamicGlyphs() const;
 
 		std::shared_ptr<Material> getMaterial() const;
 
@@ -72,6 +93,15 @@ namespace Halley
 		void printGlyphs() const;
 
 	private:
+		class DynamicGlyphs;
+
+		struct KerningPair {
+			int32_t next;
+			Vector2f kerning;
+		};
+
+		constexpr static int directGlyphRange = 0x800; // Everything encoded in one or two UTF-8 bytes (Latin, Greek, Cyrillic, Arabic, etc)
+
 		String name;
 		String imageName;
 		float ascender;
@@ -87,6 +117,16 @@ namespace Halley
 
 		std::shared_ptr<Material> material;
 		HashMap<int, Glyph> glyphs;
+
+		// Flat lookup tables built from glyphs, so that common characters and kerning don't need hash lookups
+		Vector<const Glyph*> directGlyphs;
+		Vector<KerningPair> kerningPairs;
+		const Glyph* replacementGlyph = nullptr;
+		bool hasLookupTables = false;
+
+		std::shared_ptr<DynamicGlyphs> dynamicGlyphs;
+
+		void buildLookupTables();
 	};
 	
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include "halley/maths/vector2.h"
+
+namespace Halley
+{
+	class Image;
+
+	// Source of glyphs for dynamic fonts (see Font::makeDynamic). Implementations must be thread-safe, as
+	// metrics are read by whoever is laying out text, while glyphs are rasterized on worker threads.
+	class IFontGlyphRasterizer
+	{
+	public:
+		struct FontInfo {
+			float ascender = 0;
+			float height = 0;
+			float sizePt = 0;
+			float smoothRadius = 0;
+			Vector2i cellSize; // Largest image returned by rasterize()
+			bool floorGlyphPosition = false;
+		};
+
+		struct GlyphMetrics {
+			Vector2f horizontalBearing;
+			Vector2f verticalBearing;
+			Vector2f advance;
+		};
+
+		virtual ~IFontGlyphRasterizer() = default;
+
+		virtual FontInfo getFontInfo() const = 0;
+
+		// Returns nothing if the font doesn't have this character
+		virtual std::optional<GlyphMetrics> getMetrics(int charcode) const = 0;
+
+		// Returns an RGBA distance field image of the glyph, laid out like the ones baked by make_font
+		virtual std::unique_ptr<Image> rasterize(int charcode) const = 0;
+	};
+}
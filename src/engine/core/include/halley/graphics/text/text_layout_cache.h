@@ -0,0 +1,95 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "halley/maths/vector2.h"
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/hash_map.h"
+
+namespace Halley
+{
+	class Font;
+
+	struct TextGlyphLayout {
+		Vector2f pos; // Relative to the line anchor
+		Vector2f penPos;
+		Vector2f lineAnchor; // Offset of this glyph's line from the text position, before flooring
+		float lineStartY;
+		float lineEndY;
+		float advanceX;
+		float ascender;
+	};
+
+	// Layout of a text at the origin. Moving the text only needs to offset each glyph by its line anchor.
+	class TextLayout {
+	public:
+		Vector<TextGlyphLayout> glyphs;
+		Vector2f extents;
+	};
+
+	class TextLayoutKey {
+	public:
+		TextLayoutKey() = default;
+		TextLayoutKey(const StringUTF32& text, const std::shared_ptr<const Font>& font, const Vector<std::pair<size_t, std::shared_ptr<const Font>>>& fontOverrides,
+			const Vector<std::pair<size_t, std::optional<float>>>& fontSizeOverrides, float size, float scale, float lineSpacing, float align, Vector2f offset, Vector2f pixelOffset);
+
+		uint64_t getHash() const;
+		bool operator==(const TextLayoutKey& other) const;
+
+	private:
+		// Fonts are held weakly so that the cache doesn't keep them loaded. A weak_ptr keeps its control block alive, so it can't be mistaken for a newer font at the same address.
+		StringUTF32 text;
+		std::weak_ptr<const Font> font;
+		Vector<std::pair<size_t, std::weak_ptr<const Font>>> fontOverrides;
+		Vector<std::pair<size_t, std::optional<float>>> fontSizeOverrides;
+		float size = 0;
+		float scale = 0;
+		float lineSpacing = 0;
+		float align = 0;
+		Vector2f offset;
+		Vector2f pixelOffset;
+		uint64_t hash = 0;
+	};
+
+	// Process-wide LRU cache of text layouts, so that identical labels share the layout work
+	class TextLayoutCache {
+	public:
+		static TextLayoutCache& get();
+
+		template <typename F>
+		std::shared_ptr<const TextLayout> getLayout(const TextLayoutKey& key, F generate)
+		{
+			if (auto layout = tryGet(key)) {
+				return layout;
+			}
+			auto layout = std::make_shared<TextLayout>(generate());
+			put(key, layout);
+			return layout;
+		}
+
+		void setCapacity(size_t maxEntries);
+		void clear();
+
+		size_t getHits() const;
+		size_t getMisses() const;
+
+	private:
+		struct Entry {
+			TextLayoutKey key;
+			std::shared_ptr<const TextLayout> layout;
+		};
+
+		mutable std::mutex mutex;
+		std::list<Entry> entries; // Most recently used first
+		HashMap<uint64_t, std::list<Entry>::iterator> index;
+		size_t capacity = 4096;
+		size_t hits = 0;
+		size_t misses = 0;
+
+		std::shared_ptr<const TextLayout> tryGet(const TextLayoutKey& key);
+		void put(const TextLayoutKey& key, std::shared_ptr<const TextLayout> layout);
+		void trim();
+	};
+}
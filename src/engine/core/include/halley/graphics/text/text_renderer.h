@@ -9,6 +9,7 @@
 #include <map>
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/text/font.h"
+#include "halley/graphics/text/text_layout_cache.h"
 
 namespace Halley
 {
@@ -136,14 +137,7 @@ namespace Halley
 		bool isCompatibleWith(const TextRenderer& other) const; // Can be drawn as part of the same draw call
 
 	private:
-		struct GlyphLayout {
-			Vector2f pos;
-			Vector2f penPos;
-			float lineStartY;
-			float lineEndY;
-			float advanceX;
-			float ascender;
-		};
+		using GlyphLayout = TextGlyphLayout;
 
 		std::shared_ptr<const Font> font;
 		mutable HashMap<const Font*, std::shared_ptr<Material>> materials;
@@ -172,13 +166,15 @@ namespace Halley
 		Vector<FontOverride> fontOverrides;
 		Vector<FontSizeOverride> fontSizeOverrides;
 
-		mutable Vector<GlyphLayout> layoutCache;
+		mutable std::shared_ptr<const TextLayout> layout; // Shared with other renderers with the same text and settings
+		mutable Vector<GlyphLayout> layoutCache; // layout, moved to position
 		mutable Vector<Sprite> spritesCache;
 		mutable bool materialDirty = true;
 		mutable bool glyphsDirty = true;
 		mutable bool layoutDirty = true;
 		mutable bool positionDirty = true;
 		mutable bool hasExtents = false;
+		mutable uint64_t dynamicGlyphsRevision = 0;
 
 		mutable Vector2f extents;
 
@@ -192,9 +188,11 @@ namespace Halley
 		void markLayoutDirty() const;
 		void markSpritesDirty() const;
 
+		void updateDynamicGlyphs() const;
 		void generateLayoutIfNeeded() const;
 		void generateGlyphsIfNeeded() const;
 		void generateLayout(const StringUTF32& text, Vector<GlyphLayout>* layouts, Vector2f& extents) const;
+		void applyLayoutPosition() const;
 		void generateSprites(Vector<Sprite>& sprites, const Vector<GlyphLayout>& layouts) const;
 		static size_t getGlyphCount(const StringUTF32& text);
 	};
@@ -2,6 +2,7 @@
 
 #include "halley/resources/resource.h"
 #include "halley/maths/vector2.h"
+#include "halley/maths/rect.h"
 #include "halley/file_formats/image_mask.h"
 #include "texture_descriptor.h"
 #include <memory>
@@ -28,6 +29,11 @@ namespace Halley
 
 		void load(TextureDescriptor descriptor);
 
+		// Replaces the pixels in region, without reloading the rest of the texture. Rows in data are stride pixels apart.
+		// Needs the texture to have been loaded with canBeUpdated, and must be called from the thread that renders.
+		// Returns false if the video backend can't do it, in which case the whole texture has to be loaded again.
+		bool updateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride);
+
 		static std::shared_ptr<Texture> loadResource(ResourceLoader& loader);
 		constexpr static AssetType getAssetType() { return AssetType::Texture; }
 
@@ -53,6 +59,7 @@ namespace Halley
 		ImageMask mask;
 
 		virtual void doLoad(TextureDescriptor& descriptor);
+		virtual bool doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride);
 		virtual void doCopyToTexture(Painter& painter, Texture& other) const;
 		virtual void doCopyToImage(Painter& painter, Image& image) const;
 		virtual size_t getVRamUsage() const;
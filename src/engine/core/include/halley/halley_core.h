@@ -75,6 +75,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/stage/stage.h"
 
 #include "halley/devcon/devcon_client.h"
+#include "halley/devcon/devcon_profiler_stream.h"
 #include "halley/devcon/devcon_server.h"
 
 #include "version/version.h"
@@ -19,6 +19,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "data_structures/config_database.h"
 #include "data_structures/config_node.h"
 #include "data_structures/dynamic_grid.h"
+#include "data_structures/frame_allocator.h"
 #include "data_structures/hash_map.h"
 #include "data_structures/mapped_pool.h"
 #include "data_structures/maybe.h"
@@ -31,6 +32,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "data_structures/ring_buffer.h"
 #include "data_structures/selection_set.h"
 #include "data_structures/simple_pool.h"
+#include "data_structures/spatial_index.h"
 #include "data_structures/temp_allocator.h"
 #include "data_structures/time_cache.h"
 #include "data_structures/tree_map.h"
@@ -55,6 +57,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "maths/bezier.h"
 #include "maths/box.h"
 #include "maths/circle.h"
+#include "maths/collision_world.h"
 #include "maths/colour.h"
 #include "maths/ellipse.h"
 #include "maths/line.h"
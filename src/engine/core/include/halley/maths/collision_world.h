@@ -0,0 +1,102 @@
+#pragma once
+
+#include "polygon.h"
+#include "halley/data_structures/vector.h"
+#include <gsl/gsl>
+
+namespace Halley {
+	// Broadphase for swept circle/ellipse queries against many polygons.
+	// Static and dynamic colliders each live in their own BVH. The static one is only rebuilt when colliders are added or removed,
+	// the dynamic one is refitted when colliders move.
+	// Call update() after making changes; queries are const and can then be run from any number of threads.
+	class CollisionWorld {
+	public:
+		using ColliderId = uint32_t;
+		static constexpr ColliderId invalidCollider = std::numeric_limits<ColliderId>::max();
+
+		enum class ColliderType : uint8_t {
+			Static,
+			Dynamic
+		};
+
+		struct SweepQuery {
+			Vector2f pos;
+			Vector2f radius; // Same x and y for a circle
+			Vector2f moveDir; // Normalised
+			float moveLen = 0;
+			uint32_t mask = std::numeric_limits<uint32_t>::max(); // Only colliders whose mask overlaps with this are tested
+		};
+
+		struct SweepResult {
+			Vector2f normal;
+			float distance = 0;
+			ColliderId collider = invalidCollider;
+			bool collided = false;
+		};
+
+		CollisionWorld();
+
+		ColliderId add(Polygon polygon, ColliderType type, uint32_t mask = std::numeric_limits<uint32_t>::max());
+		void remove(ColliderId id);
+		void clear();
+
+		// Only dynamic colliders can be moved
+		void setPolygon(ColliderId id, Polygon polygon);
+		void translate(ColliderId id, Vector2f offset);
+
+		const Polygon& getPolygon(ColliderId id) const;
+		ColliderType getType(ColliderId id) const;
+		size_t size() const;
+
+		// Rebuilds or refits the trees as needed
+		void update();
+
+		// Returns the closest collision along the sweep, same as calling getCollisionWithSweepingCircle/Ellipse on every polygon and picking the closest
+		SweepResult sweep(const SweepQuery& query) const;
+
+		// Runs all queries, in parallel on the CPU executor if there's enough of them. results[i] gets the result of queries[i].
+		void sweep(gsl::span<const SweepQuery> queries, Vector<SweepResult>& results) const;
+
+	private:
+		struct Collider {
+			Polygon polygon;
+			Rect4f aabb;
+			Circle circle;
+			uint32_t mask = 0;
+			ColliderType type = ColliderType::Static;
+			bool alive = false;
+		};
+
+		// Nodes are stored in pre-order, so children always come after their parent. The left child of an internal node is right after it.
+		struct Node {
+			Rect4f aabb;
+			uint32_t mask = 0; // Union of the masks below
+			uint32_t first = 0; // Right child (internal) or first entry in items (leaf)
+			uint32_t count = 0; // 0 for internal nodes
+		};
+
+		struct Tree {
+			Vector<Node> nodes;
+			Vector<ColliderId> items;
+			bool needsRebuild = false;
+			bool needsRefit = false;
+
+			void build(const Vector<Collider>& colliders, ColliderType type);
+			void refit(const Vector<Collider>& colliders);
+
+		private:
+			uint32_t buildNode(const Vector<Collider>& colliders, uint32_t start, uint32_t end);
+			void updateNode(const Vector<Collider>& colliders, uint32_t idx);
+		};
+
+		Vector<Collider> colliders;
+		Vector<ColliderId> freeList;
+		Tree staticTree;
+		Tree dynamicTree;
+		size_t nAlive = 0;
+
+		Tree& getTree(ColliderType type);
+		void updateCollider(Collider& collider);
+		void sweepTree(const Tree& tree, const SweepQuery& query, Rect4f sweepBounds, SweepResult& result) const;
+	};
+}
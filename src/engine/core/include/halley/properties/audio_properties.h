@@ -61,12 +61,15 @@ namespace Halley {
 		void setId(String value);
 		gsl::span<const AudioBusProperties> getChildren() const;
 		gsl::span<AudioBusProperties> getChildren();
+		std::optional<int> getMaxVoices() const;
+		void setMaxVoices(std::optional<int> value);
 
 		void collectBusIds(Vector<String>& output) const;
 
 	private:
 		String id;
 		Vector<AudioBusProperties> children;
+		std::optional<int> maxVoices;
 	};
 
 	class AudioProperties {
@@ -93,10 +96,17 @@ namespace Halley {
 		const AudioSwitchProperties* tryGetSwitch(const String& id) const;
 		const AudioVariableProperties* tryGetVariable(const String& id) const;
 
+		std::optional<int> getMaxVoices() const;
+		void setMaxVoices(std::optional<int> value);
+		float getVirtualVoiceThreshold() const;
+		void setVirtualVoiceThreshold(float value);
+
 	private:
 		Vector<AudioSwitchProperties> switches;
 		Vector<AudioVariableProperties> variables;
 		Vector<AudioBusProperties> buses;
+		std::optional<int> maxVoices;
+		float virtualVoiceThreshold = 0.001f;
 
 		void getBusIds(Vector<String>& result) const;
 	};
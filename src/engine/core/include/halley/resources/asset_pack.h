@@ -15,12 +15,18 @@ namespace Halley {
 	class ResourceDataReader;
 
 	struct AssetPackHeader {
+		static constexpr uint64_t flagEncrypted = 1;
+
 		std::array<char, 8> identifier;
-		std::array<uint8_t, 16> iv;
+		std::array<uint8_t, 16> iv; // Whole data IV for "HALLEYPK" packs, zero if not encrypted. Always zero on chunked "HALLEYP2" packs, which store an IV on each chunk.
 		uint64_t assetDbStartPos;
 		uint64_t dataStartPos;
+		uint64_t flags; // Only used by chunked packs
 
 		void init(size_t assetDbSize);
+		void initChunked(size_t dataSize, bool encrypted);
+		bool isChunked() const;
+		bool isEncrypted() const;
 	};
 
     class AssetPack {
@@ -55,15 +61,39 @@ namespace Halley {
 
 		size_t getMemoryUsage() const;
 
+		bool isChunked() const;
+		bool isEncrypted() const;
+
+		// Chunked packs store every asset on its own, with the asset database at the end, so they can be written as a stream and rebuilt incrementally.
+		// Encrypted chunks are laid out as [IV][ciphertext], and the asset position points past the IV so that chunks can be decrypted in place.
+		struct ChunkInfo {
+			size_t pos = 0;
+			size_t size = 0;
+			std::optional<uint64_t> hash;
+		};
+
+		static constexpr size_t chunkIVSize = 16;
+
+		static Bytes makeChunk(gsl::span<const gsl::byte> assetData, std::optional<Encrypt::AESKey> key);
+		static size_t getChunkSize(size_t assetSize, bool encrypted);
+		static String makeChunkPath(size_t pos, size_t size, uint64_t hash);
+		static ChunkInfo parseChunkPath(const String& path);
+		static Bytes serializeAssetDatabase(const AssetDatabase& assetDb);
+
     private:
 		std::unique_ptr<AssetDatabase> assetDb;
 		std::unique_ptr<ResourceDataReader> reader;
 		std::atomic<bool> hasReader;
 		std::mutex readerMutex;
 		size_t dataOffset = 0;
+		size_t dataSize = 0;
 		Bytes data;
 		std::array<uint8_t, 16> iv;
+		bool chunked = false;
+		bool encrypted = false;
 		mutable std::shared_ptr<bool> aliveToken;
+
+		void decryptChunks(Encrypt::AESKey key);
     };
 
 
@@ -4,6 +4,8 @@
 #include <memory>
 #include <functional>
 #include <shared_mutex>
+#include <atomic>
+#include <optional>
 #include <halley/concurrency/shared_recursive_mutex.h>
 #include <halley/text/halleystring.h>
 #include <halley/resources/resource_data.h>
@@ -17,21 +19,68 @@ namespace Halley
 	class ResourceLoader;
 	struct ResourceMemoryUsage;
 
+	struct ResourceResidencyStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t reloads = 0; // Misses on resources which had previously been evicted
+		size_t bytesEvicted = 0;
+
+		ResourceResidencyStats& operator+=(const ResourceResidencyStats& other);
+		String toString() const;
+	};
+
 	class ResourceCollectionBase
 	{
 		class Wrapper
 		{
 		public:
-			Wrapper(std::shared_ptr<Resource> resource, int loadDepth)
+			Wrapper(std::shared_ptr<Resource> resource, int loadDepth, ResourceLoadPriority priority, uint64_t lastUse, bool evictable)
 				: res(std::move(resource))
 				, depth(loadDepth)
+				, evictable(evictable)
+				, priority(static_cast<int>(priority))
+				, lastUse(lastUse)
+			{}
+
+			Wrapper(Wrapper&& other) noexcept
+				: res(std::move(other.res))
+				, depth(other.depth)
+				, evictable(other.evictable)
+				, priority(other.priority.load())
+				, lastUse(other.lastUse.load())
 			{}
 
+			Wrapper& operator=(Wrapper&& other) noexcept
+			{
+				res = std::move(other.res);
+				depth = other.depth;
+				evictable = other.evictable;
+				priority = other.priority.load();
+				lastUse = other.lastUse.load();
+				return *this;
+			}
+
 			std::shared_ptr<Resource> res;
 			int depth;
+			bool evictable;
+
+			// Updated on every get, which only holds a shared lock
+			std::atomic<int> priority; // Highest ResourceLoadPriority this resource was requested with
+			std::atomic<uint64_t> lastUse;
 		};
 
 	public:
+		struct EvictionCandidate {
+			AssetType type;
+			String assetId;
+			ResourceLoadPriority priority;
+			uint64_t lastUse;
+			size_t size;
+
+			bool operator<(const EvictionCandidate& other) const; // Sorts in eviction order
+		};
+
 		using ResourceLoaderFunc = std::function<std::shared_ptr<Resource>(std::string_view, ResourceLoadPriority)>;
 		using ResourceEnumeratorFunc = std::function<Vector<String>()>;
 
@@ -65,6 +114,25 @@ namespace Halley
 		ResourceMemoryUsage clearOldResources(float maxAge);
 		void notifyResourcesUnloaded();
 
+		// Memory budget (RAM + VRAM) for this asset type, enforced by evicting the least recently used resources that aren't referenced outside this collection.
+		// Resources requested with a higher ResourceLoadPriority are evicted after lower ones; pinned resources are never evicted.
+		void setMemoryBudget(std::optional<size_t> bytes);
+		std::optional<size_t> getMemoryBudget() const;
+		/// <returns>How much memory was freed</returns>
+		ResourceMemoryUsage enforceMemoryBudget();
+
+		void pin(std::string_view assetId);
+		void unpin(std::string_view assetId);
+		bool isPinned(std::string_view assetId) const;
+
+		/// <returns>Total memory used by this collection, including resources which can't be evicted</returns>
+		size_t collectEvictionCandidates(Vector<EvictionCandidate>& candidates) const;
+		/// <returns>How much memory was freed, zero if the resource is no longer evictable</returns>
+		ResourceMemoryUsage evict(std::string_view assetId);
+
+		ResourceResidencyStats getResidencyStats() const;
+		void resetResidencyStats();
+
 	protected:
 		virtual std::shared_ptr<Resource> loadResource(ResourceLoader& loader) = 0;
 
@@ -82,6 +150,18 @@ namespace Halley
 		mutable SharedRecursiveMutex mutex;
 		mutable std::condition_variable_any resourceLoaded;
 		HashSet<String> resourcesLoading;
+
+		std::optional<size_t> memoryBudget;
+		HashMap<String, int> pinned;
+		HashSet<String> evicted;
+
+		std::atomic<size_t> hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t reloads = 0;
+		size_t bytesEvicted = 0;
+
+		bool canEvict(const Wrapper& wrapper, std::string_view assetId) const;
 	};
 
 	template <typename T>
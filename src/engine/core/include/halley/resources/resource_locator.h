@@ -46,6 +46,7 @@ namespace Halley {
 		virtual bool purgeIfAffected(SystemAPI& system, gsl::span<const String> assetIds, gsl::span<const String> packIds) = 0;
 		virtual size_t getMemoryUsage() const = 0;
 		virtual String getName() const = 0;
+		virtual std::optional<size_t> getDataOffset(const String& asset, AssetType type) { return {}; }
 	};
 
 	class ResourceLocator final : public IResourceLocator
@@ -69,6 +70,9 @@ namespace Halley {
 		Vector<String> enumerate(AssetType type);
 		bool exists(const String& asset, AssetType type);
 
+		// Sorts assets by where their data is stored (which locator, then offset in it), so they can be read sequentially
+		void sortByDataLocation(Vector<std::pair<AssetType, String>>& assets) const;
+
 		size_t getLocatorCount() const;
 		void generateMemoryReport() const;
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/vector.h"
+#include "halley/data_structures/hash_map.h"
+
+namespace Halley {
+	enum class AssetType;
+	class ConfigNode;
+	class Resources;
+
+	// Ordered list of the assets touched while an asset (e.g. a scene) was loaded and instantiated, in first access order.
+	// Stored as a config file ("prefetch/<type>/<assetId>"), so it gets packed with the rest of the config on release builds.
+	class ResourcePrefetchManifest {
+	public:
+		using Entry = std::pair<AssetType, String>;
+
+		ResourcePrefetchManifest() = default;
+		explicit ResourcePrefetchManifest(const ConfigNode& node);
+
+		ConfigNode toConfigNode() const;
+
+		void add(AssetType type, std::string_view assetId);
+		const Vector<Entry>& getEntries() const;
+		bool empty() const;
+
+		static String getManifestId(AssetType type, std::string_view assetId);
+
+	private:
+		Vector<Entry> entries;
+		HashSet<String> seen;
+	};
+
+	// Records every resource access made by this thread during the scope's lifetime into the manifest of the given asset, if recording is enabled
+	class ResourceAccessTraceScope {
+	public:
+		ResourceAccessTraceScope(Resources& resources, AssetType type, String assetId);
+		~ResourceAccessTraceScope();
+
+		ResourceAccessTraceScope(const ResourceAccessTraceScope& other) = delete;
+		ResourceAccessTraceScope& operator=(const ResourceAccessTraceScope& other) = delete;
+
+	private:
+		Resources& resources;
+		AssetType type;
+		String assetId;
+	};
+}
@@ -28,6 +28,9 @@
 #include "halley/resources/resource.h"
 #include "resource_collection.h"
 #include "halley/text/enum_names.h"
+#include "halley/time/halleytime.h"
+#include "halley/file/path.h"
+#include "resource_prefetch.h"
 
 namespace Halley {
 	
@@ -152,10 +155,63 @@ namespace Halley {
 
 		void generateMemoryReport();
 
+		// Budget across all asset types, enforced on top of each type's own budget (see ResourceCollectionBase::setMemoryBudget)
+		void setMemoryBudget(std::optional<size_t> bytes);
+		std::optional<size_t> getMemoryBudget() const;
+		void setMemoryBudget(AssetType type, std::optional<size_t> bytes);
+
+		/// <returns>How much memory was freed</returns>
+		ResourceMemoryUsage enforceMemoryBudgets();
+		// Cache hits are only tracked (for LRU order and these stats) while any budget is set
+		ResourceResidencyStats getResidencyStats() const;
+
+		void update(Time t);
+
+		// Access traces record which assets are used while an asset loads (see ResourceAccessTraceScope)
+		// They're only recorded while an output path is set (Core sets one with --record-prefetch), and only from the thread that started them
+		// Each trace is saved as that asset's prefetch manifest when it stops
+		void setPrefetchManifestOutputPath(std::optional<Path> path);
+		void startAccessTrace(AssetType type, const String& assetId);
+		void stopAccessTrace(AssetType type, const String& assetId);
+
+		// Starts loading everything in the asset's prefetch manifest, if it has one
+		void prefetch(AssetType type, const String& assetId);
+
 	private:
+		struct AccessTrace {
+			const Resources* owner = nullptr;
+			AssetType type;
+			String assetId;
+			int depth = 1;
+			ResourcePrefetchManifest manifest;
+		};
+
 		const std::unique_ptr<ResourceLocator> locator;
 		Vector<std::unique_ptr<ResourceCollectionBase>> resources;
 		const HalleyAPI* const api;
 		ResourceOptions options;
+
+		std::optional<size_t> memoryBudget;
+		Time timeSinceBudgetCheck = 0;
+		std::atomic<uint64_t> accessClock = 0;
+		std::atomic<bool> trackingResidency = false;
+
+		std::optional<Path> prefetchManifestPath;
+
+		struct PrefetchJob;
+		std::mutex prefetchMutex;
+		Vector<Future<void>> prefetchTasks;
+		bool prefetchCancelled = false;
+
+		uint64_t nextAccessTick();
+		void recordAccess(AssetType type, std::string_view assetId);
+		void saveManifest(const AccessTrace& trace) const;
+		static Vector<AccessTrace>& getThreadTraces();
+		bool hasMemoryBudgets() const;
+		void updateResidencyTracking();
+		bool isTrackingResidency() const;
+		void schedulePrefetch(std::shared_ptr<PrefetchJob> job);
+		void runPrefetchBatch(PrefetchJob& job);
+		void stopPrefetching();
 	};
 }
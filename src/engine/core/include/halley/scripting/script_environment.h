@@ -67,6 +67,12 @@ namespace Halley {
             ReturnToOwner
         };
 
+        struct Outbox {
+            Vector<std::pair<EntityId, ScriptMessage>> scriptMessages;
+            Vector<EntityMessageData> entityMessages;
+            Vector<ScriptExecutionRequest> scriptExecutionRequests;
+        };
+
         using ScriptTargetRetriever = std::function<EntityId(const String&)>;
 
     	ScriptEnvironment(const HalleyAPI& api, World& world, Resources& resources, std::shared_ptr<ScriptNodeTypeCollection> nodeTypeCollection, bool isHost = true);
@@ -74,6 +80,11 @@ namespace Halley {
 
     	virtual void update(Time time, ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables);
 
+        // Makes an environment for updating parallel-safe scripts on a worker thread, sharing this one's world and resources.
+        // Returns null if this is a subclass that doesn't override it, as it can't be replicated here.
+        virtual std::unique_ptr<ScriptEnvironment> makeWorkerEnvironment() const;
+        void copySettingsTo(ScriptEnvironment& worker) const;
+
     	void stopState(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables, bool allThreads);
     	void terminateState(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables);
 		ConfigNode readNodeElementDevConData(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables, GraphNodeId nodeId, GraphPinId pinId);
@@ -85,6 +96,7 @@ namespace Halley {
         void assignTypes(const ScriptGraph& graph);
 
     	ConfigNode readInputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
+    	ScriptValue readInputDataPinValue(const ScriptGraphNode& node, GraphPinId pinN);
         ConfigNode readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
         EntityId readInputEntityId(const ScriptGraphNode& node, GraphPinId pinN, bool disconnectedIsSelf);
         EntityId readInputEntityIdRaw(const ScriptGraphNode& node, GraphPinId pinN);
@@ -98,6 +110,7 @@ namespace Halley {
         const ScriptVariables& getEntityVariables(EntityId entityId) const;
 
         void setEntityVariable(EntityId entityId, const String& name, ConfigNode data) const;
+        void setEntityVariable(EntityId entityId, ScriptVariableSlots::Slot slot, ConfigNode data) const;
         void setVariableTable(const VariableTable& variableTable);
         const VariableTable* getVariableTable() const;
 
@@ -142,6 +155,8 @@ namespace Halley {
         Vector<EntityMessageData> getOutboundEntityMessages();
         Vector<ScriptExecutionRequest> getScriptExecutionRequests();
         bool hasStopRequests() const;
+        Outbox takeOutbox();
+        void appendOutbox(Outbox outbox);
 
         void startHostThread(int node, ConfigNode params);
         void cancelHostThread(int node);
@@ -1,5 +1,6 @@
 #pragma once
 #include "script_state.h"
+#include "script_value.h"
 #include "halley/entity/entity_id.h"
 #include "halley/bytes/config_node_serializer.h"
 #include "halley/graph/base_graph.h"
@@ -13,6 +14,14 @@ namespace Halley {
 
 	class ScriptGraphNode final : public BaseGraphNode {
 	public:
+		// Resolved from the settings by IScriptNodeType::compile() whenever the node type is assigned, so that evaluating the node doesn't have to parse them again
+		struct CompiledData {
+			ScriptValue constant;
+			uint32_t variableSlot = 0;
+			uint8_t op = 0;
+			uint8_t scope = 0;
+		};
+
 		ScriptGraphNode();
 		ScriptGraphNode(String type, Vector2f position);
 		ScriptGraphNode(const ConfigNode& node);
@@ -27,6 +36,7 @@ namespace Halley {
 		void clearType() const override;
 		const IGraphNodeType& getGraphNodeType() const override;
 		const IScriptNodeType& getNodeType() const;
+		const CompiledData& getCompiledData() const { return compiledData; }
 
 		OptionalLite<GraphNodeId> getParentNode() const { return parentNode; }
 		void setParentNode(OptionalLite<GraphNodeId> id) { parentNode = id; }
@@ -37,6 +47,7 @@ namespace Halley {
 
 	private:
 		mutable const IScriptNodeType* nodeType = nullptr;
+		mutable CompiledData compiledData;
 		OptionalLite<GraphNodeId> parentNode;
 	};
 
@@ -132,6 +143,9 @@ namespace Halley {
 
 		const ScriptGraph* getPreviousVersion(uint64_t hash) const;
 
+		// Requires types to have been assigned
+		bool isParallelSafe() const;
+
 	private:
 		Vector<std::pair<GraphNodeId, GraphNodeId>> callerToCallee;
 		Vector<std::pair<GraphNodeId, GraphNodeId>> returnToCaller;
@@ -143,6 +157,9 @@ namespace Halley {
 
 		std::shared_ptr<ScriptGraph> previousVersion;
 
+		mutable uint64_t parallelSafeHash = 0;
+		mutable bool parallelSafe = false;
+
 		GraphNodeId findNodeRoot(GraphNodeId nodeId) const;
 		void generateRoots();
 		[[nodiscard]] bool isMultiConnection(GraphNodePinType pinType) const override;
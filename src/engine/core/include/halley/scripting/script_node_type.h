@@ -42,6 +42,10 @@ namespace Halley {
 		virtual bool hasDestructor(const ScriptGraphNode& node) const { return false; }
 		virtual bool showDestructor() const { return true; }
 
+		// Parallel-safe nodes only modify their own script state and entity (anything else is deferred through the environment's outboxes),
+		// and only make read-only queries to the rest of the world. Graphs made solely of these can be updated on worker threads.
+		virtual bool isParallelSafe() const { return false; }
+
 		virtual std::unique_ptr<IScriptStateData> makeData() const { return {}; }
         virtual void initData(IScriptStateData& data, const ScriptGraphNode& node, const EntitySerializationContext& context, const ConfigNode& nodeData) const {}
 
@@ -49,12 +53,17 @@ namespace Halley {
 		virtual void destructor(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData* curData) const = 0;
 		virtual bool isStackRollbackPoint(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId outPin, IScriptStateData* curData) const = 0;
 
+		// Called whenever the node's type is assigned, to resolve anything evaluation needs from the settings ahead of time
+		virtual void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const {}
+
 		virtual ConfigNode getData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData* curData) const = 0;
+		virtual ScriptValue getValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData* curData) const;
 		virtual void setData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data, IScriptStateData* curData) const = 0;
         virtual EntityId getEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN, IScriptStateData* curData) const = 0;
 		virtual ConfigNode getDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData* curData) const = 0;
 
 		ConfigNode readDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const;
+		ScriptValue readDataPinValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const;
 		void writeDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const;
 		EntityId readEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t idx) const;
 		EntityId readRawEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t idx) const;
@@ -86,6 +95,7 @@ namespace Halley {
 		virtual bool doIsStackRollbackPoint(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId outPin, DataType& curData) const { return false; }
 		virtual void doInitData(DataType& data, const ScriptGraphNode& node, const EntitySerializationContext& context, const ConfigNode& nodeData) const = 0;
 		virtual ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, DataType& curData) const { return ConfigNode(); }
+		virtual ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, DataType& curData) const { return ScriptValue(doGetData(environment, node, pinN, curData)); }
 		virtual void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data, DataType& curData) const {}
 		virtual EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN, DataType& curData) const { return EntityId(); }
 		virtual ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node, DataType& curData) const { return {}; }
@@ -97,6 +107,7 @@ namespace Halley {
 		void destructor(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData* curData) const final override { return doDestructor(environment, node, *dynamic_cast<DataType*>(curData)); }
 		bool isStackRollbackPoint(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId outPin, IScriptStateData* curData) const final override { return doIsStackRollbackPoint(environment, node, outPin, *dynamic_cast<DataType*>(curData)); }
 		ConfigNode getData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData* curData) const final override { return doGetData(environment, node, pinN, *dynamic_cast<DataType*>(curData)); }
+		ScriptValue getValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData* curData) const final override { return doGetValue(environment, node, pinN, *dynamic_cast<DataType*>(curData)); }
 		void setData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data, IScriptStateData* curData) const final override { doSetData(environment, node, pinN, std::move(data), *dynamic_cast<DataType*>(curData)); }
 		EntityId getEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN, IScriptStateData* curData) const final override { return doGetEntityId(environment, node, pinN, *dynamic_cast<DataType*>(curData)); }
 		ConfigNode getDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData* curData) const override { return doGetDevConData(environment, node, *dynamic_cast<DataType*>(curData)); }
@@ -109,6 +120,7 @@ namespace Halley {
 		virtual void doDestructor(ScriptEnvironment& environment, const ScriptGraphNode& node) const {}
 		virtual bool doIsStackRollbackPoint(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId outPin) const { return false; }
 		virtual ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const { return ConfigNode(); }
+		virtual ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const { return ScriptValue(doGetData(environment, node, pinN)); }
 		virtual void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const {}
 		virtual EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const { return EntityId(); }
 		virtual ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const { return {}; }
@@ -117,6 +129,7 @@ namespace Halley {
 		void destructor(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData*) const final override { return doDestructor(environment, node); }
 		bool isStackRollbackPoint(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId outPin, IScriptStateData*) const final override { return doIsStackRollbackPoint(environment, node, outPin); }
 		ConfigNode getData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData*) const final override { return doGetData(environment, node, pinN); }
+		ScriptValue getValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData*) const final override { return doGetValue(environment, node, pinN); }
 		void setData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data, IScriptStateData*) const final override { doSetData(environment, node, pinN, std::move(data)); }
 		EntityId getEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN, IScriptStateData*) const final override { return doGetEntityId(environment, node, pinN); }
 		ConfigNode getDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData*) const override { return doGetDevConData(environment, node); }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include "halley/concurrency/concurrent.h"
+#include "halley/data_structures/vector.h"
+
+namespace Halley {
+	// Updates a family of scriptable entities, running those with only parallel-safe scripts on worker environments.
+	// Each entity gets its own outbox, which are merged back in family order, so messages and execution requests
+	// come out the same regardless of which thread ran what.
+	// Entities that aren't parallel-safe update on the calling thread after all the parallel ones are done, so unlike the
+	// serial loop, they see this frame's updates of every parallel-safe entity, including those after them in the family.
+	template <typename Environment>
+	class ScriptParallelUpdater {
+	public:
+		constexpr static size_t minParallelEntities = 32;
+		constexpr static size_t entitiesPerTask = 16;
+
+		// isParallelSafe(size_t entityIdx) -> bool, updateEntity(Environment& env, size_t entityIdx)
+		// Returns false, without updating anything, if it's not worth going parallel or env can't make workers
+		template <typename IsParallelSafe, typename UpdateEntity>
+		bool update(Environment& env, size_t nEntities, IsParallelSafe isParallelSafe, UpdateEntity updateEntity)
+		{
+			const size_t nThreads = Executors::hasInstance() ? Executors::getCPU().threadCount() : 0;
+			if (nEntities < minParallelEntities || nThreads == 0 || !canMakeWorkers(env)) {
+				return false;
+			}
+
+			parallelEntities.clear();
+			for (size_t i = 0; i < nEntities; ++i) {
+				if (isParallelSafe(i)) {
+					parallelEntities.push_back(i);
+				}
+			}
+			if (parallelEntities.size() < minParallelEntities) {
+				return false;
+			}
+
+			const size_t nTasks = std::min((parallelEntities.size() + entitiesPerTask - 1) / entitiesPerTask, 4 * (nThreads + 1));
+			while (workerEnvironments.size() < nTasks) {
+				auto worker = env.makeWorkerEnvironment();
+				if (!worker) {
+					return false;
+				}
+				workerEnvironments.push_back(std::move(worker));
+			}
+
+			auto pending = env.takeOutbox();
+			entityOutboxes.resize(nEntities);
+
+			Concurrent::parallelFor(nTasks, [&] (size_t taskIdx)
+			{
+				auto& worker = *workerEnvironments[taskIdx];
+				env.copySettingsTo(worker);
+				const size_t start = parallelEntities.size() * taskIdx / nTasks;
+				const size_t end = parallelEntities.size() * (taskIdx + 1) / nTasks;
+				for (size_t i = start; i < end; ++i) {
+					const auto entityIdx = parallelEntities[i];
+					updateEntity(worker, entityIdx);
+					entityOutboxes[entityIdx] = worker.takeOutbox();
+				}
+			});
+
+			for (size_t i = 0, j = 0; i < nEntities; ++i) {
+				if (j < parallelEntities.size() && parallelEntities[j] == i) {
+					++j;
+				} else {
+					updateEntity(env, i);
+					entityOutboxes[i] = env.takeOutbox();
+				}
+			}
+
+			env.appendOutbox(std::move(pending));
+			for (auto& outbox: entityOutboxes) {
+				env.appendOutbox(std::move(outbox));
+			}
+			entityOutboxes.clear();
+
+			return true;
+		}
+
+	private:
+		Vector<std::unique_ptr<Environment>> workerEnvironments;
+		Vector<size_t> parallelEntities;
+		Vector<typename Environment::Outbox> entityOutboxes;
+		bool workersUnsupported = false;
+
+		// Checked once, before scanning any scripts, as environments that can't be replicated never will be
+		bool canMakeWorkers(Environment& env)
+		{
+			if (workerEnvironments.empty() && !workersUnsupported) {
+				if (auto worker = env.makeWorkerEnvironment()) {
+					workerEnvironments.push_back(std::move(worker));
+				} else {
+					workersUnsupported = true;
+				}
+			}
+			return !workersUnsupported;
+		}
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "halley/data_structures/config_node.h"
+#include "halley/entity/entity_id.h"
+#include "halley/maths/ops.h"
+
+namespace Halley {
+	// Value flowing through script data pins.
+	// Scalars, vectors and entity ids are held unboxed, anything else (strings, sequences, maps...) is kept as a ConfigNode.
+	class ScriptValue {
+	public:
+		enum class Type : uint8_t {
+			Undefined,
+			Bool,
+			Int,
+			Int64,
+			Float,
+			Int2,
+			Float2,
+			EntityId,
+			Boxed
+		};
+
+		ScriptValue();
+		explicit ScriptValue(bool value);
+		explicit ScriptValue(int value);
+		explicit ScriptValue(int64_t value);
+		explicit ScriptValue(float value);
+		explicit ScriptValue(Vector2i value);
+		explicit ScriptValue(Vector2f value);
+		explicit ScriptValue(EntityId value);
+		explicit ScriptValue(const ConfigNode& value);
+		explicit ScriptValue(ConfigNode&& value);
+
+		Type getType() const { return type; }
+		bool isUnboxed() const { return type != Type::Boxed; }
+
+		ConfigNode toConfigNode() const &;
+		ConfigNode toConfigNode() &&;
+
+		bool asBool(bool defaultValue) const;
+		int asInt(int defaultValue) const;
+		int64_t asInt64(int64_t defaultValue) const;
+		float asFloat(float defaultValue) const;
+		Vector2i asVector2i(Vector2i defaultValue) const;
+		Vector2f asVector2f(Vector2f defaultValue) const;
+		EntityId asEntityId(EntityId defaultValue) const;
+
+		// Same semantics as ConfigNode::compareTo
+		bool compareTo(MathRelOp op, const ScriptValue& other) const;
+
+		// Numeric arithmetic, with the same type promotion as ConfigNode::getPromotedType
+		// Returns an empty optional if the operands aren't (unboxed) numbers or vectors, and the caller needs to handle them as ConfigNodes
+		static std::optional<ScriptValue> tryApply(MathOp op, const ScriptValue& a, const ScriptValue& b);
+
+	private:
+		Type type = Type::Undefined;
+		union {
+			int64_t int64Data;
+			int intData;
+			float floatData;
+			Vector2i vec2iData;
+			Vector2f vec2fData;
+		};
+		ConfigNode boxed;
+	};
+}
@@ -5,6 +5,17 @@
 namespace Halley {
 	class EntitySerializationContext;
 
+	// Process-wide mapping of variable names to slot indices, so that compiled script nodes can address variables without hashing strings.
+	// Slots are never released, and their names stay valid for the lifetime of the process.
+	class ScriptVariableSlots {
+	public:
+		using Slot = uint32_t;
+
+		static Slot getSlot(const String& name);
+		static std::optional<Slot> tryGetSlot(const String& name);
+		static const String& getName(Slot slot);
+	};
+
 	class ScriptVariables {
 	public:
 		ScriptVariables() = default;
@@ -14,15 +25,26 @@ namespace Halley {
 		ConfigNode toConfigNode(const EntitySerializationContext& context) const;
 
 		const ConfigNode& getVariable(const String& name) const;
+		const ConfigNode& getVariable(ScriptVariableSlots::Slot slot) const;
     	void setVariable(const String& name, ConfigNode value);
+    	void setVariable(ScriptVariableSlots::Slot slot, ConfigNode value);
 		bool hasVariable(const String& name) const;
 
 		bool empty() const;
 		void clear();
 
 	private:
+		struct Entry {
+			ScriptVariableSlots::Slot slot;
+			ConfigNode value;
+		};
+
 		ConfigNode dummy;
-		HashMap<String, ConfigNode> variables;
+		Vector<Entry> variables; // Sorted by slot
+
+		const ConfigNode* tryGet(ScriptVariableSlots::Slot slot) const;
+		ConfigNode& getOrInsert(ScriptVariableSlots::Slot slot);
+		void erase(ScriptVariableSlots::Slot slot);
 	};
 
 	template <>
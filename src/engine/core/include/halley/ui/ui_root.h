@@ -27,6 +27,11 @@ namespace Halley {
 		Gamepad
 	};
 
+	struct UILayoutStats {
+		size_t widgetsLaidOut = 0; // Widgets whose children were (re-)placed
+		size_t widgetsSkipped = 0; // Widgets whose subtree was clean and kept its previous placement
+	};
+
 	class IUIRootSettingsProvider {
 	public:
 		virtual ~IUIRootSettingsProvider() = default;
@@ -36,6 +41,8 @@ namespace Halley {
 	};
 	
 	class UIRoot final : public UIParent {
+		friend class UIWidget;
+
 	public:
 		explicit UIRoot(const HalleyAPI& api, Rect4f rect = {});
 		~UIRoot();
@@ -54,6 +61,7 @@ namespace Halley {
 
 		void mouseOverNext(bool forward = true);
 		void runLayout();
+		const UILayoutStats& getLayoutStats() const; // Since the start of the last update
 		
 		std::optional<std::shared_ptr<IAudioHandle>> playSound(const String& eventName);
 		void sendEvent(UIEvent event, bool includeSelf) const override;
@@ -123,6 +131,7 @@ namespace Halley {
 		UIInputType lastInputType = UIInputType::Keyboard;
 
 		Vector<std::shared_ptr<UIWidget>> widgetsCache;
+		UILayoutStats layoutStats;
 
 		void updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType);
 
@@ -63,11 +63,15 @@ namespace Halley {
 		bool isEnabled() const;
 		void updateEnabled() const;
 
-		void setBorder(const Vector4f& border);
-
+		// Both invalidate the layout of the sizer holding this entry, and mark its parent as needing layout.
+		// Widgets placing many entries at once (e.g. UIVirtualList) can skip the latter and mark themselves once when done.
+		void setBorder(const Vector4f& border, bool markParent = true);
 		void setProportion(float prop);
 
 	private:
+		friend class UISizer;
+
+		UISizer* owner = nullptr;
 		UIElementPtr element;
 		Vector4f border;
 		float proportion;
@@ -139,6 +143,9 @@ namespace Halley {
 		UISizer* findSizerFor(IUIElement* element);
 
 		void updateEnabled() const;
+
+		// Minimum sizes are cached until this is called; the owning widget calls it whenever it's marked as needing layout
+		void markAsNeedingLayout() const;
 		
 		void swapItems(int idxA, int idxB);
 
@@ -147,9 +154,12 @@ namespace Halley {
 		{
 			std::sort(entries.begin(), entries.end(), f);
 			sortChildrenBySizerOrder();
+			onEntriesChanged();
 		}
 
 	private:
+		friend class UISizerEntry;
+
 		struct GridProportions {
 			Vector<float> columnProportions;
 			Vector<float> rowProportions;
@@ -164,6 +174,8 @@ namespace Halley {
 
 		UIParent* curParent = nullptr;
 
+		mutable std::array<std::optional<Vector2f>, 2> minSizeCache; // Indexed by includeProportional
+
 		void reparentEntry(UISizerEntry& entry);
 		void unparentEntry(UISizerEntry& entry);
 
@@ -182,5 +194,6 @@ namespace Halley {
 		float getRowProportion(int row) const;
 
 		void sortChildrenBySizerOrder();
+		void onEntriesChanged(bool markParent = true);
 	};
 }
@@ -187,6 +187,8 @@ namespace Halley {
 
 		bool needsLayout() const;
 		void markAsNeedingLayout() final override;
+		void markLayoutDirty() final override; // Re-places this subtree on the next layout, without invalidating cached minimum sizes
+		bool isLayoutDirty() const;
 
 		virtual bool canReceiveFocus() const;
 		virtual bool canReceiveMouseExclusive() const;
@@ -272,6 +274,8 @@ namespace Halley {
 		void notifyTreeRemovedFromRoot(UIRoot& root);
 
 		void setWidgetRect(Rect4f rect);
+		void notifyLaidOut();
+		void notifyLayoutSkipped();
 		void resetInputResults();
 		void updateActive(bool wasActiveBefore);
 		void notifyActivationChange(bool active);
@@ -290,6 +294,8 @@ namespace Halley {
 		UIInputType lastInputType = UIInputType::Undefined;
 	private:
 		mutable int layoutNeeded = 1;
+		bool layoutDirty = true;
+		Rect4f lastSizerRect;
 		
 		Vector2f position;
 		Vector2f size;
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ui_clickable.h"
+#include "ui_list.h"
+#include "../ui_style.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/graphics/sprite/sprite.h"
+
+namespace Halley {
+	class UIScrollPane;
+
+	class IUIVirtualListDataSource {
+	public:
+		virtual ~IUIVirtualListDataSource() = default;
+
+		virtual size_t getNumItems() const = 0;
+		virtual String getItemId(size_t idx) const = 0;
+
+		// Creates the widget for a row. Widgets are recycled as the list scrolls, so updateItem may later be called on it with a different index.
+		virtual std::shared_ptr<UIWidget> makeItem(size_t idx) = 0;
+		virtual void updateItem(UIWidget& widget, size_t idx) = 0;
+
+		// Trees can be shown by flattening their expanded nodes, the depth is used to indent each row
+		virtual int getItemDepth(size_t idx) const { return 0; }
+	};
+
+	// A vertical list which only instantiates widgets for the rows currently visible (plus a margin), for lists with a very large number of items
+	// Every row has the same height. Selection, keyboard/gamepad navigation and scrolling work over all items, not just the instantiated ones.
+	class UIVirtualList : public UIClickable {
+	public:
+		using SelectionMode = UIList::SelectionMode;
+
+		UIVirtualList(String id, UIStyle style, float itemHeight, size_t margin = 8);
+		UIVirtualList(String id, float itemHeight, size_t margin = 8); // Unstyled, for rows that draw their own background
+
+		void setDataSource(std::shared_ptr<IUIVirtualListDataSource> dataSource);
+		const std::shared_ptr<IUIVirtualListDataSource>& getDataSource() const;
+
+		// Call when items were added, removed or changed in the data source
+		void refresh();
+		void refreshItem(size_t idx);
+
+		size_t getCount() const;
+		size_t getNumInstantiatedItems() const;
+
+		bool setSelectedOption(int option, SelectionMode mode = SelectionMode::Normal);
+		bool setSelectedOptionId(const String& id, SelectionMode mode = SelectionMode::Normal);
+		int getSelectedOption() const;
+		String getSelectedOptionId() const;
+		Vector<int> getSelectedOptions() const;
+		Vector<String> getSelectedOptionIds() const;
+		bool isSelected(int option) const;
+		std::optional<int> getHoveredOption() const;
+
+		bool isMultiSelect() const;
+		void setMultiSelect(bool enabled);
+		void setRequiresSelection(bool requireSelection);
+		void setSingleClickAccept(bool enabled);
+		void setScrollToSelection(bool value);
+		void setIndentSize(float size);
+
+		void showCurSelection(bool centre);
+		Rect4f getOptionRect(int option) const;
+
+		Vector2f getLayoutMinimumSize(bool force) const override;
+		bool canReceiveFocus() const override;
+		void readFromDataBind() override;
+
+	protected:
+		void update(Time t, bool moved) override;
+		void draw(UIPainter& painter) const override;
+		void doSetState(State state) override;
+
+		void pressMouse(Vector2f mousePos, int button, KeyMods keyMods) override;
+		void onDoubleClicked(Vector2f mousePos, KeyMods keyMods) override;
+		void onMouseOver(Vector2f mousePos) override;
+		void onMouseLeft(Vector2f mousePos) override;
+		bool onKeyPress(KeyboardKeyPress key) override;
+		void onGamepadInput(const UIInputResults& input, Time time) override;
+
+	private:
+		struct Row {
+			std::shared_ptr<UIWidget> widget;
+			std::optional<size_t> idx;
+		};
+
+		UIStyle itemStyle;
+		Sprite background;
+		std::shared_ptr<IUIVirtualListDataSource> dataSource;
+		Vector<Row> rows;
+		HashSet<size_t> selected;
+
+		float itemHeight;
+		float indentSize = 0;
+		size_t margin;
+		size_t count = 0;
+		size_t windowStart = 0;
+		size_t windowEnd = 0;
+		float widestItem = 0;
+
+		int curOption = -1;
+		std::optional<int> hoverOption;
+		bool multiSelect = false;
+		bool requiresSelection = true;
+		bool singleClickAccept = false;
+		bool scrollToSelection = true;
+		bool firstUpdate = true;
+
+		void updateWindow();
+		std::pair<size_t, size_t> getVisibleRange() const;
+		const UIScrollPane* findScrollPane() const;
+
+		bool assignRow(size_t rowIdx, size_t itemIdx); // Returns true if the list got wider
+		void releaseRow(Row& row);
+		void onRowsPlaced(bool widened);
+		void refreshRowSelection(const Row& row) const;
+		void refreshAllRowSelections() const;
+
+		std::optional<int> getOptionAt(Vector2f mousePos) const;
+		bool changeSelection(int newOption, SelectionMode mode);
+		void notifyNewItemSelected();
+		void moveSelection(int delta);
+		void onAccept();
+		void onCancel();
+		SelectionMode getMode(KeyMods keyMods) const;
+	};
+}
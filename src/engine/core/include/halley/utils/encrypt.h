@@ -12,5 +12,14 @@ namespace Halley {
 
 		static Bytes encryptAES(AESIV iv, AESKey key, const Bytes& data);
 		static Bytes decryptAES(AESIV iv, AESKey key, const Bytes& data);
+
+		// Size of the output of encryptAES for an input of the given size, including the PKCS7 padding
+		static size_t getEncryptedSize(size_t size);
+
+		// dst must be getEncryptedSize(src.size()) bytes long
+		static void encryptAES(AESIV iv, AESKey key, gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst);
+
+		// Decrypts whole blocks in place, leaving the padding at the end. data must be a multiple of the block size.
+		static void decryptAESInPlace(AESIV iv, AESKey key, gsl::span<gsl::byte> data);
 	};
 }
@@ -89,8 +89,10 @@ size_t AudioClip::copyChannelData(size_t channelN, size_t pos, size_t len, float
 	Expects(pos + len <= sampleLength);
 
 	if (streaming) {
-		// NB: this assumes the channels will be read in order.
-		if (channelN == 0) {
+		// Voices sharing this clip may be rendered concurrently by different voice workers, so decoding and reading the buffer is locked,
+		// and the buffer is decoded again if another voice decoded a different range between channel reads.
+		std::unique_lock<std::mutex> lock(streamMutex);
+		if (channelN == 0 || streamBufferPos != pos || streamPos != pos + len) {
 			if (buffer.size() != numChannels) {
 				buffer.resize(numChannels);
 			}
@@ -108,6 +110,7 @@ size_t AudioClip::copyChannelData(size_t channelN, size_t pos, size_t len, float
 					AudioMixer::zero(b);
 				}
 			}
+			streamBufferPos = pos;
 			streamPos = pos + len;
 		}
 
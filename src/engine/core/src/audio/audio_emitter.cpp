@@ -72,32 +72,78 @@ void AudioEmitter::makeTemporary()
 	temporary = true;
 }
 
-void AudioEmitter::setSwitchValue(const String& id, String value)
+void AudioEmitter::setSwitchValue(const String& id, const String& value)
 {
-	switchValues[id] = std::move(value);
+	setSwitchValue(AudioParameterIds::getId(AudioParameterIds::Kind::Switch, id), AudioParameterIds::getId(AudioParameterIds::Kind::SwitchValue, value));
 }
 
 void AudioEmitter::setVariableValue(const String& id, float value)
 {
-	variableValues[id] = value;
+	setVariableValue(AudioParameterIds::getId(AudioParameterIds::Kind::Variable, id), value);
 }
 
 const String& AudioEmitter::getSwitchValue(const String& id) const
 {
-	const auto iter = switchValues.find(id);
-	if (iter == switchValues.end()) {
-		return fallback ? fallback->getSwitchValue(id) : String::emptyString();
+	const auto switchId = AudioParameterIds::tryGetId(AudioParameterIds::Kind::Switch, id);
+	if (switchId == AudioParameterIds::invalid) {
+		return String::emptyString();
 	}
-	return iter->second;
+	return AudioParameterIds::getName(AudioParameterIds::Kind::SwitchValue, getSwitchValueId(switchId));
 }
 
 float AudioEmitter::getVariableValue(const String& id) const
 {
-	const auto iter = variableValues.find(id);
-	if (iter == variableValues.end()) {
-		return fallback ? fallback->getVariableValue(id) : 0;
+	const auto variableId = AudioParameterIds::tryGetId(AudioParameterIds::Kind::Variable, id);
+	if (variableId == AudioParameterIds::invalid) {
+		return 0;
 	}
-	return iter->second;
+	return getVariableValue(variableId);
+}
+
+void AudioEmitter::setSwitchValue(AudioParameterId switchId, AudioParameterId valueId)
+{
+	if (switchId >= switchValues.size()) {
+		switchValues.resize(switchId + 1, AudioParameterIds::invalid);
+	}
+	if (switchValues[switchId] != valueId) {
+		switchValues[switchId] = valueId;
+		++version;
+	}
+}
+
+void AudioEmitter::setVariableValue(AudioParameterId variableId, float value)
+{
+	if (variableId >= variableValues.size()) {
+		variableValues.resize(variableId + 1, 0.0f);
+		variableSet.resize(variableId + 1, 0);
+	}
+	if (!variableSet[variableId] || variableValues[variableId] != value) {
+		variableValues[variableId] = value;
+		variableSet[variableId] = 1;
+		++version;
+	}
+}
+
+AudioParameterId AudioEmitter::getSwitchValueId(AudioParameterId switchId) const
+{
+	if (switchId < switchValues.size() && switchValues[switchId] != AudioParameterIds::invalid) {
+		return switchValues[switchId];
+	}
+	return fallback ? fallback->getSwitchValueId(switchId) : AudioParameterIds::emptySwitchValue;
+}
+
+float AudioEmitter::getVariableValue(AudioParameterId variableId) const
+{
+	if (variableId < variableSet.size() && variableSet[variableId]) {
+		return variableValues[variableId];
+	}
+	return fallback ? fallback->getVariableValue(variableId) : 0;
+}
+
+uint64_t AudioEmitter::getVersion() const
+{
+	// Every version only ever goes up, so the sum changes if any of them does
+	return version + (fallback ? fallback->getVersion() : 0);
 }
 
 void AudioEmitter::setRegion(AudioRegionId regionId)
@@ -115,8 +161,16 @@ AudioDebugData::EmitterData AudioEmitter::getDebugData() const
 	AudioDebugData::EmitterData result;
 
 	result.emitterId = id;
-	result.switches = switchValues;
-	result.variables = variableValues;
+	for (size_t i = 0; i < switchValues.size(); ++i) {
+		if (switchValues[i] != AudioParameterIds::invalid) {
+			result.switches[AudioParameterIds::getName(AudioParameterIds::Kind::Switch, static_cast<AudioParameterId>(i))] = AudioParameterIds::getName(AudioParameterIds::Kind::SwitchValue, switchValues[i]);
+		}
+	}
+	for (size_t i = 0; i < variableValues.size(); ++i) {
+		if (variableSet[i]) {
+			result.variables[AudioParameterIds::getName(AudioParameterIds::Kind::Variable, static_cast<AudioParameterId>(i))] = variableValues[i];
+		}
+	}
 	result.regionId = regionId;
 
 	result.voices.reserve(voices.size());
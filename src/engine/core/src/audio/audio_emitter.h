@@ -2,6 +2,7 @@
 #include "halley/audio/audio_position.h"
 #include "audio_voice.h"
 #include "halley/data_structures/hash_map.h"
+#include "halley/audio/audio_parameter_ids.h"
 
 namespace Halley {
     class AudioEmitter {
@@ -24,11 +25,19 @@ namespace Halley {
         bool shouldBeRemoved();
         void makeTemporary();
 
-        void setSwitchValue(const String& id, String value);
+        void setSwitchValue(const String& id, const String& value);
         void setVariableValue(const String& id, float value);
     	const String& getSwitchValue(const String& id) const;
         float getVariableValue(const String& id) const;
 
+        void setSwitchValue(AudioParameterId switchId, AudioParameterId valueId);
+        void setVariableValue(AudioParameterId variableId, float value);
+        AudioParameterId getSwitchValueId(AudioParameterId switchId) const; // Falls back to AudioParameterIds::emptySwitchValue
+        float getVariableValue(AudioParameterId variableId) const;
+
+        // Changes whenever a switch or variable changes on this emitter or its fallbacks
+        uint64_t getVersion() const;
+
         void setRegion(AudioRegionId regionId);
         AudioRegionId getRegion() const;
 
@@ -42,7 +51,11 @@ namespace Halley {
         AudioRegionId regionId = 0;
 
         Vector<std::unique_ptr<AudioVoice>> voices;
-        HashMap<String, String> switchValues;
-        HashMap<String, float> variableValues;
+        uint64_t version = 0;
+
+        // Indexed by AudioParameterId
+        Vector<AudioParameterId> switchValues; // AudioParameterIds::invalid if not set
+        Vector<float> variableValues;
+        Vector<uint8_t> variableSet;
     };
 }
@@ -49,11 +49,15 @@ void AudioEmitterHandleImpl::setSwitch(String switchId, String value)
 	AudioEngine* engine = facade.engine.get();
 	const auto emId = id;
 
-	facade.enqueue([=] () mutable
+	// Intern here, so the audio thread doesn't have to
+	const auto switchParamId = AudioParameterIds::getId(AudioParameterIds::Kind::Switch, switchId);
+	const auto valueParamId = AudioParameterIds::getId(AudioParameterIds::Kind::SwitchValue, value);
+
+	facade.enqueue([=] ()
 	{
 		auto* em = engine->getEmitter(emId);
 		if (em) {
-			em->setSwitchValue(switchId, std::move(value));
+			em->setSwitchValue(switchParamId, valueParamId);
 		}
 	});
 }
@@ -62,12 +66,13 @@ void AudioEmitterHandleImpl::setVariable(String variableId, float value)
 {
 	AudioEngine* engine = facade.engine.get();
 	const auto emId = id;
+	const auto variableParamId = AudioParameterIds::getId(AudioParameterIds::Kind::Variable, variableId);
 
 	facade.enqueue([=] ()
 	{
 		auto* em = engine->getEmitter(emId);
 		if (em) {
-			em->setVariableValue(variableId, value);
+			em->setVariableValue(variableParamId, value);
 		}
 	});
 }
@@ -14,9 +14,28 @@
 #include "halley/support/profiler.h"
 #include "halley/time/stopwatch.h"
 #include "halley/utils/algorithm.h"
+#include "halley/concurrency/concurrent.h"
 
 using namespace Halley;
 
+namespace {
+	// Below this many voices, dispatching to the workers costs more than it saves
+	constexpr size_t minVoicesForParallelRender = 8;
+
+	// Set while a voice worker is rendering, so sources requesting buffers get the worker's own
+	thread_local AudioBufferPool* workerPool = nullptr;
+
+	// Set while a voice is rendering, so sources requesting random numbers get the voice's own
+	thread_local AudioVoice* renderingVoice = nullptr;
+
+	void renderVoice(AudioVoice& voice, size_t numSamples, AudioBufferPool& pool)
+	{
+		renderingVoice = &voice;
+		voice.render(numSamples, pool);
+		renderingVoice = nullptr;
+	}
+}
+
 AudioEngine::AudioEngine()
 	: pool(std::make_unique<AudioBufferPool>())
 	, audioOutputBuffer(4096 * 8)
@@ -194,6 +213,19 @@ void AudioEngine::start(AudioSpec s, AudioOutputAPI& o, const AudioProperties& a
 	loadBuses();
 }
 
+void AudioEngine::setVoiceWorkers(size_t n, MakeThread makeThread)
+{
+	Expects(!voiceThreadPool);
+
+	voiceWorkers.resize(n);
+	for (auto& worker: voiceWorkers) {
+		worker.pool = std::make_unique<AudioBufferPool>();
+	}
+	if (n > 0) {
+		voiceThreadPool = std::make_unique<ThreadPool>("AudioVoice", voiceQueue, n, std::move(makeThread));
+	}
+}
+
 void AudioEngine::resume()
 {
 	running = true;
@@ -275,11 +307,10 @@ void AudioEngine::queueAudioFloat(gsl::span<const float> data)
 		if (tmpShort.size() < numSamples) {
 			tmpShort.resize(numSamples);
 		}
-		for (size_t i = 0; i < data.size(); ++i) {
-			tmpShort[i] = static_cast<short>(data[i] * 32768.0f);
-		}
+		const auto dst = gsl::span<int16_t>(tmpShort).subspan(0, numSamples);
+		AudioMixer::convertToInt16(data, dst);
 
-		queueAudioBytes(gsl::as_bytes(gsl::span<short>(tmpShort)));
+		queueAudioBytes(gsl::as_bytes(dst));
 	}
 
 	// Int32
@@ -287,11 +318,10 @@ void AudioEngine::queueAudioFloat(gsl::span<const float> data)
 		if (tmpInt.size() < numSamples) {
 			tmpInt.resize(numSamples);
 		}
-		for (size_t i = 0; i < data.size(); ++i) {
-			tmpInt[i] = static_cast<int>(data[i] * 2147483648.0f);
-		}
+		const auto dst = gsl::span<int32_t>(tmpInt).subspan(0, numSamples);
+		AudioMixer::convertToInt32(data, dst);
 
-		queueAudioBytes(gsl::as_bytes(gsl::span<int>(tmpInt)));
+		queueAudioBytes(gsl::as_bytes(dst));
 	}
 }
 
@@ -337,12 +367,12 @@ bool AudioEngine::needsMoreAudio()
 
 Random& AudioEngine::getRNG()
 {
-	return rng;
+	return renderingVoice ? renderingVoice->getRNG() : rng;
 }
 
 AudioBufferPool& AudioEngine::getPool() const
 {
-	return *pool;
+	return workerPool ? *workerPool : *pool;
 }
 
 void AudioEngine::setMasterGain(float gain)
@@ -358,20 +388,36 @@ void AudioEngine::mixVoices(size_t numSamples, size_t nChannels, AudioBuffersRef
 	}
 
 	// Update every emitter
+	playingVoices.clear();
 	for (auto& e: emitters) {
 		for (auto& v: e.second->getVoices()) {
 			// Start playing if necessary
 			if (!v->isPlaying() && !v->isDone() && v->isReady()) {
 				v->start();
 			}
-			// Render
 			if (v->isPlaying()) {
 				v->update(channels, e.second->getPosition(), listener, masterGain * getCompositeBusGain(v->getBus()));
-				v->render(numSamples, *pool);
+				playingVoices.push_back(v.get());
 			}
 		}
 	}
 
+	// Decide which voices are worth rendering
+	updateVirtualVoices();
+
+	// Render them, virtual voices just advance their playback position
+	voicesToRender.clear();
+	for (auto* voice: playingVoices) {
+		if (voice->isVirtual()) {
+			renderingVoice = voice;
+			voice->renderVirtual(numSamples);
+			renderingVoice = nullptr;
+		} else {
+			voicesToRender.push_back(voice);
+		}
+	}
+	renderVoices(numSamples);
+
 	// Mix every region
 	for (auto& listenerRegion: listener.regions) {
 		auto& region = *regions.at(listenerRegion.regionId);
@@ -391,6 +437,122 @@ void AudioEngine::mixVoices(size_t numSamples, size_t nChannels, AudioBuffersRef
 	}
 }
 
+void AudioEngine::updateVirtualVoices()
+{
+	// Most important voices get first pick of the voice slots: by priority, and then by how loud they are
+	std::sort(playingVoices.begin(), playingVoices.end(), [] (const AudioVoice* a, const AudioVoice* b)
+	{
+		if (a->getPriority() != b->getPriority()) {
+			return a->getPriority() > b->getPriority();
+		}
+		return a->getAudibility() > b->getAudibility();
+	});
+
+	for (auto& bus: buses) {
+		bus.activeVoices = 0;
+	}
+
+	const auto& props = getAudioProperties();
+	const float threshold = props.getVirtualVoiceThreshold();
+	const size_t maxVoices = static_cast<size_t>(props.getMaxVoices().value_or(std::numeric_limits<int>::max()));
+	numActiveVoices = 0;
+	numVirtualVoices = 0;
+
+	for (auto* voice: playingVoices) {
+		bool virt = false;
+		if (voice->canBeVirtual()) {
+			// A virtual voice must get noticeably louder before it comes back, so it doesn't flip every buffer around the threshold
+			const float curThreshold = voice->isVirtual() ? 2.0f * threshold : threshold;
+			virt = voice->getAudibility() < curThreshold || numActiveVoices >= maxVoices || !hasBusVoiceSlot(voice->getBus());
+		}
+		voice->setVirtual(virt);
+
+		// Voices fading out still render this buffer, so they keep their slot until they're fully virtual
+		if (voice->isVirtual()) {
+			++numVirtualVoices;
+		} else {
+			++numActiveVoices;
+			addBusVoice(voice->getBus());
+		}
+	}
+}
+
+bool AudioEngine::hasBusVoiceSlot(uint8_t busId) const
+{
+	// Limits on a bus apply to all of its children too
+	for (OptionalLite<uint8_t> cur = busId; cur && cur.value() < buses.size(); cur = buses[cur.value()].parent) {
+		const auto& bus = buses[cur.value()];
+		if (bus.maxVoices && bus.activeVoices >= *bus.maxVoices) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void AudioEngine::addBusVoice(uint8_t busId)
+{
+	for (OptionalLite<uint8_t> cur = busId; cur && cur.value() < buses.size(); cur = buses[cur.value()].parent) {
+		++buses[cur.value()].activeVoices;
+	}
+}
+
+void AudioEngine::renderVoices(size_t numSamples)
+{
+	expressionEvalTime = 0;
+	numExpressionsEvaluated = 0;
+	numExpressionsCached = 0;
+
+	const size_t nWorkers = voiceWorkers.size();
+	if (nWorkers == 0 || voicesToRender.size() < minVoicesForParallelRender) {
+		for (auto* voice: voicesToRender) {
+			renderVoice(*voice, numSamples, *pool);
+		}
+	} else {
+		// Voices are handed out one at a time, as their cost varies wildly (e.g. with resampling or filters)
+		// Each worker only touches its own voices, and random numbers come from each voice's own generator, so mixing them
+		// afterwards in emitter order gives the same result as rendering serially
+		std::atomic<size_t> nextVoice = 0;
+		auto renderNext = [&] (AudioBufferPool& voicePool)
+		{
+			for (size_t i = nextVoice++; i < voicesToRender.size(); i = nextVoice++) {
+				renderVoice(*voicesToRender[i], numSamples, voicePool);
+			}
+		};
+
+		std::array<Future<void>, 8> futures;
+		const size_t nFutures = std::min(nWorkers, futures.size());
+		for (size_t i = 0; i < nFutures; ++i) {
+			futures[i] = Concurrent::execute(voiceQueue, [&, i] ()
+			{
+				auto& worker = voiceWorkers[i];
+				workerPool = worker.pool.get();
+				renderNext(*worker.pool);
+				workerPool = nullptr;
+			});
+		}
+
+		// The audio thread pulls its weight too
+		renderNext(*pool);
+
+		Concurrent::whenAll(futures.data(), futures.data() + nFutures).wait();
+	}
+
+	lastVoiceRenderTime = 0;
+	for (const auto* voice: voicesToRender) {
+		lastVoiceRenderTime += voice->getLastRenderTime();
+	}
+	lastExpressionEvalTime = expressionEvalTime;
+	lastNumExpressionsEvaluated = numExpressionsEvaluated;
+	lastNumExpressionsCached = numExpressionsCached;
+}
+
+void AudioEngine::reportExpressionEvaluation(int64_t nanoseconds, size_t numEvaluated, size_t numCached)
+{
+	expressionEvalTime += nanoseconds;
+	numExpressionsEvaluated += numEvaluated;
+	numExpressionsCached += numCached;
+}
+
 void AudioEngine::mixMainRegion(size_t numSamples, size_t nChannels, AudioRegion& region, AudioBuffersRef& outputBuffers, float prevGain, float gain)
 {
 	mixRegion(region, outputBuffers, prevGain, gain);
@@ -423,7 +585,7 @@ void AudioEngine::mixRegion(const AudioRegion& region, AudioBuffersRef& buffers,
 		const auto regionId = e.second->getRegion();
 		if (regionId == region.getId()) {
 			for (auto& v: e.second->getVoices()) {
-				if (v->isPlaying()) {
+				if (v->isPlaying() && !v->isVirtual()) {
 					v->mixTo(buffers.getBuffers(), prevGain, gain);
 				}
 			}
@@ -549,7 +711,7 @@ void AudioEngine::loadBuses()
 uint8_t AudioEngine::loadBus(const AudioBusProperties& bus, OptionalLite<uint8_t> parent)
 {
 	const auto id = static_cast<uint8_t>(buses.size());
-	buses.push_back(BusData{ bus.getId(), 1.0f, 1.0f, parent });
+	buses.push_back(BusData{ bus.getId(), 1.0f, 1.0f, parent, {}, bus.getMaxVoices() });
 	for (const auto& child: bus.getChildren()) {
 		buses[id].children.push_back(loadBus(child, id));
 	}
@@ -602,7 +764,7 @@ std::optional<AudioDebugData> AudioEngine::getDebugData() const
 	}
 }
 
-std::unique_ptr<AudioVoice> AudioEngine::makeObjectVoice(const AudioObject& object, AudioEventId uniqueId, AudioEmitter& emitter, Range<float> playGain, Range<float> playPitch, uint32_t delaySamples)
+std::unique_ptr<AudioVoice> AudioEngine::makeObjectVoice(const AudioObject& object, AudioEventId uniqueId, AudioEmitter& emitter, Range<float> playGain, Range<float> playPitch, uint32_t delaySamples, std::optional<int> priority)
 {
 	// Prune if out of range
 	if (object.getPruneDistant()) {
@@ -635,6 +797,7 @@ std::unique_ptr<AudioVoice> AudioEngine::makeObjectVoice(const AudioObject& obje
 
 	voice->setIds(uniqueId, object.getAudioObjectId());
 	voice->setAttenuationOverride(object.getAttenuationOverride());
+	voice->setPriority(priority.value_or(object.getPriority()));
 
 	return voice;
 }
@@ -649,6 +812,13 @@ AudioDebugData AudioEngine::generateDebugData() const
 	}
 
 	result.listener = listener;
+	result.voiceRenderTime = static_cast<float>(lastVoiceRenderTime) / 1000.0f;
+	result.numVoiceWorkers = voiceWorkers.size();
+	result.numActiveVoices = numActiveVoices;
+	result.numVirtualVoices = numVirtualVoices;
+	result.expressionEvalTime = static_cast<float>(lastExpressionEvalTime) / 1000.0f;
+	result.numExpressionsEvaluated = lastNumExpressionsEvaluated;
+	result.numExpressionsCached = lastNumExpressionsCached;
 
 	return result;
 }
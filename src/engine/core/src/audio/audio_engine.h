@@ -12,6 +12,7 @@
 #include "audio_voice.h"
 #include "halley/audio/audio_event.h"
 #include "halley/audio/resampler.h"
+#include "halley/concurrency/executor.h"
 #include "halley/data_structures/hash_map.h"
 #include "halley/data_structures/ring_buffer.h"
 #include "halley/maths/random.h"
@@ -29,6 +30,7 @@ namespace Halley {
     {
     public:
 		using VoiceCallback = std::function<void(AudioVoice&)>;
+		using MakeThread = std::function<std::thread(String, std::function<void()>)>;
     	
 	    AudioEngine();
 		~AudioEngine();
@@ -55,6 +57,7 @@ namespace Halley {
 
 		void run();
 		void start(AudioSpec spec, AudioOutputAPI& out, const AudioProperties& audioProperties);
+		void setVoiceWorkers(size_t n, MakeThread makeThread);
 		void resume();
 		void pause();
 
@@ -78,7 +81,10 @@ namespace Halley {
     	void setGenerateDebugData(bool enabled);
 		std::optional<AudioDebugData> getDebugData() const;
 
-		std::unique_ptr<AudioVoice> makeObjectVoice(const AudioObject& object, AudioEventId uniqueId, AudioEmitter& emitter, Range<float> gain = { 1, 1 }, Range<float> pitch = { 1, 1 }, uint32_t delaySamples = 0);
+		std::unique_ptr<AudioVoice> makeObjectVoice(const AudioObject& object, AudioEventId uniqueId, AudioEmitter& emitter, Range<float> gain = { 1, 1 }, Range<float> pitch = { 1, 1 }, uint32_t delaySamples = 0, std::optional<int> priority = {});
+
+		// Called by sources while rendering, possibly from voice workers
+		void reportExpressionEvaluation(int64_t nanoseconds, size_t numEvaluated, size_t numCached);
 
 	private:
 		struct BusData {
@@ -87,6 +93,8 @@ namespace Halley {
 			float compositeGain = 1;
 			OptionalLite<uint8_t> parent;
 			Vector<uint8_t> children;
+			std::optional<int> maxVoices;
+			int activeVoices = 0;
 		};
 
 		struct PlayingObjectData {
@@ -95,13 +103,17 @@ namespace Halley {
 			float cooldown = 0;
 		};
 
+		struct VoiceWorker {
+			std::unique_ptr<AudioBufferPool> pool;
+		};
+
 		AudioSpec spec;
 		AudioOutputAPI* out = nullptr;
 		const AudioProperties* audioProperties = nullptr;
 		std::unique_ptr<AudioBufferPool> pool;
 		std::unique_ptr<AudioResampler> outResampler;
-		Vector<short> tmpShort;
-		Vector<int> tmpInt;
+		Vector<int16_t> tmpShort;
+		Vector<int32_t> tmpInt;
 		RingBuffer<gsl::byte> audioOutputBuffer;
 
 		std::atomic<bool> running;
@@ -126,7 +138,26 @@ namespace Halley {
 
 		bool debugDataEnabled = false;
 
+		ExecutionQueue voiceQueue;
+		std::unique_ptr<ThreadPool> voiceThreadPool;
+		Vector<VoiceWorker> voiceWorkers;
+		Vector<AudioVoice*> playingVoices;
+		Vector<AudioVoice*> voicesToRender;
+		int64_t lastVoiceRenderTime = 0;
+		std::atomic<int64_t> expressionEvalTime = 0;
+		std::atomic<size_t> numExpressionsEvaluated = 0;
+		std::atomic<size_t> numExpressionsCached = 0;
+		int64_t lastExpressionEvalTime = 0;
+		size_t lastNumExpressionsEvaluated = 0;
+		size_t lastNumExpressionsCached = 0;
+		size_t numActiveVoices = 0;
+		size_t numVirtualVoices = 0;
+
 		void mixVoices(size_t numSamples, size_t channels, AudioBuffersRef& buffers);
+		void updateVirtualVoices();
+		bool hasBusVoiceSlot(uint8_t bus) const;
+		void addBusVoice(uint8_t bus);
+		void renderVoices(size_t numSamples);
 		void mixMainRegion(size_t numSamples, size_t nChannels, AudioRegion& region, AudioBuffersRef& outputBuffers, float prevGain, float gain);
 		void mixRegion(const AudioRegion& region, AudioBuffersRef& buffers, float prevGain, float gain);
 
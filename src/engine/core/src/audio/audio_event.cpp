@@ -403,6 +403,7 @@ void AudioEventActionPlay::load(const ConfigNode& node)
 		playGain = node["gain"].asFloatRange(Range<float>(1, 1));
 		playPitch = node["pitch"].asFloatRange(Range<float>(1, 1));
 		singleton = node["singleton"].asBool(false);
+		priority = node["priority"].asOptional<int>();
 	}
 
 	delay = node["delay"].asFloat(0);
@@ -422,7 +423,7 @@ bool AudioEventActionPlay::run(AudioEngine& engine, AudioEventId uniqueId, Audio
 	}
 
 	const auto delaySamples = std::lroundf(delay * static_cast<float>(AudioConfig::sampleRate));
-	if (auto voice = engine.makeObjectVoice(*object, uniqueId, emitter, playGain, playPitch, delaySamples)) {
+	if (auto voice = engine.makeObjectVoice(*object, uniqueId, emitter, playGain, playPitch, delaySamples, priority)) {
 		voice->play(fade);
 		emitter.addVoice(std::move(voice));
 		return true;
@@ -485,12 +486,23 @@ void AudioEventActionPlay::setSingleton(bool value)
 	singleton = value;
 }
 
+std::optional<int> AudioEventActionPlay::getPriority() const
+{
+	return priority;
+}
+
+void AudioEventActionPlay::setPriority(std::optional<int> value)
+{
+	priority = value;
+}
+
 void AudioEventActionPlay::serialize(Serializer& s) const
 {
 	s << singleton;
 	s << playGain;
 	s << playPitch;
 	s << delay;
+	s << priority;
 	AudioEventActionObject::serialize(s);
 }
 
@@ -500,6 +512,7 @@ void AudioEventActionPlay::deserialize(Deserializer& s)
 	s >> playGain;
 	s >> playPitch;
 	s >> delay;
+	s >> priority;
 	AudioEventActionObject::deserialize(s);
 }
 
@@ -513,6 +526,9 @@ ConfigNode AudioEventActionPlay::toConfigNode() const
 	if (singleton) {
 		result["singleton"] = singleton;
 	}
+	if (priority) {
+		result["priority"] = priority;
+	}
 
 	if (std::abs(playGain.start - 1.0f) > 0.0001f && std::abs(playGain.end - 1.0f) > 0.0001f) {
 		result["gain"] = playGain;
@@ -11,6 +11,7 @@ using namespace Halley;
 AudioExpressionTerm::AudioExpressionTerm(AudioExpressionTermType type)
 	: type(type)
 {
+	updateIds();
 }
 
 AudioExpressionTerm::AudioExpressionTerm(const ConfigNode& node)
@@ -29,6 +30,8 @@ AudioExpressionTerm::AudioExpressionTerm(const ConfigNode& node)
 		points = InterpolationCurve(node["points"]);
 		break;
 	}
+
+	updateIds();
 }
 
 ConfigNode AudioExpressionTerm::toConfigNode() const
@@ -47,6 +50,20 @@ ConfigNode AudioExpressionTerm::toConfigNode() const
 	return result;
 }
 
+void AudioExpressionTerm::updateIds()
+{
+	switch (type) {
+	case AudioExpressionTermType::Switch:
+		paramId = AudioParameterIds::getId(AudioParameterIds::Kind::Switch, id);
+		valueId = AudioParameterIds::getId(AudioParameterIds::Kind::SwitchValue, value);
+		break;
+	case AudioExpressionTermType::Variable:
+		paramId = AudioParameterIds::getId(AudioParameterIds::Kind::Variable, id);
+		valueId = AudioParameterIds::invalid;
+		break;
+	}
+}
+
 float AudioExpressionTerm::evaluate(const AudioEmitter& emitter) const
 {
 	switch (type) {
@@ -61,7 +78,7 @@ float AudioExpressionTerm::evaluate(const AudioEmitter& emitter) const
 
 float AudioExpressionTerm::evaluateSwitch(const AudioEmitter& emitter) const
 {
-	const bool isEqual = emitter.getSwitchValue(id) == value;
+	const bool isEqual = emitter.getSwitchValueId(paramId) == valueId;
 	if (op == AudioExpressionTermComp::Equals) {
 		return isEqual ? gain : 0.0f;
 	} else if (op == AudioExpressionTermComp::NotEquals) {
@@ -72,7 +89,7 @@ float AudioExpressionTerm::evaluateSwitch(const AudioEmitter& emitter) const
 
 float AudioExpressionTerm::evaluateVariable(const AudioEmitter& emitter) const
 {
-	const auto val = emitter.getVariableValue(id);
+	const auto val = emitter.getVariableValue(paramId);
 	return points.evaluate(val);
 }
 
@@ -97,6 +114,7 @@ void AudioExpressionTerm::deserialize(Deserializer& s)
 	s >> value;
 	s >> points;
 	s >> gain;
+	updateIds();
 }
 
 void AudioExpression::load(const ConfigNode& node)
@@ -115,6 +133,21 @@ ConfigNode AudioExpression::toConfigNode() const
 	return result;
 }
 
+float AudioExpression::evaluate(const AudioEmitter& emitter, Cache& cache, bool& cached) const
+{
+	const auto version = emitter.getVersion();
+	if (cache.emitter == &emitter && cache.version == version) {
+		cached = true;
+		return cache.value;
+	}
+
+	cached = false;
+	cache.emitter = &emitter;
+	cache.version = version;
+	cache.value = evaluate(emitter);
+	return cache.value;
+}
+
 float AudioExpression::evaluate(const AudioEmitter& emitter) const
 {
 	float value;
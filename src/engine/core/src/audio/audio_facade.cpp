@@ -23,6 +23,16 @@ namespace {
 	constexpr size_t exceptionQueueSize = 16;
 	constexpr size_t finishedSoundsQueueSize = 16;
 	constexpr size_t debugInfoQueueSize = 16;
+
+	// Voice rendering is spread over a few dedicated threads, leaving the rest of the cores to the game.
+	// The audio thread also renders voices, so single or dual core machines don't get any workers.
+	constexpr size_t maxVoiceWorkers = 3;
+
+	size_t getNumVoiceWorkers()
+	{
+		const size_t nCores = std::thread::hardware_concurrency();
+		return std::min(maxVoiceWorkers, nCores / 4);
+	}
 }
 
 AudioFacade::AudioFacade(AudioOutputAPI& o, SystemAPI& system)
@@ -88,6 +98,10 @@ void AudioFacade::doStartPlayback(int deviceNumber, bool createEngine)
 	if (int(devices.size()) > deviceNumber) {
 		if (createEngine) {
 			engine = std::make_unique<AudioEngine>();
+			engine->setVoiceWorkers(getNumVoiceWorkers(), [this] (String name, std::function<void()> runnable) -> std::thread
+			{
+				return system.createThread(name, ThreadPriority::VeryHigh, std::move(runnable));
+			});
 		}
 
 		AudioSpec format;
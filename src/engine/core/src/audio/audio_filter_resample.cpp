@@ -3,8 +3,8 @@
 
 using namespace Halley;
 
-AudioFilterResample::AudioFilterResample(std::shared_ptr<AudioSource> source, float fromHz, float toHz, AudioBufferPool& pool)
-	: pool(pool)
+AudioFilterResample::AudioFilterResample(std::shared_ptr<AudioSource> source, float fromHz, float toHz, AudioEnv& env)
+	: env(env)
 	, source(std::move(source))
 	, fromHz(fromHz)
 	, toHz(toHz)
@@ -36,6 +36,8 @@ bool AudioFilterResample::getAudioData(size_t numSamples, AudioMultiChannelSampl
 	}
 
 	// Read upstream data
+	// The pool is fetched on every call, as voices can be rendered by a different voice worker each buffer
+	auto& pool = env.getPool();
 	auto srcBuffers = pool.getBuffers(nChannels, numSamplesSrc);
 	auto srcs = srcBuffers.getSampleSpans();
 	bool playing = source->getAudioData(numSamplesSrc, srcs);
@@ -82,6 +84,24 @@ void AudioFilterResample::restart()
 	resamplers.clear();
 }
 
+bool AudioFilterResample::canSkip() const
+{
+	return source->canSkip();
+}
+
+bool AudioFilterResample::skipAudioData(size_t numSamples)
+{
+	// Leftovers and resampler state are discarded, as they'd be out of date by the time we're rendering again
+	const size_t nLeftOver = leftoverSamples[0].n;
+	const size_t samplesToSkip = numSamples >= nLeftOver ? numSamples - nLeftOver : 0;
+	for (auto& l: leftoverSamples) {
+		l.n = 0;
+	}
+	resamplers.clear();
+
+	return source->skipAudioData(lroundl(samplesToSkip * fromHz / toHz));
+}
+
 void AudioFilterResample::setFromHz(float fromHz)
 {
 	this->fromHz = fromHz;
@@ -1,36 +1,182 @@
 #include "audio_mixer.h"
+#include "audio_mixer_kernels.h"
 #include "halley/utils/utils.h"
+#include <atomic>
+
+#if defined(HALLEY_AUDIO_MIXER_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 using namespace Halley;
 
+namespace {
+	void mixAudioScalar(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		if (gain0 == gain1) {
+			for (size_t i = 0; i < n; ++i) {
+				dst[i] += src[i] * gain0;
+			}
+		} else {
+			const float scale = 1.0f / static_cast<float>(n);
+			for (size_t i = 0; i < n; ++i) {
+				dst[i] += src[i] * lerp(gain0, gain1, static_cast<float>(i) * scale);
+			}
+		}
+	}
 
-#if (defined(_M_X64) || defined(__x86_64__)) && !defined(__APPLE__)
-#define HAS_SSE
-#define HAS_AVX
-#endif
+	void copyWithGainScalar(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		if (gain0 == gain1) {
+			for (size_t i = 0; i < n; ++i) {
+				dst[i] = src[i] * gain0;
+			}
+		} else {
+			const float scale = 1.0f / static_cast<float>(n);
+			for (size_t i = 0; i < n; ++i) {
+				dst[i] = src[i] * lerp(gain0, gain1, static_cast<float>(i) * scale);
+			}
+		}
+	}
 
-#if defined(_M_IX86) || defined(__i386)
-// Might not be available, but do we really care about such old processors?
-#define HAS_SSE
-#endif
+	void compressRangeScalar(AudioSample* buffer, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			buffer[i] = std::max(-0.99995f, std::min(buffer[i], 0.99995f));
+		}
+	}
 
-#ifdef HAS_AVX
-#include <xmmintrin.h>
-#ifdef __clang__
-#include <immintrin.h>
+	void interleaveStereoScalar(const AudioSample* left, const AudioSample* right, AudioSample* dst, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			dst[2 * i] = left[i];
+			dst[2 * i + 1] = right[i];
+		}
+	}
+
+	void convertToInt16Scalar(const AudioSample* src, int16_t* dst, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			dst[i] = static_cast<int16_t>(src[i] * 32768.0f);
+		}
+	}
+
+	void convertToInt32Scalar(const AudioSample* src, int32_t* dst, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			dst[i] = static_cast<int32_t>(src[i] * 2147483648.0f);
+		}
+	}
+
+	bool cpuSupportsAVX2()
+	{
+#if defined(HALLEY_AUDIO_MIXER_X86)
+	#if defined(_MSC_VER)
+		int regs[4];
+		__cpuid(regs, 1);
+		const bool osUsesXSAVE = (regs[2] & (1 << 27)) != 0;
+		const bool cpuHasAVX = (regs[2] & (1 << 28)) != 0;
+		if (!osUsesXSAVE || !cpuHasAVX || (_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+	#else
+		// Also checks that the OS saves the AVX registers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	#endif
+#else
+		return false;
 #endif
-#ifdef _MSC_VER
-#include <intrin.h>
+	}
+
+	const AudioMixerKernels& getKernelsFor(AudioMixerImplementation impl)
+	{
+		switch (impl) {
+#ifdef HALLEY_AUDIO_MIXER_X86
+		case AudioMixerImplementation::SSE:
+			return getAudioMixerKernelsSSE();
+		case AudioMixerImplementation::AVX2:
+			return getAudioMixerKernelsAVX2();
 #endif
+#ifdef HALLEY_AUDIO_MIXER_NEON
+		case AudioMixerImplementation::NEON:
+			return getAudioMixerKernelsNEON();
 #endif
+		default:
+			return getAudioMixerKernelsScalar();
+		}
+	}
 
-#ifdef HAS_SSE
-#include <xmmintrin.h>
-#ifdef _MSC_VER
-#include <intrin.h>
+	std::atomic<AudioMixerImplementation> curImplementation = AudioMixerImplementation::Scalar;
+	std::atomic<const AudioMixerKernels*> curKernels = nullptr;
+
+	const AudioMixerKernels& getKernels()
+	{
+		const auto* kernels = curKernels.load(std::memory_order_relaxed);
+		if (!kernels) {
+			AudioMixer::setImplementation(AudioMixer::getBestImplementation());
+			kernels = curKernels.load();
+		}
+		return *kernels;
+	}
+}
+
+const AudioMixerKernels& Halley::getAudioMixerKernelsScalar()
+{
+	static const AudioMixerKernels kernels = {
+		&mixAudioScalar,
+		&copyWithGainScalar,
+		&compressRangeScalar,
+		&interleaveStereoScalar,
+		&convertToInt16Scalar,
+		&convertToInt32Scalar
+	};
+	return kernels;
+}
+
+bool AudioMixer::isImplementationSupported(AudioMixerImplementation impl)
+{
+	switch (impl) {
+	case AudioMixerImplementation::Scalar:
+		return true;
+#ifdef HALLEY_AUDIO_MIXER_X86
+	case AudioMixerImplementation::SSE:
+		return true;
+	case AudioMixerImplementation::AVX2:
+		return cpuSupportsAVX2();
 #endif
+#ifdef HALLEY_AUDIO_MIXER_NEON
+	case AudioMixerImplementation::NEON:
+		return true;
 #endif
+	default:
+		return false;
+	}
+}
 
+AudioMixerImplementation AudioMixer::getBestImplementation()
+{
+	for (const auto impl: { AudioMixerImplementation::AVX2, AudioMixerImplementation::NEON, AudioMixerImplementation::SSE }) {
+		if (isImplementationSupported(impl)) {
+			return impl;
+		}
+	}
+	return AudioMixerImplementation::Scalar;
+}
+
+AudioMixerImplementation AudioMixer::getImplementation()
+{
+	getKernels();
+	return curImplementation;
+}
+
+void AudioMixer::setImplementation(AudioMixerImplementation impl)
+{
+	Expects(isImplementationSupported(impl));
+	curImplementation = impl;
+	curKernels = &getKernelsFor(impl);
+}
 
 void AudioMixer::mixAudio(AudioSamplesConst src, AudioSamples dst, float gain0, float gain1)
 {
@@ -39,21 +185,13 @@ void AudioMixer::mixAudio(AudioSamplesConst src, AudioSamples dst, float gain0,
 	if (std::abs(gain0 - gain1) < 0.0001f) {
 		// If the gain doesn't change, the code is faster
 		if (std::abs(gain0 - 1.0f) < 0.0001f) {
-			// No need to even multiply
-			for (size_t i = 0; i < nSamples; ++i) {
-				dst[i] += src[i];
-			}
+			getKernels().mixAudio(src.data(), dst.data(), nSamples, 1.0f, 1.0f);
 		} else if (std::abs(gain0) > 0.0001f) {
-			for (size_t i = 0; i < nSamples; ++i) {
-				dst[i] += src[i] * gain0;
-			}
+			getKernels().mixAudio(src.data(), dst.data(), nSamples, gain0, gain0);
 		}
 	} else {
 		// Interpolate the gain
-		const float scale = 1.0f / nSamples;
-		for (size_t i = 0; i < nSamples; ++i) {
-			dst[i] += src[i] * lerp(gain0, gain1, i * scale);
-		}
+		getKernels().mixAudio(src.data(), dst.data(), nSamples, gain0, gain1);
 	}
 }
 
@@ -75,31 +213,44 @@ void AudioMixer::mixAudio(AudioMultiChannelSamples src, AudioMultiChannelSamples
 
 void AudioMixer::interleaveChannels(AudioSamples dstBuffer, gsl::span<AudioBuffer*> srcs)
 {
-	const size_t nChannels = srcs.size();	
+	const size_t nChannels = srcs.size();
 	const size_t nSamples = dstBuffer.size() / nChannels;
-	for (size_t i = 0; i < nSamples; ++i) {
-		for (size_t j = 0; j < nChannels; ++j) {
-			dstBuffer[i * nChannels + j] = srcs[j]->samples[i];
+
+	if (nChannels == 2) {
+		getKernels().interleaveStereo(srcs[0]->samples.data(), srcs[1]->samples.data(), dstBuffer.data(), nSamples);
+	} else {
+		for (size_t i = 0; i < nSamples; ++i) {
+			for (size_t j = 0; j < nChannels; ++j) {
+				dstBuffer[i * nChannels + j] = srcs[j]->samples[i];
+			}
 		}
 	}
 }
 
 void AudioMixer::concatenateChannels(AudioSamples dst, gsl::span<AudioBuffer*> srcs)
 {
+	// Plain memory copies, no point in vectorising these
 	size_t pos = 0;
 	for (size_t i = 0; i < size_t(srcs.size()); ++i) {
-		const size_t nBytes = srcs[i]->samples.size() * sizeof(AudioSample);
-		memcpy(dst.subspan(pos, nBytes).data(), srcs[i]->samples.data(), nBytes);
-		pos += nBytes;
+		const size_t nSamples = srcs[i]->samples.size();
+		memcpy(dst.subspan(pos, nSamples).data(), srcs[i]->samples.data(), nSamples * sizeof(AudioSample));
+		pos += nSamples;
 	}
 }
 
 void AudioMixer::compressRange(AudioSamples buffer)
 {
-	for (size_t i = 0; i < buffer.size(); ++i) {
-		float& sample = buffer[i];
-		sample = std::max(-0.99995f, std::min(sample, 0.99995f));
-	}
+	getKernels().compressRange(buffer.data(), buffer.size());
+}
+
+void AudioMixer::convertToInt16(AudioSamplesConst src, gsl::span<int16_t> dst)
+{
+	getKernels().convertToInt16(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void AudioMixer::convertToInt32(AudioSamplesConst src, gsl::span<int32_t> dst)
+{
+	getKernels().convertToInt32(src.data(), dst.data(), std::min(src.size(), dst.size()));
 }
 
 void AudioMixer::zero(AudioSamples dst)
@@ -144,173 +295,10 @@ void AudioMixer::copy(AudioSamples dst, AudioSamples src, float gainStart, float
 		if (std::abs(gainStart - 1.0f) < 0.0001f) {
 			copy(dst, src);
 		} else {
-			for (size_t i = 0; i < nSamples; ++i) {
-				dst[i] = src[i] * gainStart;
-			}
+			getKernels().copyWithGain(src.data(), dst.data(), nSamples, gainStart, gainStart);
 		}
 	} else {
 		// Interpolate the gain
-		const float scale = 1.0f / nSamples;
-		for (size_t i = 0; i < nSamples; ++i) {
-			dst[i] = src[i] * lerp(gainStart, gainEnd, i * scale);
-		}
+		getKernels().copyWithGain(src.data(), dst.data(), nSamples, gainStart, gainEnd);
 	}
 }
-
-#ifdef HAS_SSE
-
-#ifdef _MSC_VER
-
-#include <intrin.h>
-
-#else
-
-#include <cpuid.h>
-static inline unsigned long long _xgetbv(unsigned int index) {
-    unsigned int eax, edx;
-    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
-    return ((unsigned long long)edx << 32) | eax;
-}
-#ifndef _XCR_XFEATURE_ENABLED_MASK
-#define _XCR_XFEATURE_ENABLED_MASK 0
-#endif
-
-#endif
-
-#endif
-
-#ifdef HAS_AVX
-static bool hasAVX()
-{
-#ifndef _MSC_VER
-    // It's crashing on Linux :(
-    return false;
-#endif
-
-#ifdef HAS_SSE
-	int regs[4];
-	int i = 1;
-
-#ifdef _WIN32
-	__cpuid(regs, i);
-#else
-	asm volatile
-	("cpuid" : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
-	: "a" (i), "c" (0));
-	// ECX is set to zero for CPUID function 4
-#endif
-
-	bool osUsesXSAVE_XRSTORE = regs[2] & (1 << 27) || false;
-	bool cpuAVXSuport = regs[2] & (1 << 28) || false;
-
-	if (osUsesXSAVE_XRSTORE && cpuAVXSuport) {
-		unsigned long long xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
-		return (xcrFeatureMask & 0x6) == 0x6;
-	} else {
-		return false;
-	}
-#else
-	return false;
-#endif
-}
-#endif
-
-
-/*
-#ifdef HAS_AVX
-void AudioMixerAVX::mixAudio(AudioSamplesConst srcRaw, AudioSamples dstRaw, float gain0, float gain1)
-{
-	gsl::span<const __m256> src(reinterpret_cast<const __m256*>(srcRaw.data()), srcRaw.size() * 2);
-	gsl::span<__m256> dst(reinterpret_cast<__m256*>(dstRaw.data()), dstRaw.size() * 2);
-	const size_t nSamples = size_t(src.size());
-
-	if (gain0 == gain1) {
-		__m256 gain = _mm256_broadcast_ss(&gain0);
-		for (size_t i = 0; i < nSamples; i += 2) {
-			dst[i] = _mm256_add_ps(dst[i], _mm256_mul_ps(src[i], gain));
-			dst[i + 1] = _mm256_add_ps(dst[i + 1], _mm256_mul_ps(src[i + 1], gain));
-		}
-	} else {
-		const float sc = 1.0f / (dst.size() * 16);
-		const float gainDiff = gain1 - gain0;
-		const float eight = 8.0f;
-
-		__m256 gain0p = _mm256_broadcast_ss(&gain0);
-		__m256 gain1p = _mm256_broadcast_ss(&gainDiff);
-		__m256 scale = _mm256_broadcast_ss(&sc);
-		__m256 inc = _mm256_broadcast_ss(&eight);
-		__m256 offset = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
-		for (size_t i = 0; i < nSamples; ++i) {
-			__m256 t = _mm256_mul_ps(offset, scale);
-			__m256 gain = _mm256_add_ps(gain0p, _mm256_mul_ps(gain1p, t));
-			offset = _mm256_add_ps(offset, inc);
-			dst[i] = _mm256_add_ps(dst[i], _mm256_mul_ps(src[i], gain));
-		}
-	}
-}
-
-void AudioMixerAVX::compressRange(AudioSamples buffer)
-{
-	gsl::span<__m256> dst(reinterpret_cast<__m256*>(buffer.data()), buffer.size() * 2);
-	const size_t nSamples = size_t(dst.size());
-
-	float val = 0.99995f;
-	__m256 minVal = { -val, -val, -val, -val, -val, -val, -val, -val };
-	__m256 maxVal = { val, val, val, val, val, val, val, val };
-
-	for (size_t i = 0; i < nSamples; ++i) {
-		dst[i] = _mm256_max_ps(minVal, _mm256_min_ps(dst[i], maxVal));
-	}
-}
-
-#endif
-
-#ifdef HAS_SSE
-
-void AudioMixerSSE::mixAudio(AudioSamplesConst srcRaw, AudioSamples dstRaw, float gain0, float gain1)
-{
-	gsl::span<const __m128> src(reinterpret_cast<const __m128*>(srcRaw.data()), srcRaw.size() * 4);
-	gsl::span<__m128> dst(reinterpret_cast<__m128*>(dstRaw.data()), dstRaw.size() * 4);
-	const size_t nSamples = size_t(src.size());
-
-	if (gain0 == gain1) {
-		__m128 gain = { gain0, gain0, gain0, gain0 };
-		for (size_t i = 0; i < nSamples; i += 4) {
-			dst[i] = _mm_add_ps(dst[i], _mm_mul_ps(src[i], gain));
-			dst[i + 1] = _mm_add_ps(dst[i + 1], _mm_mul_ps(src[i + 1], gain));
-			dst[i + 2] = _mm_add_ps(dst[i + 2], _mm_mul_ps(src[i + 2], gain));
-			dst[i + 3] = _mm_add_ps(dst[i + 3], _mm_mul_ps(src[i + 3], gain));
-		}
-	} else {
-		const float sc = 1.0f / (dst.size() * 16);
-		const float gainDiff = gain1 - gain0;
-
-		__m128 gain0p = { gain0, gain0, gain0, gain0 };
-		__m128 gain1p = { gainDiff, gainDiff, gainDiff, gainDiff };
-		__m128 scale = { sc, sc, sc, sc };
-		__m128 offset = { 0.0f, 1.0f, 2.0f, 3.0f };
-		__m128 inc = { 4.0f, 4.0f, 4.0f, 4.0f };
-		for (size_t i = 0; i < nSamples; ++i) {
-			__m128 t = _mm_mul_ps(offset, scale);
-			__m128 gain = _mm_add_ps(_mm_mul_ps(gain1p, t), gain0p);
-			offset = _mm_add_ps(offset, inc);
-			dst[i] = _mm_add_ps(dst[i], _mm_mul_ps(src[i], gain));
-		}
-	}
-}
-
-void AudioMixerSSE::compressRange(AudioSamples buffer)
-{
-	gsl::span<__m128> dst(reinterpret_cast<__m128*>(buffer.data()), buffer.size() * 4);
-	const size_t nSamples = size_t(dst.size());
-
-	float val = 0.99995f;
-	__m128 minVal = {-val, -val, -val, -val};
-	__m128 maxVal = {val, val, val, val};
-
-	for (size_t i = 0; i < nSamples; ++i) {
-		dst[i] = _mm_max_ps(minVal, _mm_min_ps(dst[i], maxVal));
-	}
-}
-#endif
-*/
@@ -5,6 +5,25 @@
 
 namespace Halley
 {
+	enum class AudioMixerImplementation : uint8_t {
+		Scalar,
+		SSE,
+		AVX2,
+		NEON
+	};
+
+	template <>
+	struct EnumNames<AudioMixerImplementation> {
+		constexpr std::array<const char*, 4> operator()() const {
+			return{{
+				"scalar",
+				"sse",
+				"avx2",
+				"neon"
+			}};
+		}
+	};
+
 	class AudioMixer
 	{
 	public:
@@ -16,11 +35,20 @@ namespace Halley
 		static void concatenateChannels(AudioSamples dst, gsl::span<AudioBuffer*> srcs);
 		static void compressRange(AudioSamples buffer);
 
+		static void convertToInt16(AudioSamplesConst src, gsl::span<int16_t> dst);
+		static void convertToInt32(AudioSamplesConst src, gsl::span<int32_t> dst);
+
 		static void zero(AudioSamples dst);
 		static void zero(AudioMultiChannelSamples dst, size_t nChannels = 8);
 		static void zeroRange(AudioMultiChannelSamples dst, size_t nChannels, size_t start, size_t len = std::numeric_limits<size_t>::max());
 		static void copy(AudioMultiChannelSamples dst, AudioMultiChannelSamples src, size_t nChannels = 8);
 		static void copy(AudioSamples dst, AudioSamples src);
 		static void copy(AudioSamples dst, AudioSamples src, float gainStart, float gainEnd);
+
+		// The best implementation supported by the CPU is picked on first use; these allow overriding it, e.g. for benchmarking
+		static bool isImplementationSupported(AudioMixerImplementation impl);
+		static AudioMixerImplementation getBestImplementation();
+		static AudioMixerImplementation getImplementation();
+		static void setImplementation(AudioMixerImplementation impl);
 	};
 }
@@ -0,0 +1,171 @@
+#include "audio_mixer_kernels.h"
+
+#ifdef HALLEY_AUDIO_MIXER_X86
+
+#include <immintrin.h>
+
+// This file is compiled like any other, with AVX2 only enabled on the kernels themselves. Enabling it for the whole
+// file would also enable it on any inline functions it instantiates from shared headers, and the linker is free to
+// keep those copies for the whole binary, which would then crash on CPUs without AVX2.
+#if defined(__GNUC__) || defined(__clang__)
+#define HALLEY_AVX2 __attribute__((target("avx2")))
+#else
+#define HALLEY_AVX2 // MSVC allows AVX2 intrinsics without /arch:AVX2
+#endif
+
+using namespace Halley;
+
+namespace {
+	// Scalar tails, kept local so nothing in here instantiates shared inline functions
+	inline float lerpGain(float gain0, float gain1, float t)
+	{
+		return gain0 * (1.0f - t) + gain1 * t;
+	}
+
+	inline float clampSample(float value)
+	{
+		return value < -0.99995f ? -0.99995f : (value > 0.99995f ? 0.99995f : value);
+	}
+
+	// Gain for samples i..i+7, as lerp(gain0, gain1, i * scale)
+	HALLEY_AVX2 inline __m256 getGain(__m256 idx, __m256 scale, __m256 gain0, __m256 gain1)
+	{
+		const __m256 t = _mm256_mul_ps(idx, scale);
+		return _mm256_add_ps(_mm256_mul_ps(gain0, _mm256_sub_ps(_mm256_set1_ps(1.0f), t)), _mm256_mul_ps(gain1, t));
+	}
+
+	HALLEY_AVX2 void mixAudioAVX2(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(7);
+
+		if (gain0 == gain1) {
+			const __m256 gain = _mm256_set1_ps(gain0);
+			for (size_t i = 0; i < nVec; i += 8) {
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain)));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const __m256 scale = _mm256_set1_ps(sc);
+			const __m256 g0 = _mm256_set1_ps(gain0);
+			const __m256 g1 = _mm256_set1_ps(gain1);
+			const __m256 inc = _mm256_set1_ps(8.0f);
+			__m256 idx = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+			for (size_t i = 0; i < nVec; i += 8) {
+				const __m256 gain = getGain(idx, scale, g0, g1);
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain)));
+				idx = _mm256_add_ps(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * lerpGain(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	HALLEY_AVX2 void copyWithGainAVX2(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(7);
+
+		if (gain0 == gain1) {
+			const __m256 gain = _mm256_set1_ps(gain0);
+			for (size_t i = 0; i < nVec; i += 8) {
+				_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), gain));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const __m256 scale = _mm256_set1_ps(sc);
+			const __m256 g0 = _mm256_set1_ps(gain0);
+			const __m256 g1 = _mm256_set1_ps(gain1);
+			const __m256 inc = _mm256_set1_ps(8.0f);
+			__m256 idx = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+			for (size_t i = 0; i < nVec; i += 8) {
+				const __m256 gain = getGain(idx, scale, g0, g1);
+				_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), gain));
+				idx = _mm256_add_ps(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * lerpGain(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	HALLEY_AVX2 void compressRangeAVX2(AudioSample* buffer, size_t n)
+	{
+		const size_t nVec = n & ~size_t(7);
+		const __m256 minVal = _mm256_set1_ps(-0.99995f);
+		const __m256 maxVal = _mm256_set1_ps(0.99995f);
+
+		for (size_t i = 0; i < nVec; i += 8) {
+			_mm256_storeu_ps(buffer + i, _mm256_max_ps(minVal, _mm256_min_ps(_mm256_loadu_ps(buffer + i), maxVal)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			buffer[i] = clampSample(buffer[i]);
+		}
+	}
+
+	HALLEY_AVX2 void interleaveStereoAVX2(const AudioSample* left, const AudioSample* right, AudioSample* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(7);
+		for (size_t i = 0; i < nVec; i += 8) {
+			const __m256 l = _mm256_loadu_ps(left + i);
+			const __m256 r = _mm256_loadu_ps(right + i);
+			// unpack works within each 128-bit lane, so the halves need to be swapped back into order
+			const __m256 lo = _mm256_unpacklo_ps(l, r);
+			const __m256 hi = _mm256_unpackhi_ps(l, r);
+			_mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+			_mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[2 * i] = left[i];
+			dst[2 * i + 1] = right[i];
+		}
+	}
+
+	HALLEY_AVX2 void convertToInt16AVX2(const AudioSample* src, int16_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(15);
+		const __m256 scale = _mm256_set1_ps(32768.0f);
+		for (size_t i = 0; i < nVec; i += 16) {
+			const __m256i a = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale));
+			const __m256i b = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale));
+			// packs also works per lane, so reorder the 64-bit blocks afterwards
+			const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int16_t>(src[i] * 32768.0f);
+		}
+	}
+
+	HALLEY_AVX2 void convertToInt32AVX2(const AudioSample* src, int32_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(7);
+		const __m256 scale = _mm256_set1_ps(2147483648.0f);
+		for (size_t i = 0; i < nVec; i += 8) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int32_t>(src[i] * 2147483648.0f);
+		}
+	}
+}
+
+const AudioMixerKernels& Halley::getAudioMixerKernelsAVX2()
+{
+	static const AudioMixerKernels kernels = {
+		&mixAudioAVX2,
+		&copyWithGainAVX2,
+		&compressRangeAVX2,
+		&interleaveStereoAVX2,
+		&convertToInt16AVX2,
+		&convertToInt32AVX2
+	};
+	return kernels;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include "halley/api/audio_api.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386)
+#define HALLEY_AUDIO_MIXER_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define HALLEY_AUDIO_MIXER_NEON
+#endif
+
+namespace Halley
+{
+	// Raw kernels behind AudioMixer, one table per instruction set. None of them require aligned pointers.
+	// Gains are interpolated linearly from gain0 at the first sample towards gain1, exactly like lerp(gain0, gain1, i / n).
+	struct AudioMixerKernels {
+		void (*mixAudio)(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1);
+		void (*copyWithGain)(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1);
+		void (*compressRange)(AudioSample* buffer, size_t n);
+		void (*interleaveStereo)(const AudioSample* left, const AudioSample* right, AudioSample* dst, size_t n);
+		void (*convertToInt16)(const AudioSample* src, int16_t* dst, size_t n);
+		void (*convertToInt32)(const AudioSample* src, int32_t* dst, size_t n);
+	};
+
+	const AudioMixerKernels& getAudioMixerKernelsScalar();
+
+#ifdef HALLEY_AUDIO_MIXER_X86
+	const AudioMixerKernels& getAudioMixerKernelsSSE();
+	const AudioMixerKernels& getAudioMixerKernelsAVX2();
+#endif
+
+#ifdef HALLEY_AUDIO_MIXER_NEON
+	const AudioMixerKernels& getAudioMixerKernelsNEON();
+#endif
+}
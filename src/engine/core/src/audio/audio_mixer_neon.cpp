@@ -0,0 +1,149 @@
+#include "audio_mixer_kernels.h"
+
+#ifdef HALLEY_AUDIO_MIXER_NEON
+
+#include <arm_neon.h>
+#include "halley/utils/utils.h"
+
+using namespace Halley;
+
+namespace {
+	// Gain for samples i..i+3, as lerp(gain0, gain1, i * scale)
+	inline float32x4_t getGain(float32x4_t idx, float32x4_t scale, float32x4_t gain0, float32x4_t gain1)
+	{
+		const float32x4_t t = vmulq_f32(idx, scale);
+		return vaddq_f32(vmulq_f32(gain0, vsubq_f32(vdupq_n_f32(1.0f), t)), vmulq_f32(gain1, t));
+	}
+
+	void mixAudioNEON(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(3);
+
+		if (gain0 == gain1) {
+			const float32x4_t gain = vdupq_n_f32(gain0);
+			for (size_t i = 0; i < nVec; i += 4) {
+				vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vld1q_f32(src + i), gain)));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const float32x4_t scale = vdupq_n_f32(sc);
+			const float32x4_t g0 = vdupq_n_f32(gain0);
+			const float32x4_t g1 = vdupq_n_f32(gain1);
+			const float32x4_t inc = vdupq_n_f32(4.0f);
+			const float idxInit[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+			float32x4_t idx = vld1q_f32(idxInit);
+			for (size_t i = 0; i < nVec; i += 4) {
+				const float32x4_t gain = getGain(idx, scale, g0, g1);
+				vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vld1q_f32(src + i), gain)));
+				idx = vaddq_f32(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * lerp(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	void copyWithGainNEON(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(3);
+
+		if (gain0 == gain1) {
+			const float32x4_t gain = vdupq_n_f32(gain0);
+			for (size_t i = 0; i < nVec; i += 4) {
+				vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), gain));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const float32x4_t scale = vdupq_n_f32(sc);
+			const float32x4_t g0 = vdupq_n_f32(gain0);
+			const float32x4_t g1 = vdupq_n_f32(gain1);
+			const float32x4_t inc = vdupq_n_f32(4.0f);
+			const float idxInit[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+			float32x4_t idx = vld1q_f32(idxInit);
+			for (size_t i = 0; i < nVec; i += 4) {
+				const float32x4_t gain = getGain(idx, scale, g0, g1);
+				vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), gain));
+				idx = vaddq_f32(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * lerp(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	void compressRangeNEON(AudioSample* buffer, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		const float32x4_t minVal = vdupq_n_f32(-0.99995f);
+		const float32x4_t maxVal = vdupq_n_f32(0.99995f);
+
+		for (size_t i = 0; i < nVec; i += 4) {
+			vst1q_f32(buffer + i, vmaxq_f32(minVal, vminq_f32(vld1q_f32(buffer + i), maxVal)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			buffer[i] = std::max(-0.99995f, std::min(buffer[i], 0.99995f));
+		}
+	}
+
+	void interleaveStereoNEON(const AudioSample* left, const AudioSample* right, AudioSample* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		for (size_t i = 0; i < nVec; i += 4) {
+			float32x4x2_t lr;
+			lr.val[0] = vld1q_f32(left + i);
+			lr.val[1] = vld1q_f32(right + i);
+			vst2q_f32(dst + 2 * i, lr);
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[2 * i] = left[i];
+			dst[2 * i + 1] = right[i];
+		}
+	}
+
+	void convertToInt16NEON(const AudioSample* src, int16_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(7);
+		const float32x4_t scale = vdupq_n_f32(32768.0f);
+		for (size_t i = 0; i < nVec; i += 8) {
+			const int32x4_t a = vcvtq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale));
+			const int32x4_t b = vcvtq_s32_f32(vmulq_f32(vld1q_f32(src + i + 4), scale));
+			vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int16_t>(src[i] * 32768.0f);
+		}
+	}
+
+	void convertToInt32NEON(const AudioSample* src, int32_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		const float32x4_t scale = vdupq_n_f32(2147483648.0f);
+		for (size_t i = 0; i < nVec; i += 4) {
+			vst1q_s32(dst + i, vcvtq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int32_t>(src[i] * 2147483648.0f);
+		}
+	}
+}
+
+const AudioMixerKernels& Halley::getAudioMixerKernelsNEON()
+{
+	static const AudioMixerKernels kernels = {
+		&mixAudioNEON,
+		&copyWithGainNEON,
+		&compressRangeNEON,
+		&interleaveStereoNEON,
+		&convertToInt16NEON,
+		&convertToInt32NEON
+	};
+	return kernels;
+}
+
+#endif
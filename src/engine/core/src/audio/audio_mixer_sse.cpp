@@ -0,0 +1,148 @@
+#include "audio_mixer_kernels.h"
+
+#ifdef HALLEY_AUDIO_MIXER_X86
+
+#include <xmmintrin.h> // SSE
+#include <emmintrin.h> // SSE2
+#include "halley/utils/utils.h"
+
+using namespace Halley;
+
+namespace {
+	// Gain for samples i..i+3, as lerp(gain0, gain1, i * scale)
+	inline __m128 getGain(__m128 idx, __m128 scale, __m128 gain0, __m128 gain1)
+	{
+		const __m128 t = _mm_mul_ps(idx, scale);
+		return _mm_add_ps(_mm_mul_ps(gain0, _mm_sub_ps(_mm_set1_ps(1.0f), t)), _mm_mul_ps(gain1, t));
+	}
+
+	void mixAudioSSE(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(3);
+
+		if (gain0 == gain1) {
+			const __m128 gain = _mm_set1_ps(gain0);
+			for (size_t i = 0; i < nVec; i += 4) {
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), gain)));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const __m128 scale = _mm_set1_ps(sc);
+			const __m128 g0 = _mm_set1_ps(gain0);
+			const __m128 g1 = _mm_set1_ps(gain1);
+			const __m128 inc = _mm_set1_ps(4.0f);
+			__m128 idx = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+			for (size_t i = 0; i < nVec; i += 4) {
+				const __m128 gain = getGain(idx, scale, g0, g1);
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), gain)));
+				idx = _mm_add_ps(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] += src[i] * lerp(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	void copyWithGainSSE(const AudioSample* src, AudioSample* dst, size_t n, float gain0, float gain1)
+	{
+		const size_t nVec = n & ~size_t(3);
+
+		if (gain0 == gain1) {
+			const __m128 gain = _mm_set1_ps(gain0);
+			for (size_t i = 0; i < nVec; i += 4) {
+				_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), gain));
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * gain0;
+			}
+		} else {
+			const float sc = 1.0f / static_cast<float>(n);
+			const __m128 scale = _mm_set1_ps(sc);
+			const __m128 g0 = _mm_set1_ps(gain0);
+			const __m128 g1 = _mm_set1_ps(gain1);
+			const __m128 inc = _mm_set1_ps(4.0f);
+			__m128 idx = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+			for (size_t i = 0; i < nVec; i += 4) {
+				const __m128 gain = getGain(idx, scale, g0, g1);
+				_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), gain));
+				idx = _mm_add_ps(idx, inc);
+			}
+			for (size_t i = nVec; i < n; ++i) {
+				dst[i] = src[i] * lerp(gain0, gain1, static_cast<float>(i) * sc);
+			}
+		}
+	}
+
+	void compressRangeSSE(AudioSample* buffer, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		const __m128 minVal = _mm_set1_ps(-0.99995f);
+		const __m128 maxVal = _mm_set1_ps(0.99995f);
+
+		for (size_t i = 0; i < nVec; i += 4) {
+			_mm_storeu_ps(buffer + i, _mm_max_ps(minVal, _mm_min_ps(_mm_loadu_ps(buffer + i), maxVal)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			buffer[i] = std::max(-0.99995f, std::min(buffer[i], 0.99995f));
+		}
+	}
+
+	void interleaveStereoSSE(const AudioSample* left, const AudioSample* right, AudioSample* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		for (size_t i = 0; i < nVec; i += 4) {
+			const __m128 l = _mm_loadu_ps(left + i);
+			const __m128 r = _mm_loadu_ps(right + i);
+			_mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[2 * i] = left[i];
+			dst[2 * i + 1] = right[i];
+		}
+	}
+
+	void convertToInt16SSE(const AudioSample* src, int16_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(7);
+		const __m128 scale = _mm_set1_ps(32768.0f);
+		for (size_t i = 0; i < nVec; i += 8) {
+			const __m128i a = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale));
+			const __m128i b = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int16_t>(src[i] * 32768.0f);
+		}
+	}
+
+	void convertToInt32SSE(const AudioSample* src, int32_t* dst, size_t n)
+	{
+		const size_t nVec = n & ~size_t(3);
+		const __m128 scale = _mm_set1_ps(2147483648.0f);
+		for (size_t i = 0; i < nVec; i += 4) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale)));
+		}
+		for (size_t i = nVec; i < n; ++i) {
+			dst[i] = static_cast<int32_t>(src[i] * 2147483648.0f);
+		}
+	}
+}
+
+const AudioMixerKernels& Halley::getAudioMixerKernelsSSE()
+{
+	static const AudioMixerKernels kernels = {
+		&mixAudioSSE,
+		&copyWithGainSSE,
+		&compressRangeSSE,
+		&interleaveStereoSSE,
+		&convertToInt16SSE,
+		&convertToInt32SSE
+	};
+	return kernels;
+}
+
+#endif
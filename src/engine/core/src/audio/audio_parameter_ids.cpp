@@ -0,0 +1,67 @@
+#include "halley/audio/audio_parameter_ids.h"
+#include "halley/data_structures/hash_map.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace Halley;
+
+namespace {
+	struct AudioParameterTable {
+		std::shared_mutex mutex;
+		HashMap<String, AudioParameterId> ids;
+		std::deque<String> names; // Deque so that references to names stay valid as it grows
+
+		AudioParameterTable()
+		{
+			names.emplace_back(); // AudioParameterIds::invalid
+		}
+	};
+
+	struct AudioParameterRegistry {
+		std::array<AudioParameterTable, 3> tables;
+
+		AudioParameterRegistry()
+		{
+			auto& switchValues = tables[static_cast<size_t>(AudioParameterIds::Kind::SwitchValue)];
+			switchValues.ids[String()] = AudioParameterIds::emptySwitchValue;
+			switchValues.names.emplace_back();
+		}
+	};
+
+	AudioParameterTable& getTable(AudioParameterIds::Kind kind)
+	{
+		static AudioParameterRegistry registry;
+		return registry.tables.at(static_cast<size_t>(kind));
+	}
+}
+
+AudioParameterId AudioParameterIds::getId(Kind kind, const String& name)
+{
+	if (const auto id = tryGetId(kind, name); id != invalid) {
+		return id;
+	}
+
+	auto& table = getTable(kind);
+	std::unique_lock lock(table.mutex);
+	const auto [iter, inserted] = table.ids.emplace(name, static_cast<AudioParameterId>(table.names.size()));
+	if (inserted) {
+		table.names.push_back(name);
+	}
+	return iter->second;
+}
+
+AudioParameterId AudioParameterIds::tryGetId(Kind kind, const String& name)
+{
+	auto& table = getTable(kind);
+	std::shared_lock lock(table.mutex);
+	const auto iter = table.ids.find(name);
+	return iter != table.ids.end() ? iter->second : invalid;
+}
+
+const String& AudioParameterIds::getName(Kind kind, AudioParameterId id)
+{
+	auto& table = getTable(kind);
+	std::shared_lock lock(table.mutex);
+	return table.names.at(id);
+}
@@ -48,6 +48,21 @@ void AudioSourceClip::restart()
 }
 
 bool AudioSourceClip::getAudioData(size_t samplesRequested, AudioMultiChannelSamples dstChannels)
+{
+	return readAudioData(samplesRequested, &dstChannels);
+}
+
+bool AudioSourceClip::canSkip() const
+{
+	return true;
+}
+
+bool AudioSourceClip::skipAudioData(size_t numSamples)
+{
+	return readAudioData(numSamples, nullptr);
+}
+
+bool AudioSourceClip::readAudioData(size_t samplesRequested, const AudioMultiChannelSamples* dstChannelsPtr)
 {
 	Expects(isReady());
 
@@ -116,7 +131,8 @@ bool AudioSourceClip::getAudioData(size_t samplesRequested, AudioMultiChannelSam
 			bool first = true;
 
 			for (auto& stream: streams) {
-				if (stream.active) {
+				if (stream.active && dstChannelsPtr) {
+					const auto& dstChannels = *dstChannelsPtr;
 					if (first) {
 						for (size_t ch = 0; ch < nChannels; ++ch) {
 							auto dst = dstChannels[ch].subspan(samplesWritten, samplesToRead);
@@ -133,7 +149,9 @@ bool AudioSourceClip::getAudioData(size_t samplesRequested, AudioMultiChannelSam
 							assert(nCopied <= samplesRequested * sizeof(AudioSample));
 						}
 					}
+				}
 
+				if (stream.active) {
 					stream.playbackPos += static_cast<int64_t>(samplesToRead);
 				}
 			}
@@ -141,7 +159,9 @@ bool AudioSourceClip::getAudioData(size_t samplesRequested, AudioMultiChannelSam
 			samplesWritten += samplesToRead;
 		} else {
 			// Reached end of playback, pad with zeroes
-			AudioMixer::zeroRange(dstChannels, nChannels, samplesWritten, samplesRemaining);
+			if (dstChannelsPtr) {
+				AudioMixer::zeroRange(*dstChannelsPtr, nChannels, samplesWritten, samplesRemaining);
+			}
 			samplesWritten += samplesRemaining;
 		}
 	}
@@ -15,6 +15,8 @@ namespace Halley
 		bool isReady() const override;
 		size_t getSamplesLeft() const override;
 		void restart() override;
+		bool canSkip() const override;
+		bool skipAudioData(size_t numSamples) override;
 
 	private:
 		AudioEngine& engine;
@@ -37,5 +39,7 @@ namespace Halley
 		bool initialised = false;
 		bool looping = false;
 		bool randomiseStart = false;
+
+		bool readAudioData(size_t samplesRequested, const AudioMultiChannelSamples* dstChannelsPtr);
 	};
 }
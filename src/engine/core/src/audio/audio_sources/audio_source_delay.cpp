@@ -51,6 +51,18 @@ void AudioSourceDelay::restart()
 	src->restart();
 }
 
+bool AudioSourceDelay::canSkip() const
+{
+	return src->canSkip();
+}
+
+bool AudioSourceDelay::skipAudioData(size_t numSamples)
+{
+	const size_t delayNow = std::min(curDelay, numSamples);
+	curDelay -= delayNow;
+	return numSamples > delayNow ? src->skipAudioData(numSamples - delayNow) : true;
+}
+
 void AudioSourceDelay::setInitialDelay(size_t delay)
 {
 	initialDelay = delay;
@@ -13,6 +13,8 @@ namespace Halley
 		bool isReady() const override;
 		size_t getSamplesLeft() const override;
         void restart() override;
+		bool canSkip() const override;
+		bool skipAudioData(size_t numSamples) override;
 		void setInitialDelay(size_t delay);
 
 	private:
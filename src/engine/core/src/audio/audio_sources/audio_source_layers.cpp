@@ -8,6 +8,7 @@
 #include "audio_source_delay.h"
 #include "../audio_mixer.h"
 #include "halley/audio/sub_objects/audio_sub_object_layers.h"
+#include "halley/time/stopwatch.h"
 
 using namespace Halley;
 
@@ -45,8 +46,9 @@ uint8_t AudioSourceLayers::getNumberOfChannels() const
 bool AudioSourceLayers::getAudioData(size_t numSamples, AudioMultiChannelSamples dst)
 {
 	if (!initialized) {
+		evaluateLayerGains();
 		for (auto& layer : layers) {
-			layer.restart(layerConfig, emitter);
+			layer.restart(layerConfig);
 		}
 		initialized = true;
 	}
@@ -59,8 +61,9 @@ bool AudioSourceLayers::getAudioData(size_t numSamples, AudioMultiChannelSamples
 	bool ok = true;
 
 	AudioMixer::zero(result.getSpans(), nChannels);
+	evaluateLayerGains();
 	for (auto& layer: layers) {
-		layer.update(deltaTime, layerConfig, emitter, fadeConfig);
+		layer.update(deltaTime, layerConfig, fadeConfig);
 		if (layer.playing || layer.synchronised || layer.fader.isFading()) {
 			ok = layer.source->getAudioData(numSamples, temp.getSampleSpans()) && ok;
 
@@ -74,6 +77,35 @@ bool AudioSourceLayers::getAudioData(size_t numSamples, AudioMultiChannelSamples
 	return ok;
 }
 
+bool AudioSourceLayers::canSkip() const
+{
+	return std::all_of(layers.begin(), layers.end(), [=] (const auto& ls) { return ls.source->canSkip(); });
+}
+
+bool AudioSourceLayers::skipAudioData(size_t numSamples)
+{
+	if (!initialized) {
+		evaluateLayerGains();
+		for (auto& layer : layers) {
+			layer.restart(layerConfig);
+		}
+		initialized = true;
+	}
+
+	const float deltaTime = static_cast<float>(numSamples) / static_cast<float>(AudioConfig::sampleRate);
+
+	bool ok = true;
+	evaluateLayerGains();
+	for (auto& layer: layers) {
+		layer.update(deltaTime, layerConfig, fadeConfig);
+		if (layer.playing || layer.synchronised || layer.fader.isFading()) {
+			ok = layer.source->skipAudioData(numSamples) && ok;
+		}
+	}
+
+	return ok;
+}
+
 bool AudioSourceLayers::isReady() const
 {
 	return std::all_of(layers.begin(), layers.end(), [=] (const auto& ls) { return ls.source->isReady(); });
@@ -90,12 +122,28 @@ size_t AudioSourceLayers::getSamplesLeft() const
 
 void AudioSourceLayers::restart()
 {
+	evaluateLayerGains();
 	for (auto& layer: layers) {
-		layer.restart(layerConfig, emitter);
+		layer.restart(layerConfig);
 		layer.source->restart();
 	}
 }
 
+void AudioSourceLayers::evaluateLayerGains()
+{
+	Stopwatch timer;
+	timer.start();
+
+	size_t nCached = 0;
+	for (auto& layer: layers) {
+		bool cached = false;
+		layer.targetGain = layerConfig.getLayer(layer.idx).expression.evaluate(emitter, layer.expressionCache, cached);
+		nCached += cached ? 1 : 0;
+	}
+
+	engine.reportExpressionEvaluation(timer.elapsedNanoseconds(), layers.size() - nCached, nCached);
+}
+
 AudioSourceLayers::Layer::Layer(std::unique_ptr<AudioSource> source, size_t idx)
 	: source(std::move(source))
 	, idx(idx)
@@ -108,10 +156,9 @@ void AudioSourceLayers::Layer::init(const AudioSubObjectLayers& layerConfig)
 	synchronised = curLayer.synchronised;
 }
 
-void AudioSourceLayers::Layer::restart(const AudioSubObjectLayers& layerConfig, AudioEmitter& emitter)
+void AudioSourceLayers::Layer::restart(const AudioSubObjectLayers& layerConfig)
 {
 	const auto& curLayer = layerConfig.getLayer(idx);
-	const auto targetGain = curLayer.expression.evaluate(emitter);
 	fader.stopAndSetValue(targetGain);
 	prevGain = gain = targetGain;
 	playing = targetGain > 0.0001f;
@@ -128,10 +175,9 @@ void AudioSourceLayers::Layer::setSourceDelay(float delay)
 	}
 }
 
-void AudioSourceLayers::Layer::update(float time, const AudioSubObjectLayers& layersConfig, AudioEmitter& emitter, const AudioFade& generalFade)
+void AudioSourceLayers::Layer::update(float time, const AudioSubObjectLayers& layersConfig, const AudioFade& generalFade)
 {
 	const auto& layer = layersConfig.getLayer(idx);
-	const auto targetGain = layer.expression.evaluate(emitter);
 
 	const auto delta = targetGain - fader.getTargetValue();
 	if (std::abs(delta) > 0.001f) {
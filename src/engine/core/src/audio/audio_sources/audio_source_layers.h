@@ -1,4 +1,5 @@
 #pragma once
+#include "halley/audio/audio_expression.h"
 #include "halley/audio/audio_fade.h"
 #include "halley/audio/audio_source.h"
 
@@ -19,6 +20,8 @@ namespace Halley
 		bool isReady() const override;
 		size_t getSamplesLeft() const override;
 		void restart() override;
+		bool canSkip() const override;
+		bool skipAudioData(size_t numSamples) override;
 
 	private:
 		class Layer {
@@ -26,6 +29,8 @@ namespace Halley
 			std::unique_ptr<AudioSource> source;
 			float prevGain = 0;
 			float gain = 0;
+			float targetGain = 0;
+			AudioExpression::Cache expressionCache;
 			bool playing = false;
 			bool layerStarted = false;
 			bool synchronised = false;
@@ -34,9 +39,9 @@ namespace Halley
 
 			Layer(std::unique_ptr<AudioSource> source, size_t idx);
 			void init(const AudioSubObjectLayers& layerConfig);
-			void restart(const AudioSubObjectLayers& layerConfig, AudioEmitter& emitter);
+			void restart(const AudioSubObjectLayers& layerConfig);
 			void setSourceDelay(float delay);
-			void update(float time, const AudioSubObjectLayers& layersConfig, AudioEmitter& emitter, const AudioFade& fade);
+			void update(float time, const AudioSubObjectLayers& layersConfig, const AudioFade& fade);
 		};
 
 		AudioEngine& engine;
@@ -45,5 +50,7 @@ namespace Halley
 		Vector<Layer> layers;
 		AudioFade fadeConfig;
 		bool initialized = false;
+
+		void evaluateLayerGains();
 	};
 }
@@ -6,6 +6,7 @@
 #include "audio_mixer.h"
 #include "halley/audio/audio_source.h"
 #include "halley/support/logger.h"
+#include "halley/time/stopwatch.h"
 
 using namespace Halley;
 
@@ -15,6 +16,8 @@ AudioVoice::AudioVoice(AudioEngine& engine, std::shared_ptr<AudioSource> src, fl
 	, playing(false)
 	, done(false)
 	, isFirstUpdate(true)
+	, virtualVoice(false)
+	, fadingToVirtual(false)
 	, baseGain(gain)
 	, userGain(1.0f)
 	, basePitch(pitch)
@@ -25,6 +28,9 @@ AudioVoice::AudioVoice(AudioEngine& engine, std::shared_ptr<AudioSource> src, fl
 {
 	fader.stopAndSetValue(1);
 	setPitch(basePitch);
+
+	// Voices are created on the audio thread, in the order events are posted
+	rngSeed = engine.getRNG().getRawInt();
 }
 
 AudioVoice::~AudioVoice() = default;
@@ -135,6 +141,56 @@ uint8_t AudioVoice::getBus() const
 	return bus;
 }
 
+void AudioVoice::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int AudioVoice::getPriority() const
+{
+	return priority;
+}
+
+bool AudioVoice::canBeVirtual() const
+{
+	return source && source->canSkip();
+}
+
+bool AudioVoice::isVirtual() const
+{
+	return virtualVoice;
+}
+
+void AudioVoice::setVirtual(bool virt)
+{
+	// Called after update(), so the mix for the coming buffer can still be changed. Mixing ramps from the previous mix
+	// to the current one over the buffer, which gives a fade out when going virtual and a fade in when coming back.
+	if (virt) {
+		if (!virtualVoice) {
+			if (fadingToVirtual || numSamplesRendered == 0) {
+				// Either it faded out over the last buffer, or it wasn't heard in it, so it can stop rendering now
+				virtualVoice = true;
+				fadingToVirtual = false;
+			} else {
+				// Render one more buffer, ramping down to silence
+				fadingToVirtual = true;
+				channelMix.fill(0);
+			}
+		}
+	} else {
+		if (virtualVoice) {
+			prevChannelMix.fill(0);
+			virtualVoice = false;
+		}
+		fadingToVirtual = false;
+	}
+}
+
+float AudioVoice::getAudibility() const
+{
+	return audibility;
+}
+
 void AudioVoice::setBaseGain(float gain)
 {
 	baseGain = gain;
@@ -165,7 +221,7 @@ void AudioVoice::setPitch(float pitch)
 			resample->setFromHz(freq);
 		} else {
 			if (source) {
-				resample = std::make_shared<AudioFilterResample>(source, freq, static_cast<float>(AudioConfig::sampleRate), engine.getPool());
+				resample = std::make_shared<AudioFilterResample>(source, freq, static_cast<float>(AudioConfig::sampleRate), engine);
 				source = resample;
 			}
 		}
@@ -211,6 +267,13 @@ void AudioVoice::update(gsl::span<const AudioChannelData> channels, const AudioP
 		isFirstUpdate = false;
 	}
 
+	// Loudest contribution to any output channel, after attenuation
+	audibility = 0;
+	const size_t nMixes = std::min(static_cast<size_t>(nChannels) * channels.size(), channelMix.size());
+	for (size_t i = 0; i < nMixes; ++i) {
+		audibility = std::max(audibility, channelMix[i]);
+	}
+
 	elapsedTime = 0;
 }
 
@@ -219,11 +282,14 @@ void AudioVoice::render(size_t numSamplesRequested, AudioBufferPool& pool)
 	startDstSample = 0;
 	numSamplesRendered = 0;
 	mixAmount = 0;
+	lastRenderTime = 0;
 
 	if (paused || !source) {
 		return;
 	}
 
+	Stopwatch timer;
+
 	// Check delay
 	size_t numSamples = numSamplesRequested;
 	if (delaySamples > 0) {
@@ -246,6 +312,38 @@ void AudioVoice::render(size_t numSamplesRequested, AudioBufferPool& pool)
 	if (!isPlaying) {
 		stop(AudioFade());
 	}
+
+	lastRenderTime = timer.elapsedNanoseconds();
+}
+
+void AudioVoice::renderVirtual(size_t numSamplesRequested)
+{
+	startDstSample = 0;
+	numSamplesRendered = 0;
+	mixAmount = 0;
+	lastRenderTime = 0;
+
+	if (paused || !source) {
+		return;
+	}
+
+	// Same as render, except that the source only advances its playback position
+	size_t numSamples = numSamplesRequested;
+	if (delaySamples > 0) {
+		const size_t delayNow = std::min(static_cast<size_t>(delaySamples), numSamples);
+		delaySamples -= static_cast<uint32_t>(delayNow);
+		numSamples -= delayNow;
+	}
+
+	bool isPlaying = true;
+	if (numSamples > 0) {
+		isPlaying = source->skipAudioData(numSamples);
+	}
+
+	advancePlayback(numSamples);
+	if (!isPlaying) {
+		stop(AudioFade());
+	}
 }
 
 void AudioVoice::mixTo(gsl::span<AudioBuffer*> dst, float prevGain, float gain)
@@ -295,6 +393,19 @@ void AudioVoice::clearBuffers()
 	audioData = {};
 }
 
+Random& AudioVoice::getRNG()
+{
+	if (!rng) {
+		rng = std::make_unique<Random>(rngSeed);
+	}
+	return *rng;
+}
+
+int64_t AudioVoice::getLastRenderTime() const
+{
+	return lastRenderTime;
+}
+
 void AudioVoice::advancePlayback(size_t samples)
 {
 	if (!paused) {
@@ -326,6 +437,8 @@ AudioDebugData::VoiceData AudioVoice::getDebugData() const
 	result.dstChannels = lastDstChannels;
 	result.pitch = lastPitch;
 	result.mixAmount = mixAmount;
+	result.renderTime = static_cast<float>(lastRenderTime) / 1000.0f;
+	result.virtualVoice = virtualVoice;
 	result.channelMix.fill(0);
 
 	const int nSrc = static_cast<int>(getNumberOfChannels());
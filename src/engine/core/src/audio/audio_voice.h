@@ -12,6 +12,7 @@ namespace Halley {
 	class AudioMixer;
 	class AudioVoiceBehaviour;
 	class AudioSource;
+	class Random;
 
 	class AudioVoice {
     public:
@@ -40,8 +41,13 @@ namespace Halley {
 
 		void update(gsl::span<const AudioChannelData> channels, const AudioPosition& sourcePos, const AudioListenerData& listener, float busGain);
 		void render(size_t numSamples, AudioBufferPool& pool);
+		void renderVirtual(size_t numSamples);
 		void mixTo(gsl::span<AudioBuffer*> dst, float prevGain, float gain);
 		void clearBuffers();
+		int64_t getLastRenderTime() const;
+
+		// Used by sources while this voice renders, so random choices don't depend on which thread renders it
+		Random& getRNG();
 		
 		void setIds(AudioEventId eventId, AudioObjectId audioObjectId = 0);
 		AudioEventId getEventId() const;
@@ -50,6 +56,14 @@ namespace Halley {
 		
 		uint8_t getBus() const;
 
+		void setPriority(int priority);
+		int getPriority() const;
+
+		bool canBeVirtual() const;
+		bool isVirtual() const;
+		void setVirtual(bool virt);
+		float getAudibility() const;
+
 		AudioDebugData::VoiceData getDebugData() const;
 
 	private:
@@ -68,6 +82,8 @@ namespace Halley {
 		bool playing : 1;
 		bool done : 1;
 		bool isFirstUpdate : 1;
+		bool virtualVoice : 1;
+		bool fadingToVirtual : 1;
     	float baseGain = 1.0f;
 		float userGain = 1.0f;
 		float basePitch = 1.0f;
@@ -76,17 +92,21 @@ namespace Halley {
 		uint32_t delaySamples = 0;
 		uint32_t paused = 0;
 		uint32_t pendingPauses = 0;
+		int priority = 0;
+		uint32_t rngSeed = 0;
 
 		AudioFader fader;
 		FadeEndBehaviour fadeEnd = FadeEndBehaviour::None;
 
 		std::shared_ptr<AudioSource> source;
 		std::shared_ptr<AudioFilterResample> resample;
+		std::unique_ptr<Random> rng; // Created on first use, as most voices never need one
 
 		std::array<float, 16> channelMix;
 		std::array<float, 16> prevChannelMix;
 		float lastGain = 0;
 		float lastPostGain = 0;
+		float audibility = 0;
 		float lastPitch = 1;
 		uint8_t lastDstChannels = 0;
 
@@ -94,6 +114,7 @@ namespace Halley {
 		size_t startDstSample = 0;
 		size_t numSamplesRendered = 0;
 		float mixAmount = 0;
+		int64_t lastRenderTime = 0;
 
 		std::optional<AudioAttenuation> attenuation;
 
@@ -76,6 +76,11 @@ Executors::Executors()
 	immediate.setImmediate(true);
 }
 
+bool Executors::hasInstance()
+{
+	return instance != nullptr;
+}
+
 Executors& Executors::get()
 {
 	if (!instance) {
@@ -5,10 +5,226 @@
 #endif
 #include "binpack2d.hpp"
 #include <queue>
+#include "halley/concurrency/concurrent.h"
 #include "halley/support/logger.h"
+#include "halley/utils/utils.h"
 
 using namespace Halley;
 
+namespace {
+	struct MaxRect {
+		int x;
+		int y;
+		int w;
+		int h;
+
+		int getRight() const { return x + w; }
+		int getBottom() const { return y + h; }
+
+		bool overlaps(const MaxRect& other) const
+		{
+			return x < other.getRight() && other.x < getRight() && y < other.getBottom() && other.y < getBottom();
+		}
+
+		bool isContainedIn(const MaxRect& other) const
+		{
+			return x >= other.x && y >= other.y && getRight() <= other.getRight() && getBottom() <= other.getBottom();
+		}
+	};
+
+	class MaxRectsBin {
+	public:
+		explicit MaxRectsBin(Vector2i size)
+		{
+			freeRects.push_back(MaxRect{ 0, 0, size.x, size.y });
+		}
+
+		std::optional<BinPackResult> insert(const BinPackEntry& entry)
+		{
+			if (entry.size.x <= 0 || entry.size.y <= 0) {
+				return BinPackResult(Rect4i(0, 0, entry.size.x, entry.size.y), false, entry.data);
+			}
+
+			std::optional<MaxRect> best;
+			bool bestRotated = false;
+			int bestShortSide = std::numeric_limits<int>::max();
+			int bestLongSide = std::numeric_limits<int>::max();
+
+			auto tryFit = [&] (const MaxRect& freeRect, int w, int h, bool rotated)
+			{
+				if (w > freeRect.w || h > freeRect.h) {
+					return;
+				}
+				const int leftoverX = freeRect.w - w;
+				const int leftoverY = freeRect.h - h;
+				const int shortSide = std::min(leftoverX, leftoverY);
+				const int longSide = std::max(leftoverX, leftoverY);
+				if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+					best = MaxRect{ freeRect.x, freeRect.y, w, h };
+					bestRotated = rotated;
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+				}
+			};
+
+			for (const auto& freeRect: freeRects) {
+				tryFit(freeRect, entry.size.x, entry.size.y, false);
+				if (entry.canRotate && entry.size.x != entry.size.y) {
+					tryFit(freeRect, entry.size.y, entry.size.x, true);
+				}
+			}
+
+			if (!best) {
+				return {};
+			}
+			place(*best);
+			return BinPackResult(Rect4i(best->x, best->y, best->w, best->h), bestRotated, entry.data);
+		}
+
+	private:
+		Vector<MaxRect> freeRects;
+		Vector<MaxRect> newRects;
+
+		void place(const MaxRect& used)
+		{
+			// Split every free rect overlapping the used one into (up to) four maximal rects around it
+			newRects.clear();
+			for (size_t i = 0; i < freeRects.size(); ) {
+				const auto freeRect = freeRects[i];
+				if (!freeRect.overlaps(used)) {
+					++i;
+					continue;
+				}
+
+				if (used.x > freeRect.x) {
+					newRects.push_back(MaxRect{ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.h });
+				}
+				if (used.getRight() < freeRect.getRight()) {
+					newRects.push_back(MaxRect{ used.getRight(), freeRect.y, freeRect.getRight() - used.getRight(), freeRect.h });
+				}
+				if (used.y > freeRect.y) {
+					newRects.push_back(MaxRect{ freeRect.x, freeRect.y, freeRect.w, used.y - freeRect.y });
+				}
+				if (used.getBottom() < freeRect.getBottom()) {
+					newRects.push_back(MaxRect{ freeRect.x, used.getBottom(), freeRect.w, freeRect.getBottom() - used.getBottom() });
+				}
+
+				freeRects[i] = freeRects.back();
+				freeRects.pop_back();
+			}
+
+			// The untouched free rects were already maximal and can't be inside any of the new ones (which are all pieces of rects that got removed),
+			// so only the new ones need to be checked for containment
+			for (size_t i = 0; i < newRects.size(); ++i) {
+				const auto& rect = newRects[i];
+				bool contained = std::any_of(freeRects.begin(), freeRects.end(), [&] (const MaxRect& r) { return rect.isContainedIn(r); });
+				for (size_t j = 0; j < newRects.size() && !contained; ++j) {
+					// Of two identical rects, keep only the first one
+					contained = j != i && rect.isContainedIn(newRects[j]) && (j < i || !newRects[j].isContainedIn(rect));
+				}
+				if (!contained) {
+					freeRects.push_back(rect);
+				}
+			}
+		}
+	};
+
+	Vector<const BinPackEntry*> sortForMaxRects(const Vector<BinPackEntry>& entries)
+	{
+		// Largest first, with a stable sort so that the output is deterministic
+		Vector<const BinPackEntry*> sorted;
+		sorted.reserve(entries.size());
+		for (const auto& e: entries) {
+			sorted.push_back(&e);
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), [] (const BinPackEntry* a, const BinPackEntry* b)
+		{
+			const int aMax = std::max(a->size.x, a->size.y);
+			const int bMax = std::max(b->size.x, b->size.y);
+			if (aMax != bMax) {
+				return aMax > bMax;
+			}
+			return std::min(a->size.x, a->size.y) > std::min(b->size.x, b->size.y);
+		});
+		return sorted;
+	}
+
+	std::optional<Vector<BinPackResult>> doMaxRectsPack(const Vector<const BinPackEntry*>& sortedEntries, Vector2i binSize)
+	{
+		MaxRectsBin bin(binSize);
+		Vector<BinPackResult> results;
+		results.reserve(sortedEntries.size());
+		for (const auto* entry: sortedEntries) {
+			auto result = bin.insert(*entry);
+			if (!result) {
+				return {};
+			}
+			results.push_back(*result);
+		}
+		return results;
+	}
+
+	Vector2i getPackedSize(const Vector<BinPackResult>& results, bool powerOfTwo)
+	{
+		Vector2i size;
+		for (const auto& r: results) {
+			size.x = std::max(size.x, r.rect.getRight());
+			size.y = std::max(size.y, r.rect.getBottom());
+		}
+		return powerOfTwo ? Vector2i(nextPowerOf2(size.x), nextPowerOf2(size.y)) : size;
+	}
+
+	Vector<Vector2i> getCandidateSizes(const Vector<BinPackEntry>& entries, Vector2i maxSize, bool powerOfTwo)
+	{
+		int64_t totalArea = 0;
+		Vector2i minSize;
+		int minMajorSide = 0;
+		for (const auto& e: entries) {
+			totalArea += int64_t(e.size.x) * int64_t(e.size.y);
+			if (e.canRotate) {
+				minMajorSide = std::max(minMajorSide, std::max(e.size.x, e.size.y));
+			} else {
+				minSize = Vector2i::max(minSize, e.size);
+			}
+		}
+
+		// Non-power-of-two atlases are cropped to the packed area anyway, so eight steps per octave are enough
+		Vector<int> sides;
+		for (int side = 32; side <= std::max(maxSize.x, maxSize.y); side *= 2) {
+			const int steps = powerOfTwo ? 1 : 8;
+			for (int i = 0; i < steps; ++i) {
+				sides.push_back(side + side * i / steps);
+			}
+		}
+
+		Vector<Vector2i> result;
+		for (const int w: sides) {
+			for (const int h: sides) {
+				const bool fitsLimits = w <= maxSize.x && h <= maxSize.y && w <= 4 * h && h <= 4 * w;
+				const bool fitsEntries = w >= minSize.x && h >= minSize.y && std::max(w, h) >= minMajorSide && int64_t(w) * int64_t(h) >= totalArea;
+				if (fitsLimits && fitsEntries) {
+					result.push_back(Vector2i(w, h));
+				}
+			}
+		}
+
+		// Smallest area first, then squarest, then wide over tall
+		std::sort(result.begin(), result.end(), [] (Vector2i a, Vector2i b)
+		{
+			const int64_t aArea = int64_t(a.x) * int64_t(a.y);
+			const int64_t bArea = int64_t(b.x) * int64_t(b.y);
+			if (aArea != bArea) {
+				return aArea < bArea;
+			}
+			if (std::abs(a.x - a.y) != std::abs(b.x - b.y)) {
+				return std::abs(a.x - a.y) < std::abs(b.x - b.y);
+			}
+			return a.x > b.x;
+		});
+		return result;
+	}
+}
+
 std::optional<Vector<BinPackResult>> BinPack::pack(const Vector<BinPackEntry>& entries, Vector2i binSize)
 {
 	using T = void*;
@@ -86,3 +302,61 @@ std::optional<Vector<BinPackResult>> BinPack::fastPack(const Vector<BinPackEntry
 
 	return result;
 }
+
+std::optional<Vector<BinPackResult>> BinPack::maxRectsPack(const Vector<BinPackEntry>& entries, Vector2i binSize)
+{
+	return doMaxRectsPack(sortForMaxRects(entries), binSize);
+}
+
+std::optional<BinPackSearchResult> BinPack::packSmallest(const Vector<BinPackEntry>& entries, Vector2i maxSize, bool powerOfTwo)
+{
+	const auto sortedEntries = sortForMaxRects(entries);
+	const auto candidates = getCandidateSizes(entries, maxSize, powerOfTwo);
+	const size_t batchSize = Executors::hasInstance() ? Executors::getCPU().threadCount() + 1 : 1;
+
+	int64_t usedArea = 0;
+	for (const auto& e: entries) {
+		usedArea += int64_t(e.size.x) * int64_t(e.size.y);
+	}
+
+	std::optional<BinPackSearchResult> best;
+	auto getArea = [] (Vector2i size) { return int64_t(size.x) * int64_t(size.y); };
+
+	// Candidates are sorted by area and the packed size is never larger than the bin, so once a packing is found,
+	// only candidates that could still beat it need to be tried
+	Vector<std::optional<Vector<BinPackResult>>> batchResults;
+	for (size_t next = 0; next < candidates.size(); ) {
+		size_t batchEnd = next;
+		while (batchEnd < candidates.size() && batchEnd - next < batchSize && (!best || getArea(candidates[batchEnd]) < getArea(best->size))) {
+			++batchEnd;
+		}
+		if (batchEnd == next) {
+			break;
+		}
+
+		batchResults.clear();
+		batchResults.resize(batchEnd - next);
+		Concurrent::parallelFor(batchResults.size(), [&] (size_t i)
+		{
+			batchResults[i] = doMaxRectsPack(sortedEntries, candidates[next + i]);
+		});
+
+		// Picked in candidate order, so the result doesn't depend on thread timing
+		for (auto& result: batchResults) {
+			if (result) {
+				const auto size = getPackedSize(*result, powerOfTwo);
+				if (!best || getArea(size) < getArea(best->size)) {
+					best = BinPackSearchResult{ std::move(*result), size, 0.0f };
+				}
+			}
+		}
+
+		next = batchEnd;
+	}
+
+	if (best) {
+		const auto area = getArea(best->size);
+		best->occupancy = area > 0 ? static_cast<float>(100.0 * static_cast<double>(usedArea) / static_cast<double>(area)) : 100.0f;
+	}
+	return best;
+}
@@ -0,0 +1,102 @@
+#include "halley/data_structures/frame_allocator.h"
+#include "halley/utils/algorithm.h"
+
+#include <atomic>
+#include <mutex>
+
+using namespace Halley;
+
+namespace {
+	// Only the owning thread touches the pool; the atomics are how it reports back to startFrame()
+	struct ThreadPool {
+		TempMemoryPool pool;
+		uint32_t frame = 0;
+
+		std::atomic<size_t> bytesUsed = 0;
+		std::atomic<size_t> numAllocations = 0;
+		std::atomic<size_t> bytesReserved = 0;
+
+		ThreadPool();
+		~ThreadPool();
+
+		void rewind(uint32_t curFrame);
+	};
+
+	constexpr size_t pageSize = 1024 * 1024;
+
+	std::atomic<uint32_t> curFrame = 0;
+	FrameAllocator::Stats lastFrameStats;
+
+	std::mutex& getPoolsMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	Vector<ThreadPool*>& getPools()
+	{
+		static Vector<ThreadPool*> pools;
+		return pools;
+	}
+
+	ThreadPool::ThreadPool()
+		: pool(pageSize, true)
+		, frame(curFrame.load(std::memory_order_relaxed))
+	{
+		bytesReserved = pool.getStats().bytesReserved;
+
+		std::unique_lock lock(getPoolsMutex());
+		getPools().push_back(this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		std::unique_lock lock(getPoolsMutex());
+		std_ex::erase(getPools(), this);
+	}
+
+	void ThreadPool::rewind(uint32_t newFrame)
+	{
+		const auto stats = pool.getStats();
+		bytesUsed.fetch_add(stats.bytesUsed, std::memory_order_relaxed);
+		numAllocations.fetch_add(stats.numAllocations, std::memory_order_relaxed);
+		bytesReserved.store(stats.bytesReserved, std::memory_order_relaxed);
+
+		pool.reset();
+		frame = newFrame;
+	}
+}
+
+TempMemoryPool& FrameAllocator::get()
+{
+	thread_local ThreadPool threadPool;
+
+	const auto frame = curFrame.load(std::memory_order_relaxed);
+	if (threadPool.frame != frame && !threadPool.pool.isInUse()) {
+		threadPool.rewind(frame);
+	}
+	return threadPool.pool;
+}
+
+void FrameAllocator::startFrame()
+{
+	curFrame.fetch_add(1, std::memory_order_relaxed);
+
+	// Rewind this thread's pool straight away, so the previous frame is counted in full
+	get();
+
+	Stats stats;
+	std::unique_lock lock(getPoolsMutex());
+	for (auto* threadPool: getPools()) {
+		stats.bytesUsed += threadPool->bytesUsed.exchange(0, std::memory_order_relaxed);
+		stats.numAllocations += threadPool->numAllocations.exchange(0, std::memory_order_relaxed);
+		stats.bytesReserved += threadPool->bytesReserved.load(std::memory_order_relaxed);
+	}
+	stats.numThreads = getPools().size();
+	lastFrameStats = stats;
+}
+
+FrameAllocator::Stats FrameAllocator::getLastFrameStats()
+{
+	return lastFrameStats;
+}
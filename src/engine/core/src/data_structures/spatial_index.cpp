@@ -0,0 +1,304 @@
+#include "halley/data_structures/spatial_index.h"
+#include "halley/concurrency/concurrent.h"
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t minParallelQueries = 16;
+
+	bool overlapsInclusive(const Rect4f& a, const Rect4f& b)
+	{
+		return a.getLeft() <= b.getRight() && b.getLeft() <= a.getRight() && a.getTop() <= b.getBottom() && b.getTop() <= a.getBottom();
+	}
+
+	bool overlapsCircle(const Rect4f& rect, Vector2f centre, float radius)
+	{
+		// Not using Rect4f::getClosestPoint, as that treats the far edges as exclusive
+		const auto closest = Vector2f(clamp(centre.x, rect.getLeft(), rect.getRight()), clamp(centre.y, rect.getTop(), rect.getBottom()));
+		return (closest - centre).squaredLength() <= radius * radius;
+	}
+
+	std::optional<float> castRay(const Rect4f& rect, const Ray& ray, float maxDistance)
+	{
+		// Slab test
+		float t0 = 0;
+		float t1 = maxDistance;
+		for (int axis = 0; axis < 2; ++axis) {
+			const float p = axis == 0 ? ray.p.x : ray.p.y;
+			const float d = axis == 0 ? ray.dir.x : ray.dir.y;
+			const float lo = axis == 0 ? rect.getLeft() : rect.getTop();
+			const float hi = axis == 0 ? rect.getRight() : rect.getBottom();
+			if (std::abs(d) < 0.000001f) {
+				if (p < lo || p > hi) {
+					return std::nullopt;
+				}
+			} else {
+				const float inv = 1.0f / d;
+				float a = (lo - p) * inv;
+				float b = (hi - p) * inv;
+				if (a > b) {
+					std::swap(a, b);
+				}
+				t0 = std::max(t0, a);
+				t1 = std::min(t1, b);
+				if (t0 > t1) {
+					return std::nullopt;
+				}
+			}
+		}
+		return t0;
+	}
+}
+
+SpatialIndex::Query SpatialIndex::Query::makeRect(Rect4f rect)
+{
+	Query result;
+	result.type = Type::Rect;
+	result.rect = rect;
+	return result;
+}
+
+SpatialIndex::Query SpatialIndex::Query::makeCircle(Vector2f centre, float radius)
+{
+	Query result;
+	result.type = Type::Circle;
+	result.centre = centre;
+	result.radius = radius;
+	return result;
+}
+
+SpatialIndex::Query SpatialIndex::Query::makeRay(Ray ray, float maxDistance)
+{
+	Query result;
+	result.type = Type::Ray;
+	result.ray = ray;
+	result.maxDistance = maxDistance;
+	return result;
+}
+
+SpatialIndex::SpatialIndex(float cellSize)
+	: cellSize(cellSize)
+	, invCellSize(1.0f / cellSize)
+{
+	Expects(cellSize > 0);
+}
+
+void SpatialIndex::set(EntityId id, Rect4f rect)
+{
+	const auto iter = locations.find(id);
+	if (iter != locations.end()) {
+		auto& location = iter->second;
+		const bool large = isLarge(rect);
+		if (large == location.large && (large || getCell(rect.getCenter()) == location.cell)) {
+			// Still in the same place, just update it
+			getContainer(location)[location.index].rect = rect;
+		} else {
+			erase(location);
+			insert(id, rect, location);
+		}
+	} else {
+		insert(id, rect, locations[id]);
+	}
+}
+
+bool SpatialIndex::remove(EntityId id)
+{
+	const auto iter = locations.find(id);
+	if (iter == locations.end()) {
+		return false;
+	}
+
+	const auto location = iter->second;
+	locations.erase(iter);
+	erase(location);
+	return true;
+}
+
+void SpatialIndex::clear()
+{
+	cells.clear();
+	largeEntries.clear();
+	locations.clear();
+}
+
+bool SpatialIndex::contains(EntityId id) const
+{
+	return locations.find(id) != locations.end();
+}
+
+std::optional<Rect4f> SpatialIndex::getRect(EntityId id) const
+{
+	const auto iter = locations.find(id);
+	if (iter == locations.end()) {
+		return std::nullopt;
+	}
+	const auto& location = iter->second;
+	if (location.large) {
+		return largeEntries[location.index].rect;
+	} else {
+		return cells.at(location.cell)[location.index].rect;
+	}
+}
+
+size_t SpatialIndex::size() const
+{
+	return locations.size();
+}
+
+float SpatialIndex::getCellSize() const
+{
+	return cellSize;
+}
+
+void SpatialIndex::query(const Query& query, Vector<EntityId>& results) const
+{
+	switch (query.type) {
+	case Query::Type::Rect:
+		queryRect(query.rect, results);
+		break;
+	case Query::Type::Circle:
+		queryCircle(query.centre, query.radius, results);
+		break;
+	case Query::Type::Ray:
+		queryRay(query.ray, query.maxDistance, results);
+		break;
+	}
+}
+
+void SpatialIndex::queryRect(Rect4f rect, Vector<EntityId>& results) const
+{
+	visit(rect, [&] (const CellEntry& entry)
+	{
+		if (overlapsInclusive(entry.rect, rect)) {
+			results.push_back(entry.id);
+		}
+	});
+}
+
+void SpatialIndex::queryCircle(Vector2f centre, float radius, Vector<EntityId>& results) const
+{
+	visit(Rect4f(centre - Vector2f(radius, radius), centre + Vector2f(radius, radius)), [&] (const CellEntry& entry)
+	{
+		if (overlapsCircle(entry.rect, centre, radius)) {
+			results.push_back(entry.id);
+		}
+	});
+}
+
+void SpatialIndex::queryRay(Ray ray, float maxDistance, Vector<EntityId>& results) const
+{
+	const auto end = ray.p + ray.dir * maxDistance;
+	const auto bounds = Rect4f(Vector2f::min(ray.p, end), Vector2f::max(ray.p, end));
+
+	Vector<std::pair<float, EntityId>> hits;
+	visit(bounds, [&] (const CellEntry& entry)
+	{
+		if (const auto t = castRay(entry.rect, ray, maxDistance)) {
+			hits.emplace_back(*t, entry.id);
+		}
+	});
+
+	std::sort(hits.begin(), hits.end(), [] (const auto& a, const auto& b) { return a.first < b.first || (a.first == b.first && a.second < b.second); });
+	results.reserve(results.size() + hits.size());
+	for (const auto& hit: hits) {
+		results.push_back(hit.second);
+	}
+}
+
+void SpatialIndex::query(gsl::span<const Query> queries, Vector<Vector<EntityId>>& results) const
+{
+	results.resize(queries.size());
+	if (queries.size() >= minParallelQueries) {
+		Concurrent::parallelFor(queries.size(), [&] (size_t i)
+		{
+			results[i].clear();
+			query(queries[i], results[i]);
+		});
+	} else {
+		for (size_t i = 0; i < queries.size(); ++i) {
+			results[i].clear();
+			query(queries[i], results[i]);
+		}
+	}
+}
+
+bool SpatialIndex::isLarge(Rect4f rect) const
+{
+	return rect.getWidth() > cellSize || rect.getHeight() > cellSize;
+}
+
+Vector2i SpatialIndex::getCell(Vector2f pos) const
+{
+	return Vector2i(static_cast<int>(std::floor(pos.x * invCellSize)), static_cast<int>(std::floor(pos.y * invCellSize)));
+}
+
+Vector<SpatialIndex::CellEntry>& SpatialIndex::getContainer(const Location& location)
+{
+	return location.large ? largeEntries : cells[location.cell];
+}
+
+void SpatialIndex::insert(EntityId id, Rect4f rect, Location& location)
+{
+	location.large = isLarge(rect);
+	location.cell = location.large ? Vector2i() : getCell(rect.getCenter());
+
+	auto& container = getContainer(location);
+	location.index = static_cast<uint32_t>(container.size());
+	container.push_back(CellEntry{ rect, id });
+}
+
+void SpatialIndex::erase(const Location& location)
+{
+	auto& container = getContainer(location);
+	if (location.index + 1 != container.size()) {
+		container[location.index] = container.back();
+		locations.at(container[location.index].id).index = location.index;
+	}
+	container.pop_back();
+
+	if (container.empty() && !location.large) {
+		cells.erase(location.cell);
+	}
+}
+
+template <typename F>
+void SpatialIndex::visit(Rect4f bounds, F f) const
+{
+	for (const auto& entry: largeEntries) {
+		f(entry);
+	}
+
+	if (cells.empty()) {
+		return;
+	}
+
+	// Small rects can poke out of their cell by up to half a cell size
+	const auto grown = bounds.grow(0.5f * cellSize);
+	const auto p1 = (grown.getTopLeft() * invCellSize).floor();
+	const auto p2 = (grown.getBottomRight() * invCellSize).floor();
+	const float nCells = (p2.x - p1.x + 1) * (p2.y - p1.y + 1);
+
+	if (!(nCells <= static_cast<float>(cells.size()))) {
+		// Cheaper to go through every cell than to look up every one in range (also handles infinite bounds)
+		for (const auto& [pos, cell]: cells) {
+			if (pos.x >= p1.x && pos.x <= p2.x && pos.y >= p1.y && pos.y <= p2.y) {
+				for (const auto& entry: cell) {
+					f(entry);
+				}
+			}
+		}
+	} else {
+		const auto c1 = Vector2i(p1);
+		const auto c2 = Vector2i(p2);
+		for (int y = c1.y; y <= c2.y; ++y) {
+			for (int x = c1.x; x <= c2.x; ++x) {
+				const auto iter = cells.find(Vector2i(x, y));
+				if (iter != cells.end()) {
+					for (const auto& entry: iter->second) {
+						f(entry);
+					}
+				}
+			}
+		}
+	}
+}
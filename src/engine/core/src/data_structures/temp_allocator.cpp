@@ -22,18 +22,20 @@ TempMemoryPool::~TempMemoryPool()
 char* TempMemoryPool::allocate(size_t n, size_t alignment)
 {
 	auto p = alignUp(pos, alignment);
-	if (p + n < capacity) {
+	if (p + n <= capacity) {
 		char* result = data + p;
 		assert(reinterpret_cast<size_t>(result) % alignment == 0);
 		pos = p + n;
 		allocated += n;
+		++numAllocations;
 		return result;
 	}
 
 	// Pool is full!
-	if (allowPaging && n < capacity) {
+	if (allowPaging) {
 		if (!nextPage) {
-			nextPage = std::make_unique<TempMemoryPool>(capacity, allowPaging);
+			// Requests too big for a page get a page of their own, which is kept around like any other
+			nextPage = std::make_unique<TempMemoryPool>(std::max(capacity, n + alignment), allowPaging);
 		}
 		return nextPage->allocate(n, alignment);
 	}
@@ -69,12 +71,27 @@ void TempMemoryPool::reset()
 
 	pos = 0;
 	allocated = 0;
+	numAllocations = 0;
 
 	if (nextPage) {
 		nextPage->reset();
 	}
 }
 
+bool TempMemoryPool::isInUse() const
+{
+	return allocated > 0 || (nextPage && nextPage->isInUse());
+}
+
+TempMemoryPool::Stats TempMemoryPool::getStats() const
+{
+	Stats result = nextPage ? nextPage->getStats() : Stats();
+	result.bytesUsed += pos;
+	result.numAllocations += numAllocations;
+	result.bytesReserved += capacity;
+	return result;
+}
+
 void TempMemoryPool::resize(size_t size)
 {
 	reset();
@@ -5,6 +5,7 @@
 #include "halley/api/halley_api.h"
 #include "halley/net/connection/message_queue.h"
 #include "halley/devcon/devcon_messages.h"
+#include "halley/devcon/devcon_profiler_stream.h"
 
 using namespace Halley;
 
@@ -87,6 +88,7 @@ DevConClient::DevConClient(const HalleyAPI& api, Resources& resources, std::uniq
 	, port(port)
 {
 	interest = std::make_unique<DevConInterest>(*this);
+	profilerStream = std::make_unique<DevConProfilerStream>(api, *interest);
 
 	connect();
 
@@ -96,6 +98,7 @@ DevConClient::DevConClient(const HalleyAPI& api, Resources& resources, std::uniq
 DevConClient::~DevConClient()
 {
 	Logger::removeSink(*this);
+	profilerStream.reset();
 	queue.reset();
 	service.reset();
 }
@@ -128,6 +131,8 @@ void DevConClient::update(Time t)
 			break;
 		}
 	}
+
+	profilerStream->update(t);
 }
 
 void DevConClient::onReceiveReloadAssets(const DevCon::ReloadAssetsMsg& msg)
@@ -160,6 +165,11 @@ DevConInterest& DevConClient::getInterest() const
 	return *interest;
 }
 
+DevConProfilerStream& DevConClient::getProfilerStream() const
+{
+	return *profilerStream;
+}
+
 void DevConClient::notifyInterest(uint32_t handle, ConfigNode data)
 {
 	queue->enqueue(std::make_unique<DevCon::NotifyInterestMsg>(handle, std::move(data)), 0);
@@ -0,0 +1,270 @@
+#include "halley/devcon/devcon_profiler_stream.h"
+#include "halley/devcon/devcon_client.h"
+#include "halley/devcon/devcon_server.h"
+#include "halley/api/halley_api.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/net/connection/network_service.h"
+#include "halley/net/session/network_session.h"
+#include "halley/os/os.h"
+
+using namespace Halley;
+
+void DevConProfilerSample::Event::serialize(Serializer& s) const
+{
+	s << nameIdx << threadIdx << type << depth << startTime << duration;
+}
+
+void DevConProfilerSample::Event::deserialize(Deserializer& s)
+{
+	s >> nameIdx >> threadIdx >> type >> depth >> startTime >> duration;
+}
+
+void DevConProfilerSample::NetworkStats::serialize(Serializer& s) const
+{
+	s << sentBytesPerSecond << receivedBytesPerSecond << sentPacketsPerSecond << receivedPacketsPerSecond;
+}
+
+void DevConProfilerSample::NetworkStats::deserialize(Deserializer& s)
+{
+	s >> sentBytesPerSecond >> receivedBytesPerSecond >> sentPacketsPerSecond >> receivedPacketsPerSecond;
+}
+
+ConfigNode DevConProfilerSample::toConfigNode() const
+{
+	return ConfigNode(Serializer::toBytes(*this));
+}
+
+std::optional<DevConProfilerSample> DevConProfilerSample::fromConfigNode(const ConfigNode& node)
+{
+	if (node.getType() != ConfigNodeType::Bytes) {
+		// Undefined when the game disconnects
+		return std::nullopt;
+	}
+	return Deserializer::fromBytes<DevConProfilerSample>(node.asBytes());
+}
+
+void DevConProfilerSample::serialize(Serializer& s) const
+{
+	s << numFrames << averageFrameTime << maxFrameTime;
+	s << ramUsage << vramUsage;
+	s << network;
+	s << sampledFrameTime;
+	s << systemTimes;
+	s << threadNames;
+	s << eventNames;
+	s << events;
+}
+
+void DevConProfilerSample::deserialize(Deserializer& s)
+{
+	s >> numFrames >> averageFrameTime >> maxFrameTime;
+	s >> ramUsage >> vramUsage;
+	s >> network;
+	s >> sampledFrameTime;
+	s >> systemTimes;
+	s >> threadNames;
+	s >> eventNames;
+	s >> events;
+}
+
+
+DevConProfilerStream::DevConProfilerStream(const HalleyAPI& api, DevConInterest& interest)
+	: api(api)
+	, interest(interest)
+{
+}
+
+DevConProfilerStream::~DevConProfilerStream()
+{
+	setRegistered(false);
+}
+
+void DevConProfilerStream::update(Time t)
+{
+	const bool active = interest.hasInterest(interestId);
+	setRegistered(active);
+	if (!active) {
+		return;
+	}
+
+	updateSettings();
+
+	++numFrames;
+	totalFrameTime += t;
+	maxFrameTime = std::max(maxFrameTime, t);
+	timeSinceSample += t;
+
+	if (pendingSample) {
+		auto sample = std::move(*pendingSample);
+		pendingSample.reset();
+
+		constexpr Time toNanoseconds = 1'000'000'000.0;
+		sample.numFrames = numFrames;
+		sample.averageFrameTime = static_cast<int64_t>(totalFrameTime / numFrames * toNanoseconds);
+		sample.maxFrameTime = static_cast<int64_t>(maxFrameTime * toNanoseconds);
+		sample.ramUsage = OS::get().getMemoryUsage();
+		if (api.system) {
+			sample.vramUsage = api.system->getMemoryUsage().vramUsage;
+		}
+		if (networkStats) {
+			auto& network = sample.network.emplace();
+			network.sentBytesPerSecond = networkStats->getSentDataPerSecond();
+			network.receivedBytesPerSecond = networkStats->getReceivedDataPerSecond();
+			network.sentPacketsPerSecond = networkStats->getSentPacketsPerSecond();
+			network.receivedPacketsPerSecond = networkStats->getReceivedPacketsPerSecond();
+		}
+
+		numFrames = 0;
+		totalFrameTime = 0;
+		maxFrameTime = 0;
+
+		sendSample(std::move(sample));
+	}
+}
+
+void DevConProfilerStream::setNetworkStats(NetworkSession& session)
+{
+	networkStats = &session.getService();
+}
+
+void DevConProfilerStream::setNetworkStats(INetworkServiceStatsListener* stats)
+{
+	networkStats = stats;
+}
+
+void DevConProfilerStream::setRegistered(bool value)
+{
+	if (registered == value) {
+		return;
+	}
+	registered = value;
+
+	if (registered) {
+		api.core->addProfilerCallback(this);
+	} else {
+		api.core->removeProfilerCallback(this);
+	}
+
+	captureRequested = false;
+	pendingSample.reset();
+	numFrames = 0;
+	totalFrameTime = 0;
+	maxFrameTime = 0;
+	timeSinceSample = 0;
+}
+
+void DevConProfilerStream::updateSettings()
+{
+	// With several listeners, serve the most demanding one
+	settings = Settings();
+	bool first = true;
+	for (const auto& config: interest.getInterestConfigs(interestId)) {
+		const auto interval = static_cast<Time>(config["interval"].asFloat(1.0f));
+		const auto maxEvents = static_cast<size_t>(std::max(config["maxEvents"].asInt(256), 0));
+		const auto minEventTime = static_cast<int64_t>(config["minEventTime"].asFloat(20.0f) * 1000.0f);
+		settings.interval = first ? interval : std::min(settings.interval, interval);
+		settings.maxEvents = first ? maxEvents : std::max(settings.maxEvents, maxEvents);
+		settings.minEventTime = first ? minEventTime : std::min(settings.minEventTime, minEventTime);
+		first = false;
+	}
+}
+
+bool DevConProfilerStream::shouldCaptureFrame()
+{
+	if (!captureRequested && !pendingSample && timeSinceSample >= settings.interval) {
+		captureRequested = true;
+	}
+	return captureRequested;
+}
+
+void DevConProfilerStream::onProfileData(std::shared_ptr<ProfilerData> data)
+{
+	// Other callbacks might be recording every frame, only use the ones that were requested
+	if (!captureRequested) {
+		return;
+	}
+	captureRequested = false;
+	timeSinceSample = 0;
+
+	DevConProfilerSample sample;
+	sample.sampledFrameTime = data->getTotalElapsedTime().count();
+
+	const auto threads = data->getThreads();
+	for (const auto& thread: threads) {
+		sample.threadNames.push_back(thread.name);
+	}
+
+	HashMap<String, int64_t> systemTimes;
+	Vector<std::pair<const ProfilerData::Event*, int64_t>> candidates;
+	for (const auto& event: data->getEvents()) {
+		const auto duration = std::chrono::duration_cast<ProfilerData::Duration>(event.endTime - event.startTime).count();
+		if (event.type == ProfilerEventType::WorldSystemUpdate || event.type == ProfilerEventType::WorldSystemRender || event.type == ProfilerEventType::WorldSystemMessages) {
+			systemTimes[event.name] += duration;
+		}
+		if (settings.maxEvents > 0 && duration >= settings.minEventTime) {
+			candidates.emplace_back(&event, duration);
+		}
+	}
+	sample.systemTimes.assign(systemTimes.begin(), systemTimes.end());
+
+	if (candidates.size() > settings.maxEvents) {
+		const auto byDuration = [] (const auto& a, const auto& b) { return a.second > b.second; };
+		std::nth_element(candidates.begin(), candidates.begin() + settings.maxEvents, candidates.end(), byDuration);
+		candidates.resize(settings.maxEvents);
+	}
+	std::sort(candidates.begin(), candidates.end(), [] (const auto& a, const auto& b) { return a.first->startTime < b.first->startTime; });
+
+	HashMap<String, uint16_t> nameIndices;
+	sample.events.reserve(candidates.size());
+	for (const auto& [event, duration]: candidates) {
+		auto& dst = sample.events.emplace_back();
+
+		const auto nameIter = nameIndices.find(event->name);
+		if (nameIter != nameIndices.end()) {
+			dst.nameIdx = nameIter->second;
+		} else {
+			dst.nameIdx = static_cast<uint16_t>(sample.eventNames.size());
+			nameIndices[event->name] = dst.nameIdx;
+			sample.eventNames.push_back(event->name);
+		}
+
+		const auto threadIter = std::find_if(threads.begin(), threads.end(), [&] (const auto& thread) { return thread.id == event->threadId; });
+		dst.threadIdx = static_cast<uint8_t>(threadIter - threads.begin());
+		dst.type = event->type;
+		dst.depth = event->depth;
+		dst.startTime = std::chrono::duration_cast<ProfilerData::Duration>(event->startTime - data->getStartTime()).count();
+		dst.duration = duration;
+	}
+
+	pendingSample = std::move(sample);
+}
+
+void DevConProfilerStream::sendSample(DevConProfilerSample sample)
+{
+	const auto node = sample.toConfigNode();
+	const auto nConfigs = interest.getInterestConfigs(interestId).size();
+	for (size_t i = 0; i < nConfigs; ++i) {
+		interest.notifyInterest(interestId, i, ConfigNode(node));
+	}
+}
+
+
+DevConProfilerListener::DevConProfilerListener(DevConServer& server, Callback callback, Time interval, int maxEvents)
+	: server(server)
+{
+	ConfigNode::MapType params;
+	params["interval"] = static_cast<float>(interval);
+	params["maxEvents"] = maxEvents;
+
+	handle = server.registerInterest(DevConProfilerStream::interestId, std::move(params), [callback = std::move(callback)] (size_t connId, ConfigNode result)
+	{
+		if (const auto sample = DevConProfilerSample::fromConfigNode(result)) {
+			callback(connId, *sample);
+		}
+	});
+}
+
+DevConProfilerListener::~DevConProfilerListener()
+{
+	server.unregisterInterest(handle);
+}
@@ -65,6 +65,26 @@ void AudioView::paint(Painter& painter)
 	{
 		ColourStringBuilder str;
 
+		str.append("Voices", valueCol);
+		str.append(" rendered in ");
+		str.append(toString(curData.voiceRenderTime, 1) + " us", valueCol);
+		str.append(" across ");
+		str.append(toString(curData.numVoiceWorkers + 1), valueCol);
+		str.append(" threads, ");
+		str.append(toString(curData.numActiveVoices), valueCol);
+		str.append(" active and ");
+		str.append(toString(curData.numVirtualVoices), valueCol);
+		str.append(" virtual\n");
+
+		str.append("Expressions", valueCol);
+		str.append(" evaluated in ");
+		str.append(toString(curData.expressionEvalTime, 1) + " us", valueCol);
+		str.append(", ");
+		str.append(toString(curData.numExpressionsEvaluated), valueCol);
+		str.append(" evaluated and ");
+		str.append(toString(curData.numExpressionsCached), valueCol);
+		str.append(" cached\n");
+
 		str.append("Listener", valueCol);
 		str.append(" at regions:");
 		for (const auto& region: curData.listener.regions) {
@@ -129,13 +149,17 @@ void AudioView::paint(Painter& painter)
 		for (auto& voiceData: emitterData.voices) {
 			str.append("\n- ");
 			str.append(getObjectName(voiceData.objectId), keyCol);
-			if (voiceData.playing) {
+			if (voiceData.playing && voiceData.virtualVoice) {
+				str.append(": virtual");
+			} else if (voiceData.playing) {
 				str.append(": gain = ");
 				str.append(toString(voiceData.gain), valueCol);
 				str.append(", pitch = ");
 				str.append(toString(voiceData.pitch), valueCol);
 				str.append(", mix amount = ");
 				str.append(toString(voiceData.mixAmount), valueCol);
+				str.append(", cost = ");
+				str.append(toString(voiceData.renderTime, 1) + " us", valueCol);
 				str.append(", pause = ");
 				str.append(toString(voiceData.paused), valueCol);
 				str.append(", mix = ");
@@ -0,0 +1,55 @@
+#include "halley/diagnostics/benchmark_report.h"
+#include "halley/file_formats/json/json.h"
+#include "halley/support/logger.h"
+#include "halley/utils/utils.h"
+
+using namespace Halley;
+
+std::optional<String> BenchmarkReport::getArgument(gsl::span<const String> args, std::string_view name)
+{
+	const auto prefix = "--" + String(name) + "=";
+	for (const auto& arg: args) {
+		if (arg.startsWith(prefix)) {
+			return arg.mid(prefix.length());
+		}
+	}
+	return std::nullopt;
+}
+
+JSONValue BenchmarkReport::makeTimeStats(Vector<int64_t> nanoseconds)
+{
+	Json::Value result(Json::objectValue);
+	if (nanoseconds.empty()) {
+		return result;
+	}
+
+	std::sort(nanoseconds.begin(), nanoseconds.end());
+	const auto toMs = [] (int64_t ns) { return static_cast<double>(ns) / 1'000'000.0; };
+	const auto percentile = [&] (double p)
+	{
+		// Nearest rank
+		const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(nanoseconds.size())));
+		return toMs(nanoseconds[clamp<size_t>(rank, 1, nanoseconds.size()) - 1]);
+	};
+
+	int64_t total = 0;
+	for (const auto ns: nanoseconds) {
+		total += ns;
+	}
+
+	result["mean"] = toMs(total) / static_cast<double>(nanoseconds.size());
+	result["p50"] = percentile(0.50);
+	result["p90"] = percentile(0.90);
+	result["p99"] = percentile(0.99);
+	result["max"] = toMs(nanoseconds.back());
+	return result;
+}
+
+void BenchmarkReport::write(const JSONValue& report, const Path& path)
+{
+	if (!Path::writeFile(path, String(Json::StyledWriter().write(report)))) {
+		Logger::logError("Unable to write benchmark report to " + path.getString());
+	} else {
+		Logger::logInfo("Benchmark report written to " + path.getString());
+	}
+}
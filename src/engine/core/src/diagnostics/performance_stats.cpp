@@ -278,6 +278,7 @@ void PerformanceStatsView::drawHeader(Painter& painter, bool simple)
 
 	if (memoryUsageRefreshTime >= 1.0) {
 		memoryUsage = api.system->getMemoryUsage();
+		materialStats = MaterialInternCache::get().getStats();
 		memoryUsageRefreshTime = 0;
 	}
 
@@ -290,6 +291,8 @@ void PerformanceStatsView::drawHeader(Painter& painter, bool simple)
 	}
 	strBuilder.append(toString(painter.getPrevDrawCalls()));
 	strBuilder.append(" calls | ");
+	strBuilder.append(toString(painter.getPrevUniqueMaterials()));
+	strBuilder.append(" mats | ");
 	strBuilder.append(toString(painter.getPrevTriangles()));
 	strBuilder.append(" tris\n");
 	strBuilder.append(formatTime(updateAvgTime), updateCol);
@@ -322,6 +325,15 @@ void PerformanceStatsView::drawHeader(Painter& painter, bool simple)
 		}
 	}
 
+	if (materialStats.uniqueMaterials > 0) {
+		strBuilder.append("\nMaterials ");
+		strBuilder.append(toString(materialStats.uniqueMaterials));
+		strBuilder.append(" interned / ");
+		strBuilder.append(toString(materialStats.references));
+		strBuilder.append(" refs | saved ");
+		strBuilder.append(String::prettySize(materialStats.bytesSaved), ramCol);
+	}
+
 	if (networkStats) {
 		strBuilder.append("\nNetwork | up: ");
 		strBuilder.append(toString(networkStats->getSentDataPerSecond() / 1000.0, 3) + " kBps");
@@ -0,0 +1,139 @@
+#include "halley/diagnostics/render_snapshot_benchmark_stage.h"
+#include "halley/diagnostics/benchmark_report.h"
+#include "halley/file_formats/json/json.h"
+#include "halley/graphics/render_context.h"
+#include "halley/graphics/render_snapshot.h"
+#include "halley/os/os.h"
+#include "halley/support/logger.h"
+#include "halley/support/profiler.h"
+#include "halley/time/stopwatch.h"
+
+using namespace Halley;
+
+std::optional<RenderSnapshotBenchmarkStage::Options> RenderSnapshotBenchmarkStage::Options::fromArguments(gsl::span<const String> args)
+{
+	auto snapshot = BenchmarkReport::getArgument(args, "replay-snapshot");
+	if (!snapshot) {
+		return std::nullopt;
+	}
+
+	Options result;
+	result.snapshot = Path(*snapshot);
+	if (const auto frames = BenchmarkReport::getArgument(args, "replay-frames")) {
+		result.frames = std::max(frames->toInteger(), 1);
+	}
+	if (const auto warmup = BenchmarkReport::getArgument(args, "replay-warmup")) {
+		result.warmupFrames = std::max(warmup->toInteger(), 0);
+	}
+	if (const auto batched = BenchmarkReport::getArgument(args, "replay-batched")) {
+		result.batched = *batched == "true" || *batched == "1";
+	}
+	if (const auto output = BenchmarkReport::getArgument(args, "replay-output")) {
+		result.output = Path(*output);
+	}
+	return result;
+}
+
+Vector<String> RenderSnapshotBenchmarkStage::Options::toArguments() const
+{
+	Vector<String> result;
+	result.push_back("--replay-snapshot=" + snapshot.getString());
+	result.push_back("--replay-frames=" + toString(frames));
+	result.push_back("--replay-warmup=" + toString(warmupFrames));
+	result.push_back("--replay-batched=" + toString(batched));
+	result.push_back("--replay-output=" + output.getString());
+	return result;
+}
+
+RenderSnapshotBenchmarkStage::RenderSnapshotBenchmarkStage(Options options)
+	: options(std::move(options))
+{
+}
+
+RenderSnapshotBenchmarkStage::~RenderSnapshotBenchmarkStage()
+{
+	if (snapshot) {
+		getCoreAPI().removeProfilerCallback(this);
+	}
+}
+
+void RenderSnapshotBenchmarkStage::init()
+{
+	const auto bytes = Path::readFile(options.snapshot);
+	if (bytes.empty()) {
+		throw Exception("Unable to read render snapshot at " + options.snapshot.getString(), HalleyExceptions::Graphics);
+	}
+	snapshot = RenderSnapshot::fromBytes(gsl::as_bytes(gsl::span<const Byte>(bytes)), getResources());
+
+	replayTimes.reserve(options.frames);
+	getCoreAPI().addProfilerCallback(this);
+
+	Logger::logInfo("Replaying render snapshot \"" + options.snapshot.getString() + "\" (" + toString(snapshot->getNumDrawCalls()) + " draw calls) for "
+		+ toString(options.frames) + " frames, after " + toString(options.warmupFrames) + " warmup frames.");
+}
+
+void RenderSnapshotBenchmarkStage::onVariableUpdate(Time)
+{
+	if (curFrame == options.warmupFrames + options.frames) {
+		writeReport();
+		getCoreAPI().quit(0);
+		return;
+	}
+
+	if (isMeasuring()) {
+		peakMemory = std::max(peakMemory, OS::get().getMemoryUsage());
+	}
+}
+
+void RenderSnapshotBenchmarkStage::onRender(RenderContext& rc) const
+{
+	rc.bind([&] (Painter& painter)
+	{
+		Stopwatch timer;
+		timer.start();
+		snapshot->replay(painter, options.batched);
+		timer.pause();
+
+		++curFrame;
+		if (isMeasuring()) {
+			replayTimes.push_back(timer.elapsedNanoseconds());
+		}
+	});
+}
+
+bool RenderSnapshotBenchmarkStage::isMeasuring() const
+{
+	return curFrame > options.warmupFrames && curFrame <= options.warmupFrames + options.frames;
+}
+
+void RenderSnapshotBenchmarkStage::onProfileData(std::shared_ptr<ProfilerData> data)
+{
+	// Core sends the capture at the end of each frame, right after the replay that ran in it
+	if (!isMeasuring()) {
+		return;
+	}
+
+	drawCallTimes.push_back(data->getElapsedTime(ProfilerEventType::PainterDrawCall).count());
+	projectionTimes.push_back(data->getElapsedTime(ProfilerEventType::PainterUpdateProjection).count());
+}
+
+void RenderSnapshotBenchmarkStage::writeReport() const
+{
+	Json::Value root(Json::objectValue);
+	root["snapshot"] = options.snapshot.getString().cppStr();
+	root["frames"] = options.frames;
+	root["warmupFrames"] = options.warmupFrames;
+	root["batched"] = options.batched;
+	root["commands"] = static_cast<Json::UInt64>(snapshot->getNumCommands());
+	root["drawCalls"] = static_cast<Json::UInt64>(snapshot->getNumDrawCalls());
+	root["triangles"] = static_cast<Json::UInt64>(snapshot->getNumTriangles());
+	root["replay"] = BenchmarkReport::makeTimeStats(replayTimes);
+
+	Json::Value events(Json::objectValue);
+	events["PainterDrawCall"] = BenchmarkReport::makeTimeStats(drawCallTimes);
+	events["PainterUpdateProjection"] = BenchmarkReport::makeTimeStats(projectionTimes);
+	root["events"] = events;
+	root["peakMemory"] = static_cast<Json::UInt64>(peakMemory);
+
+	BenchmarkReport::write(root, options.output);
+}
@@ -88,6 +88,11 @@ void DummyTexture::doLoad(TextureDescriptor&)
 	doneLoading();
 }
 
+bool DummyTexture::doUpdateRegion(Rect4i, gsl::span<const gsl::byte>, int)
+{
+	return true;
+}
+
 int DummyShader::getUniformLocation(const String&, ShaderType)
 {
 	return 0;
@@ -35,6 +35,7 @@ namespace Halley {
 	public:
 		explicit DummyTexture(Vector2i size);
 		void doLoad(TextureDescriptor& descriptor) override;
+		bool doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride) override;
 	};
 
 	class DummyShader : public Shader
@@ -0,0 +1,193 @@
+#include "halley/entity/benchmark_stage.h"
+#include "halley/diagnostics/benchmark_report.h"
+#include "halley/data_structures/frame_allocator.h"
+#include "halley/entity/entity_factory.h"
+#include "halley/entity/entity_scene.h"
+#include "halley/entity/prefab.h"
+#include "halley/entity/world.h"
+#include "halley/file_formats/json/json.h"
+#include "halley/game/game.h"
+#include "halley/maths/random.h"
+#include "halley/os/os.h"
+#include "halley/support/logger.h"
+#include "halley/support/profiler.h"
+#include "halley/time/stopwatch.h"
+#include "halley/utils/algorithm.h"
+#include <numeric>
+
+using namespace Halley;
+
+std::optional<BenchmarkStage::Options> BenchmarkStage::Options::fromArguments(gsl::span<const String> args)
+{
+	auto scene = BenchmarkReport::getArgument(args, "benchmark-scene");
+	if (!scene) {
+		return std::nullopt;
+	}
+
+	Options result;
+	result.scene = std::move(*scene);
+	if (const auto stage = BenchmarkReport::getArgument(args, "benchmark-stage")) {
+		result.stage = *stage;
+	}
+	result.systemTag = BenchmarkReport::getArgument(args, "benchmark-tag");
+	if (const auto ticks = BenchmarkReport::getArgument(args, "benchmark-ticks")) {
+		result.ticks = std::max(ticks->toInteger(), 1);
+	}
+	if (const auto warmup = BenchmarkReport::getArgument(args, "benchmark-warmup")) {
+		result.warmupTicks = std::max(warmup->toInteger(), 0);
+	}
+	if (const auto seed = BenchmarkReport::getArgument(args, "benchmark-seed")) {
+		result.seed = static_cast<uint32_t>(seed->toInteger64());
+	}
+	if (const auto output = BenchmarkReport::getArgument(args, "benchmark-output")) {
+		result.output = Path(*output);
+	}
+	return result;
+}
+
+Vector<String> BenchmarkStage::Options::toArguments() const
+{
+	Vector<String> result;
+	result.push_back("--benchmark-scene=" + scene);
+	result.push_back("--benchmark-stage=" + stage);
+	if (systemTag) {
+		result.push_back("--benchmark-tag=" + *systemTag);
+	}
+	result.push_back("--benchmark-ticks=" + toString(ticks));
+	result.push_back("--benchmark-warmup=" + toString(warmupTicks));
+	result.push_back("--benchmark-seed=" + toString(seed));
+	result.push_back("--benchmark-output=" + output.getString());
+	return result;
+}
+
+BenchmarkStage::BenchmarkStage(Options options)
+	: options(std::move(options))
+{
+}
+
+BenchmarkStage::~BenchmarkStage()
+{
+	if (world) {
+		getCoreAPI().removeProfilerCallback(this);
+	}
+	factory.reset();
+	world.reset();
+}
+
+void BenchmarkStage::init()
+{
+	Random::getGlobal().setSeed(options.seed);
+
+	world = createWorld(options.stage, options.systemTag);
+	world->setHeadless(true);
+	getGame().setupBenchmarkWorld(*world);
+
+	factory = std::make_shared<EntityFactory>(*world, getResources());
+	factory->createScene(getResources().get<Scene>(options.scene), false);
+
+	tickTimes.reserve(options.ticks);
+	frameAllocatorBytes.reserve(options.ticks);
+	getCoreAPI().addProfilerCallback(this);
+
+	Logger::logInfo("Benchmarking \"" + options.scene + "\" for " + toString(options.ticks) + " ticks, after " + toString(options.warmupTicks) + " warmup ticks.");
+}
+
+void BenchmarkStage::onVariableUpdate(Time)
+{
+	if (isMeasuring()) {
+		// Core only tallies the frame allocator when the next frame starts, so this is for the previous tick
+		const auto frameStats = FrameAllocator::getLastFrameStats();
+		frameAllocatorBytes.push_back(frameStats.bytesUsed);
+		frameAllocatorAllocations += frameStats.numAllocations;
+		frameAllocatorReserved = std::max(frameAllocatorReserved, frameStats.bytesReserved);
+	}
+
+	if (curTick == options.warmupTicks + options.ticks) {
+		writeReport();
+		getCoreAPI().quit(0);
+		return;
+	}
+
+	// Always step by the fixed update period, so the simulation is the same regardless of how fast it runs
+	const Time dt = 1.0 / getGame().getFixedUpdateFPS();
+
+	Stopwatch timer;
+	timer.start();
+	world->step(TimeLine::FixedUpdate, dt);
+	world->step(TimeLine::VariableUpdate, dt);
+	timer.pause();
+
+	++curTick;
+
+	if (isMeasuring()) {
+		tickTimes.push_back(timer.elapsedNanoseconds());
+
+		const auto nEntities = world->numEntities();
+		minEntities = std::min(minEntities, nEntities);
+		maxEntities = std::max(maxEntities, nEntities);
+		peakMemory = std::max(peakMemory, OS::get().getMemoryUsage());
+	}
+}
+
+void BenchmarkStage::onRender(RenderContext& rc) const
+{
+}
+
+bool BenchmarkStage::isMeasuring() const
+{
+	return curTick > options.warmupTicks && curTick <= options.warmupTicks + options.ticks;
+}
+
+void BenchmarkStage::onProfileData(std::shared_ptr<ProfilerData> data)
+{
+	// Core sends the capture at the end of each frame, right after the tick that ran in it
+	if (!isMeasuring()) {
+		return;
+	}
+
+	HashMap<String, int64_t> frameTimes;
+	for (const auto& event: data->getEvents()) {
+		if (event.type == ProfilerEventType::WorldSystemUpdate || event.type == ProfilerEventType::WorldSystemMessages) {
+			frameTimes[event.name] += std::chrono::duration_cast<ProfilerData::Duration>(event.endTime - event.startTime).count();
+		}
+	}
+
+	for (const auto& [name, ns]: frameTimes) {
+		systemTimes[name].push_back(ns);
+	}
+}
+
+void BenchmarkStage::writeReport() const
+{
+	Json::Value root(Json::objectValue);
+	root["scene"] = options.scene.cppStr();
+	root["stage"] = options.stage.cppStr();
+	root["ticks"] = options.ticks;
+	root["warmupTicks"] = options.warmupTicks;
+	root["seed"] = options.seed;
+	root["fixedUpdateFPS"] = getGame().getFixedUpdateFPS();
+	root["tick"] = BenchmarkReport::makeTimeStats(tickTimes);
+
+	Json::Value systems(Json::objectValue);
+	for (const auto& [name, times]: systemTimes) {
+		systems[name.cppStr()] = BenchmarkReport::makeTimeStats(times);
+	}
+	root["systems"] = systems;
+
+	Json::Value entities(Json::objectValue);
+	entities["min"] = static_cast<Json::UInt64>(tickTimes.empty() ? 0 : minEntities);
+	entities["max"] = static_cast<Json::UInt64>(maxEntities);
+	entities["final"] = static_cast<Json::UInt64>(world->numEntities());
+	root["entities"] = entities;
+	root["peakMemory"] = static_cast<Json::UInt64>(peakMemory);
+
+	Json::Value frameAllocator(Json::objectValue);
+	const auto nFrames = std::max(frameAllocatorBytes.size(), size_t(1));
+	frameAllocator["bytesPerTick"] = static_cast<double>(std::accumulate(frameAllocatorBytes.begin(), frameAllocatorBytes.end(), size_t(0))) / static_cast<double>(nFrames);
+	frameAllocator["maxBytesPerTick"] = static_cast<Json::UInt64>(frameAllocatorBytes.empty() ? 0 : *std::max_element(frameAllocatorBytes.begin(), frameAllocatorBytes.end()));
+	frameAllocator["allocationsPerTick"] = static_cast<double>(frameAllocatorAllocations) / static_cast<double>(nFrames);
+	frameAllocator["reservedBytes"] = static_cast<Json::UInt64>(frameAllocatorReserved);
+	root["frameAllocator"] = frameAllocator;
+
+	BenchmarkReport::write(root, options.output);
+}
@@ -35,6 +35,7 @@ World& EntityFactory::getWorld()
 EntityScene EntityFactory::createScene(const std::shared_ptr<const Prefab>& prefab, bool allowReload, WorldPartitionId worldPartition, String variant)
 {
 	EntityScene curScene(allowReload, worldPartition, variant);
+	ResourceAccessTraceScope trace(resources, prefab->getPrefabType(), prefab->getAssetId());
 	try {
 		Vector<EntityRef> entities;
 		for (const auto& entityData : prefab->getEntityDatas()) {
@@ -350,6 +351,7 @@ void EntityFactoryContext::notifyEntity(const EntityRef& entity) const
 
 EntityRef EntityFactory::createEntity(const String& prefabName, EntityRef parent, EntityScene* scene)
 {
+	ResourceAccessTraceScope trace(resources, AssetType::Prefab, prefabName);
 	EntityData data(UUID::generate());
 	data.setPrefab(prefabName);
 	const int mask = makeMask(EntitySerialization::Type::Prefab);
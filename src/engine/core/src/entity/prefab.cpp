@@ -18,6 +18,7 @@ std::shared_ptr<Prefab> Prefab::loadResource(ResourceLoader& loader)
 {
 	auto prefab = std::make_shared<Prefab>();
 	auto& res = loader.getResources();
+	res.prefetch(getAssetType(), loader.getName());
 
 	if (threadedLoad) {
 		prefab->startLoading();
@@ -306,6 +307,7 @@ std::shared_ptr<Scene> Scene::loadResource(ResourceLoader& loader)
 {
 	auto scene = std::make_shared<Scene>();
 	auto& resources = loader.getResources();
+	resources.prefetch(getAssetType(), loader.getName());
 	
 	if (threadedLoad) {
 		scene->startLoading();
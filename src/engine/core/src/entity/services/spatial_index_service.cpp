@@ -0,0 +1,46 @@
+#include "halley/entity/services/spatial_index_service.h"
+
+using namespace Halley;
+
+SpatialIndexService::SpatialIndexService(float cellSize)
+	: index(cellSize)
+{
+}
+
+void SpatialIndexService::invalidate(EntityId id)
+{
+	const auto iter = tracked.find(id);
+	if (iter != tracked.end()) {
+		iter->second.dirty = true;
+	}
+}
+
+void SpatialIndexService::remove(EntityId id)
+{
+	tracked.erase(id);
+	index.remove(id);
+}
+
+void SpatialIndexService::clear()
+{
+	tracked.clear();
+	index.clear();
+}
+
+void SpatialIndexService::removeStale()
+{
+	for (auto iter = tracked.begin(); iter != tracked.end();) {
+		if (iter->second.generation != generation) {
+			index.remove(iter->first);
+			iter = tracked.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	++generation;
+}
+
+const SpatialIndex& SpatialIndexService::getIndex() const
+{
+	return index;
+}
@@ -149,8 +149,9 @@ void System::receiveSystemMessage(const SystemMessageContext& context)
 
 void System::prepareSystemMessages()
 {
-	systemMessages = std::move(systemMessageInbox);
-	systemMessageInbox.clear();
+	// Swap rather than move, so both buffers keep their capacity from frame to frame
+	systemMessages.clear();
+	std::swap(systemMessages, systemMessageInbox);
 }
 
 void System::processSystemMessages()
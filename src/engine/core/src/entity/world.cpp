@@ -8,6 +8,7 @@
 
 #include "halley/entity/system.h"
 #include "halley/entity/family.h"
+#include "halley/data_structures/frame_allocator.h"
 #include "halley/bytes/byte_serializer.h"
 #include "halley/text/string_converter.h"
 #include "halley/support/debug.h"
@@ -688,14 +689,26 @@ void World::updateEntities()
 	HALLEY_DEBUG_TRACE();
 	size_t nEntities = entities.size();
 
-	Vector<size_t> entitiesRemoved;
+	auto& framePool = FrameAllocator::get();
+	auto entitiesRemoved = VectorTemp<size_t>(framePool);
 
 	struct FamilyTodo {
-		Vector<std::pair<FamilyMaskType, Entity*>> toAdd;
-		Vector<std::pair<FamilyMaskType, Entity*>> toRemove;
-		Vector<std::pair<FamilyMaskType, Entity*>> toReload;
+		VectorTemp<std::pair<FamilyMaskType, Entity*>> toAdd;
+		VectorTemp<std::pair<FamilyMaskType, Entity*>> toRemove;
+		VectorTemp<std::pair<FamilyMaskType, Entity*>> toReload;
+
+		FamilyTodo(TempMemoryPool& pool)
+			: toAdd(pool)
+			, toRemove(pool)
+			, toReload(pool)
+		{}
+	};
+	using PendingMap = std::map<FamilyMaskType, FamilyTodo, std::less<FamilyMaskType>, TempPoolAllocator<std::pair<const FamilyMaskType, FamilyTodo>>>;
+	PendingMap pending{ PendingMap::allocator_type(framePool) };
+	auto getPending = [&] (const FamilyMaskType& mask) -> FamilyTodo&
+	{
+		return pending.try_emplace(mask, framePool).first->second;
 	};
-	std::map<FamilyMaskType, FamilyTodo> pending;
 
 	// Update all entities
 	// This loop should be as fast as reasonably possible
@@ -710,7 +723,7 @@ void World::updateEntities()
 			// First of all, let's check if it's dead
 			if (!entity.isAlive()) {
 				// Remove from systems
-				pending[entity.getMask()].toRemove.emplace_back(FamilyMaskType(), &entity);
+				getPending(entity.getMask()).toRemove.emplace_back(FamilyMaskType(), &entity);
 				entitiesRemoved.push_back(i);
 			} else {
 				// It's alive, so check old and new system inclusions
@@ -720,8 +733,8 @@ void World::updateEntities()
 
 				// Did it change?
 				if (oldMask != newMask) {
-					pending[oldMask].toRemove.emplace_back(newMask, &entity);
-					pending[newMask].toAdd.emplace_back(oldMask, &entity);
+					getPending(oldMask).toRemove.emplace_back(newMask, &entity);
+					getPending(newMask).toAdd.emplace_back(oldMask, &entity);
 				}
 			}
 		}
@@ -731,7 +744,7 @@ void World::updateEntities()
 		for (size_t i = 0; i < nEntities; i++) {
 			auto& entity = *entities[i];
 			if (entity.reloaded && entity.isAlive()) {
-				pending[entity.getMask()].toReload.emplace_back(entity.getMask(), &entity);
+				getPending(entity.getMask()).toReload.emplace_back(entity.getMask(), &entity);
 				entity.reloaded = false;
 			}
 		}
@@ -1,6 +1,7 @@
 #include "halley/file/directory_monitor.h"
 
 #include "halley/support/exception.h"
+#include "halley/data_structures/hash_map.h"
 #include "halley/file/path.h"
 #include "halley/support/logger.h"
 #include "halley/text/string_converter.h"
@@ -147,6 +148,256 @@ namespace Halley {
 	};
 }
 
+#elif defined(__linux__)
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+namespace Halley {
+	class DirectoryMonitorPimpl
+	{
+	public:
+		DirectoryMonitorPimpl(const Path& path)
+			: root(path.getNativeString(false).cppStr())
+		{
+			while (root.size() > 1 && root.back() == '/') {
+				root.pop_back();
+			}
+
+			fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (fd < 0) {
+				Logger::logError("Directory monitor could not be set up for " + path.toString() + ": " + strerror(errno));
+				return;
+			}
+
+			buffer.resize(256 * 1024);
+			if (!addWatchRecursive(root)) {
+				Logger::logError("Directory monitor could not watch " + path.toString());
+				close(fd);
+				fd = -1;
+			}
+		}
+
+		~DirectoryMonitorPimpl()
+		{
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+
+		void poll(Vector<DirectoryMonitor::Event>& output, bool any)
+		{
+			if (fd < 0) {
+				output.emplace_back(DirectoryMonitor::Event{ DirectoryMonitor::ChangeType::Unknown, {}, {} });
+				return;
+			}
+
+			Vector<DirectoryMonitor::Event> events;
+			bool overflow = false;
+
+			while (true) {
+				const auto bytes = read(fd, buffer.data(), buffer.size());
+				if (bytes <= 0) {
+					if (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+						Logger::logError("Directory monitor failed to read events for " + String(root) + ": " + strerror(errno));
+						overflow = true;
+					}
+					break;
+				}
+
+				for (size_t pos = 0; pos < static_cast<size_t>(bytes); ) {
+					const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + pos);
+					overflow |= processEvent(*event, events);
+					pos += sizeof(inotify_event) + event->len;
+				}
+			}
+
+			flushUnpairedMoves(events);
+
+			if (overflow) {
+				// We lost track of what changed, so re-create all watches and ask for everything to be rescanned
+				resetWatches();
+				output.emplace_back(DirectoryMonitor::Event{ DirectoryMonitor::ChangeType::Unknown, true, String(root), {} });
+			} else if (!events.empty()) {
+				if (any) {
+					output.emplace_back(DirectoryMonitor::Event{ DirectoryMonitor::ChangeType::Unknown, {}, {} });
+				} else {
+					for (auto& e: events) {
+						output.push_back(std::move(e));
+					}
+				}
+			}
+		}
+
+		bool hasRealImplementation() const
+		{
+			return fd >= 0;
+		}
+
+	private:
+		struct PendingMove {
+			uint32_t cookie;
+			size_t eventIdx;
+		};
+
+		constexpr static uint32_t watchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+		int fd = -1;
+		std::string root;
+		Vector<char> buffer;
+		HashMap<int, std::string> watches;
+		Vector<PendingMove> pendingMoves;
+
+		// Returns true if the event queue overflowed
+		bool processEvent(const inotify_event& event, Vector<DirectoryMonitor::Event>& output)
+		{
+			using CT = DirectoryMonitor::ChangeType;
+
+			if (event.mask & IN_Q_OVERFLOW) {
+				return true;
+			}
+
+			if (event.mask & IN_IGNORED) {
+				watches.erase(event.wd);
+				return false;
+			}
+
+			const auto dirIter = watches.find(event.wd);
+			if (dirIter == watches.end() || event.len == 0) {
+				// Events on the watched directory itself (e.g. IN_DELETE_SELF) are reported by its parent
+				return false;
+			}
+
+			const bool isDir = (event.mask & IN_ISDIR) != 0;
+			auto curPath = dirIter->second + "/" + event.name;
+
+			if (event.mask & IN_CREATE) {
+				output.emplace_back(DirectoryMonitor::Event{ CT::FileAdded, isDir, String(curPath), {} });
+				if (isDir) {
+					addWatchRecursive(curPath, &output);
+				}
+			} else if (event.mask & IN_DELETE) {
+				output.emplace_back(DirectoryMonitor::Event{ CT::FileRemoved, isDir, String(curPath), {} });
+			} else if (event.mask & (IN_MODIFY | IN_CLOSE_WRITE)) {
+				if (!isDir) {
+					output.emplace_back(DirectoryMonitor::Event{ CT::FileModified, isDir, String(curPath), {} });
+				}
+			} else if (event.mask & IN_MOVED_FROM) {
+				// Stays a rename if the matching IN_MOVED_TO shows up, otherwise the file was moved out of the tree
+				pendingMoves.push_back(PendingMove{ event.cookie, output.size() });
+				output.emplace_back(DirectoryMonitor::Event{ CT::FileRenamed, isDir, {}, String(curPath) });
+			} else if (event.mask & IN_MOVED_TO) {
+				const auto moveIter = std::find_if(pendingMoves.begin(), pendingMoves.end(), [&] (const PendingMove& m) { return m.cookie == event.cookie; });
+				if (moveIter != pendingMoves.end()) {
+					auto& renamed = output[moveIter->eventIdx];
+					if (isDir) {
+						renameWatches(renamed.oldName.cppStr(), curPath);
+					}
+					renamed.name = String(curPath);
+					pendingMoves.erase(moveIter);
+				} else {
+					output.emplace_back(DirectoryMonitor::Event{ CT::FileAdded, isDir, String(curPath), {} });
+					if (isDir) {
+						addWatchRecursive(curPath, &output);
+					}
+				}
+			}
+
+			return false;
+		}
+
+		void flushUnpairedMoves(Vector<DirectoryMonitor::Event>& output)
+		{
+			for (const auto& move: pendingMoves) {
+				auto& e = output[move.eventIdx];
+				if (e.isDir) {
+					removeWatches(e.oldName.cppStr());
+				}
+				e.type = DirectoryMonitor::ChangeType::FileRemoved;
+				e.name = std::move(e.oldName);
+				e.oldName = {};
+			}
+			pendingMoves.clear();
+		}
+
+		// If added is set, everything already inside dir is reported as added. A directory only gets its watch after it
+		// shows up, so anything created in it before then would otherwise be missed. Files created in between the watch
+		// and the scan might be reported twice.
+		bool addWatchRecursive(const std::string& dir, Vector<DirectoryMonitor::Event>* added = nullptr)
+		{
+			if (!addWatch(dir)) {
+				return false;
+			}
+
+			std::error_code ec;
+			for (auto iter = std::filesystem::recursive_directory_iterator(dir, std::filesystem::directory_options::skip_permission_denied, ec); !ec && iter != std::filesystem::recursive_directory_iterator(); iter.increment(ec)) {
+				const bool isDir = iter->is_directory(ec) && !iter->is_symlink(ec);
+				if (isDir) {
+					addWatch(iter->path().string());
+				}
+				if (added) {
+					added->emplace_back(DirectoryMonitor::Event{ DirectoryMonitor::ChangeType::FileAdded, isDir, String(iter->path().string()), {} });
+				}
+			}
+			return true;
+		}
+
+		bool addWatch(const std::string& dir)
+		{
+			const int wd = inotify_add_watch(fd, dir.c_str(), watchMask);
+			if (wd < 0) {
+				if (errno == ENOSPC) {
+					Logger::logWarning("Directory monitor ran out of inotify watches while watching " + String(dir) + ", consider raising fs.inotify.max_user_watches");
+				}
+				return false;
+			}
+			watches[wd] = dir;
+			return true;
+		}
+
+		void renameWatches(const std::string& oldDir, const std::string& newDir)
+		{
+			for (auto& [wd, dir]: watches) {
+				if (isSameOrInside(dir, oldDir)) {
+					dir = newDir + dir.substr(oldDir.size());
+				}
+			}
+		}
+
+		void removeWatches(const std::string& dir)
+		{
+			for (auto& [wd, watchDir]: watches) {
+				if (isSameOrInside(watchDir, dir)) {
+					// The watch entry itself is removed when IN_IGNORED arrives
+					inotify_rm_watch(fd, wd);
+				}
+			}
+		}
+
+		void resetWatches()
+		{
+			for (const auto& [wd, dir]: watches) {
+				inotify_rm_watch(fd, wd);
+			}
+			watches.clear();
+			pendingMoves.clear();
+
+			// Drop any stale events (including the IN_IGNORED ones we just caused)
+			while (read(fd, buffer.data(), buffer.size()) > 0) {}
+
+			addWatchRecursive(root);
+		}
+
+		static bool isSameOrInside(const std::string& path, const std::string& dir)
+		{
+			return path.size() >= dir.size() && path.compare(0, dir.size(), dir) == 0 && (path.size() == dir.size() || path[dir.size()] == '/');
+		}
+	};
+}
+
 #else
 
 namespace Halley {
@@ -191,7 +442,12 @@ Vector<DirectoryMonitor::Event> DirectoryMonitor::poll(bool waitForNoChange)
 
 		if (nNow != nBefore) {
 			if (result.back().type == ChangeType::Unknown) {
+				// An Unknown event with a name asks for that whole directory to be rescanned, otherwise it means the monitor can't tell
+				auto rescan = std::move(result.back());
 				result.clear();
+				if (!rescan.name.isEmpty()) {
+					result.push_back(std::move(rescan));
+				}
 				return result;
 			}
 			if (waitForNoChange) {
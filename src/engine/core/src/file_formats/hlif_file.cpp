@@ -1,12 +1,32 @@
 #include "halley/file_formats/hlif_file.h"
 
 #include "halley/bytes/compression.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/maths/simd.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define HALLEY_HLIF_NEON
+#include <arm_neon.h>
+#endif
 
 using namespace Halley;
 
+namespace {
+	// LZ4 only looks back 64 KB, so tiles of at least that size hardly cost any compression
+	constexpr size_t targetTileBytes = 128 * 1024;
+	constexpr int minTileHeight = 16;
+
+	int getTileHeight(Vector2i size, size_t stride)
+	{
+		const auto rows = static_cast<int>((targetTileBytes + stride - 1) / std::max(stride, size_t(1)));
+		return std::max(1, std::min(std::max(rows, minTileHeight), size.y));
+	}
+}
+
 void HLIFFile::decode(Image& dst, gsl::span<const gsl::byte> bytes)
 {
-	if (!isHLIF(bytes)) {
+	const auto version = getVersion(bytes);
+	if (!version) {
 		throw Exception("Not an HLIF file.", HalleyExceptions::Utils);
 	}
 
@@ -21,6 +41,17 @@ void HLIFFile::decode(Image& dst, gsl::span<const gsl::byte> bytes)
 		throw Exception("Invalid HLIF file encoding.", HalleyExceptions::Utils);
 	}
 
+	if (*version == Version::V1) {
+		decodeV1(dst, header, bytes);
+	} else {
+		decodeV2(dst, header, bytes);
+	}
+}
+
+void HLIFFile::decodeV1(Image& dst, const Header& header, gsl::span<const gsl::byte> bytes)
+{
+	const int bpp = header.numPalettes > 0 ? 1 : getBPP(header.format);
+
 	Bytes decompressedData;
 	decompressedData.resize_no_init(header.uncompressedSize);
 	const auto decompressedSize = Compression::lz4Decompress(bytes.subspan(sizeof(header), header.compressedSize), decompressedData.byte_span());
@@ -33,14 +64,11 @@ void HLIFFile::decode(Image& dst, gsl::span<const gsl::byte> bytes)
 	const auto paletteData = dataSpan.subspan(0, header.numPalettes * sizeof(Palette));
 	const auto lineData = dataSpan.subspan(paletteData.size(), header.height);
 	const auto pixelData = dataSpan.subspan(paletteData.size() + lineData.size());
-	const auto imgFormat = header.format == Format::RGBA ?
-		((header.flags & static_cast<uint8_t>(Flags::Premultiplied)) ? Image::Format::RGBAPremultiplied : Image::Format::RGBA) :
-		(header.format == Format::SingleChannel ? Image::Format::SingleChannel : Image::Format::Indexed);
 	const auto imgSize = Vector2i(header.width, header.height);
 
 	decodeLines(imgSize, lineData, pixelData, bpp);
 
-	dst = Image(imgFormat, imgSize, false);
+	dst = Image(getImageFormat(header), imgSize, false);
 	if (header.numPalettes > 0) {
 		Vector<Palette> palettes(header.numPalettes);
 		memcpy(palettes.data(), paletteData.data(), paletteData.size());
@@ -51,9 +79,114 @@ void HLIFFile::decode(Image& dst, gsl::span<const gsl::byte> bytes)
 	}
 }
 
-Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
+void HLIFFile::decodeV2(Image& dst, const Header& header, gsl::span<const gsl::byte> bytes)
+{
+	const int bpp = header.numPalettes > 0 ? 1 : getBPP(header.format);
+	const auto imgSize = Vector2i(header.width, header.height);
+	const size_t stride = static_cast<size_t>(imgSize.x) * bpp;
+
+	size_t pos = sizeof(Header);
+	auto read = [&] (void* dstData, size_t size)
+	{
+		if (pos + size > bytes.size()) {
+			throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+		}
+		memcpy(dstData, bytes.data() + pos, size);
+		pos += size;
+	};
+
+	TileHeader tileHeader;
+	read(&tileHeader, sizeof(tileHeader));
+	const int tileHeight = tileHeader.tileHeight;
+	const size_t numTiles = tileHeader.numTiles;
+	if (tileHeight <= 0 ? imgSize.y > 0 : numTiles != static_cast<size_t>((imgSize.y + tileHeight - 1) / tileHeight)) {
+		throw Exception("Invalid HLIF file encoding.", HalleyExceptions::Utils);
+	}
+
+	// Block 0 holds the palettes, the rest are tiles
+	Vector<uint32_t> blockSizes(numTiles + 1);
+	read(blockSizes.data(), blockSizes.size() * sizeof(uint32_t));
+	Vector<size_t> blockStarts(numTiles + 1);
+	for (size_t i = 0; i < blockSizes.size(); ++i) {
+		blockStarts[i] = pos;
+		pos += blockSizes[i];
+	}
+	if (pos > bytes.size()) {
+		throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+	}
+
+	Vector<Palette> palettes(header.numPalettes);
+	if (!palettes.empty()) {
+		const auto paletteBytes = gsl::as_writable_bytes(gsl::span<Palette>(palettes));
+		const auto decompressedSize = Compression::lz4Decompress(bytes.subspan(blockStarts[0], blockSizes[0]), paletteBytes);
+		if (decompressedSize != paletteBytes.size()) {
+			throw Exception("Error decoding HLIF file.", HalleyExceptions::Utils);
+		}
+		deltaDecodePalettes(palettes);
+	}
+
+	dst = Image(getImageFormat(header), imgSize, false);
+	const auto dstBytes = dst.getPixelBytes();
+	const auto dstPixels = palettes.empty() ? gsl::span<int>() : dst.getPixels4BPP();
+
+	Concurrent::parallelFor(numTiles, [&] (size_t i)
+	{
+		const int y0 = static_cast<int>(i) * tileHeight;
+		const int h = std::min(tileHeight, imgSize.y - y0);
+		const size_t tileSize = static_cast<size_t>(h) + static_cast<size_t>(h) * stride;
+
+		Bytes tileData;
+		tileData.resize_no_init(tileSize);
+		const auto decompressedSize = Compression::lz4Decompress(bytes.subspan(blockStarts[i + 1], blockSizes[i + 1]), tileData.byte_span());
+		if (decompressedSize != tileSize) {
+			throw Exception("Error decoding HLIF file.", HalleyExceptions::Utils);
+		}
+
+		const auto tileSpan = gsl::span<Byte>(tileData);
+		const auto lineData = tileSpan.subspan(0, h);
+		const auto pixelData = tileSpan.subspan(h);
+		decodeLines(Vector2i(imgSize.x, h), lineData, pixelData, bpp);
+
+		if (palettes.empty()) {
+			memcpy(dstBytes.data() + y0 * stride, pixelData.data(), pixelData.size_bytes());
+		} else {
+			const size_t firstPixel = static_cast<size_t>(y0) * imgSize.x;
+			applyPalettes(pixelData, palettes, dstPixels.subspan(firstPixel, pixelData.size()), firstPixel);
+		}
+	});
+}
+
+Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc, Version version)
+{
+	auto header = makeHeader(image);
+
+	// Try to generate palette
+	Vector<Palette> palettes;
+	Bytes palettedImage;
+	if (header.format == Format::RGBA && static_cast<size_t>(header.width) * static_cast<size_t>(header.height) > 512) {
+		if (auto result = makePalettes(image.getPixels4BPP(), name)) {
+			optimizePalettes(result->first, result->second);
+			deltaEncodePalettes(result->first);
+			palettes = std::move(result->first);
+			palettedImage = std::move(result->second);
+			header.numPalettes = static_cast<uint8_t>(palettes.size());
+		}
+	}
+
+	// Figure out full size
+	const int bpp = palettedImage.empty() ? getBPP(header.format) : 1;
+	header.uncompressedSize = header.width * header.height * bpp + header.height + static_cast<uint32_t>(palettes.size() * sizeof(Palette));
+
+	const auto pixels = palettes.empty() ? image.getPixelBytes() : gsl::span<const uint8_t>(palettedImage);
+	if (version == Version::V1) {
+		return encodeV1(header, palettes, pixels, image.getSize(), bpp, lz4hc);
+	} else {
+		return encodeV2(header, palettes, pixels, image.getSize(), bpp, lz4hc);
+	}
+}
+
+HLIFFile::Header HLIFFile::makeHeader(const Image& image)
 {
-	// Fill header
 	Header header;
 	memcpy(header.id, hlifId, 8);
 	switch (image.getFormat()) {
@@ -75,24 +208,36 @@ Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
 	}
 	header.width = static_cast<uint16_t>(image.getWidth());
 	header.height = static_cast<uint16_t>(image.getHeight());
+	return header;
+}
 
-	// Try to generate palette
-	Vector<Palette> palettes;
-	Bytes palettedImage;
-	if (header.format == Format::RGBA && static_cast<size_t>(header.width) * static_cast<size_t>(header.height) > 512) {
-		if (auto result = makePalettes(image.getPixels4BPP(), name)) {
-			optimizePalettes(result->first, result->second);
-			deltaEncodePalettes(result->first);
-			palettes = std::move(result->first);
-			palettedImage = std::move(result->second);
-			header.numPalettes = static_cast<uint8_t>(palettes.size());
-		}
-	}
+Image::Format HLIFFile::getImageFormat(const Header& header)
+{
+	return header.format == Format::RGBA ?
+		((header.flags & static_cast<uint8_t>(Flags::Premultiplied)) ? Image::Format::RGBAPremultiplied : Image::Format::RGBA) :
+		(header.format == Format::SingleChannel ? Image::Format::SingleChannel : Image::Format::Indexed);
+}
 
-	// Figure out full size
-	const int bpp = palettedImage.empty() ? getBPP(header.format) : 1;
-	header.uncompressedSize = header.width * header.height * bpp + header.height + static_cast<uint32_t>(palettes.size() * sizeof(Palette));
+Bytes HLIFFile::compressBlock(gsl::span<uint8_t> data, gsl::span<uint8_t> lineData, gsl::span<uint8_t> pixelData, Vector2i size, int bpp, bool lz4hc)
+{
+	memset(lineData.data(), 0, lineData.size_bytes());
+
+	// Try compressing with no filters first
+	Compression::LZ4Options options;
+	options.mode = lz4hc ? Compression::LZ4Mode::HC : Compression::LZ4Mode::Normal;
+	//options.level = 12;
+	auto compressedUnfiltered = Compression::lz4Compress(gsl::as_bytes(data), options);
+
+	// Filter and compress again
+	encodeLines(size, lineData, pixelData, bpp);
+	auto compressedFiltered = Compression::lz4Compress(gsl::as_bytes(data), options);
+
+	// Take the best of the two
+	return compressedUnfiltered.size() < compressedFiltered.size() ? std::move(compressedUnfiltered) : std::move(compressedFiltered);
+}
 
+Bytes HLIFFile::encodeV1(Header header, gsl::span<const Palette> palettes, gsl::span<const uint8_t> pixels, Vector2i size, int bpp, bool lz4hc)
+{
 	// Prepare uncompressed data
 	Bytes uncompressed;
 	uncompressed.resize_no_init(header.uncompressedSize);
@@ -100,30 +245,12 @@ Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
 	const auto paletteSpan = dataSpan.subspan(0, palettes.size() * sizeof(Palette));
 	const auto lineSpan = dataSpan.subspan(paletteSpan.size(), header.height);
 	const auto pixelSpan = dataSpan.subspan(paletteSpan.size() + lineSpan.size());
-	if (palettes.empty()) {
-		memcpy(pixelSpan.data(), image.getPixelBytes().data(), pixelSpan.size());
-	} else {
-		memcpy(paletteSpan.data(), palettes.data(), paletteSpan.size());
-		memcpy(pixelSpan.data(), palettedImage.data(), pixelSpan.size());
-	}
-	memset(lineSpan.data(), 0, lineSpan.size_bytes());
-
-	// Try compressing with no filters first
-	Compression::LZ4Options options;
-	options.mode = lz4hc ? Compression::LZ4Mode::HC : Compression::LZ4Mode::Normal;
-	//options.level = 12;
-	auto compressedUnfiltered = Compression::lz4Compress(gsl::as_bytes(dataSpan), options);
+	memcpy(paletteSpan.data(), palettes.data(), paletteSpan.size());
+	memcpy(pixelSpan.data(), pixels.data(), pixelSpan.size());
 
-	// Filter and compress again
-	encodeLines(image.getSize(), lineSpan, pixelSpan, bpp);
-	auto compressedFiltered = Compression::lz4Compress(gsl::as_bytes(dataSpan), options);
+	const auto compressed = compressBlock(dataSpan, lineSpan, pixelSpan, size, bpp, lz4hc);
 	uncompressed = {};
 
-	// Take the best of the two
-	const auto compressed = compressedUnfiltered.size() < compressedFiltered.size() ? std::move(compressedUnfiltered) : std::move(compressedFiltered);
-	compressedFiltered = {};
-	compressedUnfiltered = {};
-
 	// Finish header and generate final bytes
 	header.compressedSize = static_cast<uint32_t>(compressed.size());
 	Bytes finalData(sizeof(header) + compressed.size());
@@ -132,6 +259,66 @@ Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
 	return finalData;
 }
 
+Bytes HLIFFile::encodeV2(Header header, gsl::span<const Palette> palettes, gsl::span<const uint8_t> pixels, Vector2i size, int bpp, bool lz4hc)
+{
+	memcpy(header.id, hlifIdV2, 8);
+	const size_t stride = static_cast<size_t>(size.x) * bpp;
+
+	TileHeader tileHeader;
+	const int tileHeight = getTileHeight(size, stride);
+	const size_t numTiles = size.y > 0 ? static_cast<size_t>((size.y + tileHeight - 1) / tileHeight) : 0;
+	tileHeader.tileHeight = static_cast<uint16_t>(tileHeight);
+	tileHeader.numTiles = static_cast<uint16_t>(numTiles);
+
+	// Block 0 holds the palettes, the rest are tiles
+	Vector<Bytes> blocks(numTiles + 1);
+	if (!palettes.empty()) {
+		Compression::LZ4Options options;
+		options.mode = lz4hc ? Compression::LZ4Mode::HC : Compression::LZ4Mode::Normal;
+		blocks[0] = Compression::lz4Compress(gsl::as_bytes(palettes), options);
+	}
+
+	Concurrent::parallelFor(numTiles, [&] (size_t i)
+	{
+		const int y0 = static_cast<int>(i) * tileHeight;
+		const int h = std::min(tileHeight, size.y - y0);
+
+		Bytes tileData;
+		tileData.resize_no_init(static_cast<size_t>(h) + static_cast<size_t>(h) * stride);
+		const auto tileSpan = gsl::span<Byte>(tileData);
+		const auto lineSpan = tileSpan.subspan(0, h);
+		const auto pixelSpan = tileSpan.subspan(h);
+		memcpy(pixelSpan.data(), pixels.data() + y0 * stride, pixelSpan.size());
+
+		blocks[i + 1] = compressBlock(tileSpan, lineSpan, pixelSpan, Vector2i(size.x, h), bpp, lz4hc);
+	});
+
+	size_t totalSize = sizeof(TileHeader) + blocks.size() * sizeof(uint32_t);
+	for (const auto& block: blocks) {
+		totalSize += block.size();
+	}
+	header.compressedSize = static_cast<uint32_t>(totalSize);
+
+	Bytes finalData(sizeof(header) + totalSize);
+	size_t pos = 0;
+	auto write = [&] (const void* src, size_t size)
+	{
+		memcpy(finalData.data() + pos, src, size);
+		pos += size;
+	};
+
+	write(&header, sizeof(header));
+	write(&tileHeader, sizeof(tileHeader));
+	for (const auto& block: blocks) {
+		const auto blockSize = static_cast<uint32_t>(block.size());
+		write(&blockSize, sizeof(blockSize));
+	}
+	for (const auto& block: blocks) {
+		write(block.data(), block.size());
+	}
+	return finalData;
+}
+
 HLIFFile::Info HLIFFile::getInfo(gsl::span<const gsl::byte> bytes)
 {
 	if (!isHLIF(bytes)) {
@@ -152,7 +339,19 @@ HLIFFile::Info HLIFFile::getInfo(gsl::span<const gsl::byte> bytes)
 
 bool HLIFFile::isHLIF(gsl::span<const gsl::byte> bytes)
 {
-	return bytes.size() >= 8 && memcmp(bytes.data(), hlifId, 8) == 0;
+	return getVersion(bytes).has_value();
+}
+
+std::optional<HLIFFile::Version> HLIFFile::getVersion(gsl::span<const gsl::byte> bytes)
+{
+	if (bytes.size() >= 8) {
+		if (memcmp(bytes.data(), hlifId, 8) == 0) {
+			return Version::V1;
+		} else if (memcmp(bytes.data(), hlifIdV2, 8) == 0) {
+			return Version::V2;
+		}
+	}
+	return {};
 }
 
 void HLIFFile::decodeLines(Vector2i size, gsl::span<const uint8_t> lineData, gsl::span<uint8_t> pixelData, int bpp)
@@ -315,8 +514,185 @@ namespace {
 	}
 }
 
+namespace {
+#if defined(HAS_SSE)
+	// SSE2 versions, modelled after libpng's. Sub, Average and Paeth depend on the pixel to the left, so those process one pixel (4 channels) at a time.
+	inline __m128i load4(const uint8_t* src)
+	{
+		int32_t v;
+		memcpy(&v, src, 4);
+		return _mm_cvtsi32_si128(v);
+	}
+
+	inline void store4(uint8_t* dst, __m128i v)
+	{
+		const int32_t x = _mm_cvtsi128_si32(v);
+		memcpy(dst, &x, 4);
+	}
+
+	inline __m128i select(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	inline __m128i abs16(__m128i v)
+	{
+		return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+	}
+
+	void decodeUpSIMD(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		size_t x = 0;
+		for (; x + 16 <= n; x += 16) {
+			const auto v = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + x)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(cur + x), v);
+		}
+		for (; x < n; ++x) {
+			cur[x] += prev[x];
+		}
+	}
+
+	void decodeSubRGBA(uint8_t* cur, size_t n)
+	{
+		__m128i a = load4(cur);
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			a = _mm_add_epi8(a, load4(cur + x));
+			store4(cur + x, a);
+		}
+	}
+
+	void decodeAverageRGBA(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		// _mm_avg_epu8 rounds up, so take the rounding back out to match (a + b) / 2
+		const __m128i one = _mm_set1_epi8(1);
+		__m128i a = load4(cur);
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			const __m128i b = load4(prev + x);
+			const __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+			a = _mm_add_epi8(avg, load4(cur + x));
+			store4(cur + x, a);
+		}
+	}
+
+	void decodePaethRGBA(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i a = _mm_unpacklo_epi8(load4(cur), zero);
+		__m128i c = _mm_unpacklo_epi8(load4(prev), zero);
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			const __m128i b = _mm_unpacklo_epi8(load4(prev + x), zero);
+
+			// With p = a + b - c: |p - a| = |b - c|, |p - b| = |a - c|, |p - c| = |(b - c) + (a - c)|
+			const __m128i bc = _mm_sub_epi16(b, c);
+			const __m128i ac = _mm_sub_epi16(a, c);
+			const __m128i pa = abs16(bc);
+			const __m128i pb = abs16(ac);
+			const __m128i pc = abs16(_mm_add_epi16(bc, ac));
+			const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+			const __m128i nearest = select(_mm_cmpeq_epi16(smallest, pa), a, select(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+			a = _mm_and_si128(_mm_add_epi16(nearest, _mm_unpacklo_epi8(load4(cur + x), zero)), _mm_set1_epi16(0xFF));
+			store4(cur + x, _mm_packus_epi16(a, a));
+			c = b;
+		}
+	}
+#elif defined(HALLEY_HLIF_NEON)
+	inline uint8x8_t load4(const uint8_t* src)
+	{
+		uint32_t v;
+		memcpy(&v, src, 4);
+		return vreinterpret_u8_u32(vdup_n_u32(v));
+	}
+
+	inline void store4(uint8_t* dst, uint8x8_t v)
+	{
+		const uint32_t x = vget_lane_u32(vreinterpret_u32_u8(v), 0);
+		memcpy(dst, &x, 4);
+	}
+
+	inline int16x8_t widen(uint8x8_t v)
+	{
+		return vreinterpretq_s16_u16(vmovl_u8(v));
+	}
+
+	void decodeUpSIMD(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		size_t x = 0;
+		for (; x + 16 <= n; x += 16) {
+			vst1q_u8(cur + x, vaddq_u8(vld1q_u8(cur + x), vld1q_u8(prev + x)));
+		}
+		for (; x < n; ++x) {
+			cur[x] += prev[x];
+		}
+	}
+
+	void decodeSubRGBA(uint8_t* cur, size_t n)
+	{
+		uint8x8_t a = load4(cur);
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			a = vadd_u8(a, load4(cur + x));
+			store4(cur + x, a);
+		}
+	}
+
+	void decodeAverageRGBA(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		uint8x8_t a = load4(cur);
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			a = vadd_u8(vhadd_u8(a, load4(prev + x)), load4(cur + x));
+			store4(cur + x, a);
+		}
+	}
+
+	void decodePaethRGBA(uint8_t* cur, const uint8_t* prev, size_t n)
+	{
+		int16x8_t a = widen(load4(cur));
+		int16x8_t c = widen(load4(prev));
+		for (size_t x = 4; x + 4 <= n; x += 4) {
+			const int16x8_t b = widen(load4(prev + x));
+
+			// With p = a + b - c: |p - a| = |b - c|, |p - b| = |a - c|, |p - c| = |(b - c) + (a - c)|
+			const int16x8_t bc = vsubq_s16(b, c);
+			const int16x8_t ac = vsubq_s16(a, c);
+			const int16x8_t pa = vabsq_s16(bc);
+			const int16x8_t pb = vabsq_s16(ac);
+			const int16x8_t pc = vabsq_s16(vaddq_s16(bc, ac));
+			const int16x8_t smallest = vminq_s16(pc, vminq_s16(pa, pb));
+			const int16x8_t nearest = vbslq_s16(vceqq_s16(smallest, pa), a, vbslq_s16(vceqq_s16(smallest, pb), b, c));
+
+			const uint8x8_t result = vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(nearest, widen(load4(cur + x)))));
+			store4(cur + x, result);
+			a = widen(result);
+			c = b;
+		}
+	}
+#endif
+}
+
 void HLIFFile::decodeLine(LineEncoding lineEncoding, gsl::span<uint8_t> curLine, gsl::span<const uint8_t> prevLine, int bpp)
 {
+#if defined(HAS_SSE) || defined(HALLEY_HLIF_NEON)
+	if (lineEncoding == LineEncoding::Up) {
+		decodeUpSIMD(curLine.data(), prevLine.data(), curLine.size());
+		return;
+	}
+	if (bpp == 4) {
+		switch (lineEncoding) {
+		case LineEncoding::Sub:
+			decodeSubRGBA(curLine.data(), curLine.size());
+			return;
+		case LineEncoding::Average:
+			decodeAverageRGBA(curLine.data(), prevLine.data(), curLine.size());
+			return;
+		case LineEncoding::Paeth:
+			decodePaethRGBA(curLine.data(), prevLine.data(), curLine.size());
+			return;
+		default:
+			return;
+		}
+	}
+#endif
+
 	if (bpp == 1) {
 		doDecodeLine<1>(lineEncoding, curLine, prevLine);
 	} else if (bpp == 4) {
@@ -418,17 +794,39 @@ void HLIFFile::optimizePalettes(gsl::span<Palette> palettes, gsl::span<uint8_t>
 	}
 }
 
-void HLIFFile::applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst)
+void HLIFFile::applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst, size_t firstPixel)
 {
 	assert(palettedImage.size() == dst.size());
 
+	// Palette lookups are gathers, which SSE2/NEON can't do any faster, so this is just unrolled to give the CPU independent loads to overlap
+	const size_t lastPixel = firstPixel + palettedImage.size();
 	size_t startPos = 0;
 	for (const auto& palette: palettes) {
-		const size_t endPos = palette.endPixel;
-		for (size_t i = startPos; i < endPos; ++i) {
-			dst[i] = palette.entries[palettedImage[i]];
+		const size_t start = std::max(startPos, firstPixel);
+		const size_t end = std::min(static_cast<size_t>(palette.endPixel), lastPixel);
+		startPos = palette.endPixel;
+		if (start >= end) {
+			continue;
+		}
+
+		const auto* entries = palette.entries.data();
+		const auto* src = palettedImage.data() + (start - firstPixel);
+		auto* out = dst.data() + (start - firstPixel);
+		const size_t n = end - start;
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			const int c0 = entries[src[i]];
+			const int c1 = entries[src[i + 1]];
+			const int c2 = entries[src[i + 2]];
+			const int c3 = entries[src[i + 3]];
+			out[i] = c0;
+			out[i + 1] = c1;
+			out[i + 2] = c2;
+			out[i + 3] = c3;
+		}
+		for (; i < n; ++i) {
+			out[i] = entries[src[i]];
 		}
-		startPos = endPos;
 	}
 }
 
@@ -20,7 +20,11 @@
 #include "../dummy/dummy_plugins.h"
 #include "halley/entry/entry_point.h"
 #include "halley/graphics/render_snapshot.h"
+#include "halley/data_structures/frame_allocator.h"
 #include "halley/devcon/devcon_client.h"
+#include "halley/entity/benchmark_stage.h"
+#include "halley/diagnostics/benchmark_report.h"
+#include "halley/diagnostics/render_snapshot_benchmark_stage.h"
 #include "halley/input/input_joystick.h"
 #include "halley/net/connection/network_service.h"
 #include "halley/support/profiler.h"
@@ -49,6 +53,12 @@ Core::Core(std::unique_ptr<Game> g, Vector<std::string> _args)
 	}
 	environment->setDataPath(game->getDataPath(args));
 	environment->setArguments(_args);
+	headless = std_ex::contains(args, "--headless");
+	if (auto capture = BenchmarkReport::getArgument(args, "capture-snapshot")) {
+		snapshotCapturePath = Path(*capture);
+		const auto frame = BenchmarkReport::getArgument(args, "capture-snapshot-frame");
+		snapshotCaptureFrame = frame ? std::max(frame->toInteger(), 0) : 300;
+	}
 
 	// Basic initialization
 	game->init(*environment, args);
@@ -225,7 +235,13 @@ void Core::init()
 	}
 
 	// Start game
-	setStage(game->startGame());
+	if (auto benchmark = BenchmarkStage::Options::fromArguments(args)) {
+		setStage(std::make_unique<BenchmarkStage>(std::move(*benchmark)));
+	} else if (auto replay = RenderSnapshotBenchmarkStage::Options::fromArguments(args)) {
+		setStage(std::make_unique<RenderSnapshotBenchmarkStage>(std::move(*replay)));
+	} else {
+		setStage(game->startGame());
+	}
 }
 
 DevConClient* Core::getDevConClient() const
@@ -290,6 +306,14 @@ void Core::initResources()
 	auto options = game->initResourceLocator(gamePath, api->system->getAssetsPath(gamePath.string()), api->system->getUnpackedAssetsPath(gamePath.string()), *locator);
 	resources = std::make_unique<Resources>(std::move(locator), *api, options);
 	StandardResources::initialize(*resources);
+
+	// Prefetch manifests are only recorded on request, into the data dir (--record-prefetch) or a given dir (--record-prefetch=<dir>)
+	// To ship them, copy them into assets_src/config/prefetch, where they get imported and packed like any other config
+	if (std_ex::contains(args, "--record-prefetch")) {
+		resources->setPrefetchManifestOutputPath(environment->getDataPath() / "prefetch");
+	} else if (const auto dir = BenchmarkReport::getArgument(args, "record-prefetch")) {
+		resources->setPrefetchManifestOutputPath(Path(*dir));
+	}
 	api->audioInternal->setResources(*resources);
 	api->inputInternal->setResources(*resources);
 }
@@ -380,8 +404,14 @@ void Core::updatePlatform()
 
 void Core::onTick(Time delta)
 {
+	FrameAllocator::startFrame();
+
 	auto& capture = ProfilerCapture::get();
-	const bool record = !profileCallbacks.empty();
+	bool record = false;
+	for (auto* c: profileCallbacks) {
+		// Not short-circuited, so every callback knows whether it's getting this frame
+		record = c->shouldCaptureFrame() || record;
+	}
 	capture.startFrame(record);
 	
 	tickFrame(delta);
@@ -475,6 +505,7 @@ void Core::preUpdate(Time time)
 
 void Core::postUpdate(Time time)
 {
+	resources->update(time);
 	pumpAudio();
 	updatePlatform();
 	updateSystem(time);
@@ -545,6 +576,11 @@ void Core::render()
 
 		painter->startRender();
 
+		if (snapshotCapturePath && snapshotCaptureFrame-- == 0) {
+			captureRenderSnapshot(*snapshotCapturePath);
+			snapshotCapturePath.reset();
+		}
+
 		if (!pendingSnapshots.empty()) {
 			snapshot = std::make_unique<RenderSnapshot>();
 			painter->startRecording(snapshot.get());
@@ -741,6 +777,10 @@ void Core::registerDefaultPlugins()
 
 void Core::registerPlugin(std::unique_ptr<Plugin> plugin)
 {
+	if (headless && plugin->getPriority() >= 0) {
+		// Headless runs only use the dummy plugins, which have negative priority
+		return;
+	}
 	plugins[plugin->getType()].emplace_back(std::move(plugin));
 }
 
@@ -833,4 +873,16 @@ Future<std::unique_ptr<RenderSnapshot>> Core::requestRenderSnapshot()
 	return promise.getFuture();
 }
 
+void Core::captureRenderSnapshot(Path path)
+{
+	requestRenderSnapshot().then(Executors::getMainUpdateThread(), [path = std::move(path)] (std::unique_ptr<RenderSnapshot> snapshot)
+	{
+		if (Path::writeFile(path, snapshot->toBytes())) {
+			Logger::logInfo("Render snapshot saved to " + path.getString() + " (" + toString(snapshot->getNumDrawCalls()) + " draw calls)");
+		} else {
+			Logger::logError("Unable to save render snapshot to " + path.getString());
+		}
+	});
+}
+
 thread_local BaseFrameData* BaseFrameData::threadInstance = nullptr;
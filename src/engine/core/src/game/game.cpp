@@ -134,6 +134,10 @@ String Game::getLocalisationFileCategory(const String& assetName)
 	return "unknown";
 }
 
+void Game::setupBenchmarkWorld(World& world)
+{
+}
+
 bool Game::canCollectVideoPerformance()
 {
 	return true;
@@ -21,6 +21,7 @@
 
 #include "halley/graphics/camera.h"
 #include "halley/graphics/render_target/render_target.h"
+#include "halley/bytes/byte_serializer.h"
 
 using namespace Halley;
 
@@ -190,3 +191,30 @@ Vector2f Camera::worldToScreen(Vector2f p, Rect4f viewport) const
 	Vector2f pos2d(pos.x, pos.y);
 	return (p - pos2d).rotate(-angle) * scale.xy() + viewport.getCenter();
 }
+
+void Camera::serialize(Serializer& s) const
+{
+	s << pos.x << pos.y << pos.z;
+	s << scale.x << scale.y << scale.z;
+	s << rotation.w << rotation.x << rotation.y << rotation.z;
+	s << viewPort;
+	s << type;
+	s << fov.getRadians();
+	s << nearPlane;
+	s << farPlane;
+}
+
+void Camera::deserialize(Deserializer& s)
+{
+	s >> pos.x >> pos.y >> pos.z;
+	s >> scale.x >> scale.y >> scale.z;
+	s >> rotation.w >> rotation.x >> rotation.y >> rotation.z;
+	s >> viewPort;
+	s >> type;
+	float fovRadians;
+	s >> fovRadians;
+	fov = Angle1f::fromRadians(fovRadians, false);
+	s >> nearPlane;
+	s >> farPlane;
+	activeRenderTarget = nullptr;
+}
@@ -5,6 +5,7 @@
 #include "halley/graphics/painter.h"
 #include "halley/graphics/shader.h"
 #include "halley/api/video_api.h"
+#include "halley/graphics/material/material_intern_cache.h"
 #include "halley/graphics/sprite/sprite_sheet.h"
 #include "halley/utils/algorithm.h"
 #include "halley/utils/hash.h"
@@ -242,6 +243,10 @@ bool Material::operator!=(const Material& material) const
 
 bool Material::isCompatibleWith(const Material& other) const
 {
+	if (this == &other) {
+		return true;
+	}
+
 	if (materialDefinition != other.materialDefinition) {
 		return false;
 	}
@@ -351,6 +356,23 @@ gsl::span<MaterialDataBlock> Material::getDataBlocks()
 	return dataBlocks.span();
 }
 
+bool Material::setDataBlockData(size_t blockIdx, gsl::span<const gsl::byte> data)
+{
+	if (blockIdx >= dataBlocks.size()) {
+		return false;
+	}
+
+	auto& block = dataBlocks[blockIdx];
+	if (block.dataBlockType == MaterialDataBlockType::SharedExternal || block.data.size() != static_cast<size_t>(data.size_bytes())) {
+		return false;
+	}
+
+	memcpy(block.data.data(), data.data(), block.data.size());
+	block.needToUpdateHash = true;
+	needToUpdateHash = true;
+	return true;
+}
+
 void Material::setPassEnabled(int pass, bool enabled)
 {
 	if (passEnabled[pass] != enabled) {
@@ -597,12 +619,18 @@ MaterialUpdater::MaterialUpdater(MaterialUpdater&& other) noexcept
 	orig = other.orig;
 	other.orig = nullptr;
 	material = std::move(other.material);
+	internOnCommit = other.internOnCommit;
 }
 
 MaterialUpdater::~MaterialUpdater()
 {
 	if (orig && material) {
-		*orig = material;
+		if (internOnCommit) {
+			// The clone is only referenced here, so it's safe to hand it over to the intern cache
+			*orig = MaterialInternCache::get().intern(std::move(material));
+		} else {
+			*orig = std::move(material);
+		}
 	}
 }
 
@@ -612,6 +640,7 @@ MaterialUpdater& MaterialUpdater::operator=(MaterialUpdater&& other) noexcept
 		orig = other.orig;
 		other.orig = nullptr;
 		material = std::move(other.material);
+		internOnCommit = other.internOnCommit;
 	}
 	return *this;
 }
@@ -621,6 +650,12 @@ bool MaterialUpdater::isValid() const
 	return orig != nullptr;
 }
 
+MaterialUpdater& MaterialUpdater::intern()
+{
+	internOnCommit = true;
+	return *this;
+}
+
 MaterialUpdater& MaterialUpdater::set(std::string_view name, const std::shared_ptr<const Texture>& texture)
 {
 	if (material || getOriginalMaterial().getTexture(name) != texture) {
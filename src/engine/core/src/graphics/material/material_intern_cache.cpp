@@ -0,0 +1,116 @@
+#include "halley/graphics/material/material_intern_cache.h"
+#include "halley/graphics/material/material.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t sweepInterval = 1024;
+}
+
+MaterialInternCache& MaterialInternCache::get()
+{
+	static MaterialInternCache cache;
+	return cache;
+}
+
+std::shared_ptr<const Material> MaterialInternCache::intern(std::shared_ptr<const Material> material)
+{
+	if (!material) {
+		return material;
+	}
+
+	const auto hash = material->getFullHash();
+
+	std::unique_lock lock(mutex);
+	++internCalls;
+
+	auto& bucket = materials[hash];
+	for (const auto& entry: bucket) {
+		// Locking keeps the candidate's definition and textures alive, so their addresses (which are part of the hash) can't have been reused
+		if (auto existing = entry.lock()) {
+			if (existing == material || isSame(*existing, *material)) {
+				++hits;
+				return existing;
+			}
+		}
+	}
+
+	std_ex::erase_if(bucket, [] (const std::weak_ptr<const Material>& e) { return e.expired(); });
+	bucket.push_back(material);
+
+	if (++insertionsSinceSweep >= sweepInterval) {
+		sweep();
+	}
+
+	return material;
+}
+
+void MaterialInternCache::clear()
+{
+	std::unique_lock lock(mutex);
+	materials.clear();
+	insertionsSinceSweep = 0;
+}
+
+MaterialInternCache::Stats MaterialInternCache::getStats() const
+{
+	std::unique_lock lock(mutex);
+
+	Stats stats;
+	stats.internCalls = internCalls;
+	stats.hits = hits;
+	for (const auto& [hash, bucket]: materials) {
+		for (const auto& entry: bucket) {
+			if (const auto material = entry.lock()) {
+				const auto refs = static_cast<size_t>(material.use_count() - 1);
+				++stats.uniqueMaterials;
+				stats.references += refs;
+				stats.bytesSaved += (refs > 1 ? refs - 1 : 0) * getMaterialSize(*material);
+			}
+		}
+	}
+	return stats;
+}
+
+bool MaterialInternCache::isSame(const Material& a, const Material& b)
+{
+	if (!a.isCompatibleWith(b)) {
+		return false;
+	}
+
+	if (a.getPassesEnabled() != b.getPassesEnabled() || a.isDepthStencilEnabled() != b.isDepthStencilEnabled() || a.getStencilReferenceOverride() != b.getStencilReferenceOverride()) {
+		return false;
+	}
+
+	const auto blocksA = a.getDataBlocks();
+	const auto blocksB = b.getDataBlocks();
+	if (blocksA.size() != blocksB.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < blocksA.size(); ++i) {
+		if (blocksA[i] != blocksB[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t MaterialInternCache::getMaterialSize(const Material& material)
+{
+	size_t size = sizeof(Material);
+	for (const auto& block: material.getDataBlocks()) {
+		size += block.getData().size();
+	}
+	return size;
+}
+
+void MaterialInternCache::sweep()
+{
+	insertionsSinceSweep = 0;
+	std_ex::erase_if_value(materials, [] (Vector<std::weak_ptr<const Material>>& bucket)
+	{
+		std_ex::erase_if(bucket, [] (const std::weak_ptr<const Material>& e) { return e.expired(); });
+		return bucket.empty();
+	});
+}
@@ -52,7 +52,9 @@ void Painter::startRender()
 	prevDrawCalls = nDrawCalls;
 	prevTriangles = nTriangles;
 	prevVertices = nVertices;
+	prevUniqueMaterials = frameMaterials.size();
 	nDrawCalls = nTriangles = nVertices = 0;
+	frameMaterials.clear();
 	frameStart = frameEnd = 0;
 
 	refreshConstantBufferCache();
@@ -188,23 +190,11 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 	while (numSpritesLeft > 0) {
 		const size_t numSprites = std::min(numSpritesLeft, maxSpritesPerCall);
 		const size_t numVertices = verticesPerSprite * numSprites;
-		const size_t vertPosOffset = material->getDefinition().getVertexPosOffset();
 
 		const auto result = addDrawData(material, numVertices, numSprites * 6, true);
 
 		const char* const src = static_cast<const char*>(vertexData) + offset;
-
-		for (size_t i = 0; i < numSprites; i++) {
-			for (size_t j = 0; j < verticesPerSprite; j++) {
-				const size_t srcOffset = i * result.vertexStride;
-				const size_t dstOffset = (i * verticesPerSprite + j) * result.vertexStride;
-				memcpy(result.dstVertex + dstOffset, src + srcOffset, result.vertexSize);
-
-				constexpr static Vector2f vertPosList[] = { Vector2f(0, 0), Vector2f(1, 0), Vector2f(1, 1), Vector2f(0, 1)};
-				const auto vertPos = Vector4f(vertPosList[j], vertPosList[j]);
-				memcpy(result.dstVertex + dstOffset + vertPosOffset, &vertPos, sizeof(vertPos));
-			}
-		}
+		expandSpriteVertices(material->getDefinition(), numSprites, src, result.dstVertex);
 
 		generateQuadIndices(result.firstIndex, numSprites, result.dstIndex);
 
@@ -213,6 +203,29 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 	}
 }
 
+void Painter::expandSpriteVertices(const MaterialDefinition& definition, size_t numSprites, const void* src, void* dst)
+{
+	constexpr size_t verticesPerSprite = 4;
+	const size_t vertexSize = definition.getVertexSize();
+	const size_t vertexStride = definition.getVertexStride();
+	const size_t vertPosOffset = definition.getVertexPosOffset();
+
+	const char* const srcBytes = static_cast<const char*>(src);
+	char* const dstBytes = static_cast<char*>(dst);
+
+	for (size_t i = 0; i < numSprites; i++) {
+		for (size_t j = 0; j < verticesPerSprite; j++) {
+			const size_t srcOffset = i * vertexStride;
+			const size_t dstOffset = (i * verticesPerSprite + j) * vertexStride;
+			memcpy(dstBytes + dstOffset, srcBytes + srcOffset, vertexSize);
+
+			constexpr static Vector2f vertPosList[] = { Vector2f(0, 0), Vector2f(1, 0), Vector2f(1, 1), Vector2f(0, 1)};
+			const auto vertPos = Vector4f(vertPosList[j], vertPosList[j]);
+			memcpy(dstBytes + dstOffset + vertPosOffset, &vertPos, sizeof(vertPos));
+		}
+	}
+}
+
 void Painter::drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData)
 {
 	Expects(vertexData != nullptr);
@@ -770,6 +783,10 @@ void Painter::executeDrawPrimitives(const Material& material, size_t numVertices
 	// Load material uniforms
 	setMaterialData(material);
 
+	if (logging) {
+		frameMaterials.insert(&material);
+	}
+
 	// Go through each pass
 	for (int i = 0; i < material.getDefinition().getNumPasses(); i++) {
 		if (material.isPassEnabled(i)) {
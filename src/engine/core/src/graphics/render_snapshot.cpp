@@ -3,14 +3,60 @@
 #include "halley/graphics/render_context.h"
 #include "halley/graphics/material/material_definition.h"
 #include "halley/graphics/render_target/render_target_texture.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/resources/resources.h"
 #include "halley/support/logger.h"
 using namespace Halley;
 
+namespace {
+	constexpr uint32_t snapshotFileMagic = 0x504E5348; // "HSNP"
+	constexpr uint32_t snapshotFileVersion = 1;
+
+	// Stands in for the render targets of a loaded snapshot, which only exist in the game that captured it
+	class SnapshotRenderTarget final : public RenderTarget {
+	public:
+		String name;
+		Rect4i viewPort;
+		bool projectionFlipVertical = false;
+		bool viewportFlipVertical = false;
+		bool colourBuffer = true;
+		bool depthBuffer = false;
+
+		String getName() const override { return name; }
+		Rect4i getViewPort() const override { return viewPort; }
+		bool getProjectionFlipVertical() const override { return projectionFlipVertical; }
+		bool getViewportFlipVertical() const override { return viewportFlipVertical; }
+		bool hasColourBuffer(int attachmentNumber) const override { return colourBuffer && attachmentNumber == 0; }
+		bool hasDepthBuffer() const override { return depthBuffer; }
+	};
+
+	template <typename T>
+	void serializeRaw(Serializer& s, const Vector<T>& values)
+	{
+		s << static_cast<uint32_t>(values.size());
+		s << gsl::as_bytes(gsl::span<const T>(values));
+	}
+
+	template <typename T>
+	void deserializeRaw(Deserializer& s, Vector<T>& values)
+	{
+		uint32_t size;
+		s >> size;
+		if (size_t(size) * sizeof(T) > s.getBytesLeft()) {
+			throw Exception("Invalid render snapshot file, data is truncated", HalleyExceptions::Graphics);
+		}
+		values.resize(size);
+		s >> gsl::as_writable_bytes(gsl::span<T>(values));
+	}
+}
+
 RenderSnapshot::RenderSnapshot()
 	: pendingTimestamps(0)
 {
 }
 
+RenderSnapshot::~RenderSnapshot() = default;
+
 void RenderSnapshot::start()
 {
 	commands.clear();
@@ -225,6 +271,340 @@ RenderSnapshot::PlaybackResult RenderSnapshot::playback(Painter& painter, std::o
 	return PlaybackResult{ finalRenderTarget ? finalRenderTarget->getName() : "" };
 }
 
+void RenderSnapshot::replay(Painter& painter, bool batched) const
+{
+	painter.stopRecording();
+
+	const auto startCamera = painter.camera;
+	const auto startRenderTarget = painter.activeRenderTarget;
+
+	painter.resetState();
+
+	for (const auto& command: commands) {
+		for (const auto& [type, idx]: command) {
+			if (batched && type != CommandType::Draw) {
+				painter.flush();
+			}
+
+			switch (type) {
+			case CommandType::Bind:
+				playBind(painter, bindDatas[idx]);
+				break;
+
+			case CommandType::Unbind:
+				playUnbind(painter);
+				break;
+
+			case CommandType::Clear:
+				playClear(painter, clearDatas[idx]);
+				break;
+
+			case CommandType::SetClip:
+				playSetClip(painter, setClipDatas[idx]);
+				break;
+
+			case CommandType::Draw:
+				if (batched) {
+					const auto& data = drawDatas[idx];
+					painter.draw(data.material, data.numVertices, data.vertexData.data(), data.indices, data.primitive);
+				} else {
+					playDraw(painter, drawDatas[idx], {});
+				}
+				break;
+
+			case CommandType::Undefined:
+				break;
+			}
+		}
+	}
+
+	painter.flush();
+	painter.doUnbind();
+	painter.doBind(startCamera, *startRenderTarget);
+	painter.setClip(Rect4i(), false);
+}
+
+size_t RenderSnapshot::getNumDrawCalls() const
+{
+	return drawDatas.size();
+}
+
+size_t RenderSnapshot::getNumTriangles() const
+{
+	size_t result = 0;
+	for (const auto& draw: drawDatas) {
+		result += draw.indices.size() / 3;
+	}
+	return result;
+}
+
+Bytes RenderSnapshot::toBytes() const
+{
+	// Render targets and materials are shared by many commands, so store each once and refer to them by index
+	Vector<const RenderTarget*> renderTargets;
+	Vector<uint32_t> bindTargetIdx;
+	for (const auto& bind: bindDatas) {
+		const auto iter = std::find(renderTargets.begin(), renderTargets.end(), bind.renderTarget);
+		bindTargetIdx.push_back(static_cast<uint32_t>(iter - renderTargets.begin()));
+		if (iter == renderTargets.end()) {
+			renderTargets.push_back(bind.renderTarget);
+		}
+	}
+
+	Vector<const Material*> materials;
+	HashMap<uint64_t, Vector<uint32_t>> materialsByHash;
+	Vector<uint32_t> drawMaterialIdx;
+	for (const auto& draw: drawDatas) {
+		auto& candidates = materialsByHash[draw.material->getFullHash()];
+		const auto iter = std::find_if(candidates.begin(), candidates.end(), [&] (uint32_t idx) { return *materials[idx] == *draw.material; });
+		if (iter != candidates.end()) {
+			drawMaterialIdx.push_back(*iter);
+		} else {
+			const auto idx = static_cast<uint32_t>(materials.size());
+			materials.push_back(draw.material.get());
+			candidates.push_back(idx);
+			drawMaterialIdx.push_back(idx);
+		}
+	}
+
+	return Serializer::toBytes([&] (Serializer& s)
+	{
+		s << snapshotFileMagic << snapshotFileVersion;
+
+		s << static_cast<uint32_t>(renderTargets.size());
+		for (const auto* renderTarget: renderTargets) {
+			s << renderTarget->getName() << renderTarget->getViewPort();
+			s << renderTarget->getProjectionFlipVertical() << renderTarget->getViewportFlipVertical();
+			s << renderTarget->hasColourBuffer(0) << renderTarget->hasDepthBuffer();
+		}
+
+		s << static_cast<uint32_t>(materials.size());
+		for (const auto* material: materials) {
+			s << material->getDefinition().getName();
+			s << static_cast<uint8_t>(material->getPassesEnabled().to_ulong());
+			s << material->getStencilReferenceOverride() << material->isDepthStencilEnabled();
+
+			const auto blocks = material->getDataBlocks();
+			s << static_cast<uint32_t>(blocks.size());
+			for (const auto& block: blocks) {
+				// Same layout as Bytes. SharedExternal blocks live in the engine, and are always empty here.
+				s << static_cast<uint32_t>(block.getData().size_bytes()) << block.getData();
+			}
+
+			s << static_cast<uint32_t>(material->getNumTextureUnits());
+			for (size_t i = 0; i < material->getNumTextureUnits(); ++i) {
+				s << material->getTexUnitAssetId(static_cast<int>(i));
+			}
+		}
+
+		s << static_cast<uint32_t>(commands.size());
+		for (const auto& command: commands) {
+			s << static_cast<uint32_t>(command.size());
+			for (const auto& [type, idx]: command) {
+				s << type << idx;
+			}
+		}
+
+		s << static_cast<uint32_t>(bindDatas.size());
+		for (size_t i = 0; i < bindDatas.size(); ++i) {
+			s << bindDatas[i].camera << bindTargetIdx[i];
+		}
+
+		s << static_cast<uint32_t>(setClipDatas.size());
+		for (const auto& clip: setClipDatas) {
+			s << clip.rect << clip.enable;
+		}
+
+		s << static_cast<uint32_t>(clearDatas.size());
+		for (const auto& clear: clearDatas) {
+			s << clear.colour << clear.depth << clear.stencil;
+		}
+
+		s << static_cast<uint32_t>(drawDatas.size());
+		for (size_t i = 0; i < drawDatas.size(); ++i) {
+			const auto& draw = drawDatas[i];
+			s << drawMaterialIdx[i] << static_cast<uint64_t>(draw.numVertices);
+			serializeRaw(s, draw.vertexData);
+			serializeRaw(s, draw.indices);
+			s << draw.primitive << draw.allIndicesAreQuads;
+		}
+	});
+}
+
+std::unique_ptr<RenderSnapshot> RenderSnapshot::fromBytes(gsl::span<const gsl::byte> bytes, Resources& resources)
+{
+	auto s = Deserializer(bytes);
+	auto result = std::make_unique<RenderSnapshot>();
+
+	uint32_t magic;
+	uint32_t version;
+	s >> magic >> version;
+	if (magic != snapshotFileMagic || version != snapshotFileVersion) {
+		throw Exception("Invalid render snapshot file, or unsupported version", HalleyExceptions::Graphics);
+	}
+
+	uint32_t nRenderTargets;
+	s >> nRenderTargets;
+	for (uint32_t i = 0; i < nRenderTargets; ++i) {
+		auto renderTarget = std::make_unique<SnapshotRenderTarget>();
+		s >> renderTarget->name >> renderTarget->viewPort;
+		s >> renderTarget->projectionFlipVertical >> renderTarget->viewportFlipVertical;
+		s >> renderTarget->colourBuffer >> renderTarget->depthBuffer;
+		result->loadedRenderTargets.push_back(std::move(renderTarget));
+	}
+
+	uint32_t nMaterials;
+	s >> nMaterials;
+	Vector<std::shared_ptr<Material>> materials;
+	for (uint32_t i = 0; i < nMaterials; ++i) {
+		String definitionName;
+		s >> definitionName;
+		if (!resources.exists<MaterialDefinition>(definitionName)) {
+			throw Exception("Render snapshot uses material \"" + definitionName + "\", which is not available", HalleyExceptions::Graphics);
+		}
+		auto material = std::make_shared<Material>(resources.get<MaterialDefinition>(definitionName));
+
+		uint8_t passesEnabled;
+		std::optional<uint8_t> stencilReference;
+		bool depthStencilEnabled;
+		s >> passesEnabled >> stencilReference >> depthStencilEnabled;
+		for (int pass = 0; pass < 8; ++pass) {
+			material->setPassEnabled(pass, (passesEnabled & (1 << pass)) != 0);
+		}
+		material->setStencilReferenceOverride(stencilReference);
+		material->setDepthStencilEnabled(depthStencilEnabled);
+
+		uint32_t nBlocks;
+		s >> nBlocks;
+		for (uint32_t j = 0; j < nBlocks; ++j) {
+			Bytes data;
+			s >> data;
+			if (!data.empty() && !material->setDataBlockData(j, gsl::as_bytes(gsl::span<const Byte>(data)))) {
+				Logger::logWarning("Render snapshot data block " + toString(j) + " doesn't match material \"" + definitionName + "\", ignoring.");
+			}
+		}
+
+		uint32_t nTextures;
+		s >> nTextures;
+		for (uint32_t j = 0; j < nTextures; ++j) {
+			String assetId;
+			s >> assetId;
+			if (assetId.isEmpty()) {
+				// Render target textures and other runtime textures can't be restored, so the material keeps its default
+				continue;
+			}
+			if (j < material->getNumTextureUnits() && resources.exists<Texture>(assetId)) {
+				material->set(j, resources.get<Texture>(assetId));
+			} else {
+				Logger::logWarning("Render snapshot texture \"" + assetId + "\" is not available, using default.");
+			}
+		}
+
+		materials.push_back(std::move(material));
+	}
+
+	// Counts are checked against what's left before allocating, each entry takes at least one byte per field
+	auto checkCount = [&] (size_t count, size_t minBytesEach)
+	{
+		if (count * minBytesEach > s.getBytesLeft()) {
+			throw Exception("Invalid render snapshot file, data is truncated", HalleyExceptions::Graphics);
+		}
+	};
+
+	uint32_t nCommands;
+	s >> nCommands;
+	checkCount(nCommands, 1);
+	result->commands.resize(nCommands);
+	for (auto& command: result->commands) {
+		uint32_t nEntries;
+		s >> nEntries;
+		checkCount(nEntries, 2);
+		command.resize(nEntries);
+		for (auto& [type, idx]: command) {
+			s >> type >> idx;
+		}
+	}
+
+	uint32_t nBinds;
+	s >> nBinds;
+	for (uint32_t i = 0; i < nBinds; ++i) {
+		auto& bind = result->bindDatas.emplace_back();
+		uint32_t renderTargetIdx;
+		s >> bind.camera >> renderTargetIdx;
+		if (renderTargetIdx >= result->loadedRenderTargets.size()) {
+			throw Exception("Invalid render snapshot file, bind " + toString(i) + " refers to missing render target " + toString(renderTargetIdx), HalleyExceptions::Graphics);
+		}
+		bind.renderTarget = result->loadedRenderTargets[renderTargetIdx].get();
+	}
+
+	uint32_t nClips;
+	s >> nClips;
+	for (uint32_t i = 0; i < nClips; ++i) {
+		auto& clip = result->setClipDatas.emplace_back();
+		s >> clip.rect >> clip.enable;
+	}
+
+	uint32_t nClears;
+	s >> nClears;
+	for (uint32_t i = 0; i < nClears; ++i) {
+		auto& clear = result->clearDatas.emplace_back();
+		s >> clear.colour >> clear.depth >> clear.stencil;
+	}
+
+	uint32_t nDraws;
+	s >> nDraws;
+	for (uint32_t i = 0; i < nDraws; ++i) {
+		auto& draw = result->drawDatas.emplace_back();
+		uint32_t materialIdx;
+		uint64_t numVertices;
+		s >> materialIdx >> numVertices;
+		if (materialIdx >= materials.size()) {
+			throw Exception("Invalid render snapshot file, draw " + toString(i) + " refers to missing material " + toString(materialIdx), HalleyExceptions::Graphics);
+		}
+		draw.material = materials[materialIdx];
+		draw.materialTemp = draw.material.get();
+		deserializeRaw(s, draw.vertexData);
+		deserializeRaw(s, draw.indices);
+		s >> draw.primitive >> draw.allIndicesAreQuads;
+
+		// Vertices and indices are handed straight to the GPU on replay
+		const auto stride = draw.material->getDefinition().getVertexStride();
+		const bool validIndices = std::all_of(draw.indices.begin(), draw.indices.end(), [&] (IndexType idx) { return idx < numVertices; });
+		if (draw.primitive != PrimitiveType::Triangle || numVertices > draw.vertexData.size() / std::max(stride, size_t(1)) || !validIndices) {
+			throw Exception("Invalid render snapshot file, draw " + toString(i) + " has inconsistent vertex data", HalleyExceptions::Graphics);
+		}
+		draw.numVertices = static_cast<size_t>(numVertices);
+	}
+
+	// Commands refer to the arrays above by index, so check them all before anything gets replayed
+	for (const auto& command: result->commands) {
+		for (const auto& [type, idx]: command) {
+			const auto count = [&] () -> std::optional<size_t>
+			{
+				switch (type) {
+				case CommandType::Undefined:
+				case CommandType::Unbind:
+					return std::numeric_limits<size_t>::max();
+				case CommandType::Bind:
+					return result->bindDatas.size();
+				case CommandType::SetClip:
+					return result->setClipDatas.size();
+				case CommandType::Clear:
+					return result->clearDatas.size();
+				case CommandType::Draw:
+					return result->drawDatas.size();
+				}
+				return std::nullopt;
+			}();
+			if (!count || idx >= *count) {
+				throw Exception("Invalid render snapshot file, command " + toString(static_cast<int>(type)) + " refers to missing entry " + toString(idx), HalleyExceptions::Graphics);
+			}
+		}
+	}
+
+	return result;
+}
+
 void RenderSnapshot::addPendingTimestamp()
 {
 	++pendingTimestamps;
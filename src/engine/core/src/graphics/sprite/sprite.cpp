@@ -4,6 +4,7 @@
 #include "halley/graphics/painter.h"
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
+#include "halley/graphics/material/material_intern_cache.h"
 #include "halley/graphics/material/material_parameter.h"
 #include "halley/graphics/texture.h"
 #include "halley/resources/resources.h"
@@ -339,7 +340,7 @@ Sprite& Sprite::setMaterial(std::shared_ptr<const Material> m)
 
 Sprite& Sprite::setMaterial(std::shared_ptr<const MaterialDefinition> definition)
 {
-	setMaterial(std::make_shared<Material>(definition));
+	setMaterial(MaterialInternCache::get().intern(std::make_shared<Material>(definition)));
 	return *this;
 }
 
@@ -378,7 +379,7 @@ Sprite& Sprite::setImage(std::shared_ptr<const Texture> image, std::shared_ptr<c
 
 	auto mat = std::make_shared<Material>(materialDefinition);
 	mat->set(0, image);
-	setMaterial(mat);
+	setMaterial(MaterialInternCache::get().intern(std::move(mat)));
 	return *this;
 }
 
@@ -408,7 +409,7 @@ Sprite& Sprite::setImage(const SpriteResource& sprite, std::shared_ptr<const Mat
 {
 	auto mat = std::make_shared<Material>(materialDefinition);
 	mat->set(0, sprite);
-	setMaterial(mat);
+	setMaterial(MaterialInternCache::get().intern(std::move(mat)));
 	doSetSprite(sprite.getSprite(), true);
 	
 #ifdef ENABLE_HOT_RELOAD
@@ -1,6 +1,7 @@
 #include "halley/graphics/sprite/sprite_painter.h"
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/painter.h"
+#include "halley/data_structures/frame_allocator.h"
 #include <gsl/gsl>
 
 #include "halley/graphics/material/material.h"
@@ -10,6 +11,90 @@
 
 using namespace Halley;
 
+namespace {
+	struct BatchOrderEntry {
+		uint32_t idx = 0;
+		bool assigned = false;
+		Rect4f bounds;
+
+		BatchOrderEntry(uint32_t idx = 0, Rect4f bounds = {})
+			: idx(idx)
+			, bounds(bounds)
+		{}
+	};
+
+	// Goes through everyone in order, pulling later entries forward to join the current one when they're compatible,
+	// as long as they don't overlap anything they'd be jumping over. Barriers never join, nor get jumped over.
+	template <typename Result, typename Entries, typename Skipped, typename IsBarrier, typename IsCompatible>
+	Result makeBatchedOrder(Result result, Entries& entries, Skipped& skipped, IsBarrier isBarrier, IsCompatible isCompatible)
+	{
+		constexpr int maxSkipsInARow = 16;
+		const auto n = static_cast<uint32_t>(entries.size());
+
+		result.reserve(entries.size());
+
+		auto overlapsAny = [&](const Rect4f& a, const Rect4f bCombined)
+		{
+			if (skipped.empty() || !a.overlaps(bCombined)) {
+				return false;
+			}
+
+			for (const auto& b: skipped) {
+				if (a.overlaps(b)) {
+					return true;
+				}
+			}
+			return false;
+		};
+
+		for (uint32_t i = 0; i < n; ++i) {
+			auto& entry = entries[i];
+			if (entry.assigned) {
+				continue;
+			}
+
+			// Add to result
+			result.push_back(entry.idx);
+			entry.assigned = true;
+
+			if (isBarrier(entry.idx)) {
+				continue;
+			}
+
+			// Look ahead and see if anyone else can join
+			skipped.clear();
+			Rect4f combinedSkipped;
+			int skipsInARow = 0;
+			for (uint32_t j = i + 1; j < n; ++j) {
+				auto& other = entries[j];
+				if (other.assigned) {
+					continue;
+				}
+
+				if (isBarrier(other.idx)) {
+					break;
+				}
+
+				if (isCompatible(entry.idx, other.idx) && !overlapsAny(other.bounds, combinedSkipped)) {
+					result.push_back(other.idx);
+					other.assigned = true;
+					skipsInARow = 0;
+				} else {
+					combinedSkipped = skipped.empty() ? other.bounds : combinedSkipped.merge(other.bounds);
+					skipped.push_back(other.bounds);
+					++skipsInARow;
+
+					if (skipsInARow >= maxSkipsInARow) {
+						break;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+}
+
 SpritePainterEntry::SpritePainterEntry(gsl::span<const Sprite> sprites, int mask, int layer, float tieBreaker, size_t insertOrder, std::optional<Rect4f> clip)
 	: ptr(sprites.empty() ? nullptr : &sprites[0])
 	, count(uint32_t(sprites.size()))
@@ -153,7 +238,10 @@ bool SpritePainterEntry::isCompatibleWith(const SpritePainterEntry& other, const
 			return true;
 		}
 
-		return s0.getMaterial().isCompatibleWith(s1.getMaterial());
+		// Interned materials are shared, so most compatible pairs are the same instance
+		const auto& m0 = s0.getMaterialPtr();
+		const auto& m1 = s1.getMaterialPtr();
+		return m0 == m1 || m0->isCompatibleWith(*m1);
 	} else if (type == SpritePainterEntryType::TextCached || type == SpritePainterEntryType::TextRef) {
 		return getTexts(cachedText)[0].isCompatibleWith(other.getTexts(cachedText)[0]);
 	} else {
@@ -161,6 +249,137 @@ bool SpritePainterEntry::isCompatibleWith(const SpritePainterEntry& other, const
 	}
 }
 
+void RetainedSpriteLayer::add(const Sprite& sprite, float tieBreaker)
+{
+	sprites.push_back(sprite.clone(false));
+	tieBreakers.push_back(tieBreaker);
+	batches.reset();
+}
+
+void RetainedSpriteLayer::add(gsl::span<const Sprite> newSprites, float tieBreaker)
+{
+	sprites.reserve(sprites.size() + newSprites.size());
+	tieBreakers.reserve(tieBreakers.size() + newSprites.size());
+	for (const auto& sprite: newSprites) {
+		sprites.push_back(sprite.clone(false));
+		tieBreakers.push_back(tieBreaker);
+	}
+	batches.reset();
+}
+
+void RetainedSpriteLayer::clear()
+{
+	sprites.clear();
+	tieBreakers.clear();
+	batches.reset();
+}
+
+void RetainedSpriteLayer::invalidate()
+{
+	batches.reset();
+}
+
+size_t RetainedSpriteLayer::size() const
+{
+	return sprites.size();
+}
+
+bool RetainedSpriteLayer::isDirty() const
+{
+	return !batches;
+}
+
+const std::shared_ptr<const RetainedSpriteLayer::Batches>& RetainedSpriteLayer::getBatches()
+{
+	if (!batches) {
+		batches = build();
+	}
+	return batches;
+}
+
+std::shared_ptr<const RetainedSpriteLayer::Batches> RetainedSpriteLayer::build() const
+{
+	// Small enough for culling to be useful, and the painter merges consecutive batches with the same material anyway
+	constexpr size_t maxSpritesPerBatch = 1024;
+
+	auto canRetain = [] (const Sprite& sprite)
+	{
+		return !sprite.isSliced() && !sprite.getClip() && !sprite.getMaterial().getDefinition().hasAutoVariables();
+	};
+
+	// Sort by tie breaker, keeping insertion order
+	Vector<BatchOrderEntry> entries;
+	entries.reserve(sprites.size());
+	for (uint32_t i = 0; i < static_cast<uint32_t>(sprites.size()); ++i) {
+		if (sprites[i].hasMaterial() && sprites[i].isVisible()) {
+			entries.emplace_back(i, sprites[i].getAABB());
+		}
+	}
+	std::stable_sort(entries.begin(), entries.end(), [&] (const BatchOrderEntry& a, const BatchOrderEntry& b)
+	{
+		return tieBreakers[a.idx] < tieBreakers[b.idx];
+	});
+
+	// Retained quads can only be merged when their materials are identical, not just compatible, as they're drawn with a single one
+	Vector<Rect4f> skipped;
+	const auto order = makeBatchedOrder(Vector<uint32_t>(), entries, skipped, [] (uint32_t idx) { return false; }, [&] (uint32_t a, uint32_t b)
+	{
+		const auto& s0 = sprites[a];
+		const auto& s1 = sprites[b];
+		return canRetain(s0) && canRetain(s1) && (s0.getMaterialPtr() == s1.getMaterialPtr() || s0.getMaterial() == s1.getMaterial());
+	});
+
+	auto result = std::make_shared<Batches>();
+	size_t i = 0;
+	while (i < order.size()) {
+		const auto& first = sprites[order[i]];
+		const bool retained = canRetain(first);
+
+		// Find how far this batch goes
+		size_t end = i + 1;
+		while (end < order.size() && end - i < maxSpritesPerBatch) {
+			const auto& next = sprites[order[end]];
+			if (canRetain(next) != retained || (retained && next.getMaterialPtr() != first.getMaterialPtr() && next.getMaterial() != first.getMaterial())) {
+				break;
+			}
+			++end;
+		}
+
+		auto& batch = result->batches.emplace_back();
+		batch.material = first.getMaterialPtr();
+		batch.bounds = first.getAABB();
+		for (size_t j = i; j < end; ++j) {
+			batch.bounds = batch.bounds.merge(sprites[order[j]].getAABB());
+		}
+
+		if (retained) {
+			const auto& def = batch.material->getDefinition();
+			const size_t stride = def.getVertexStride();
+			Expects(stride == sizeof(SpriteVertexAttrib) + 16);
+
+			const size_t n = end - i;
+			Vector<char> spriteVertices(n * stride);
+			for (size_t j = 0; j < n; ++j) {
+				memcpy(spriteVertices.data() + j * stride, sprites[order[i + j]].getVertexAttrib(), stride);
+			}
+
+			batch.numVertices = n * 4;
+			batch.vertices.resize(batch.numVertices * stride);
+			Painter::expandSpriteVertices(def, n, spriteVertices.data(), batch.vertices.data());
+		} else {
+			batch.sprites.reserve(end - i);
+			for (size_t j = i; j < end; ++j) {
+				batch.sprites.push_back(sprites[order[j]].clone(false));
+			}
+		}
+
+		result->bounds = result->bounds ? result->bounds->merge(batch.bounds) : batch.bounds;
+		i = end;
+	}
+
+	return result;
+}
+
 SpritePainterMaterialParamUpdater::SpritePainterMaterialParamUpdater()
 {
 	setHandle("halley.texSize", [this] (MaterialUpdater& material, std::string_view uniformName, std::string_view autoVarArgs)
@@ -237,7 +456,6 @@ bool SpritePainterMaterialParamUpdater::needsToPreProcessessMaterial(const Sprit
 }
 
 SpritePainter::SpritePainter()
-	: memoryPool(256 * 1024)
 {
 }
 
@@ -267,7 +485,7 @@ void SpritePainter::clear()
 	sprites.clear();
 	cachedSprites.clear();
 	cachedText.clear();
-	memoryPool.reset();
+	retainedLayers.clear();
 }
 
 void SpritePainter::add(const Sprite& sprite, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
@@ -364,6 +582,16 @@ void SpritePainter::add(Rect4f bounds)
 	extraBounds.push_back(bounds);
 }
 
+void SpritePainter::add(RetainedSpriteLayer& retained, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
+{
+	Expects(mask >= 0);
+	if (retained.size() > 0) {
+		sprites.push_back(SpritePainterEntry(SpritePainterEntryType::Retained, retainedLayers.size(), 1, mask, layer, tieBreaker, sprites.size(), std::move(clip)));
+		retainedLayers.push_back(retained.getBatches());
+		dirty = true;
+	}
+}
+
 void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
 {
 	if (dirty) {
@@ -385,18 +613,20 @@ void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
 			draw(s.getTexts(cachedText), painter, view, s.getClip());
 		} else if (type == SpritePainterEntryType::Callback) {
 			draw(callbacks.at(s.getIndex()), painter, s.getClip());
+		} else if (type == SpritePainterEntryType::Retained) {
+			draw(*retainedLayers.at(s.getIndex()), painter, view, s.getClip());
 		}
 	}
 	painter.flush();
 }
 
-Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const
+VectorTemp<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const
 {
 	if (reorder) {
 		return getSpriteDrawOrderReordered(mask, view);
 	}
 
-	Vector<uint32_t> result;
+	auto result = FrameAllocator::makeVector<uint32_t>();
 	const auto nTotal = static_cast<uint32_t>(sprites.size());
 	for (uint32_t i = 0; i < nTotal; ++i) {
 		auto& s = sprites[i];
@@ -408,23 +638,11 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool r
 	return result;
 }
 
-Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f view) const
+VectorTemp<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f view) const
 {
-	struct Entry {
-		uint32_t idx = 0;
-		bool assigned = false;
-		Rect4f bounds;
-
-		Entry(uint32_t idx = 0, Rect4f bounds = {})
-			: idx(idx)
-			, bounds(bounds)
-		{}
-	};
-
-	auto entries = VectorTemp<Entry>(memoryPool);
-	auto skipped = VectorTemp<Rect4f>(memoryPool);
+	auto entries = FrameAllocator::makeVector<BatchOrderEntry>();
+	auto skipped = FrameAllocator::makeVector<Rect4f>();
 	skipped.reserve(64);
-	constexpr int maxSkipsInARow = 16;
 
 	// Generate filtered sprite draw order, and sprite bounds
 	const auto nTotal = static_cast<uint32_t>(sprites.size());
@@ -435,71 +653,15 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f vie
 			entries.emplace_back(i, s.getBounds(view, cachedSprites, cachedText));
 		}
 	}
-	const auto n = static_cast<uint32_t>(entries.size());
 
-	Vector<uint32_t> result;
-	result.reserve(entries.size());
-
-	auto overlapsAny = [](const Rect4f& a, const Rect4f bCombined, const VectorTemp<Rect4f>& bs)
+	return makeBatchedOrder(FrameAllocator::makeVector<uint32_t>(), entries, skipped, [&] (uint32_t idx)
 	{
-		if (bs.empty() || !a.overlaps(bCombined)) {
-			return false;
-		}
-
-		for (const auto& b: bs) {
-			if (a.overlaps(b)) {
-				return true;
-			}
-		}
-		return false;
-	};
-
-	// Go through everyone, adding to final list, including any re-ordering
-	for (uint32_t i = 0; i < n; ++i) {
-		auto& entry = entries[i];
-		if (entry.assigned) {
-			continue;
-		}
-
-		// Add to result
-		result.push_back(entry.idx);
-		entry.assigned = true;
-
-		if (sprites[entry.idx].getType() == SpritePainterEntryType::Callback) {
-			continue;
-		}
-
-		// Look ahead and see if anyone else can join
-		skipped.clear();
-		Rect4f combinedSkipped;
-		int skipsInARow = 0;
-		for (uint32_t j = i + 1; j < n; ++j) {
-			auto& other = entries[j];
-			if (other.assigned) {
-				continue;
-			}
-
-			if (sprites[other.idx].getType() == SpritePainterEntryType::Callback) {
-				break;
-			}
-
-			if (sprites[entry.idx].isCompatibleWith(sprites[other.idx], cachedSprites, cachedText) && !overlapsAny(other.bounds, combinedSkipped, skipped)) {
-				result.push_back(other.idx);
-				other.assigned = true;
-				skipsInARow = 0;
-			} else {
-				combinedSkipped = skipped.empty() ? other.bounds : combinedSkipped.merge(other.bounds);
-				skipped.push_back(other.bounds);
-				++skipsInARow;
-
-				if (skipsInARow >= maxSkipsInARow) {
-					break;
-				}
-			}
-		}
-	}
-
-	return result;
+		const auto type = sprites[idx].getType();
+		return type == SpritePainterEntryType::Callback || type == SpritePainterEntryType::Retained;
+	}, [&] (uint32_t a, uint32_t b)
+	{
+		return sprites[a].isCompatibleWith(sprites[b], cachedSprites, cachedText);
+	});
 }
 
 std::optional<Rect4f> SpritePainter::getBounds() const
@@ -531,6 +693,10 @@ std::optional<Rect4f> SpritePainter::getBounds() const
 			}
 		} else if (type == SpritePainterEntryType::Callback) {
 			// Not included
+		} else if (type == SpritePainterEntryType::Retained) {
+			if (const auto& bounds = retainedLayers.at(s.getIndex())->bounds) {
+				merge(*bounds, clip);
+			}
 		}
 	}
 
@@ -582,3 +748,24 @@ void SpritePainter::draw(const SpritePainterEntry::Callback& callback, Painter&
 		painter.setClip();
 	}
 }
+
+void SpritePainter::draw(const RetainedSpriteLayer::Batches& retained, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const
+{
+	for (const auto& batch: retained.batches) {
+		if (!batch.bounds.overlaps(view)) {
+			continue;
+		}
+
+		if (!batch.sprites.empty()) {
+			draw(batch.sprites, painter, view, clip);
+		} else if (waitForSpriteLoad || batch.material->areAllTexturesLoaded()) {
+			if (clip) {
+				painter.setRelativeClip(clip.value());
+			}
+			painter.drawQuads(batch.material, batch.numVertices, batch.vertices.data());
+			if (clip) {
+				painter.setClip();
+			}
+		}
+	}
+}
@@ -469,49 +469,32 @@ std::unique_ptr<Image> SpriteSheet::generateAtlas(Vector<ImageData>& images, Con
 	markDuplicates(images);
 
 	// Generate entries
-	int64_t totalImageArea = 0;
 	Vector<BinPackEntry> entries;
 	entries.reserve(images.size());
 	for (auto& img: images) {
 		if (!img.isDuplicate) {
-			auto size = img.clip.getSize();
-			totalImageArea += size.x * size.y;
-			entries.emplace_back(size, &img);
+			// Duplicates share the packed rect, so they all have to be fine with rotation
+			bool canRotate = img.canRotate();
+			for (const auto* dupe: img.duplicatesOfThis) {
+				canRotate = canRotate && dupe->canRotate();
+			}
+			entries.emplace_back(img.clip.getSize(), &img, canRotate);
 		}
 	}
 
-	// Figure out a reasonable pack size to start with
-	const int minSize = nextPowerOf2(static_cast<int>(sqrt(static_cast<double>(totalImageArea)))) / 2;
-	const int64_t guessArea = int64_t(minSize) * int64_t(minSize);
-	const int maxSize = 4096;
-	int curSize = std::min(maxSize, std::max(32, static_cast<int>(minSize)));
-
 	// Try packing
-	bool wide = guessArea > 2 * totalImageArea;
-	while (true) {
-		Vector2i size(curSize * (wide ? 2 : 1), curSize);
-		if (size.x > maxSize || size.y > maxSize) {
-			// Give up!
-			throw Exception("Unable to pack " + toString(images.size()) + " sprites in a reasonably sized atlas! curSize at " + toString(curSize) + ", maxSize is " + toString(maxSize) + ". Total image area is " + toString(totalImageArea) + " px^2, sqrt = " + toString(lround(sqrt(totalImageArea))) + " px.", HalleyExceptions::Tools);
-		}
-
-		//Logger::logInfo("Trying " + toString(size.x) + "x" + toString(size.y) + " px...");
-		//auto res = entries.size() < 50 ? BinPack::pack(entries, size) : BinPack::fastPack(entries, size);
-		auto res = BinPack::fastPack(entries, size);
-		if (res) {
-			// Found a pack
-			return makeAtlas(res.value(), spriteInfo, powerOfTwo);
-		} else {
-			// Try 64x64, then 128x64, 128x128, 256x128, etc
-			if (wide) {
-				wide = false;
-				curSize *= 2;
-			}
-			else {
-				wide = true;
-			}
+	const int maxSize = 4096;
+	auto res = BinPack::packSmallest(entries, Vector2i(maxSize, maxSize), powerOfTwo);
+	if (!res) {
+		int64_t totalImageArea = 0;
+		for (const auto& e: entries) {
+			totalImageArea += int64_t(e.size.x) * int64_t(e.size.y);
 		}
+		throw Exception("Unable to pack " + toString(images.size()) + " sprites in a reasonably sized atlas! maxSize is " + toString(maxSize) + ". Total image area is " + toString(totalImageArea) + " px^2, sqrt = " + toString(lround(sqrt(totalImageArea))) + " px.", HalleyExceptions::Tools);
 	}
+
+	Logger::logDev("Packed " + toString(entries.size()) + " sprites in a " + toString(res->size.x) + "x" + toString(res->size.y) + " atlas, " + toString(lround(res->occupancy)) + "% occupancy.");
+	return makeAtlas(res->results, spriteInfo, powerOfTwo);
 }
 
 std::unique_ptr<Image> SpriteSheet::makeAtlas(const Vector<BinPackResult>& result, ConfigNode& spriteInfo, bool powerOfTwo)
@@ -635,6 +618,12 @@ bool SpriteSheet::ImageData::operator==(const SpriteSheet::ImageData& other) con
 		&& img->getSize() == other.img->getSize();
 }
 
+bool SpriteSheet::ImageData::canRotate() const
+{
+	// Sliced sprites are drawn in parts, which don't support rotated texture coordinates
+	return allowRotation && slices == Vector4s();
+}
+
 bool SpriteSheet::ImageData::operator!=(const SpriteSheet::ImageData& other) const
 {
 	return !(*this == other);
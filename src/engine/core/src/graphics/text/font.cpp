@@ -1,4 +1,10 @@
 #include "halley/graphics/text/font.h"
+#include "halley/graphics/text/font_glyph_rasterizer.h"
+#include "halley/graphics/text/text_layout_cache.h"
+#include "halley/graphics/texture_descriptor.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/file_formats/image.h"
+#include "halley/support/logger.h"
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
 #include "halley/graphics/material/material_parameter.h"
@@ -10,6 +16,219 @@
 
 using namespace Halley;
 
+class Font::DynamicGlyphs {
+public:
+	DynamicGlyphs(String name, std::shared_ptr<IFontGlyphRasterizer> rasterizer, Vector2i atlasSize, Vector2i cellSize, std::shared_ptr<Texture> texture)
+		: name(std::move(name))
+		, rasterizer(std::move(rasterizer))
+		, texture(std::move(texture))
+		, completed(std::make_shared<Completed>())
+		, atlasSize(atlasSize)
+		, cellSize(cellSize)
+		, gridSize(atlasSize.x / std::max(cellSize.x, 1), atlasSize.y / std::max(cellSize.y, 1))
+	{
+		if (gridSize.x <= 0 || gridSize.y <= 0) {
+			throw Exception("Dynamic font atlas for \"" + this->name + "\" can't fit a single glyph.", HalleyExceptions::Graphics);
+		}
+
+		atlas = std::make_unique<Image>(Image::Format::RGBA, atlasSize);
+		atlas->clear(0);
+		blankCell = std::make_unique<Image>(Image::Format::RGBA, cellSize);
+		blankCell->clear(0);
+		slotOwners.resize(static_cast<size_t>(gridSize.x * gridSize.y), -1);
+		upload();
+	}
+
+	const Glyph* getGlyph(int code)
+	{
+		std::unique_lock lock(mutex);
+
+		auto iter = entries.find(code);
+		if (iter == entries.end()) {
+			// Misses are remembered too, so that characters the font doesn't have don't hit the rasterizer every time
+			Entry entry;
+			if (const auto metrics = rasterizer->getMetrics(code)) {
+				entry.glyph = std::make_unique<Glyph>(code, Rect4f(), Vector2f(), metrics->horizontalBearing, metrics->verticalBearing, metrics->advance, HashMap<int32_t, Vector2f>());
+			}
+			iter = entries.emplace(code, std::move(entry)).first;
+		}
+
+		auto& entry = iter->second;
+		if (!entry.glyph) {
+			return nullptr;
+		}
+
+		entry.lastUsed = ++accessCounter;
+		if (!entry.slot && !entry.pending) {
+			request(code, entry);
+		}
+		return entry.glyph.get();
+	}
+
+	std::pair<Rect4f, Vector2f> getImage(int code)
+	{
+		// Read under the lock, as update() can move or evict the glyph at any time
+		std::unique_lock lock(mutex);
+		const auto iter = entries.find(code);
+		if (iter == entries.end()) {
+			return {};
+		}
+		return { iter->second.area, iter->second.size };
+	}
+
+	uint64_t update()
+	{
+		Vector<std::pair<int, std::unique_ptr<Image>>> done;
+		{
+			std::unique_lock lock(completed->mutex);
+			if (completed->glyphs.empty()) {
+				return revision;
+			}
+			std::swap(done, completed->glyphs);
+		}
+
+		std::unique_lock lock(mutex);
+		std::optional<Rect4i> dirty;
+		for (auto& [code, image]: done) {
+			const auto iter = entries.find(code);
+			if (iter == entries.end() || !iter->second.glyph) {
+				continue;
+			}
+			auto& entry = iter->second;
+			entry.pending = false;
+			if (!image || entry.slot) {
+				continue;
+			}
+
+			const auto imageSize = image->getSize();
+			if (imageSize.x > cellSize.x || imageSize.y > cellSize.y) {
+				Logger::logWarning("Glyph " + toString(code) + " doesn't fit in the cells of dynamic font \"" + name + "\".", true);
+				continue;
+			}
+
+			const auto slot = allocateSlot();
+			if (!slot) {
+				Logger::logWarning("Dynamic font atlas for \"" + name + "\" is full.", true);
+				continue;
+			}
+
+			const auto pos = Vector2i(static_cast<int>(*slot) % gridSize.x, static_cast<int>(*slot) / gridSize.x) * cellSize;
+			atlas->blitFrom(pos, *blankCell);
+			atlas->blitFrom(pos, *image);
+
+			entry.slot = slot;
+			entry.area = Rect4f(Vector2f(pos), Vector2f(pos + imageSize)) / Vector2f(atlasSize);
+			entry.size = Vector2f(imageSize);
+			slotOwners[*slot] = code;
+
+			const auto cell = Rect4i(pos, pos + cellSize);
+			dirty = dirty ? dirty->merge(cell) : cell;
+		}
+
+		if (dirty) {
+			uploadRegion(*dirty);
+			++revision;
+		}
+		return revision;
+	}
+
+private:
+	struct Entry {
+		std::unique_ptr<Glyph> glyph; // Heap allocated, as references are held while entries is modified
+		Rect4f area; // Kept here rather than in glyph, as only getImage() reads these under the lock
+		Vector2f size;
+		std::optional<size_t> slot;
+		bool pending = false;
+		uint64_t lastUsed = 0;
+	};
+
+	struct Completed {
+		std::mutex mutex;
+		Vector<std::pair<int, std::unique_ptr<Image>>> glyphs;
+	};
+
+	String name;
+	std::shared_ptr<IFontGlyphRasterizer> rasterizer;
+	std::shared_ptr<Texture> texture;
+	std::shared_ptr<Completed> completed;
+	Vector2i atlasSize;
+	Vector2i cellSize;
+	Vector2i gridSize;
+	std::unique_ptr<Image> atlas;
+	std::unique_ptr<Image> blankCell;
+
+	std::mutex mutex;
+	HashMap<int, Entry> entries;
+	Vector<int> slotOwners;
+	uint64_t accessCounter = 0;
+	uint64_t revision = 1;
+
+	void request(int code, Entry& entry)
+	{
+		entry.pending = true;
+
+		// The task only holds on to what it needs, so it's fine for the font to go away before it runs
+		auto rasterize = [rasterizer = rasterizer, completed = completed, code] ()
+		{
+			auto image = rasterizer->rasterize(code);
+			std::unique_lock lock(completed->mutex);
+			completed->glyphs.emplace_back(code, std::move(image));
+		};
+
+		if (Executors::hasInstance()) {
+			Concurrent::execute(Executors::getCPUAux(), std::move(rasterize));
+		} else {
+			rasterize();
+		}
+	}
+
+	std::optional<size_t> allocateSlot()
+	{
+		std::optional<size_t> best;
+		uint64_t bestLastUsed = std::numeric_limits<uint64_t>::max();
+		for (size_t i = 0; i < slotOwners.size(); ++i) {
+			if (slotOwners[i] == -1) {
+				return i;
+			}
+			const auto& owner = entries.at(slotOwners[i]);
+			if (owner.lastUsed < bestLastUsed) {
+				best = i;
+				bestLastUsed = owner.lastUsed;
+			}
+		}
+
+		if (best) {
+			// Evict the least recently used glyph. It'll be requested again if it's still needed when sprites get regenerated.
+			auto& evicted = entries.at(slotOwners[*best]);
+			evicted.slot.reset();
+			evicted.area = Rect4f();
+			evicted.size = Vector2f();
+			slotOwners[*best] = -1;
+		}
+		return best;
+	}
+
+	void upload()
+	{
+		TextureDescriptor desc(atlasSize, TextureFormat::RGBA);
+		desc.pixelData = atlas->clone();
+		desc.useFiltering = true;
+		desc.canBeUpdated = true;
+		texture->startLoading();
+		texture->load(std::move(desc));
+	}
+
+	void uploadRegion(Rect4i region)
+	{
+		// Only send the cells that changed, unless the backend can't do partial updates
+		const auto offset = static_cast<size_t>(region.getTop() * atlasSize.x + region.getLeft()) * 4;
+		const auto bytes = gsl::as_bytes(atlas->getPixelBytes().subspan(offset));
+		if (!texture->updateRegion(region, bytes, atlasSize.x)) {
+			upload();
+		}
+	}
+};
+
 Font::Glyph::Glyph() {}
 
 Font::Glyph::Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance, HashMap<int32_t, Vector2f> kerning)
@@ -81,6 +300,22 @@ Font::Font(String name, String imageName, float ascender, float height, float si
 {
 }
 
+std::shared_ptr<Font> Font::makeDynamic(String name, std::shared_ptr<IFontGlyphRasterizer> rasterizer, Vector2i atlasSize, Resources& resources, VideoAPI& video)
+{
+	const auto info = rasterizer->getFontInfo();
+
+	auto texture = std::shared_ptr<Texture>(video.createTexture(atlasSize));
+	texture->setAssetId("dynamicFont/" + name);
+
+	auto font = std::make_shared<Font>(name, "", info.ascender, info.height, info.sizePt, 1.0f, atlasSize, info.smoothRadius, Vector<String>(), info.floorGlyphPosition);
+	font->dynamicGlyphs = std::make_shared<DynamicGlyphs>(std::move(name), std::move(rasterizer), atlasSize, info.cellSize, texture);
+	font->material = std::make_shared<Material>(resources.get<MaterialDefinition>("Halley/Text"));
+	font->material->set(0, texture);
+	font->buildLookupTables();
+
+	return font;
+}
+
 std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
 {
 	auto data = loader.getStatic(false);
@@ -103,6 +338,8 @@ std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
 void Font::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<Font&>(resource));
+	buildLookupTables();
+	TextLayoutCache::get().clear();
 }
 
 void Font::onLoaded(Resources& resources)
@@ -114,29 +351,50 @@ void Font::onLoaded(Resources& resources)
 
 std::pair<const Font::Glyph&, const Font&> Font::getGlyph(int code) const
 {
-	const auto& font = getFontForGlyph(code);
-	return { font.getGlyphHere(code), font };
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return { *glyph, *this };
+	}
+	for (const auto& font: fallbackFont) {
+		if (const auto* glyph = font->tryGetGlyphHere(code)) {
+			return { *glyph, *font };
+		}
+	}
+	return { getGlyphHere(code), *this };
 }
 
 const Font::Glyph& Font::getGlyphHere(int code) const
 {
-	auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
-		iter = glyphs.find(0);
-		if (iter == glyphs.end()) {
-			throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
-		}
-		return iter->second;
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return *glyph;
+	}
+	const auto* replacement = hasLookupTables ? replacementGlyph : tryGetGlyphHere(0);
+	if (!replacement) {
+		throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
+	}
+	return *replacement;
+}
+
+const Font::Glyph* Font::tryGetGlyphHere(int code) const
+{
+	const Glyph* glyph = nullptr;
+	if (code >= 0 && code < static_cast<int>(directGlyphs.size())) {
+		glyph = directGlyphs[code];
+	} else if (code >= directGlyphRange || !hasLookupTables) {
+		const auto iter = glyphs.find(code);
+		glyph = iter != glyphs.end() ? &iter->second : nullptr;
 	}
-	return iter->second;
+
+	if (!glyph && dynamicGlyphs) {
+		glyph = dynamicGlyphs->getGlyph(code);
+	}
+	return glyph;
 }
 
 const Font& Font::getFontForGlyph(int code) const
 {
-	const auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
+	if (!tryGetGlyphHere(code)) {
 		for (const auto& font: fallbackFont) {
-			if (font->glyphs.find(code) != font->glyphs.end()) {
+			if (font->tryGetGlyphHere(code)) {
 				return *font;
 			}
 		}
@@ -144,6 +402,21 @@ const Font& Font::getFontForGlyph(int code) const
 	return *this;
 }
 
+Vector2f Font::getKerning(const Glyph& prev, int32_t next) const
+{
+	if (!hasLookupTables) {
+		return prev.getKerning(next);
+	}
+
+	const auto begin = kerningPairs.begin() + prev.kerningStart;
+	const auto end = begin + prev.kerningCount;
+	const auto iter = std::lower_bound(begin, end, next, [] (const KerningPair& pair, int32_t code) { return pair.next < code; });
+	if (iter != end && iter->next == next) {
+		return iter->kerning;
+	}
+	return Vector2f();
+}
+
 float Font::getLineHeightAtSize(float size) const
 {
 	return height * size / sizePt;
@@ -196,7 +469,41 @@ bool Font::shouldFloorGlyphPosition() const
 
 void Font::addGlyph(const Glyph& glyph)
 {
+	// Inserting can move every glyph, so the tables are only rebuilt when loading. Until then, lookups go through the hash maps.
 	glyphs[glyph.charcode] = glyph;
+	directGlyphs.clear();
+	kerningPairs.clear();
+	replacementGlyph = nullptr;
+	hasLookupTables = false;
+}
+
+void Font::addFallback(std::shared_ptr<const Font> font)
+{
+	fallbackFont.push_back(std::move(font));
+}
+
+bool Font::isDynamic() const
+{
+	return !!dynamicGlyphs;
+}
+
+std::pair<Rect4f, Vector2f> Font::getGlyphImage(const Glyph& glyph) const
+{
+	// Dynamic fonts have no baked glyphs, so anything here came from dynamicGlyphs
+	if (dynamicGlyphs) {
+		return dynamicGlyphs->getImage(glyph.charcode);
+	}
+	return { glyph.area, glyph.size };
+}
+
+uint64_t Font::updateDynamicGlyphs() const
+{
+	// Revisions only ever go up, so the sum changes whenever any of them does
+	uint64_t revision = dynamicGlyphs ? dynamicGlyphs->update() : 0;
+	for (const auto& font: fallbackFont) {
+		revision += font->updateDynamicGlyphs();
+	}
+	return revision;
 }
 
 std::shared_ptr<Material> Font::getMaterial() const
@@ -238,10 +545,45 @@ void Font::deserialize(Deserializer& s)
 	for (auto& g: glyphs) {
 		g.second.charcode = g.first;
 	}
+	buildLookupTables();
 
 	//printGlyphs();
 }
 
+void Font::buildLookupTables()
+{
+	int maxDirect = -1;
+	size_t numKerningPairs = 0;
+	for (const auto& [code, glyph]: glyphs) {
+		if (code >= 0 && code < directGlyphRange) {
+			maxDirect = std::max(maxDirect, code);
+		}
+		numKerningPairs += glyph.kerning.size();
+	}
+
+	directGlyphs.clear();
+	directGlyphs.resize(static_cast<size_t>(maxDirect + 1), nullptr);
+	kerningPairs.clear();
+	kerningPairs.reserve(numKerningPairs);
+
+	for (auto& [code, glyph]: glyphs) {
+		if (code >= 0 && code < directGlyphRange) {
+			directGlyphs[code] = &glyph;
+		}
+
+		glyph.kerningStart = static_cast<uint32_t>(kerningPairs.size());
+		glyph.kerningCount = static_cast<uint32_t>(glyph.kerning.size());
+		for (const auto& [next, kerning]: glyph.kerning) {
+			kerningPairs.push_back(KerningPair{ next, kerning });
+		}
+		std::sort(kerningPairs.begin() + glyph.kerningStart, kerningPairs.end(), [] (const KerningPair& a, const KerningPair& b) { return a.next < b.next; });
+	}
+
+	const auto iter = glyphs.find(0);
+	replacementGlyph = iter != glyphs.end() ? &iter->second : nullptr;
+	hasLookupTables = true;
+}
+
 void Font::printGlyphs() const
 {
 	std::optional<Range<int>> curRange;
@@ -0,0 +1,138 @@
+#include "halley/graphics/text/text_layout_cache.h"
+#include "halley/utils/hash.h"
+
+using namespace Halley;
+
+namespace {
+	bool isSameFont(const std::weak_ptr<const Font>& a, const std::weak_ptr<const Font>& b)
+	{
+		return !a.owner_before(b) && !b.owner_before(a);
+	}
+}
+
+TextLayoutKey::TextLayoutKey(const StringUTF32& text, const std::shared_ptr<const Font>& font, const Vector<std::pair<size_t, std::shared_ptr<const Font>>>& fontOverrides,
+	const Vector<std::pair<size_t, std::optional<float>>>& fontSizeOverrides, float size, float scale, float lineSpacing, float align, Vector2f offset, Vector2f pixelOffset)
+	: text(text)
+	, font(font)
+	, fontSizeOverrides(fontSizeOverrides)
+	, size(size)
+	, scale(scale)
+	, lineSpacing(lineSpacing)
+	, align(align)
+	, offset(offset)
+	, pixelOffset(pixelOffset)
+{
+	Hash::Hasher hasher;
+	hasher.feedBytes(gsl::as_bytes(gsl::span<const char32_t>(text.data(), text.size())));
+	hasher.feed(font.get());
+	hasher.feed(size);
+	hasher.feed(scale);
+	hasher.feed(lineSpacing);
+	hasher.feed(align);
+	hasher.feed(offset);
+	hasher.feed(pixelOffset);
+
+	this->fontOverrides.reserve(fontOverrides.size());
+	for (const auto& [pos, f]: fontOverrides) {
+		this->fontOverrides.emplace_back(pos, f);
+		hasher.feed(pos);
+		hasher.feed(f.get());
+	}
+	for (const auto& [pos, s]: fontSizeOverrides) {
+		hasher.feed(pos);
+		hasher.feed(s.value_or(-1.0f));
+	}
+
+	hash = hasher.digest();
+}
+
+uint64_t TextLayoutKey::getHash() const
+{
+	return hash;
+}
+
+bool TextLayoutKey::operator==(const TextLayoutKey& other) const
+{
+	if (hash != other.hash || text != other.text || size != other.size || scale != other.scale || lineSpacing != other.lineSpacing || align != other.align
+		|| offset != other.offset || pixelOffset != other.pixelOffset || fontSizeOverrides != other.fontSizeOverrides || !isSameFont(font, other.font)) {
+		return false;
+	}
+
+	if (fontOverrides.size() != other.fontOverrides.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < fontOverrides.size(); ++i) {
+		if (fontOverrides[i].first != other.fontOverrides[i].first || !isSameFont(fontOverrides[i].second, other.fontOverrides[i].second)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TextLayoutCache& TextLayoutCache::get()
+{
+	static TextLayoutCache cache;
+	return cache;
+}
+
+void TextLayoutCache::setCapacity(size_t maxEntries)
+{
+	std::unique_lock lock(mutex);
+	capacity = maxEntries;
+	trim();
+}
+
+void TextLayoutCache::clear()
+{
+	std::unique_lock lock(mutex);
+	index.clear();
+	entries.clear();
+}
+
+size_t TextLayoutCache::getHits() const
+{
+	std::unique_lock lock(mutex);
+	return hits;
+}
+
+size_t TextLayoutCache::getMisses() const
+{
+	std::unique_lock lock(mutex);
+	return misses;
+}
+
+std::shared_ptr<const TextLayout> TextLayoutCache::tryGet(const TextLayoutKey& key)
+{
+	std::unique_lock lock(mutex);
+	const auto iter = index.find(key.getHash());
+	if (iter != index.end() && iter->second->key == key) {
+		entries.splice(entries.begin(), entries, iter->second);
+		++hits;
+		return iter->second->layout;
+	}
+	++misses;
+	return {};
+}
+
+void TextLayoutCache::put(const TextLayoutKey& key, std::shared_ptr<const TextLayout> layout)
+{
+	std::unique_lock lock(mutex);
+
+	// On a hash collision (or if another thread got here first), the newer entry replaces the old one
+	if (const auto iter = index.find(key.getHash()); iter != index.end()) {
+		entries.erase(iter->second);
+		index.erase(iter);
+	}
+
+	entries.push_front(Entry{ key, std::move(layout) });
+	index[key.getHash()] = entries.begin();
+	trim();
+}
+
+void TextLayoutCache::trim()
+{
+	while (entries.size() > capacity) {
+		index.erase(entries.back().key.getHash());
+		entries.pop_back();
+	}
+}
@@ -277,21 +277,66 @@ TextRenderer TextRenderer::clone() const
 	return *this;
 }
 
+void TextRenderer::updateDynamicGlyphs() const
+{
+	if (!font) {
+		return;
+	}
+
+	// Dynamic glyphs only change where they are in the atlas, never their metrics, so the layout stays valid
+	uint64_t revision = font->updateDynamicGlyphs();
+	for (const auto& [pos, f]: fontOverrides) {
+		if (f) {
+			revision += f->updateDynamicGlyphs();
+		}
+	}
+
+	if (revision != dynamicGlyphsRevision) {
+		dynamicGlyphsRevision = revision;
+		markSpritesDirty();
+	}
+}
+
 void TextRenderer::generateLayoutIfNeeded() const
 {
 	if (!font) {
 		return;
 	}
 
-	if (layoutDirty || positionDirty) {
-		generateLayout(text, &layoutCache, extents);
+	if (layoutDirty || !layout) {
+		const auto key = TextLayoutKey(text, font, fontOverrides, fontSizeOverrides, size, scale, lineSpacing, align, offset, pixelOffset);
+		layout = TextLayoutCache::get().getLayout(key, [&] ()
+		{
+			TextLayout result;
+			generateLayout(text, &result.glyphs, result.extents);
+			return result;
+		});
+		extents = layout->extents;
 		hasExtents = true;
-		positionDirty = false;
 		layoutDirty = false;
+		positionDirty = true;
+	}
+
+	if (positionDirty) {
+		applyLayoutPosition();
+		positionDirty = false;
 		glyphsDirty = true;
 	}
 }
 
+void TextRenderer::applyLayoutPosition() const
+{
+	const bool floorEnabled = font->shouldFloorGlyphPosition();
+
+	layoutCache.resize(layout->glyphs.size());
+	for (size_t i = 0; i < layoutCache.size(); ++i) {
+		auto& glyph = layoutCache[i];
+		glyph = layout->glyphs[i];
+		const auto lineOffset = position + glyph.lineAnchor;
+		glyph.pos += floorEnabled ? lineOffset.floor() : lineOffset;
+	}
+}
+
 void TextRenderer::generateGlyphsIfNeeded() const
 {
 	if (!font) {
@@ -312,6 +357,7 @@ void TextRenderer::generateGlyphsIfNeeded() const
 
 void TextRenderer::generateSprites() const
 {
+	updateDynamicGlyphs();
 	generateLayoutIfNeeded();
 	generateGlyphsIfNeeded();
 }
@@ -353,7 +399,7 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 		const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
 		const float curScale = getScale(fontForGlyph, *curFontSize);
 
-		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? lastGlyph->getKerning(c) : Vector2f();
+		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? fontForGlyph.getKerning(*lastGlyph, c) : Vector2f();
 		const Vector2f cursorPos = lineStartPos + curLineOffset + pixelOffset;
 		const Vector2f glyphPos = cursorPos + (kerning + glyph.horizontalBearing.flipVertical()) * curScale;
 		const float advance = (glyph.advance.x + kerning.x) * curScale;
@@ -380,12 +426,12 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 		lastFont = &fontForGlyph;
 
 		auto lineBreak = [&] {
-			// Line break, update previous characters!
+			// Line break, update previous characters! The position itself is only added later, see applyLayoutPosition()
 			if (layouts) {
-				const Vector2f lineOffset = floorAlign(position + Vector2f(0, curAscender) - curLineOffset * align);
+				const Vector2f lineAnchor = Vector2f(0, curAscender) - curLineOffset * align;
 				for (size_t j = firstIdxInCurLine; j <= i; j++) {
 					auto& layout = (*layouts)[j];
-					layout.pos += lineOffset;
+					layout.lineAnchor = lineAnchor;
 					layout.lineStartY = lineStartPos.y;
 					layout.lineEndY = lineStartPos.y + curLineHeight;
 				}
@@ -443,14 +489,15 @@ void TextRenderer::generateSprites(Vector<Sprite>& sprites, const Vector<GlyphLa
 		if (c != '\n') {
 			const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
 			const float curScale = getScale(fontForGlyph, *curFontSize);
+			const auto [glyphArea, glyphSize] = fontForGlyph.getGlyphImage(glyph);
 
 			const Vector2f glyphPos = layouts[i].pos;
 			const Vector2f renderPos = (glyphPos - position).rotate(angle) + position;
 
 			sprites.at(spritesInserted++) = Sprite()
 				.setMaterial(hasMaterialOverride ? getMaterial(fontForGlyph) : fontForGlyph.getMaterial())
-				.setSize(glyph.size)
-				.setTexRect(glyph.area)
+				.setSize(glyphSize)
+				.setTexRect(glyphArea)
 				.setPos(renderPos)
 				.setScale(curScale)
 				.setColour(curCol.getCurValue())
@@ -615,7 +662,7 @@ StringUTF32 TextRenderer::split(const StringUTF32& str, float maxWidth, std::fun
 
 			const auto& [glyph, f] = curFont->getGlyph(c);
 			const float scale = getScale(f, *curFontSize);
-			const auto kerning = lastFont == &f && lastGlyph ? lastGlyph->getKerning(c) : Vector2f();
+			const auto kerning = lastFont == &f && lastGlyph ? f.getKerning(*lastGlyph, c) : Vector2f();
 			const float w = accepted ? (glyph.advance.x + kerning.x) * scale : 0.0f;
 			curWidth += w;
 
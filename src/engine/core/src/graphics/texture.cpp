@@ -37,6 +37,21 @@ void Texture::load(TextureDescriptor desc)
 	}
 }
 
+bool Texture::updateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride)
+{
+	if (!descriptor.canBeUpdated || !Rect4i(Vector2i(), size).contains(region)) {
+		return false;
+	}
+
+	const auto bpp = static_cast<size_t>(TextureDescriptor::getBytesPerPixel(descriptor.format));
+	const auto needed = (static_cast<size_t>(region.getHeight() - 1) * stride + region.getWidth()) * bpp;
+	if (region.getWidth() <= 0 || region.getHeight() <= 0 || stride < region.getWidth() || data.size() < needed) {
+		return false;
+	}
+
+	return doUpdateRegion(region, data, stride);
+}
+
 void Texture::copyToTexture(Painter& painter, Texture& other) const
 {
 	if (getSize() != other.getSize()) {
@@ -85,6 +100,11 @@ void Texture::doLoad(TextureDescriptor& descriptor)
 {
 }
 
+bool Texture::doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride)
+{
+	return false;
+}
+
 void Texture::doCopyToTexture(Painter& painter, Texture& other) const
 {
 	Logger::logWarning("Copying to texture not implemented.");
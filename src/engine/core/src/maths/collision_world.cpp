@@ -0,0 +1,306 @@
+#include "halley/maths/collision_world.h"
+#include "halley/concurrency/concurrent.h"
+
+using namespace Halley;
+
+namespace {
+	constexpr uint32_t maxLeafSize = 4;
+	constexpr size_t maxTreeDepth = 64;
+	constexpr size_t minParallelQueries = 16;
+
+	bool overlaps(const Rect4f& a, const Rect4f& b)
+	{
+		return a.getLeft() <= b.getRight() && b.getLeft() <= a.getRight() && a.getTop() <= b.getBottom() && b.getTop() <= a.getBottom();
+	}
+
+	Rect4f getSweepBounds(const CollisionWorld::SweepQuery& query, float moveLen)
+	{
+		const auto end = query.pos + query.moveDir * moveLen;
+		return Rect4f(Vector2f::min(query.pos, end), Vector2f::max(query.pos, end)).grow(query.radius.x, query.radius.y, query.radius.x, query.radius.y);
+	}
+
+	// Squared distance from p to the segment a-b
+	float getSquaredDistanceToSegment(Vector2f p, Vector2f a, Vector2f b)
+	{
+		const auto ab = b - a;
+		const float lenSq = ab.squaredLength();
+		const float t = lenSq > 0 ? clamp((p - a).dot(ab) / lenSq, 0.0f, 1.0f) : 0.0f;
+		return (a + ab * t - p).squaredLength();
+	}
+}
+
+CollisionWorld::CollisionWorld() = default;
+
+CollisionWorld::ColliderId CollisionWorld::add(Polygon polygon, ColliderType type, uint32_t mask)
+{
+	ColliderId id;
+	if (freeList.empty()) {
+		id = static_cast<ColliderId>(colliders.size());
+		colliders.emplace_back();
+	} else {
+		id = freeList.back();
+		freeList.pop_back();
+	}
+
+	auto& collider = colliders[id];
+	collider.polygon = std::move(polygon);
+	collider.mask = mask;
+	collider.type = type;
+	collider.alive = true;
+	updateCollider(collider);
+	++nAlive;
+
+	getTree(type).needsRebuild = true;
+	return id;
+}
+
+void CollisionWorld::remove(ColliderId id)
+{
+	auto& collider = colliders.at(id);
+	Expects(collider.alive);
+
+	collider.alive = false;
+	collider.polygon = Polygon();
+	freeList.push_back(id);
+	--nAlive;
+
+	getTree(collider.type).needsRebuild = true;
+}
+
+void CollisionWorld::clear()
+{
+	colliders.clear();
+	freeList.clear();
+	staticTree = Tree();
+	dynamicTree = Tree();
+	nAlive = 0;
+}
+
+void CollisionWorld::setPolygon(ColliderId id, Polygon polygon)
+{
+	auto& collider = colliders.at(id);
+	Expects(collider.alive && collider.type == ColliderType::Dynamic);
+
+	collider.polygon = std::move(polygon);
+	updateCollider(collider);
+	dynamicTree.needsRefit = true;
+}
+
+void CollisionWorld::translate(ColliderId id, Vector2f offset)
+{
+	auto& collider = colliders.at(id);
+	Expects(collider.alive && collider.type == ColliderType::Dynamic);
+
+	collider.polygon.translate(offset);
+	updateCollider(collider);
+	dynamicTree.needsRefit = true;
+}
+
+const Polygon& CollisionWorld::getPolygon(ColliderId id) const
+{
+	return colliders.at(id).polygon;
+}
+
+CollisionWorld::ColliderType CollisionWorld::getType(ColliderId id) const
+{
+	return colliders.at(id).type;
+}
+
+size_t CollisionWorld::size() const
+{
+	return nAlive;
+}
+
+void CollisionWorld::update()
+{
+	for (auto* tree: { &staticTree, &dynamicTree }) {
+		const auto type = tree == &staticTree ? ColliderType::Static : ColliderType::Dynamic;
+		if (tree->needsRebuild) {
+			tree->build(colliders, type);
+		} else if (tree->needsRefit) {
+			tree->refit(colliders);
+		}
+	}
+}
+
+CollisionWorld::SweepResult CollisionWorld::sweep(const SweepQuery& query) const
+{
+	assert(!staticTree.needsRebuild && !dynamicTree.needsRebuild && !dynamicTree.needsRefit);
+
+	SweepResult result;
+	const auto bounds = getSweepBounds(query, query.moveLen);
+	sweepTree(staticTree, query, bounds, result);
+	sweepTree(dynamicTree, query, result.collided ? getSweepBounds(query, result.distance) : bounds, result);
+	return result;
+}
+
+void CollisionWorld::sweep(gsl::span<const SweepQuery> queries, Vector<SweepResult>& results) const
+{
+	results.resize(queries.size());
+	if (queries.size() >= minParallelQueries) {
+		Concurrent::parallelFor(queries.size(), [&] (size_t i)
+		{
+			results[i] = sweep(queries[i]);
+		});
+	} else {
+		for (size_t i = 0; i < queries.size(); ++i) {
+			results[i] = sweep(queries[i]);
+		}
+	}
+}
+
+CollisionWorld::Tree& CollisionWorld::getTree(ColliderType type)
+{
+	return type == ColliderType::Static ? staticTree : dynamicTree;
+}
+
+void CollisionWorld::updateCollider(Collider& collider)
+{
+	collider.aabb = collider.polygon.getAABB();
+	collider.circle = collider.polygon.getBoundingCircle();
+}
+
+void CollisionWorld::sweepTree(const Tree& tree, const SweepQuery& query, Rect4f sweepBounds, SweepResult& result) const
+{
+	if (tree.nodes.empty()) {
+		return;
+	}
+
+	const bool isCircle = query.radius.x == query.radius.y;
+	const float maxRadius = std::max(query.radius.x, query.radius.y);
+
+	std::array<uint32_t, maxTreeDepth> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const auto& node = tree.nodes[stack[--stackSize]];
+		if ((node.mask & query.mask) == 0 || !overlaps(node.aabb, sweepBounds)) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			// Visit the closest child first, as finding a hit early shrinks the sweep
+			const uint32_t left = static_cast<uint32_t>(&node - tree.nodes.data()) + 1;
+			const uint32_t right = node.first;
+			const float distLeft = (tree.nodes[left].aabb.getCenter() - query.pos).squaredLength();
+			const float distRight = (tree.nodes[right].aabb.getCenter() - query.pos).squaredLength();
+			if (distLeft < distRight) {
+				stack[stackSize++] = right;
+				stack[stackSize++] = left;
+			} else {
+				stack[stackSize++] = left;
+				stack[stackSize++] = right;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+			const auto id = tree.items[i];
+			const auto& collider = colliders[id];
+			if ((collider.mask & query.mask) == 0 || !overlaps(collider.aabb, sweepBounds)) {
+				continue;
+			}
+
+			// Bounding circle against the capsule swept by the query
+			const float moveLen = result.collided ? result.distance : query.moveLen;
+			const auto end = query.pos + query.moveDir * moveLen;
+			const float reach = collider.circle.getRadius() + maxRadius;
+			if (getSquaredDistanceToSegment(collider.circle.getCentre(), query.pos, end) > reach * reach) {
+				continue;
+			}
+
+			const auto col = isCircle
+				? collider.polygon.getCollisionWithSweepingCircle(query.pos, query.radius.x, query.moveDir, moveLen)
+				: collider.polygon.getCollisionWithSweepingEllipse(query.pos, query.radius, query.moveDir, moveLen);
+			if (col.collided && (!result.collided || col.distance < result.distance)) {
+				result.collided = true;
+				result.distance = col.distance;
+				result.normal = col.normal;
+				result.collider = id;
+				sweepBounds = getSweepBounds(query, col.distance);
+			}
+		}
+	}
+}
+
+void CollisionWorld::Tree::build(const Vector<Collider>& colliders, ColliderType type)
+{
+	nodes.clear();
+	items.clear();
+	needsRebuild = false;
+	needsRefit = false;
+
+	for (size_t i = 0; i < colliders.size(); ++i) {
+		if (colliders[i].alive && colliders[i].type == type) {
+			items.push_back(static_cast<ColliderId>(i));
+		}
+	}
+
+	if (!items.empty()) {
+		nodes.reserve(2 * items.size() / maxLeafSize + 1);
+		buildNode(colliders, 0, static_cast<uint32_t>(items.size()));
+	}
+}
+
+void CollisionWorld::Tree::refit(const Vector<Collider>& colliders)
+{
+	// Children always come after parents, so going backwards updates them first
+	for (size_t i = nodes.size(); i > 0; --i) {
+		updateNode(colliders, static_cast<uint32_t>(i - 1));
+	}
+	needsRefit = false;
+}
+
+uint32_t CollisionWorld::Tree::buildNode(const Vector<Collider>& colliders, uint32_t start, uint32_t end)
+{
+	const auto idx = static_cast<uint32_t>(nodes.size());
+	nodes.emplace_back();
+
+	if (end - start <= maxLeafSize) {
+		nodes[idx].first = start;
+		nodes[idx].count = end - start;
+	} else {
+		// Median split along the longest axis of the centres
+		auto centreBounds = Rect4f(colliders[items[start]].aabb.getCenter(), colliders[items[start]].aabb.getCenter());
+		for (uint32_t i = start + 1; i < end; ++i) {
+			centreBounds = centreBounds.merge(colliders[items[i]].aabb.getCenter());
+		}
+		const bool splitX = centreBounds.getWidth() >= centreBounds.getHeight();
+		const uint32_t mid = start + (end - start) / 2;
+		std::nth_element(items.begin() + start, items.begin() + mid, items.begin() + end, [&] (ColliderId a, ColliderId b)
+		{
+			const auto ca = colliders[a].aabb.getCenter();
+			const auto cb = colliders[b].aabb.getCenter();
+			return splitX ? (ca.x < cb.x || (ca.x == cb.x && a < b)) : (ca.y < cb.y || (ca.y == cb.y && a < b));
+		});
+
+		buildNode(colliders, start, mid);
+		const auto right = buildNode(colliders, mid, end);
+		nodes[idx].first = right;
+		nodes[idx].count = 0;
+	}
+
+	updateNode(colliders, idx);
+	return idx;
+}
+
+void CollisionWorld::Tree::updateNode(const Vector<Collider>& colliders, uint32_t idx)
+{
+	auto& node = nodes[idx];
+	if (node.count == 0) {
+		const auto& left = nodes[idx + 1];
+		const auto& right = nodes[node.first];
+		node.aabb = left.aabb.merge(right.aabb);
+		node.mask = left.mask | right.mask;
+	} else {
+		const auto& first = colliders[items[node.first]];
+		node.aabb = first.aabb;
+		node.mask = first.mask;
+		for (uint32_t i = node.first + 1; i < node.first + node.count; ++i) {
+			const auto& collider = colliders[items[i]];
+			node.aabb = node.aabb.merge(collider.aabb);
+			node.mask |= collider.mask;
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include "halley/net/entity/entity_network_remote_peer.h"
 #include "halley/net/entity/entity_network_session.h"
+#include "halley/data_structures/frame_allocator.h"
 #include "halley/entity/entity_factory.h"
 #include "halley/entity/world.h"
 #include "halley/support/logger.h"
@@ -37,8 +38,9 @@ void EntityNetworkRemotePeer::sendEntities(Time t, gsl::span<const EntityNetwork
 		e.second.alive = false;
 	}
 
-	Vector<EntityRef> toCreate;
-	Vector<std::pair<EntityRef, OutboundEntity*>> toUpdate;
+	// This runs as a task, so these come from the worker thread's own frame pool
+	auto toCreate = FrameAllocator::makeVector<EntityRef>();
+	auto toUpdate = FrameAllocator::makeVector<std::pair<EntityRef, OutboundEntity*>>();
 
 	for (auto entry: entityIds) {
 		if (entry.ownerId == peerId) {
@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "halley/bytes/compression.h"
+#include "halley/data_structures/frame_allocator.h"
 #include "halley/entity/data_interpolator.h"
 #include "halley/entity/entity_factory.h"
 #include "halley/entity/system.h"
@@ -81,12 +82,13 @@ void EntityNetworkSession::sendEntityUpdates(Time t, Rect4i viewRect, gsl::span<
 	}
 
 	// Update entities
-    Vector<Future<void>> tasks;
+    auto tasks = FrameAllocator::makeVector<Future<void>>();
+    tasks.reserve(peers.size());
 
     for (auto& peer : peers) {
-        tasks += Concurrent::execute([&]() {
+        tasks.push_back(Concurrent::execute([&]() {
             peer.sendEntities(t, entityIds, session->getClientSharedData<EntityClientSharedData>(peer.getPeerId()));
-        });
+        }));
     }
 
     Concurrent::whenAll(tasks.begin(), tasks.end()).wait();
@@ -118,4 +118,20 @@ void OSLinux::openURL(const String& url)
 	}
 }
 
-#endif
\ No newline at end of file
+uint64_t OSLinux::getMemoryUsage()
+{
+	// Second field of statm is the resident set size, in pages
+	FILE* file = fopen("/proc/self/statm", "r");
+	if (!file) {
+		return 0;
+	}
+
+	unsigned long long size = 0;
+	unsigned long long resident = 0;
+	const int nRead = fscanf(file, "%llu %llu", &size, &resident);
+	fclose(file);
+
+	return nRead == 2 ? static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+#endif
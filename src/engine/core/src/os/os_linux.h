@@ -34,6 +34,8 @@ namespace Halley {
 		Path parseProgramPath(const String&) override;
 
 		void openURL(const String& url) override;
+
+		uint64_t getMemoryUsage() override;
 	};
 }
 
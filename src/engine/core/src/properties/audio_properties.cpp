@@ -114,6 +114,7 @@ AudioBusProperties::AudioBusProperties(const ConfigNode& node)
 {
 	id = node["id"].asString();
 	children = node["children"].asVector<AudioBusProperties>();
+	maxVoices = node["maxVoices"].asOptional<int>();
 }
 
 ConfigNode AudioBusProperties::toConfigNode() const
@@ -121,6 +122,9 @@ ConfigNode AudioBusProperties::toConfigNode() const
 	ConfigNode::MapType result;
 	result["id"] = id;
 	result["children"] = children;
+	if (maxVoices) {
+		result["maxVoices"] = maxVoices;
+	}
 	return result;
 }
 
@@ -128,12 +132,14 @@ void AudioBusProperties::serialize(Serializer& s) const
 {
 	s << id;
 	s << children;
+	s << maxVoices;
 }
 
 void AudioBusProperties::deserialize(Deserializer& s)
 {
 	s >> id;
 	s >> children;
+	s >> maxVoices;
 }
 
 const String& AudioBusProperties::getId() const
@@ -156,6 +162,16 @@ gsl::span<AudioBusProperties> AudioBusProperties::getChildren()
 	return children;
 }
 
+std::optional<int> AudioBusProperties::getMaxVoices() const
+{
+	return maxVoices;
+}
+
+void AudioBusProperties::setMaxVoices(std::optional<int> value)
+{
+	maxVoices = value;
+}
+
 void AudioBusProperties::collectBusIds(Vector<String>& output) const
 {
 	output.push_back(id);
@@ -170,6 +186,8 @@ AudioProperties::AudioProperties(const ConfigNode& node)
 		variables = node["variables"].asVector<AudioVariableProperties>({});
 		switches = node["switches"].asVector<AudioSwitchProperties>({});
 		buses = node["buses"].asVector<AudioBusProperties>({});
+		maxVoices = node["maxVoices"].asOptional<int>();
+		virtualVoiceThreshold = node["virtualVoiceThreshold"].asFloat(0.001f);
 	}
 }
 
@@ -179,6 +197,10 @@ ConfigNode AudioProperties::toConfigNode() const
 	result["variables"] = variables;
 	result["switches"] = switches;
 	result["buses"] = buses;
+	if (maxVoices) {
+		result["maxVoices"] = maxVoices;
+	}
+	result["virtualVoiceThreshold"] = virtualVoiceThreshold;
 	return result;
 }
 
@@ -187,6 +209,8 @@ void AudioProperties::serialize(Serializer& s) const
 	s << switches;
 	s << variables;
 	s << buses;
+	s << maxVoices;
+	s << virtualVoiceThreshold;
 }
 
 void AudioProperties::deserialize(Deserializer& s)
@@ -194,6 +218,8 @@ void AudioProperties::deserialize(Deserializer& s)
 	s >> switches;
 	s >> variables;
 	s >> buses;
+	s >> maxVoices;
+	s >> virtualVoiceThreshold;
 }
 
 gsl::span<const AudioSwitchProperties> AudioProperties::getSwitches() const
@@ -277,3 +303,23 @@ void AudioProperties::getBusIds(Vector<String>& result) const
 		b.collectBusIds(result);
 	}
 }
+
+std::optional<int> AudioProperties::getMaxVoices() const
+{
+	return maxVoices;
+}
+
+void AudioProperties::setMaxVoices(std::optional<int> value)
+{
+	maxVoices = value;
+}
+
+float AudioProperties::getVirtualVoiceThreshold() const
+{
+	return virtualVoiceThreshold;
+}
+
+void AudioProperties::setVirtualVoiceThreshold(float value)
+{
+	virtualVoiceThreshold = value;
+}
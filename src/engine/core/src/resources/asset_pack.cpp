@@ -5,6 +5,8 @@
 #include "halley/bytes/compression.h"
 #include "halley/maths/random.h"
 #include "halley/utils/encrypt.h"
+#include "halley/utils/hash.h"
+#include "halley/resources/resource.h"
 
 using namespace Halley;
 
@@ -14,6 +16,30 @@ void AssetPackHeader::init(size_t assetDbSize)
 	assetDbStartPos = sizeof(AssetPackHeader);
 	dataStartPos = assetDbStartPos + assetDbSize;
 	memset(iv.data(), 0, iv.size());
+	flags = 0;
+}
+
+void AssetPackHeader::initChunked(size_t dataSize, bool encrypted)
+{
+	memcpy(identifier.data(), "HALLEYP2", 8);
+	dataStartPos = sizeof(AssetPackHeader);
+	assetDbStartPos = dataStartPos + dataSize;
+	memset(iv.data(), 0, iv.size());
+	flags = encrypted ? flagEncrypted : 0;
+}
+
+bool AssetPackHeader::isChunked() const
+{
+	return memcmp(identifier.data(), "HALLEYP2", 8) == 0;
+}
+
+bool AssetPackHeader::isEncrypted() const
+{
+	if (isChunked()) {
+		return (flags & flagEncrypted) != 0;
+	} else {
+		return std::any_of(iv.begin(), iv.end(), [] (uint8_t v) { return v != 0; });
+	}
 }
 
 AssetPack::AssetPack()
@@ -42,16 +68,28 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, std::optional<
 	if (nRead != int(sizeof(header))) {
 		throw Exception("Unable to read header", HalleyExceptions::Resources);
 	}
-	if (memcmp(header.identifier.data(), "HALLEYPK", 8) != 0) {
+	chunked = header.isChunked();
+	if (!chunked && memcmp(header.identifier.data(), "HALLEYPK", 8) != 0) {
 		throw Exception("Asset pack is invalid (invalid identifier)", HalleyExceptions::Resources);
 	}
+	if (chunked && header.dataStartPos < sizeof(AssetPackHeader)) {
+		throw Exception("Asset pack is invalid (bad data position)", HalleyExceptions::Resources);
+	}
 	iv = header.iv;
+	encrypted = header.isEncrypted();
 	dataOffset = size_t(header.dataStartPos);
 
 	// Read asset database
 	{
-		const size_t assetDbSize = size_t(header.dataStartPos - header.assetDbStartPos);
-		auto assetDbBytes = Bytes(assetDbSize);
+		// Chunked packs have the database after the data
+		const size_t assetDbEnd = chunked ? totalSize : size_t(header.dataStartPos);
+		if (header.assetDbStartPos > assetDbEnd || assetDbEnd > totalSize) {
+			throw Exception("Asset pack is invalid (bad asset database position)", HalleyExceptions::Resources);
+		}
+		dataSize = chunked ? size_t(header.assetDbStartPos - header.dataStartPos) : totalSize - dataOffset;
+
+		auto assetDbBytes = Bytes(assetDbEnd - size_t(header.assetDbStartPos));
+		reader->seek(int64_t(header.assetDbStartPos), SEEK_SET);
 		nRead = reader->read(gsl::as_writable_bytes(gsl::span<Byte>(assetDbBytes)));
 		if (nRead != int(assetDbBytes.size())) {
 			throw Exception("Unable to read header", HalleyExceptions::Resources);
@@ -60,9 +98,7 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, std::optional<
 		Deserializer::fromBytes<AssetDatabase>(*assetDb, Compression::decompress(assetDbBytes));
 	}
 
-	std::array<char, 16> ivEmpty;
-	memset(ivEmpty.data(), 0, ivEmpty.size());
-	const bool hasCrypt = memcmp(iv.data(), ivEmpty.data(), iv.size()) != 0 && encryptionKey.has_value();
+	const bool hasCrypt = encrypted && encryptionKey.has_value();
 
 	if (preLoad || hasCrypt) {
 		readToMemory();
@@ -86,8 +122,12 @@ AssetPack& AssetPack::operator=(AssetPack&& other) noexcept
 
 	assetDb = std::move(other.assetDb);
 	dataOffset = other.dataOffset;
+	dataSize = other.dataSize;
 	reader = std::move(other.reader);
 	data = std::move(other.data);
+	iv = other.iv;
+	chunked = other.chunked;
+	encrypted = other.encrypted;
 	hasReader = !!reader;
 
 	other.hasReader = false;
@@ -118,7 +158,7 @@ const Bytes& AssetPack::getData() const
 
 Bytes AssetPack::writeOut() const
 {
-	auto assetDbBytes = Compression::compress(Serializer::toBytes(*assetDb));
+	auto assetDbBytes = serializeAssetDatabase(*assetDb);
 	AssetPackHeader header;
 	header.init(assetDbBytes.size());
 	header.iv = iv;
@@ -137,9 +177,7 @@ std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType
 	if (!assetInfo) {
 		return {};
 	}
-	auto ps = assetInfo->path.split(':');
-	size_t pos = size_t(ps.at(0).toInteger());
-	size_t size = size_t(ps.at(1).toInteger());
+	const auto [pos, size, hash] = parseChunkPath(assetInfo->path);
 
 	if (stream) {
 		return std::make_unique<ResourceDataStream>(path, [=] () -> std::unique_ptr<ResourceDataReader> {
@@ -170,22 +208,64 @@ void AssetPack::readToMemory()
 {
 	std::unique_lock<std::mutex> lock(readerMutex);
 	reader->seek(dataOffset, SEEK_SET);
-	data = reader->readAll();
+
+	// Chunked packs have the asset database after the data, so this can't just read to the end
+	data.resize(dataSize);
+	constexpr size_t maxReadSize = 256 * 1024 * 1024;
+	for (size_t pos = 0; pos < dataSize;) {
+		const int nRead = reader->read(gsl::as_writable_bytes(gsl::span<Byte>(data.data() + pos, std::min(maxReadSize, dataSize - pos))));
+		if (nRead <= 0) {
+			throw Exception("Unable to read asset pack data", HalleyExceptions::Resources);
+		}
+		pos += size_t(nRead);
+	}
+
 	hasReader = false;
 	reader.reset();
 }
 
 void AssetPack::encrypt(Encrypt::AESKey key)
 {
+	if (chunked) {
+		throw Exception("Chunked asset packs are encrypted one chunk at a time, with makeChunk()", HalleyExceptions::Resources);
+	}
+
 	// Generate IV
 	Random::getGlobal().getBytes(gsl::as_writable_bytes(gsl::span<uint8_t>(iv)));
+	encrypted = true;
 
 	data = Encrypt::encryptAES(iv, key, data);
 }
 
 void AssetPack::decrypt(Encrypt::AESKey key)
 {
-	data = Encrypt::decryptAES(iv, key, data);
+	if (chunked) {
+		decryptChunks(key);
+	} else {
+		data = Encrypt::decryptAES(iv, key, data);
+	}
+}
+
+void AssetPack::decryptChunks(Encrypt::AESKey key)
+{
+	for (const auto& typeName: EnumNames<AssetType>()()) {
+		const auto type = fromString<AssetType>(typeName);
+		if (!assetDb->hasDatabase(type)) {
+			continue;
+		}
+
+		for (const auto& [name, entry]: assetDb->getDatabase(type).getAssets()) {
+			const auto chunk = parseChunkPath(entry.path);
+			const auto encryptedSize = Encrypt::getEncryptedSize(chunk.size);
+			if (chunk.pos < chunkIVSize || chunk.pos + encryptedSize > data.size()) {
+				throw Exception("Asset \"" + name + "\" is out of pack bounds.", HalleyExceptions::Resources);
+			}
+
+			std::array<uint8_t, chunkIVSize> chunkIV;
+			memcpy(chunkIV.data(), data.data() + chunk.pos - chunkIVSize, chunkIVSize);
+			Encrypt::decryptAESInPlace(chunkIV, key, gsl::as_writable_bytes(gsl::span<Byte>(data.data() + chunk.pos, encryptedSize)));
+		}
+	}
 }
 
 void AssetPack::readData(size_t pos, gsl::span<gsl::byte> dst)
@@ -226,6 +306,57 @@ size_t AssetPack::getMemoryUsage() const
 	return sizeof(*this) + data.size() + assetDb->getMemoryUsage();
 }
 
+bool AssetPack::isChunked() const
+{
+	return chunked;
+}
+
+bool AssetPack::isEncrypted() const
+{
+	return encrypted;
+}
+
+Bytes AssetPack::makeChunk(gsl::span<const gsl::byte> assetData, std::optional<Encrypt::AESKey> key)
+{
+	if (!key) {
+		return Bytes(reinterpret_cast<const Byte*>(assetData.data()), reinterpret_cast<const Byte*>(assetData.data()) + assetData.size());
+	}
+
+	Bytes result(getChunkSize(assetData.size(), true));
+	std::array<uint8_t, chunkIVSize> chunkIV;
+	Random::getGlobal().getBytes(gsl::as_writable_bytes(gsl::span<uint8_t>(chunkIV)));
+	memcpy(result.data(), chunkIV.data(), chunkIVSize);
+	Encrypt::encryptAES(chunkIV, *key, assetData, result.byte_span().subspan(chunkIVSize));
+	return result;
+}
+
+size_t AssetPack::getChunkSize(size_t assetSize, bool encrypted)
+{
+	return encrypted ? chunkIVSize + Encrypt::getEncryptedSize(assetSize) : assetSize;
+}
+
+String AssetPack::makeChunkPath(size_t pos, size_t size, uint64_t hash)
+{
+	return toString(pos) + ":" + toString(size) + ":" + toString(hash, 16);
+}
+
+AssetPack::ChunkInfo AssetPack::parseChunkPath(const String& path)
+{
+	const auto ps = path.split(':');
+	ChunkInfo result;
+	result.pos = size_t(ps.at(0).toInteger64());
+	result.size = size_t(ps.at(1).toInteger64());
+	if (ps.size() >= 3) {
+		result.hash = std::stoull(ps[2].cppStr(), nullptr, 16);
+	}
+	return result;
+}
+
+Bytes AssetPack::serializeAssetDatabase(const AssetDatabase& assetDb)
+{
+	return Compression::compress(Serializer::toBytes(assetDb));
+}
+
 PackDataReader::PackDataReader(AssetPack& pack, size_t startPos, size_t fileSize)
 	: pack(pack)
 	, startPos(startPos)
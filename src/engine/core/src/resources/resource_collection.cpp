@@ -45,6 +45,27 @@ namespace {
 
 
 
+ResourceResidencyStats& ResourceResidencyStats::operator+=(const ResourceResidencyStats& other)
+{
+	hits += other.hits;
+	misses += other.misses;
+	evictions += other.evictions;
+	reloads += other.reloads;
+	bytesEvicted += other.bytesEvicted;
+	return *this;
+}
+
+String ResourceResidencyStats::toString() const
+{
+	return Halley::toString(hits) + " hits, " + Halley::toString(misses) + " misses (" + Halley::toString(reloads) + " reloads), "
+		+ Halley::toString(evictions) + " evictions (" + String::prettySize(bytesEvicted) + ")";
+}
+
+bool ResourceCollectionBase::EvictionCandidate::operator<(const EvictionCandidate& other) const
+{
+	return std::tie(priority, lastUse) < std::tie(other.priority, other.lastUse);
+}
+
 ResourceCollectionBase::ResourceCollectionBase(Resources& parent, AssetType type)
 	: parent(parent)
 	, type(type)
@@ -246,6 +267,8 @@ std::shared_ptr<Resource> ResourceCollectionBase::doGet(std::string_view assetId
 {
 	using namespace std::chrono_literals;
 
+	parent.recordAccess(type, assetId);
+
 	for (int i = 0; true; ++i) {
 		{
 			// Look in cache and return if it's there
@@ -253,7 +276,14 @@ std::shared_ptr<Resource> ResourceCollectionBase::doGet(std::string_view assetId
 			const auto res = resources.find(assetId);
 			if (res != resources.end()) {
 				// Found resource, all good
-				return res->second.res;
+				// LRU order and priority only matter for eviction, so without budgets the hit path doesn't touch any shared state
+				auto& wrapper = res->second;
+				if (parent.isTrackingResidency()) {
+					wrapper.lastUse = parent.nextAccessTick();
+					for (int p = wrapper.priority; p < static_cast<int>(priority) && !wrapper.priority.compare_exchange_weak(p, static_cast<int>(priority)); ) {}
+					++hits;
+				}
+				return wrapper.res;
 			}
 		}
 
@@ -285,7 +315,11 @@ std::shared_ptr<Resource> ResourceCollectionBase::doGet(std::string_view assetId
 			std::unique_lock lock(mutex);
 			resourcesLoading.erase(assetId);
 			if (loaded) {
-				resources.emplace(assetId, Wrapper(newRes, 0));
+				resources.emplace(assetId, Wrapper(newRes, 0, priority, parent.nextAccessTick(), true));
+				++misses;
+				if (evicted.erase(String(assetId)) > 0) {
+					++reloads;
+				}
 				resourceLoaded.notify_all();
 			}
 		}
@@ -314,7 +348,8 @@ void ResourceCollectionBase::setFallback(std::string_view assetId)
 }
 
 void ResourceCollectionBase::setResource(int curDepth, std::string_view name, std::shared_ptr<Resource> resource) {
-	resources.emplace(name, Wrapper(std::move(resource), curDepth));
+	// Resources set from outside can't be loaded back, so they're never evicted
+	resources.emplace(name, Wrapper(std::move(resource), curDepth, ResourceLoadPriority::High, parent.nextAccessTick(), false));
 }
 
 void ResourceCollectionBase::setResourceLoader(ResourceLoaderFunc loader)
@@ -326,3 +361,135 @@ void ResourceCollectionBase::setResourceEnumerator(ResourceEnumeratorFunc enumer
 {
 	resourceEnumerator = std::move(enumerator);
 }
+
+void ResourceCollectionBase::setMemoryBudget(std::optional<size_t> bytes)
+{
+	memoryBudget = bytes;
+	parent.updateResidencyTracking();
+}
+
+std::optional<size_t> ResourceCollectionBase::getMemoryBudget() const
+{
+	return memoryBudget;
+}
+
+ResourceMemoryUsage ResourceCollectionBase::enforceMemoryBudget()
+{
+	if (!memoryBudget) {
+		return {};
+	}
+
+	Vector<EvictionCandidate> candidates;
+	const size_t total = collectEvictionCandidates(candidates);
+	if (total <= *memoryBudget) {
+		return {};
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	ResourceMemoryUsage freed;
+	const size_t toFree = total - *memoryBudget;
+	for (const auto& candidate: candidates) {
+		if (freed.getTotal() >= toFree) {
+			break;
+		}
+		freed += evict(candidate.assetId);
+	}
+	return freed;
+}
+
+void ResourceCollectionBase::pin(std::string_view assetId)
+{
+	std::unique_lock lock(mutex);
+	++pinned[String(assetId)];
+}
+
+void ResourceCollectionBase::unpin(std::string_view assetId)
+{
+	std::unique_lock lock(mutex);
+	const auto iter = pinned.find(assetId);
+	if (iter != pinned.end() && --iter->second <= 0) {
+		pinned.erase(iter);
+	}
+}
+
+bool ResourceCollectionBase::isPinned(std::string_view assetId) const
+{
+	std::shared_lock lock(mutex);
+	return pinned.contains(assetId);
+}
+
+bool ResourceCollectionBase::canEvict(const Wrapper& wrapper, std::string_view assetId) const
+{
+	// Unlike age(), this doesn't tolerate an extra reference, so e.g. a Texture only becomes evictable after the SpriteSheet holding it is gone
+	return wrapper.evictable && wrapper.res.use_count() == 1 && !pinned.contains(assetId) && !resourcesLoading.contains(assetId);
+}
+
+size_t ResourceCollectionBase::collectEvictionCandidates(Vector<EvictionCandidate>& candidates) const
+{
+	size_t total = 0;
+	std::shared_lock lock(mutex);
+
+	for (const auto& [assetId, wrapper]: resources) {
+		const size_t size = wrapper.res->getMemoryUsage().getTotal();
+		total += size;
+		if (size > 0 && canEvict(wrapper, assetId)) {
+			candidates.push_back(EvictionCandidate{ type, assetId, static_cast<ResourceLoadPriority>(wrapper.priority.load()), wrapper.lastUse.load(), size });
+		}
+	}
+
+	return total;
+}
+
+ResourceMemoryUsage ResourceCollectionBase::evict(std::string_view assetId)
+{
+	std::shared_ptr<Resource> toDelete;
+	ResourceMemoryUsage usage;
+
+	{
+		std::unique_lock lock(mutex);
+
+		const auto iter = resources.find(assetId);
+		if (iter == resources.end() || !canEvict(iter->second, assetId)) {
+			return {};
+		}
+
+		toDelete = std::move(iter->second.res);
+		resources.erase(iter);
+
+		usage = toDelete->getMemoryUsage();
+		toDelete->setUnloaded();
+		evicted.insert(String(assetId));
+		++evictions;
+		bytesEvicted += usage.getTotal();
+	}
+
+	// Delete out of the lock to avoid stalling resources for too long
+	toDelete.reset();
+
+	return usage;
+}
+
+ResourceResidencyStats ResourceCollectionBase::getResidencyStats() const
+{
+	std::shared_lock lock(mutex);
+
+	ResourceResidencyStats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.evictions = evictions;
+	stats.reloads = reloads;
+	stats.bytesEvicted = bytesEvicted;
+	return stats;
+}
+
+void ResourceCollectionBase::resetResidencyStats()
+{
+	std::unique_lock lock(mutex);
+
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+	reloads = 0;
+	bytesEvicted = 0;
+}
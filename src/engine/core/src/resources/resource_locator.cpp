@@ -199,6 +199,37 @@ bool ResourceLocator::exists(const String& asset, AssetType type)
 	return assetToLocator.find(toString(type) + ":" + asset) != assetToLocator.end();
 }
 
+void ResourceLocator::sortByDataLocation(Vector<std::pair<AssetType, String>>& assets) const
+{
+	using Key = std::tuple<size_t, size_t, size_t>; // Locator index, offset, original index
+
+	Vector<std::pair<Key, size_t>> keys;
+	keys.reserve(assets.size());
+	for (size_t i = 0; i < assets.size(); ++i) {
+		const auto& [type, asset] = assets[i];
+		size_t locatorIdx = locators.size();
+		size_t offset = 0;
+
+		const auto iter = assetToLocator.find(toString(type) + ":" + asset);
+		if (iter != assetToLocator.end()) {
+			const auto locatorIter = std::find_if(locators.begin(), locators.end(), [&] (const auto& l) { return l.get() == iter->second; });
+			locatorIdx = static_cast<size_t>(locatorIter - locators.begin());
+			offset = iter->second->getDataOffset(asset, type).value_or(0);
+		}
+
+		keys.emplace_back(Key(locatorIdx, offset, i), i);
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	Vector<std::pair<AssetType, String>> result;
+	result.reserve(assets.size());
+	for (const auto& k: keys) {
+		result.push_back(std::move(assets[k.second]));
+	}
+	assets = std::move(result);
+}
+
 size_t ResourceLocator::getLocatorCount() const
 {
 	return assetToLocator.size();
@@ -70,6 +70,18 @@ size_t PackResourceLocator::getMemoryUsage() const
 	return sizeof(*this) + (assetPack ? assetPack->getMemoryUsage() : 0);
 }
 
+std::optional<size_t> PackResourceLocator::getDataOffset(const String& asset, AssetType type)
+{
+	if (!assetPack || !assetPack->getAssetDatabase().hasDatabase(type)) {
+		return {};
+	}
+	const auto* entry = assetPack->getAssetDatabase().getDatabase(type).tryGet(asset);
+	if (!entry) {
+		return {};
+	}
+	return AssetPack::parseChunkPath(entry->path).pos;
+}
+
 String PackResourceLocator::getName() const
 {
 	return path.getFilenameStr();
@@ -21,6 +21,7 @@ namespace Halley {
 		int getPriority() const override;
 		size_t getMemoryUsage() const override;
 		String getName() const override;
+		std::optional<size_t> getDataOffset(const String& asset, AssetType type) override;
 		
 	private:
 		void loadAfterPurge();
@@ -0,0 +1,70 @@
+#include "halley/resources/resource_prefetch.h"
+#include "halley/resources/resources.h"
+#include "halley/data_structures/config_node.h"
+
+using namespace Halley;
+
+ResourcePrefetchManifest::ResourcePrefetchManifest(const ConfigNode& node)
+{
+	if (node.getType() != ConfigNodeType::Map || !node.hasKey("assets")) {
+		return;
+	}
+
+	for (const auto& e: node["assets"].asSequence()) {
+		const auto str = e.asString();
+		const auto splitPos = str.find(':');
+		if (splitPos != String::npos) {
+			add(fromString<AssetType>(str.left(splitPos)), str.mid(splitPos + 1));
+		}
+	}
+}
+
+ConfigNode ResourcePrefetchManifest::toConfigNode() const
+{
+	ConfigNode::SequenceType assets;
+	assets.reserve(entries.size());
+	for (const auto& [type, assetId]: entries) {
+		assets.push_back(ConfigNode(toString(type) + ":" + assetId));
+	}
+
+	ConfigNode::MapType result;
+	result["assets"] = std::move(assets);
+	return result;
+}
+
+void ResourcePrefetchManifest::add(AssetType type, std::string_view assetId)
+{
+	auto key = toString(type) + ":" + assetId;
+	if (!seen.contains(key)) {
+		seen.insert(std::move(key));
+		entries.emplace_back(type, String(assetId));
+	}
+}
+
+const Vector<ResourcePrefetchManifest::Entry>& ResourcePrefetchManifest::getEntries() const
+{
+	return entries;
+}
+
+bool ResourcePrefetchManifest::empty() const
+{
+	return entries.empty();
+}
+
+String ResourcePrefetchManifest::getManifestId(AssetType type, std::string_view assetId)
+{
+	return "prefetch/" + toString(type) + "/" + assetId;
+}
+
+ResourceAccessTraceScope::ResourceAccessTraceScope(Resources& resources, AssetType type, String assetId)
+	: resources(resources)
+	, type(type)
+	, assetId(std::move(assetId))
+{
+	resources.startAccessTrace(type, this->assetId);
+}
+
+ResourceAccessTraceScope::~ResourceAccessTraceScope()
+{
+	resources.stopAccessTrace(type, assetId);
+}
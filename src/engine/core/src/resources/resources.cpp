@@ -2,9 +2,28 @@
 #include "halley/resources/resource_locator.h"
 #include "halley/api/halley_api.h"
 #include "halley/support/logger.h"
+#include "halley/file_formats/config_file.h"
+#include "halley/file_formats/yaml_convert.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/utils/algorithm.h"
+#include "halley/utils/scoped_guard.h"
+#include "halley/os/os.h"
 
 using namespace Halley;
 
+namespace {
+	// Set while prefetching, so that prefetched assets don't get recorded into traces which are running at the same time
+	thread_local bool isPrefetching = false;
+
+	// Entries loaded per task, before handing the worker back to the queue
+	constexpr size_t prefetchBatchSize = 8;
+}
+
+struct Resources::PrefetchJob {
+	Vector<ResourcePrefetchManifest::Entry> entries;
+	size_t next = 0;
+};
+
 Resources::Resources(std::unique_ptr<ResourceLocator> locator, const HalleyAPI& api, ResourceOptions options)
 	: locator(std::move(locator))
 	, api(&api)
@@ -85,7 +104,270 @@ void Resources::generateMemoryReport()
 		}
 	}
 
+	if (hasMemoryBudgets()) {
+		Logger::logInfo("Resource residency: " + getResidencyStats().toString());
+	}
+
 	locator->generateMemoryReport();
 }
 
-Resources::~Resources() = default;
+void Resources::setMemoryBudget(std::optional<size_t> bytes)
+{
+	memoryBudget = bytes;
+	updateResidencyTracking();
+}
+
+std::optional<size_t> Resources::getMemoryBudget() const
+{
+	return memoryBudget;
+}
+
+void Resources::setMemoryBudget(AssetType type, std::optional<size_t> bytes)
+{
+	ofType(type).setMemoryBudget(bytes);
+}
+
+ResourceMemoryUsage Resources::enforceMemoryBudgets()
+{
+	ResourceMemoryUsage freed;
+
+	for (auto& res: resources) {
+		if (res) {
+			freed += res->enforceMemoryBudget();
+		}
+	}
+
+	if (memoryBudget) {
+		// LRU order is shared across types, since all collections use the same access clock
+		Vector<ResourceCollectionBase::EvictionCandidate> candidates;
+		size_t total = 0;
+		for (auto& res: resources) {
+			if (res) {
+				total += res->collectEvictionCandidates(candidates);
+			}
+		}
+
+		if (total > *memoryBudget) {
+			std::sort(candidates.begin(), candidates.end());
+
+			const size_t toFree = total - *memoryBudget;
+			size_t globalFreed = 0;
+			for (const auto& candidate: candidates) {
+				if (globalFreed >= toFree) {
+					break;
+				}
+				const auto usage = ofType(candidate.type).evict(candidate.assetId);
+				globalFreed += usage.getTotal();
+				freed += usage;
+			}
+		}
+	}
+
+	return freed;
+}
+
+ResourceResidencyStats Resources::getResidencyStats() const
+{
+	ResourceResidencyStats stats;
+	for (auto& res: resources) {
+		if (res) {
+			stats += res->getResidencyStats();
+		}
+	}
+	return stats;
+}
+
+void Resources::update(Time t)
+{
+	if (!isTrackingResidency()) {
+		return;
+	}
+
+	// Measuring memory usage walks every resource, so don't do it every frame
+	constexpr Time budgetCheckInterval = 0.5;
+	timeSinceBudgetCheck += t;
+	if (timeSinceBudgetCheck >= budgetCheckInterval) {
+		timeSinceBudgetCheck = 0;
+		enforceMemoryBudgets();
+	}
+}
+
+uint64_t Resources::nextAccessTick()
+{
+	return accessClock.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+bool Resources::hasMemoryBudgets() const
+{
+	if (memoryBudget) {
+		return true;
+	}
+	return std::any_of(resources.begin(), resources.end(), [] (const auto& res) { return res && res->getMemoryBudget(); });
+}
+
+void Resources::updateResidencyTracking()
+{
+	trackingResidency.store(hasMemoryBudgets(), std::memory_order_relaxed);
+}
+
+bool Resources::isTrackingResidency() const
+{
+	return trackingResidency.load(std::memory_order_relaxed);
+}
+
+void Resources::setPrefetchManifestOutputPath(std::optional<Path> path)
+{
+	prefetchManifestPath = std::move(path);
+}
+
+void Resources::startAccessTrace(AssetType type, const String& assetId)
+{
+	if (!prefetchManifestPath) {
+		return;
+	}
+
+	auto& traces = getThreadTraces();
+	for (auto& trace: traces) {
+		if (trace.owner == this && trace.type == type && trace.assetId == assetId) {
+			++trace.depth;
+			return;
+		}
+	}
+
+	traces.push_back(AccessTrace{ this, type, assetId });
+}
+
+void Resources::stopAccessTrace(AssetType type, const String& assetId)
+{
+	auto& traces = getThreadTraces();
+	const auto iter = std::find_if(traces.begin(), traces.end(), [&] (const AccessTrace& trace) { return trace.owner == this && trace.type == type && trace.assetId == assetId; });
+	if (iter == traces.end() || --iter->depth > 0) {
+		return;
+	}
+
+	const auto finished = std::move(*iter);
+	traces.erase(iter);
+
+	if (prefetchManifestPath && !finished.manifest.empty()) {
+		saveManifest(finished);
+	}
+}
+
+void Resources::recordAccess(AssetType type, std::string_view assetId)
+{
+	// Traces belong to the thread that started them, so accesses from other threads never need to synchronise with them
+	auto& traces = getThreadTraces();
+	if (traces.empty() || isPrefetching) {
+		return;
+	}
+
+	for (auto& trace: traces) {
+		if (trace.owner == this && (trace.type != type || trace.assetId != assetId)) {
+			trace.manifest.add(type, assetId);
+		}
+	}
+}
+
+Vector<Resources::AccessTrace>& Resources::getThreadTraces()
+{
+	thread_local Vector<AccessTrace> traces;
+	return traces;
+}
+
+void Resources::saveManifest(const AccessTrace& trace) const
+{
+	const auto path = *prefetchManifestPath / (toString(trace.type) + "/" + trace.assetId + ".yaml");
+	const auto yaml = YAMLConvert::generateYAML(trace.manifest.toConfigNode());
+
+	// Avoid touching the file if nothing changed
+	if (Path::readFileString(path) != yaml) {
+		OS::get().createDirectories(path.parentPath());
+		Path::writeFile(path, yaml);
+		Logger::logDev("Saved prefetch manifest for " + toString(trace.type) + ":" + trace.assetId + " (" + toString(trace.manifest.getEntries().size()) + " assets) to \"" + path.getString() + "\"");
+	}
+}
+
+void Resources::prefetch(AssetType type, const String& assetId)
+{
+	const auto manifestId = ResourcePrefetchManifest::getManifestId(type, assetId);
+	if (!locator->exists(manifestId, AssetType::ConfigFile)) {
+		return;
+	}
+
+	Vector<ResourcePrefetchManifest::Entry> entries;
+	{
+		isPrefetching = true;
+		auto guard = ScopedGuard([] { isPrefetching = false; });
+
+		const auto manifest = ResourcePrefetchManifest(get<ConfigFile>(manifestId)->getRoot());
+		entries.reserve(manifest.getEntries().size());
+		for (const auto& entry: manifest.getEntries()) {
+			const auto typeIdx = static_cast<size_t>(entry.first);
+			if (typeIdx < resources.size() && resources[typeIdx] && locator->exists(entry.second, entry.first)) {
+				entries.push_back(entry);
+			}
+		}
+	}
+	locator->sortByDataLocation(entries);
+
+	// Asynchronous loaders queue their reads on the disk IO executor as they're requested, so requesting everything in pack order
+	// issues the reads in the order they're laid out in the packs.
+	// This doesn't run on the disk IO executor itself, as some loaders block waiting for their dependencies, which load there.
+	// It's split into small batches, each a task of its own, so a long manifest doesn't hold on to a worker thread for its whole duration.
+	auto job = std::make_shared<PrefetchJob>();
+	job->entries = std::move(entries);
+	schedulePrefetch(std::move(job));
+}
+
+void Resources::schedulePrefetch(std::shared_ptr<PrefetchJob> job)
+{
+	std::unique_lock lock(prefetchMutex);
+	if (prefetchCancelled) {
+		return;
+	}
+
+	std_ex::erase_if(prefetchTasks, [] (const Future<void>& f) { return f.isReady(); });
+	prefetchTasks.push_back(Concurrent::execute([this, job = std::move(job)] ()
+	{
+		runPrefetchBatch(*job);
+		if (job->next < job->entries.size()) {
+			schedulePrefetch(job);
+		}
+	}));
+}
+
+void Resources::runPrefetchBatch(PrefetchJob& job)
+{
+	isPrefetching = true;
+	auto guard = ScopedGuard([] { isPrefetching = false; });
+
+	const size_t end = std::min(job.next + prefetchBatchSize, job.entries.size());
+	for (; job.next < end; ++job.next) {
+		const auto& [entryType, entryId] = job.entries[job.next];
+		try {
+			static_cast<void>(ofType(entryType).getUntyped(entryId, ResourceLoadPriority::Low));
+		} catch (const std::exception& e) {
+			Logger::logWarning("Failed to prefetch " + toString(entryType) + ":" + entryId + ": " + e.what());
+		}
+	}
+}
+
+void Resources::stopPrefetching()
+{
+	// Once cancelled no new batches get scheduled, so this only has to wait for the ones already queued or running
+	Vector<Future<void>> tasks;
+	{
+		std::unique_lock lock(prefetchMutex);
+		prefetchCancelled = true;
+		tasks = std::move(prefetchTasks);
+		prefetchTasks.clear();
+	}
+	for (auto& task: tasks) {
+		task.wait();
+	}
+}
+
+Resources::~Resources()
+{
+	stopPrefetching();
+}
@@ -19,7 +19,7 @@ std::pair<String, Vector<ColourOverride>> ScriptBranch::getNodeDescription(const
 
 IScriptNodeType::Result ScriptBranch::doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const
 {
-	const bool value = readDataPin(environment, node, 1).asBool(false);
+	const bool value = readDataPinValue(environment, node, 1).asBool(false);
 	return Result(ScriptNodeExecutionState::Done, 0, value ? 1 : 2);
 }
 
@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Start"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/start.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isParallelSafe() const override { return true; }
 		bool canAdd() const override { return false; }
 		bool canDelete() const override { return false; }
 
@@ -31,6 +32,7 @@ namespace Halley {
 		String getName() const override { return "Destructor"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/destructor.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isParallelSafe() const override { return true; }
 
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -45,6 +47,7 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isParallelSafe() const override { return true; }
 		Result doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const override;
 	};
 	
@@ -56,6 +59,7 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isParallelSafe() const override { return true; }
 		Result doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const override;
 	};
 	
@@ -67,6 +71,7 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isParallelSafe() const override { return true; }
 		Result doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const override;
 	};
 
@@ -104,6 +109,7 @@ namespace Halley {
 		String getName() const override { return "Stop Script"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/stop.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isParallelSafe() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -117,6 +123,7 @@ namespace Halley {
 		String getName() const override { return "Stop Tag"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/stop_tag.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isParallelSafe() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -138,6 +145,7 @@ namespace Halley {
 		String getName() const override { return "Wait Until EOF"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/wait_until_eof.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool isParallelSafe() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
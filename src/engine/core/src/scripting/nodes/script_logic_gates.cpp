@@ -31,7 +31,7 @@ std::pair<String, Vector<ColourOverride>> ScriptLogicGateAnd::getNodeDescription
 
 ConfigNode ScriptLogicGateAnd::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	const bool value = readDataPin(environment, node, 0).asBool(false) && readDataPin(environment, node, 1).asBool(false);
+	const bool value = readDataPinValue(environment, node, 0).asBool(false) && readDataPinValue(environment, node, 1).asBool(false);
 	return ConfigNode(value);
 }
 
@@ -65,7 +65,7 @@ std::pair<String, Vector<ColourOverride>> ScriptLogicGateOr::getNodeDescription(
 
 ConfigNode ScriptLogicGateOr::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	const bool value = readDataPin(environment, node, 0).asBool(false) || readDataPin(environment, node, 1).asBool(false);
+	const bool value = readDataPinValue(environment, node, 0).asBool(false) || readDataPinValue(environment, node, 1).asBool(false);
 	return ConfigNode(value);
 }
 
@@ -99,7 +99,7 @@ std::pair<String, Vector<ColourOverride>> ScriptLogicGateXor::getNodeDescription
 
 ConfigNode ScriptLogicGateXor::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	const bool value = (readDataPin(environment, node, 0).asBool(false) ^ readDataPin(environment, node, 1).asBool(false)) != 0;
+	const bool value = (readDataPinValue(environment, node, 0).asBool(false) ^ readDataPinValue(environment, node, 1).asBool(false)) != 0;
 	return ConfigNode(value);
 }
 
@@ -129,6 +129,6 @@ std::pair<String, Vector<ColourOverride>> ScriptLogicGateNot::getNodeDescription
 
 ConfigNode ScriptLogicGateNot::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	const bool value = !readDataPin(environment, node, 0).asBool(false);
+	const bool value = !readDataPinValue(environment, node, 0).asBool(false);
 	return ConfigNode(value);
 }
@@ -122,7 +122,7 @@ std::pair<String, Vector<ColourOverride>> ScriptWhileLoop::getNodeDescription(co
 
 IScriptNodeType::Result ScriptWhileLoop::doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const
 {
-	const bool condition = readDataPin(environment, node, 1).asBool(true);
+	const bool condition = readDataPinValue(environment, node, 1).asBool(true);
 	return Result(ScriptNodeExecutionState::Done, 0, condition ? 2 : 1);
 }
 
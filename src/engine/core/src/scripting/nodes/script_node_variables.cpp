@@ -46,16 +46,28 @@ std::pair<String, Vector<ColourOverride>> ScriptVariable::getNodeDescription(con
 	return str.moveResults();
 }
 
+void ScriptVariable::compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const
+{
+	data.scope = static_cast<uint8_t>(fromString<ScriptVariableScope>(node.getSettings()["scope"].asString("local")));
+	data.variableSlot = ScriptVariableSlots::getSlot(node.getSettings()["variable"].asString(""));
+}
+
 ConfigNode ScriptVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return ConfigNode(vars.getVariable(node.getCompiledData().variableSlot));
+}
+
+ScriptValue ScriptVariable::doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	const auto& vars = environment.getVariables(getScope(node));
+	return ScriptValue(vars.getVariable(node.getCompiledData().variableSlot));
 }
 
 EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	const auto& data = vars.getVariable(node.getSettings()["variable"].asString(""));
+	const auto& data = vars.getVariable(node.getCompiledData().variableSlot);
 	if (data.getType() == ConfigNodeType::EntityId || data.getType() == ConfigNodeType::Int || data.getType() == ConfigNodeType::Float) {
 		return data.asEntityId();
 	} else {
@@ -66,15 +78,15 @@ EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const Scr
 void ScriptVariable::doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const
 {
 	const auto scope = getScope(node);
-	const auto variable = node.getSettings()["variable"].asString("");
+	const auto slot = node.getCompiledData().variableSlot;
 
 	if (scope != ScriptVariableScope::Local && !environment.hasNetworkAuthorityOver(environment.getCurrentEntityId())) {
-		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + variable + "\", not owned by this client");
+		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + ScriptVariableSlots::getName(slot) + "\", not owned by this client");
 		return;
 	}
 
 	auto& vars = environment.getVariables(scope);
-	vars.setVariable(variable, std::move(data));
+	vars.setVariable(slot, std::move(data));
 }
 
 ConfigNode ScriptVariable::doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const
@@ -84,7 +96,7 @@ ConfigNode ScriptVariable::doGetDevConData(ScriptEnvironment& environment, const
 
 ScriptVariableScope ScriptVariable::getScope(const ScriptGraphNode& node) const
 {
-	return fromString<ScriptVariableScope>(node.getSettings()["scope"].asString("local"));
+	return static_cast<ScriptVariableScope>(node.getCompiledData().scope);
 }
 
 
@@ -129,16 +141,27 @@ std::pair<String, Vector<ColourOverride>> ScriptEntityVariable::getNodeDescripti
 	return str.moveResults();
 }
 
+void ScriptEntityVariable::compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const
+{
+	data.variableSlot = ScriptVariableSlots::getSlot(node.getSettings()["variable"].asString(""));
+}
+
 ConfigNode ScriptEntityVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return ConfigNode(vars.getVariable(node.getCompiledData().variableSlot));
+}
+
+ScriptValue ScriptEntityVariable::doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
+	return ScriptValue(vars.getVariable(node.getCompiledData().variableSlot));
 }
 
 EntityId ScriptEntityVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return vars.getVariable(node.getSettings()["variable"].asString("")).asEntityId({});
+	return vars.getVariable(node.getCompiledData().variableSlot).asEntityId({});
 }
 
 ConfigNode ScriptEntityVariable::doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const
@@ -155,7 +178,7 @@ void ScriptEntityVariable::doSetData(ScriptEnvironment& environment, const Scrip
 			Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Entity Variable \"" + node.getSettings()["variable"].asString("") + "\", not owned by this client");
 			return;
 		}
-		environment.setEntityVariable(e.getEntityId(), node.getSettings()["variable"].asString(""), std::move(data));
+		environment.setEntityVariable(e.getEntityId(), node.getCompiledData().variableSlot, std::move(data));
 	}
 }
 
@@ -219,9 +242,19 @@ std::pair<String, Vector<ColourOverride>> ScriptLiteral::getNodeDescription(cons
 	return str.moveResults();
 }
 
+void ScriptLiteral::compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const
+{
+	data.constant = ScriptValue(getConfigNode(node));
+}
+
 ConfigNode ScriptLiteral::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	return getConfigNode(node);
+	return node.getCompiledData().constant.toConfigNode();
+}
+
+ScriptValue ScriptLiteral::doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	return node.getCompiledData().constant;
 }
 
 ConfigNode ScriptLiteral::getConfigNode(const BaseGraphNode& node) const
@@ -476,12 +509,22 @@ std::pair<String, Vector<ColourOverride>> ScriptComparison::getNodeDescription(c
 	return str.moveResults();
 }
 
+void ScriptComparison::compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const
+{
+	data.op = static_cast<uint8_t>(fromString<MathRelOp>(node.getSettings()["operator"].asString("==")));
+}
+
 ConfigNode ScriptComparison::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	const auto a = readDataPin(environment, node, 0);
-	const auto b = readDataPin(environment, node, 1);
-	const auto op = fromString<MathRelOp>(node.getSettings()["operator"].asString("=="));
-	return ConfigNode(a.compareTo(op, b));
+	return doGetValue(environment, node, pinN).toConfigNode();
+}
+
+ScriptValue ScriptComparison::doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	const auto a = readDataPinValue(environment, node, 0);
+	const auto b = readDataPinValue(environment, node, 1);
+	const auto op = static_cast<MathRelOp>(node.getCompiledData().op);
+	return ScriptValue(a.compareTo(op, b));
 }
 
 
@@ -530,12 +573,30 @@ std::pair<String, Vector<ColourOverride>> ScriptArithmetic::getNodeDescription(c
 	return str.moveResults();
 }
 
+void ScriptArithmetic::compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const
+{
+	data.op = static_cast<uint8_t>(fromString<MathOp>(node.getSettings()["operator"].asString("+")));
+}
+
 ConfigNode ScriptArithmetic::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pin_n) const
 {
-	const auto a = readDataPin(environment, node, 0);
-	const auto b = readDataPin(environment, node, 1);
-	const auto op = fromString<MathOp>(node.getSettings()["operator"].asString("+"));
+	return doGetValue(environment, node, pin_n).toConfigNode();
+}
+
+ScriptValue ScriptArithmetic::doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	auto a = readDataPinValue(environment, node, 0);
+	auto b = readDataPinValue(environment, node, 1);
+	const auto op = static_cast<MathOp>(node.getCompiledData().op);
 
+	if (auto result = ScriptValue::tryApply(op, a, b)) {
+		return std::move(*result);
+	}
+	return ScriptValue(applyBoxed(op, std::move(a).toConfigNode(), std::move(b).toConfigNode()));
+}
+
+ConfigNode ScriptArithmetic::applyBoxed(MathOp op, const ConfigNode& a, const ConfigNode& b) const
+{
 	const auto type = ConfigNode::getPromotedType(std::array<ConfigNodeType, 2>{ a.getType(), b.getType() }, true);
 
 	if (type == ConfigNodeType::String) {
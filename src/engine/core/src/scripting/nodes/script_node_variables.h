@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Variable"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/variable.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isParallelSafe() const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -15,7 +16,9 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 		EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const override;
 		void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const override;
 		ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const override;
@@ -37,7 +40,9 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 		EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const override;
 		ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const override;
 		void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const override;
@@ -53,9 +58,12 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isParallelSafe() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 
 	private:
 		ConfigNode getConfigNode(const BaseGraphNode& node) const;
@@ -68,6 +76,7 @@ namespace Halley {
 		String getName() const override { return "Variable Table"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/variable_table.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isParallelSafe() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		String getLargeLabel(const BaseGraphNode& node) const override;
@@ -106,6 +115,7 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isParallelSafe() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
@@ -117,6 +127,7 @@ namespace Halley {
 		String getName() const override { return "Comparison"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/comparison.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isParallelSafe() const override { return true; }
 		
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -124,7 +135,9 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 	};
 	
 	class ScriptArithmetic final : public ScriptNodeTypeBase<void> {
@@ -133,6 +146,7 @@ namespace Halley {
 		String getName() const override { return "Arithmetic"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/arithmetic.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isParallelSafe() const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -140,7 +154,12 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::CompiledData& data) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		ScriptValue doGetValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+
+	private:
+		ConfigNode applyBoxed(MathOp op, const ConfigNode& a, const ConfigNode& b) const;
 	};
 	
 	class ScriptValueOr final : public ScriptNodeTypeBase<void> {
@@ -149,6 +168,7 @@ namespace Halley {
 		String getName() const override { return "Value Or"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isParallelSafe() const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -163,6 +183,7 @@ namespace Halley {
 		String getName() const override { return "Conditional Operator"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isParallelSafe() const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -177,6 +198,7 @@ namespace Halley {
 		String getName() const override { return "Lerp"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/lerp.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isParallelSafe() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -193,6 +215,7 @@ namespace Halley {
 		String getName() const override { return "Advance Variable To"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/advanceTo.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isParallelSafe() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
@@ -209,6 +232,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/set_variable.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isParallelSafe() const override { return true; }
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -233,6 +257,7 @@ namespace Halley {
 		String getLabel(const BaseGraphNode& node) const override;
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/set_variable.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isParallelSafe() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		bool hasDestructor(const ScriptGraphNode& node) const override { return true; }
@@ -30,6 +30,6 @@ std::pair<String, Vector<ColourOverride>> ScriptWaitFor::getNodeDescription(cons
 
 IScriptNodeType::Result ScriptWaitFor::doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node) const
 {
-	const bool done = readDataPin(environment, node, 1).asBool(false) == node.getSettings()["untilTrue"].asBool(true);
+	const bool done = readDataPinValue(environment, node, 1).asBool(false) == node.getSettings()["untilTrue"].asBool(true);
 	return Result(done ? ScriptNodeExecutionState::Done : ScriptNodeExecutionState::Executing);
 }
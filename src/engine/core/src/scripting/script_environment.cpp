@@ -113,6 +113,25 @@ void ScriptEnvironment::update(Time time, ScriptState& graphState, EntityId curE
 	currentEntity = EntityId();
 }
 
+std::unique_ptr<ScriptEnvironment> ScriptEnvironment::makeWorkerEnvironment() const
+{
+	if (typeid(*this) != typeid(ScriptEnvironment)) {
+		return {};
+	}
+
+	auto result = std::make_unique<ScriptEnvironment>(api, world, resources, nodeTypeCollection, isHost);
+	copySettingsTo(*result);
+	return result;
+}
+
+void ScriptEnvironment::copySettingsTo(ScriptEnvironment& worker) const
+{
+	worker.isHost = isHost;
+	worker.inputEnabled = inputEnabled;
+	worker.scriptTargetRetriever = scriptTargetRetriever;
+	worker.variableTable = variableTable;
+}
+
 bool ScriptEnvironment::updateThread(ScriptState& graphState, ScriptStateThread& thread, Vector<ScriptStateThread>& pendingThreads)
 {
 	currentThread = &thread;
@@ -727,6 +746,26 @@ bool ScriptEnvironment::hasStopRequests() const
 	return false;
 }
 
+ScriptEnvironment::Outbox ScriptEnvironment::takeOutbox()
+{
+	return Outbox{ std::move(scriptOutbox), std::move(entityOutbox), std::move(scriptExecutionRequestOutbox) };
+}
+
+void ScriptEnvironment::appendOutbox(Outbox outbox)
+{
+	auto append = [] (auto& dst, auto&& src)
+	{
+		if (dst.empty()) {
+			dst = std::move(src);
+		} else {
+			dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+		}
+	};
+	append(scriptOutbox, outbox.scriptMessages);
+	append(entityOutbox, outbox.entityMessages);
+	append(scriptExecutionRequestOutbox, outbox.scriptExecutionRequests);
+}
+
 Vector<std::pair<EntityId, ScriptMessage>> ScriptEnvironment::getOutboundScriptMessages()
 {
 	return std::move(scriptOutbox);
@@ -849,6 +888,25 @@ ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, Grap
 	return dstNode.getNodeType().getData(*this, dstNode, dst.dstPin, getNodeData(dst.dstNode.value()));
 }
 
+ScriptValue ScriptEnvironment::readInputDataPinValue(const ScriptGraphNode& node, GraphPinId pinN)
+{
+	const auto& pins = node.getPins();
+	if (pinN >= pins.size()) {
+		return {};
+	}
+
+	const auto& pin = pins[pinN];
+	if (pin.connections.empty() || !pin.connections[0].dstNode) {
+		return {};
+	}
+	assert(pin.connections.size() == 1);
+
+	const auto& dst = pin.connections[0];
+	const auto& nodes = currentGraph->getNodes();
+	const auto& dstNode = nodes[dst.dstNode.value()];
+	return dstNode.getNodeType().getValue(*this, dstNode, dst.dstPin, getNodeData(dst.dstNode.value()));
+}
+
 ConfigNode ScriptEnvironment::readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN)
 {
 	return node.getNodeType().getData(*this, node, pinN, getNodeData(node.getId()));
@@ -935,12 +993,17 @@ const ScriptVariables& ScriptEnvironment::getEntityVariables(EntityId entityId)
 }
 
 void ScriptEnvironment::setEntityVariable(EntityId entityId, const String& name, ConfigNode value) const
+{
+	setEntityVariable(entityId, ScriptVariableSlots::getSlot(name), std::move(value));
+}
+
+void ScriptEnvironment::setEntityVariable(EntityId entityId, ScriptVariableSlots::Slot slot, ConfigNode value) const
 {
 	auto entity = tryGetEntity(entityId);
 	if (entity.isValid()) {
 		auto* scriptable = entity.tryGetComponent<ScriptableComponent>();
 		if (scriptable) {
-			scriptable->variables.setVariable(name, std::move(value));
+			scriptable->variables.setVariable(slot, std::move(value));
 		}
 	}
 }
@@ -135,11 +135,15 @@ void ScriptGraphNode::assignType(const GraphNodeTypeCollection& nodeTypeCollecti
 {
 	nodeType = dynamic_cast<const IScriptNodeType*>(nodeTypeCollection.tryGetGraphNodeType(type));
 	Ensures(nodeType != nullptr);
+
+	compiledData = CompiledData();
+	nodeType->compile(*this, compiledData);
 }
 
 void ScriptGraphNode::clearType() const
 {
 	nodeType = nullptr;
+	compiledData = CompiledData();
 }
 
 const IGraphNodeType& ScriptGraphNode::getGraphNodeType() const
@@ -506,6 +510,15 @@ const ScriptGraph* ScriptGraph::getPreviousVersion(uint64_t hash) const
 	return previousVersion.get();
 }
 
+bool ScriptGraph::isParallelSafe() const
+{
+	if (parallelSafeHash != hash) {
+		parallelSafeHash = hash;
+		parallelSafe = std::all_of(nodes.begin(), nodes.end(), [] (const ScriptGraphNode& node) { return node.getNodeType().isParallelSafe(); });
+	}
+	return parallelSafe;
+}
+
 ConfigNode& ScriptGraph::getProperties()
 {
 	return properties;
@@ -78,11 +78,21 @@ std::pair<String, Vector<ColourOverride>> IScriptNodeType::getPinAndConnectionDe
 	return builder.moveResults();
 }
 
+ScriptValue IScriptNodeType::getValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, IScriptStateData* curData) const
+{
+	return ScriptValue(getData(environment, node, pinN, curData));
+}
+
 ConfigNode IScriptNodeType::readDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	return environment.readInputDataPin(node, static_cast<GraphPinId>(pinN));
 }
 
+ScriptValue IScriptNodeType::readDataPinValue(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
+{
+	return environment.readInputDataPinValue(node, static_cast<GraphPinId>(pinN));
+}
+
 void IScriptNodeType::writeDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const
 {
 	const auto& pins = node.getPins();
@@ -0,0 +1,339 @@
+#include "halley/scripting/script_value.h"
+using namespace Halley;
+
+namespace {
+	bool isScalar(ScriptValue::Type type)
+	{
+		using T = ScriptValue::Type;
+		return type == T::Undefined || type == T::Bool || type == T::Int || type == T::Int64 || type == T::Float;
+	}
+
+	bool isVector2(ScriptValue::Type type)
+	{
+		using T = ScriptValue::Type;
+		return type == T::Undefined || type == T::Int2 || type == T::Float2;
+	}
+
+	template <typename T>
+	bool compareEq(MathRelOp op, const T& a, const T& b)
+	{
+		if (op == MathRelOp::Equal) {
+			return a == b;
+		} else if (op == MathRelOp::Different) {
+			return a != b;
+		}
+		return false;
+	}
+}
+
+ScriptValue::ScriptValue()
+	: int64Data(0)
+{
+}
+
+ScriptValue::ScriptValue(bool value)
+	: type(Type::Bool)
+	, int64Data(0)
+{
+	intData = value ? 1 : 0;
+}
+
+ScriptValue::ScriptValue(int value)
+	: type(Type::Int)
+	, int64Data(0)
+{
+	intData = value;
+}
+
+ScriptValue::ScriptValue(int64_t value)
+	: type(Type::Int64)
+	, int64Data(value)
+{
+}
+
+ScriptValue::ScriptValue(float value)
+	: type(Type::Float)
+	, int64Data(0)
+{
+	floatData = value;
+}
+
+ScriptValue::ScriptValue(Vector2i value)
+	: type(Type::Int2)
+	, int64Data(0)
+{
+	vec2iData = value;
+}
+
+ScriptValue::ScriptValue(Vector2f value)
+	: type(Type::Float2)
+	, int64Data(0)
+{
+	vec2fData = value;
+}
+
+ScriptValue::ScriptValue(EntityId value)
+	: type(Type::EntityId)
+	, int64Data(value.value)
+{
+}
+
+ScriptValue::ScriptValue(const ConfigNode& value)
+	: int64Data(0)
+{
+	switch (value.getType()) {
+	case ConfigNodeType::Undefined:
+		break;
+	case ConfigNodeType::Bool:
+		*this = ScriptValue(value.asBool());
+		break;
+	case ConfigNodeType::Int:
+		*this = ScriptValue(value.asInt());
+		break;
+	case ConfigNodeType::Int64:
+		*this = ScriptValue(value.asInt64());
+		break;
+	case ConfigNodeType::Float:
+		*this = ScriptValue(value.asFloat());
+		break;
+	case ConfigNodeType::Int2:
+		*this = ScriptValue(value.asVector2i());
+		break;
+	case ConfigNodeType::Float2:
+		*this = ScriptValue(value.asVector2f());
+		break;
+	case ConfigNodeType::EntityId:
+		*this = ScriptValue(value.asEntityId());
+		break;
+	default:
+		type = Type::Boxed;
+		boxed = ConfigNode(value);
+	}
+}
+
+ScriptValue::ScriptValue(ConfigNode&& value)
+	: int64Data(0)
+{
+	switch (value.getType()) {
+	case ConfigNodeType::Undefined:
+	case ConfigNodeType::Bool:
+	case ConfigNodeType::Int:
+	case ConfigNodeType::Int64:
+	case ConfigNodeType::Float:
+	case ConfigNodeType::Int2:
+	case ConfigNodeType::Float2:
+	case ConfigNodeType::EntityId:
+		*this = ScriptValue(static_cast<const ConfigNode&>(value));
+		break;
+	default:
+		type = Type::Boxed;
+		boxed = std::move(value);
+	}
+}
+
+ConfigNode ScriptValue::toConfigNode() const &
+{
+	switch (type) {
+	case Type::Undefined:
+		return ConfigNode();
+	case Type::Bool:
+		return ConfigNode(intData != 0);
+	case Type::Int:
+		return ConfigNode(intData);
+	case Type::Int64:
+		return ConfigNode(int64Data);
+	case Type::Float:
+		return ConfigNode(floatData);
+	case Type::Int2:
+		return ConfigNode(vec2iData);
+	case Type::Float2:
+		return ConfigNode(vec2fData);
+	case Type::EntityId:
+		return ConfigNode(EntityId(int64Data));
+	case Type::Boxed:
+		return ConfigNode(boxed);
+	}
+	return ConfigNode();
+}
+
+ConfigNode ScriptValue::toConfigNode() &&
+{
+	if (type == Type::Boxed) {
+		return std::move(boxed);
+	}
+	return static_cast<const ScriptValue&>(*this).toConfigNode();
+}
+
+bool ScriptValue::asBool(bool defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Bool:
+	case Type::Int:
+		return intData != 0;
+	case Type::Boxed:
+		return boxed.asBool(defaultValue);
+	default:
+		return toConfigNode().asBool(defaultValue);
+	}
+}
+
+int ScriptValue::asInt(int defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Bool:
+	case Type::Int:
+		return intData;
+	case Type::Float:
+		return static_cast<int>(floatData);
+	case Type::Boxed:
+		return boxed.asInt(defaultValue);
+	default:
+		return toConfigNode().asInt(defaultValue);
+	}
+}
+
+int64_t ScriptValue::asInt64(int64_t defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Bool:
+	case Type::Int:
+		return intData;
+	case Type::Int64:
+	case Type::EntityId:
+		return int64Data;
+	case Type::Boxed:
+		return boxed.asInt64(defaultValue);
+	default:
+		return toConfigNode().asInt64(defaultValue);
+	}
+}
+
+float ScriptValue::asFloat(float defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Bool:
+	case Type::Int:
+		return static_cast<float>(intData);
+	case Type::Int64:
+		return static_cast<float>(int64Data);
+	case Type::Float:
+		return floatData;
+	case Type::Boxed:
+		return boxed.asFloat(defaultValue);
+	default:
+		return toConfigNode().asFloat(defaultValue);
+	}
+}
+
+Vector2i ScriptValue::asVector2i(Vector2i defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Int2:
+		return vec2iData;
+	case Type::Float2:
+		return Vector2i(vec2fData);
+	case Type::Boxed:
+		return boxed.asVector2i(defaultValue);
+	default:
+		return toConfigNode().asVector2i(defaultValue);
+	}
+}
+
+Vector2f ScriptValue::asVector2f(Vector2f defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Int2:
+		return Vector2f(vec2iData);
+	case Type::Float2:
+		return vec2fData;
+	case Type::Boxed:
+		return boxed.asVector2f(defaultValue);
+	default:
+		return toConfigNode().asVector2f(defaultValue);
+	}
+}
+
+EntityId ScriptValue::asEntityId(EntityId defaultValue) const
+{
+	switch (type) {
+	case Type::Undefined:
+		return defaultValue;
+	case Type::Int64:
+	case Type::EntityId:
+		return EntityId(int64Data);
+	case Type::Boxed:
+		return boxed.asEntityId(defaultValue);
+	default:
+		return toConfigNode().asEntityId(defaultValue);
+	}
+}
+
+bool ScriptValue::compareTo(MathRelOp op, const ScriptValue& other) const
+{
+	if (type == other.type) {
+		switch (type) {
+		case Type::Bool:
+		case Type::Int:
+			return MathOps::compare(op, intData, other.intData);
+		case Type::Int64:
+		case Type::EntityId:
+			return MathOps::compare(op, int64Data, other.int64Data);
+		case Type::Float:
+			return MathOps::compare(op, floatData, other.floatData);
+		case Type::Int2:
+			return compareEq(op, vec2iData, other.vec2iData);
+		case Type::Float2:
+			return compareEq(op, vec2fData, other.vec2fData);
+		case Type::Boxed:
+			return boxed.compareTo(op, other.boxed);
+		default:
+			break;
+		}
+	} else if (isScalar(type) && isScalar(other.type) && type != Type::Undefined && other.type != Type::Undefined && type != Type::Bool && other.type != Type::Bool) {
+		// Mixed Int, Int64 and Float, promoted the same way as ConfigNode does
+		if (type == Type::Float || other.type == Type::Float) {
+			return MathOps::compare(op, asFloat(0), other.asFloat(0));
+		} else {
+			return MathOps::compare(op, asInt64(0), other.asInt64(0));
+		}
+	}
+
+	return toConfigNode().compareTo(op, other.toConfigNode());
+}
+
+std::optional<ScriptValue> ScriptValue::tryApply(MathOp op, const ScriptValue& a, const ScriptValue& b)
+{
+	if (a.type == Type::Undefined && b.type == Type::Undefined) {
+		return std::nullopt;
+	}
+
+	if (isScalar(a.type) && isScalar(b.type)) {
+		if (a.type == Type::Float || b.type == Type::Float) {
+			return ScriptValue(MathOps::apply(op, a.asFloat(0), b.asFloat(0)));
+		} else if (a.type == Type::Int64 || b.type == Type::Int64) {
+			return ScriptValue(MathOps::apply(op, a.asInt64(0), b.asInt64(0)));
+		} else if (a.type == Type::Int || b.type == Type::Int) {
+			return ScriptValue(MathOps::apply(op, a.asInt(0), b.asInt(0)));
+		}
+	} else if (isVector2(a.type) && isVector2(b.type)) {
+		if (a.type == Type::Float2 || b.type == Type::Float2) {
+			return ScriptValue(MathOps::apply(op, a.asVector2f({}), b.asVector2f({})));
+		} else {
+			return ScriptValue(MathOps::apply(op, a.asVector2i({}), b.asVector2i({})));
+		}
+	}
+
+	return std::nullopt;
+}
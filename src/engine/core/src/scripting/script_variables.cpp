@@ -1,9 +1,58 @@
 #include "halley/scripting/script_variables.h"
 #include "halley/bytes/config_node_serializer.h"
 #include "halley/entity/entity_id.h"
+#include <deque>
+#include <shared_mutex>
 
 using namespace Halley;
 
+namespace {
+	struct ScriptVariableSlotRegistry {
+		std::shared_mutex mutex;
+		HashMap<String, ScriptVariableSlots::Slot> slots;
+		std::deque<String> names; // Deque so that references to names stay valid as it grows
+	};
+
+	ScriptVariableSlotRegistry& getSlotRegistry()
+	{
+		static ScriptVariableSlotRegistry registry;
+		return registry;
+	}
+}
+
+ScriptVariableSlots::Slot ScriptVariableSlots::getSlot(const String& name)
+{
+	if (const auto slot = tryGetSlot(name)) {
+		return *slot;
+	}
+
+	auto& registry = getSlotRegistry();
+	std::unique_lock lock(registry.mutex);
+	const auto [iter, inserted] = registry.slots.emplace(name, static_cast<Slot>(registry.names.size()));
+	if (inserted) {
+		registry.names.push_back(name);
+	}
+	return iter->second;
+}
+
+std::optional<ScriptVariableSlots::Slot> ScriptVariableSlots::tryGetSlot(const String& name)
+{
+	auto& registry = getSlotRegistry();
+	std::shared_lock lock(registry.mutex);
+	const auto iter = registry.slots.find(name);
+	if (iter != registry.slots.end()) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+const String& ScriptVariableSlots::getName(Slot slot)
+{
+	auto& registry = getSlotRegistry();
+	std::shared_lock lock(registry.mutex);
+	return registry.names.at(slot);
+}
+
 ScriptVariables::ScriptVariables(const ConfigNode& node, const EntitySerializationContext& context)
 {
 	load(node, context);
@@ -18,27 +67,27 @@ void ScriptVariables::load(const ConfigNode& node, const EntitySerializationCont
 				context.debugCurrentContext = "ScriptVariables:" + k;
 				const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 				context.debugCurrentContext = {};
-				variables[k.mid(7)] = entityId;
+				getOrInsert(ScriptVariableSlots::getSlot(k.mid(7))) = entityId;
 			} else {
-				variables[k] = v;
+				getOrInsert(ScriptVariableSlots::getSlot(k)) = v;
 			}
 		}
 	} else if (node.getType() != ConfigNodeType::Undefined) {
 		for (const auto& [k, v]: node.asMap()) {
 			if (k.startsWith("entity!")) {
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k.mid(7));
+					erase(ScriptVariableSlots::getSlot(k.mid(7)));
 				} else {
 					context.debugCurrentContext = "ScriptVariables:" + k;
 					const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 					context.debugCurrentContext = {};
-					variables[k.mid(7)] = entityId;
+					getOrInsert(ScriptVariableSlots::getSlot(k.mid(7))) = entityId;
 				}
 			} else {
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k);
+					erase(ScriptVariableSlots::getSlot(k));
 				} else {
-					variables[k].applyDelta(v);
+					getOrInsert(ScriptVariableSlots::getSlot(k)).applyDelta(v);
 				}
 			}
 		}
@@ -48,7 +97,8 @@ void ScriptVariables::load(const ConfigNode& node, const EntitySerializationCont
 ConfigNode ScriptVariables::toConfigNode(const EntitySerializationContext& context) const
 {
 	ConfigNode::MapType result;
-	for (const auto& [k, v]: variables) {
+	for (const auto& [slot, v]: variables) {
+		const auto& k = ScriptVariableSlots::getName(slot);
 		if (v.getType() == ConfigNodeType::EntityId) {
 			result["entity!" + k] = ConfigNodeSerializer<EntityId>().serialize(v.asEntityId(), context);
 		} else {
@@ -60,21 +110,34 @@ ConfigNode ScriptVariables::toConfigNode(const EntitySerializationContext& conte
 
 const ConfigNode& ScriptVariables::getVariable(const String& name) const
 {
-	const auto iter = variables.find(name);
-	if (iter != variables.end()) {
-		return iter->second;
+	if (const auto slot = ScriptVariableSlots::tryGetSlot(name)) {
+		return getVariable(*slot);
+	}
+	return dummy;
+}
+
+const ConfigNode& ScriptVariables::getVariable(ScriptVariableSlots::Slot slot) const
+{
+	if (const auto* value = tryGet(slot)) {
+		return *value;
 	}
 	return dummy;
 }
 
 void ScriptVariables::setVariable(const String& name, ConfigNode value)
 {
-	variables[name] = std::move(value);
+	setVariable(ScriptVariableSlots::getSlot(name), std::move(value));
+}
+
+void ScriptVariables::setVariable(ScriptVariableSlots::Slot slot, ConfigNode value)
+{
+	getOrInsert(slot) = std::move(value);
 }
 
 bool ScriptVariables::hasVariable(const String& name) const
 {
-	return variables.find(name) != variables.end();
+	const auto slot = ScriptVariableSlots::tryGetSlot(name);
+	return slot && tryGet(*slot) != nullptr;
 }
 
 bool ScriptVariables::empty() const
@@ -87,6 +150,32 @@ void ScriptVariables::clear()
 	variables.clear();
 }
 
+const ConfigNode* ScriptVariables::tryGet(ScriptVariableSlots::Slot slot) const
+{
+	const auto iter = std::lower_bound(variables.begin(), variables.end(), slot, [] (const Entry& e, ScriptVariableSlots::Slot s) { return e.slot < s; });
+	if (iter != variables.end() && iter->slot == slot) {
+		return &iter->value;
+	}
+	return nullptr;
+}
+
+ConfigNode& ScriptVariables::getOrInsert(ScriptVariableSlots::Slot slot)
+{
+	auto iter = std::lower_bound(variables.begin(), variables.end(), slot, [] (const Entry& e, ScriptVariableSlots::Slot s) { return e.slot < s; });
+	if (iter == variables.end() || iter->slot != slot) {
+		iter = variables.insert(iter, Entry{ slot, ConfigNode() });
+	}
+	return iter->value;
+}
+
+void ScriptVariables::erase(ScriptVariableSlots::Slot slot)
+{
+	const auto iter = std::lower_bound(variables.begin(), variables.end(), slot, [] (const Entry& e, ScriptVariableSlots::Slot s) { return e.slot < s; });
+	if (iter != variables.end() && iter->slot == slot) {
+		variables.erase(iter);
+	}
+}
+
 ConfigNode ConfigNodeSerializer<ScriptVariables>::serialize(const ScriptVariables& variables, const EntitySerializationContext& context)
 {
 	return variables.toConfigNode(context);
@@ -106,6 +106,8 @@ bool UIParent::isWaitingToSpawnChildren() const
 
 void UIParent::markAsNeedingLayout() {}
 
+void UIParent::markLayoutDirty() {}
+
 Vector<std::shared_ptr<UIWidget>>& UIParent::getChildren()
 {
 	/*
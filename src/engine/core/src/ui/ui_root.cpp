@@ -54,7 +54,14 @@ const String& UIRoot::getId() const
 
 void UIRoot::setRect(Rect4f rect, Vector2f overscan)
 {
-	uiRect = Rect4f(rect.getTopLeft() + overscan, rect.getBottomRight() - overscan);
+	const auto newRect = Rect4f(rect.getTopLeft() + overscan, rect.getBottomRight() - overscan);
+	if (newRect != uiRect) {
+		// Anything anchored to the root needs to be placed again
+		for (auto& c: getChildren()) {
+			c->markLayoutDirty();
+		}
+	}
+	uiRect = newRect;
 	this->overscan = overscan;
 }
 
@@ -65,11 +72,17 @@ Rect4f UIRoot::getRect() const
 
 void UIRoot::runLayout()
 {
+	// Only root-level widgets are always visited, they skip any of their subtrees that haven't changed
 	for (auto& c: getChildren()) {
 		c->layout();
 	}
 }
 
+const UILayoutStats& UIRoot::getLayoutStats() const
+{
+	return layoutStats;
+}
+
 void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType)
 {
 	widgetsCache.clear();
@@ -114,6 +127,7 @@ void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, sp
 	auto joystickType = manual ? manual->getJoystickType() : JoystickType::Generic;
 	bool first = true;
 	lastInputType = activeInputType;
+	layoutStats = {};
 
 	updateKeyboardInput();
 
@@ -133,10 +147,15 @@ void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, sp
 		removeDeadChildren();
 
 		// Layout all widgets
+		const auto laidOutBefore = layoutStats.widgetsLaidOut;
 		runLayout();
 
 		// Update again, to reflect what happened >_>
-		updateWidgets(UIWidgetUpdateType::Partial, 0, activeInputType, joystickType);
+		// Not needed if every subtree was clean and nothing moved while laying out (e.g. anchors)
+		const bool layoutChanged = layoutStats.widgetsLaidOut != laidOutBefore || std::any_of(getChildren().begin(), getChildren().end(), [] (const auto& c) { return c->isActive() && c->isLayoutDirty(); });
+		if (layoutChanged) {
+			updateWidgets(UIWidgetUpdateType::Partial, 0, activeInputType, joystickType);
+		}
 
 		// For subsequent iterations, make sure t = 0
 		t = 0;
@@ -93,14 +93,24 @@ void UISizerEntry::updateEnabled() const
 	enabled = !element || element->isActive();
 }
 
-void UISizerEntry::setBorder(const Vector4f& b)
+void UISizerEntry::setBorder(const Vector4f& b, bool markParent)
 {
-	border = b;
+	if (border != b) {
+		border = b;
+		if (owner) {
+			owner->onEntriesChanged(markParent);
+		}
+	}
 }
 
 void UISizerEntry::setProportion(float prop)
 {
-	proportion = prop;
+	if (proportion != prop) {
+		proportion = prop;
+		if (owner) {
+			owner->onEntriesChanged();
+		}
+	}
 }
 
 Vector4f UISizerEntry::getBorder() const
@@ -151,8 +161,12 @@ UISizer& UISizer::operator=(UISizer&& other) noexcept
 	gridProportions = std::move(other.gridProportions);
 
 	entries = std::move(other.entries);
+	for (auto& e: entries) {
+		e.owner = this;
+	}
 
 	curParent = other.curParent;
+	onEntriesChanged();
 
 	return *this;
 }
@@ -164,14 +178,18 @@ Vector2f UISizer::getLayoutMinimumSize(bool force) const
 
 Vector2f UISizer::computeMinimumSize(bool includeProportional) const
 {
-	updateEnabled();
-	if (type == UISizerType::Horizontal || type == UISizerType::Vertical) {
-		return computeMinimumSizeBox(includeProportional);
-	} else if (type == UISizerType::Free) {
-		return computeMinimumSizeBoxFree();
-	} else {
-		return computeMinimumSizeGrid();
+	auto& cached = minSizeCache[includeProportional ? 1 : 0];
+	if (!cached) {
+		updateEnabled();
+		if (type == UISizerType::Horizontal || type == UISizerType::Vertical) {
+			cached = computeMinimumSizeBox(includeProportional);
+		} else if (type == UISizerType::Free) {
+			cached = computeMinimumSizeBoxFree();
+		} else {
+			cached = computeMinimumSizeGrid();
+		}
 	}
+	return *cached;
 }
 
 void UISizer::setRect(Rect4f rect, IUIElementListener* listener)
@@ -187,8 +205,10 @@ void UISizer::setRect(Rect4f rect, IUIElementListener* listener)
 
 void UISizer::add(std::shared_ptr<IUIElement> element, float proportion, Vector4f border, int fillFlags, size_t insertPos)
 {
-	entries.emplace(entries.begin() + std::min(entries.size(), insertPos), UISizerEntry(element, proportion, border, fillFlags));
-	reparentEntry(entries.back());
+	auto& entry = *entries.emplace(entries.begin() + std::min(entries.size(), insertPos), UISizerEntry(element, proportion, border, fillFlags));
+	entry.owner = this;
+	reparentEntry(entry);
+	onEntriesChanged();
 }
 
 void UISizer::addSpacer(float size)
@@ -205,6 +225,7 @@ void UISizer::addStretchSpacer(float proportion)
 void UISizer::remove(IUIElement& element)
 {
 	entries.erase(std::remove_if(entries.begin(), entries.end(), [&] (const UISizerEntry& e) { return e.getPointer().get() == &element; }), entries.end());
+	onEntriesChanged();
 }
 
 void UISizer::reparent(UIParent& parent)
@@ -312,9 +333,33 @@ void UISizer::updateEnabled() const
 	}
 }
 
+void UISizer::markAsNeedingLayout() const
+{
+	minSizeCache = {};
+	for (auto& e: entries) {
+		e.updateEnabled();
+		if (const auto* sizer = dynamic_cast<const UISizer*>(e.getPointer().get())) {
+			sizer->markAsNeedingLayout();
+		}
+	}
+}
+
+void UISizer::onEntriesChanged(bool markParent)
+{
+	if (markParent) {
+		markAsNeedingLayout();
+		if (curParent) {
+			curParent->markAsNeedingLayout();
+		}
+	} else {
+		minSizeCache = {};
+	}
+}
+
 void UISizer::swapItems(int idxA, int idxB)
 {
 	std::swap(entries[idxA], entries[idxB]);
+	onEntriesChanged();
 }
 
 void UISizer::clear()
@@ -331,6 +376,7 @@ void UISizer::clear()
 		}
 	}
 	entries.clear();
+	onEntriesChanged();
 }
 
 bool UISizer::isActive() const
@@ -348,6 +394,7 @@ void UISizer::setColumnProportions(const Vector<float>& values)
 	if (gridProportions) {
 		gridProportions->columnProportions = values;
 		gridProportions->columnProportions.resize(gridProportions->nColumns, 0);
+		onEntriesChanged();
 	}
 }
 
@@ -358,6 +405,7 @@ void UISizer::setEvenColumns()
 		for (auto& c: gridProportions->columnProportions) {
 			c = 1.0f;
 		}
+		onEntriesChanged();
 	}
 }
 
@@ -366,6 +414,7 @@ void UISizer::setRowProportions(const Vector<float>& values)
 {
 	if (gridProportions) {
 		gridProportions->rowProportions = values;
+		onEntriesChanged();
 	}
 }
 
@@ -437,7 +486,7 @@ void UISizer::setRectBox(Rect4f rect, IUIElementListener* listener)
 	const int mainAxis = type == UISizerType::Horizontal ? 0 : 1;
 	const int otherAxis = 1 - mainAxis;
 
-	const Vector2f sizerMinSize = computeMinimumSizeBox(false);
+	const Vector2f sizerMinSize = computeMinimumSize(false);
 	float spare = std::max(0.0f, (rect.getSize() - sizerMinSize)[mainAxis]);
 	
 	bool first = true;
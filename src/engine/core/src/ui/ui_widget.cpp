@@ -161,21 +161,56 @@ Vector2f UIWidget::getLayoutMinimumSize(bool force) const
 void UIWidget::setRect(Rect4f rect, IUIElementListener* listener)
 {
 	setWidgetRect(rect);
+
+	// Cleared before descending, so that children which move themselves during layout (e.g. anchors) flag us again for next time
+	const bool dirty = layoutDirty || listener;
+	layoutDirty = false;
+
 	if (sizer) {
 		const auto border = getInnerBorder();
 		const auto p0 = getLayoutOriginPosition();
 		const auto size = getLayoutSize(rect.getSize());
+		const auto sizerRect = Rect4f(p0 + Vector2f(border.x, border.y), p0 + size - Vector2f(border.z, border.w));
+
+		// Nothing below us changed and we're being given the same space, so the whole subtree is already in place
+		if (!dirty && sizerRect == lastSizerRect) {
+			notifyLayoutSkipped();
+			return;
+		}
+		lastSizerRect = sizerRect;
+
 		if (listener) {
 			onPreNotifySetRect(*listener);
 		}
-		sizer->setRect(Rect4f(p0 + Vector2f(border.x, border.y), p0 + size - Vector2f(border.z, border.w)), listener);
+		notifyLaidOut();
+		sizer->setRect(sizerRect, listener);
 	} else {
+		if (!dirty) {
+			notifyLayoutSkipped();
+			return;
+		}
+
+		notifyLaidOut();
 		for (auto& c: getChildren()) {
 			c->layout();
 		}
 	}
 }
 
+void UIWidget::notifyLaidOut()
+{
+	if (root) {
+		++root->layoutStats.widgetsLaidOut;
+	}
+}
+
+void UIWidget::notifyLayoutSkipped()
+{
+	if (root) {
+		++root->layoutStats.widgetsSkipped;
+	}
+}
+
 void UIWidget::onPreNotifySetRect(IUIElementListener& listener)
 {
 }
@@ -251,6 +286,7 @@ void UIWidget::setSizer(std::optional<UISizer> sizer)
 	if (this->sizer) {
 		this->sizer->reparent(*this);
 	}
+	markAsNeedingLayout();
 }
 
 void UIWidget::add(std::shared_ptr<IUIElement> element, float proportion, Vector4f border, int fillFlags, size_t insertPos)
@@ -395,6 +431,7 @@ void UIWidget::setPositionOffset(Vector2f offset)
 	if (positionOffset != offset) {
 		positionOffset = offset;
 		positionUpdated = true;
+		markLayoutDirty();
 	}
 }
 
@@ -426,7 +463,10 @@ bool UIWidget::ignoreClip() const
 void UIWidget::setPosition(Vector2f pos)
 {
 	Expects(pos.isValid());
-	
+
+	if (position != pos) {
+		markLayoutDirty();
+	}
 	position = pos;
 	positionUpdated = true;
 }
@@ -638,6 +678,7 @@ void UIWidget::forceLayout()
 {
 	Expects (lastInputType != UIInputType::Undefined);
 	forceAddChildren(lastInputType, true);
+	markLayoutDirty();
 	layout();
 }
 
@@ -1084,14 +1125,28 @@ bool UIWidget::needsLayout() const
 void UIWidget::markAsNeedingLayout()
 {
 	layoutNeeded = 1;
+	layoutDirty = true;
 	if (parent) {
 		parent->markAsNeedingLayout();
 	}
 	if (sizer) {
-		sizer->updateEnabled();
+		sizer->markAsNeedingLayout();
 	}
 }
 
+void UIWidget::markLayoutDirty()
+{
+	layoutDirty = true;
+	if (parent) {
+		parent->markLayoutDirty();
+	}
+}
+
+bool UIWidget::isLayoutDirty() const
+{
+	return layoutDirty;
+}
+
 bool UIWidget::canReceiveFocus() const
 {
 	return false;
@@ -220,7 +220,10 @@ std::optional<Vector2f> UIRenderSurface::transformToChildSpace(Vector2f pos) con
 
 void UIRenderSurface::setBypass(bool bypass)
 {
-	this->bypass = bypass;
+	if (this->bypass != bypass) {
+		this->bypass = bypass;
+		markAsNeedingLayout();
+	}
 }
 
 void UIRenderSurface::setAutoBypass(bool autoBypass)
@@ -54,7 +54,10 @@ Vector2f UIScrollPane::getRelativeScrollEndPosition() const
 
 void UIScrollPane::setClipSize(Vector2f clipSize)
 {
-	this->clipSize = clipSize;
+	if (this->clipSize != clipSize) {
+		this->clipSize = clipSize;
+		markAsNeedingLayout();
+	}
 }
 
 void UIScrollPane::scrollTo(Vector2f position)
@@ -71,6 +74,7 @@ void UIScrollPane::scrollTo(Vector2f position)
 	}
 
 	if (scrollPos != old) {
+		markLayoutDirty();
 		sendEventDown(UIEvent(UIEventType::ScrollPositionChanged, getId(), Vector2f(scrollPos)));
 	}
 }
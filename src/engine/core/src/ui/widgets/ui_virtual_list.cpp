@@ -0,0 +1,733 @@
+#include "halley/ui/widgets/ui_virtual_list.h"
+#include "halley/ui/widgets/ui_scroll_pane.h"
+#include "halley/input/input_keyboard.h"
+#include "halley/ui/ui_data_bind.h"
+#include "halley/ui/ui_painter.h"
+#include "halley/ui/ui_root.h"
+
+using namespace Halley;
+
+UIVirtualList::UIVirtualList(String id, UIStyle style, float itemHeight, size_t margin)
+	: UIClickable(std::move(id), {}, UISizer(UISizerType::Free), style.getBorder("innerBorder"))
+	, itemStyle(style.getSubStyle("item"))
+	, itemHeight(itemHeight)
+	, margin(margin)
+{
+	Expects(itemHeight > 0);
+
+	styles.emplace_back(style);
+	background = style.getSprite("background");
+}
+
+UIVirtualList::UIVirtualList(String id, float itemHeight, size_t margin)
+	: UIClickable(std::move(id), {}, UISizer(UISizerType::Free))
+	, itemHeight(itemHeight)
+	, margin(margin)
+{
+	Expects(itemHeight > 0);
+}
+
+void UIVirtualList::setDataSource(std::shared_ptr<IUIVirtualListDataSource> source)
+{
+	dataSource = std::move(source);
+
+	clearChildren();
+	rows.clear();
+	selected.clear();
+	curOption = -1;
+	hoverOption = {};
+	widestItem = 0;
+	firstUpdate = true;
+
+	refresh();
+}
+
+const std::shared_ptr<IUIVirtualListDataSource>& UIVirtualList::getDataSource() const
+{
+	return dataSource;
+}
+
+void UIVirtualList::refresh()
+{
+	count = dataSource ? dataSource->getNumItems() : 0;
+
+	for (auto iter = selected.begin(); iter != selected.end();) {
+		if (*iter >= count) {
+			iter = selected.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	if (curOption >= static_cast<int>(count)) {
+		curOption = static_cast<int>(count) - 1;
+	}
+	if (hoverOption && *hoverOption >= static_cast<int>(count)) {
+		hoverOption = {};
+	}
+
+	// Rows that are still in range get their contents refreshed, the window update takes care of the rest
+	for (size_t i = 0; i < rows.size(); ++i) {
+		if (rows[i].idx) {
+			if (*rows[i].idx < count) {
+				dataSource->updateItem(*rows[i].widget, *rows[i].idx);
+				assignRow(i, *rows[i].idx);
+			} else {
+				releaseRow(rows[i]);
+			}
+		}
+	}
+
+	windowStart = 0;
+	windowEnd = 0;
+	markAsNeedingLayout();
+	updateWindow();
+
+	if (requiresSelection && curOption < 0 && count > 0) {
+		setSelectedOption(0);
+	} else if (curOption >= 0 && selected.empty()) {
+		changeSelection(curOption, SelectionMode::Normal);
+	}
+}
+
+void UIVirtualList::refreshItem(size_t idx)
+{
+	for (size_t i = 0; i < rows.size(); ++i) {
+		if (rows[i].idx == idx) {
+			dataSource->updateItem(*rows[i].widget, idx);
+			onRowsPlaced(assignRow(i, idx));
+		}
+	}
+}
+
+size_t UIVirtualList::getCount() const
+{
+	return count;
+}
+
+size_t UIVirtualList::getNumInstantiatedItems() const
+{
+	return rows.size();
+}
+
+bool UIVirtualList::setSelectedOption(int option, SelectionMode mode)
+{
+	if (count == 0) {
+		return false;
+	}
+
+	if (option < 0 && !requiresSelection) {
+		const bool changed = curOption != -1 || !selected.empty();
+		selected.clear();
+		curOption = -1;
+		if (changed) {
+			refreshAllRowSelections();
+			notifyNewItemSelected();
+		}
+		return changed;
+	}
+
+	return changeSelection(clamp(option, 0, static_cast<int>(count) - 1), multiSelect ? mode : SelectionMode::Normal);
+}
+
+bool UIVirtualList::setSelectedOptionId(const String& id, SelectionMode mode)
+{
+	if (dataSource) {
+		for (size_t i = 0; i < count; ++i) {
+			if (dataSource->getItemId(i) == id) {
+				return setSelectedOption(static_cast<int>(i), mode);
+			}
+		}
+	}
+	return false;
+}
+
+int UIVirtualList::getSelectedOption() const
+{
+	return curOption;
+}
+
+String UIVirtualList::getSelectedOptionId() const
+{
+	if (!dataSource || curOption < 0 || curOption >= static_cast<int>(count)) {
+		return "";
+	}
+	return dataSource->getItemId(static_cast<size_t>(curOption));
+}
+
+Vector<int> UIVirtualList::getSelectedOptions() const
+{
+	Vector<int> result;
+	result.reserve(selected.size());
+	for (const auto idx: selected) {
+		result.push_back(static_cast<int>(idx));
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+Vector<String> UIVirtualList::getSelectedOptionIds() const
+{
+	Vector<String> result;
+	if (dataSource) {
+		for (const auto idx: getSelectedOptions()) {
+			result.push_back(dataSource->getItemId(static_cast<size_t>(idx)));
+		}
+	}
+	return result;
+}
+
+bool UIVirtualList::isSelected(int option) const
+{
+	return option >= 0 && selected.contains(static_cast<size_t>(option));
+}
+
+std::optional<int> UIVirtualList::getHoveredOption() const
+{
+	return hoverOption;
+}
+
+bool UIVirtualList::isMultiSelect() const
+{
+	return multiSelect;
+}
+
+void UIVirtualList::setMultiSelect(bool enabled)
+{
+	multiSelect = enabled;
+	if (!multiSelect && selected.size() > 1 && curOption >= 0) {
+		changeSelection(curOption, SelectionMode::Normal);
+	}
+}
+
+void UIVirtualList::setRequiresSelection(bool requireSelection)
+{
+	requiresSelection = requireSelection;
+	if (requiresSelection && curOption < 0 && count > 0) {
+		setSelectedOption(0);
+	}
+}
+
+void UIVirtualList::setSingleClickAccept(bool enabled)
+{
+	singleClickAccept = enabled;
+}
+
+void UIVirtualList::setScrollToSelection(bool value)
+{
+	scrollToSelection = value;
+}
+
+void UIVirtualList::setIndentSize(float size)
+{
+	if (indentSize != size) {
+		indentSize = size;
+		bool widened = false;
+		for (size_t i = 0; i < rows.size(); ++i) {
+			if (rows[i].idx) {
+				widened |= assignRow(i, *rows[i].idx);
+			}
+		}
+		onRowsPlaced(widened);
+	}
+}
+
+void UIVirtualList::showCurSelection(bool centre)
+{
+	if (curOption >= 0) {
+		sendEvent(UIEvent(centre ? UIEventType::MakeAreaVisibleCentered : UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+	}
+}
+
+Rect4f UIVirtualList::getOptionRect(int option) const
+{
+	if (count == 0) {
+		return Rect4f();
+	}
+
+	const auto border = getInnerBorder();
+	const auto idx = clamp(option, 0, static_cast<int>(count) - 1);
+	const auto rect = Rect4f(border.x, border.y + static_cast<float>(idx) * itemHeight, getSize().x - border.x - border.z, itemHeight);
+	return styles.empty() ? rect : rect.grow(styles[0].getBorder("scrollBorder", Vector4f()));
+}
+
+Vector2f UIVirtualList::getLayoutMinimumSize(bool force) const
+{
+	if (!isActive() && !force) {
+		return {};
+	}
+
+	const auto border = getInnerBorder();
+	const auto contentSize = Vector2f(widestItem, static_cast<float>(count) * itemHeight) + Vector2f(border.x + border.z, border.y + border.w);
+	return Vector2f::max(getMinimumSize(), contentSize);
+}
+
+bool UIVirtualList::canReceiveFocus() const
+{
+	return true;
+}
+
+void UIVirtualList::readFromDataBind()
+{
+	auto data = getDataBind();
+	if (data->getFormat() == UIDataBind::Format::String) {
+		setSelectedOptionId(data->getStringData());
+	} else {
+		setSelectedOption(data->getIntData());
+	}
+}
+
+void UIVirtualList::update(Time t, bool moved)
+{
+	UIClickable::update(t, moved);
+	updateButton();
+
+	if (moved && background.hasMaterial()) {
+		background.scaleTo(getSize()).setPos(getPosition());
+	}
+
+	updateWindow();
+
+	if (firstUpdate && count > 0) {
+		if (scrollToSelection && curOption >= 0) {
+			sendEvent(UIEvent(UIEventType::MakeAreaVisibleCentered, getId(), getOptionRect(curOption)));
+		}
+		firstUpdate = false;
+	}
+}
+
+void UIVirtualList::draw(UIPainter& painter) const
+{
+	if (background.hasMaterial()) {
+		painter.draw(background);
+	}
+	if (styles.empty()) {
+		return;
+	}
+
+	const auto border = getInnerBorder();
+	const float width = getSize().x - border.x - border.z;
+	const auto origin = getPosition() + Vector2f(border.x, border.y);
+
+	for (const auto& row: rows) {
+		if (!row.idx) {
+			continue;
+		}
+
+		const auto idx = static_cast<int>(*row.idx);
+		const char* spriteName = "normal";
+		if (selected.contains(*row.idx) && itemStyle.hasSprite("selected")) {
+			spriteName = "selected";
+		} else if (hoverOption == idx && itemStyle.hasSprite("hover")) {
+			spriteName = "hover";
+		}
+
+		if (itemStyle.hasSprite(spriteName)) {
+			auto sprite = itemStyle.getSprite(spriteName);
+			if (sprite.hasMaterial()) {
+				painter.draw(sprite.scaleTo(Vector2f(width, itemHeight)).setPos(origin + Vector2f(0, static_cast<float>(idx) * itemHeight)));
+			}
+		}
+	}
+}
+
+void UIVirtualList::doSetState(State state)
+{
+	// Rows are drawn by draw() based on selection and hover, nothing to do for the list itself
+}
+
+void UIVirtualList::pressMouse(Vector2f mousePos, int button, KeyMods keyMods)
+{
+	UIClickable::pressMouse(mousePos, button, keyMods);
+
+	const auto option = getOptionAt(mousePos);
+	if (!option) {
+		if (button == 0) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundLeftClicked, getId()));
+		} else if (button == 1) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundMiddleClicked, getId()));
+		} else if (button == 2) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundRightClicked, getId()));
+		}
+		return;
+	}
+
+	const auto mode = getMode(keyMods);
+	if (mode != SelectionMode::Normal || !isSelected(*option)) {
+		setSelectedOption(*option, mode);
+	}
+
+	const auto itemId = dataSource->getItemId(static_cast<size_t>(*option));
+	if (button == 0) {
+		sendEvent(UIEvent(UIEventType::ListItemLeftClicked, getId(), itemId, *option));
+		if (singleClickAccept) {
+			onAccept();
+		}
+	} else if (button == 1) {
+		sendEvent(UIEvent(UIEventType::ListItemMiddleClicked, getId(), itemId, *option));
+	} else if (button == 2) {
+		sendEvent(UIEvent(UIEventType::ListItemRightClicked, getId(), itemId, *option));
+	}
+	focus();
+}
+
+void UIVirtualList::onDoubleClicked(Vector2f mousePos, KeyMods keyMods)
+{
+	const auto option = getOptionAt(mousePos);
+	if (option && keyMods == KeyMods::None) {
+		setSelectedOption(*option);
+		onAccept();
+	}
+}
+
+void UIVirtualList::onMouseOver(Vector2f mousePos)
+{
+	const auto option = getOptionAt(mousePos);
+	if (option != hoverOption) {
+		hoverOption = option;
+		if (hoverOption) {
+			sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), dataSource->getItemId(static_cast<size_t>(*hoverOption)), *hoverOption));
+			playStyleSound("hoverSound");
+		} else {
+			sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), String(), -1));
+		}
+	}
+}
+
+void UIVirtualList::onMouseLeft(Vector2f mousePos)
+{
+	if (hoverOption) {
+		hoverOption = {};
+		sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), String(), -1));
+	}
+}
+
+bool UIVirtualList::onKeyPress(KeyboardKeyPress key)
+{
+	const auto [visibleStart, visibleEnd] = getVisibleRange();
+	const int pageSize = std::max(1, static_cast<int>(visibleEnd - visibleStart) - 2 * static_cast<int>(margin) - 1);
+
+	if (key.is(KeyCode::Up)) {
+		moveSelection(-1);
+		return true;
+	}
+
+	if (key.is(KeyCode::Down)) {
+		moveSelection(1);
+		return true;
+	}
+
+	if (key.is(KeyCode::PageUp)) {
+		setSelectedOption(std::max(curOption - pageSize, 0));
+		return true;
+	}
+
+	if (key.is(KeyCode::PageDown)) {
+		setSelectedOption(std::min(curOption + pageSize, static_cast<int>(count) - 1));
+		return true;
+	}
+
+	if (key.is(KeyCode::Home)) {
+		setSelectedOption(0);
+		return true;
+	}
+
+	if (key.is(KeyCode::End)) {
+		setSelectedOption(static_cast<int>(count) - 1);
+		return true;
+	}
+
+	if (key.is(KeyCode::Enter)) {
+		onAccept();
+		return true;
+	}
+
+	return false;
+}
+
+void UIVirtualList::onGamepadInput(const UIInputResults& input, Time time)
+{
+	if (count == 0) {
+		return;
+	}
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Next)) {
+		setSelectedOption(modulo(curOption + 1, static_cast<int>(count)));
+	}
+	if (input.isButtonPressed(UIGamepadInput::Button::Prev)) {
+		setSelectedOption(modulo(curOption - 1, static_cast<int>(count)));
+	}
+
+	moveSelection(input.getAxisRepeat(UIGamepadInput::Axis::Y));
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Accept)) {
+		onAccept();
+	}
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Cancel)) {
+		onCancel();
+	}
+}
+
+void UIVirtualList::updateWindow()
+{
+	const auto [start, end] = getVisibleRange();
+	if (start == windowStart && end == windowEnd) {
+		return;
+	}
+	windowStart = start;
+	windowEnd = end;
+
+	// Rows leaving the window stay active for now, as they're likely to be reused straight away.
+	// Toggling them would invalidate the layout of every ancestor, once per row.
+	for (auto& row: rows) {
+		if (row.idx && (*row.idx < start || *row.idx >= end)) {
+			row.idx = {};
+		}
+	}
+
+	Vector<bool> present(end - start, false);
+	for (const auto& row: rows) {
+		if (row.idx) {
+			present[*row.idx - start] = true;
+		}
+	}
+
+	// Recycle free rows before creating new ones. Row n is always sizer entry n, as rows are never removed.
+	bool placed = false;
+	bool widened = false;
+	size_t nextFree = 0;
+	for (size_t i = start; i < end; ++i) {
+		if (present[i - start]) {
+			continue;
+		}
+
+		while (nextFree < rows.size() && rows[nextFree].idx) {
+			++nextFree;
+		}
+
+		if (nextFree < rows.size()) {
+			dataSource->updateItem(*rows[nextFree].widget, i);
+			widened |= assignRow(nextFree, i);
+		} else {
+			auto widget = dataSource->makeItem(i);
+			widget->setMinSize(Vector2f(widget->getMinimumSize().x, itemHeight));
+			add(widget, 0, {}, UISizerAlignFlags::Left | UISizerAlignFlags::Top | UISizerFillFlags::FillHorizontal);
+			rows.push_back(Row{ std::move(widget), {} });
+			widened |= assignRow(rows.size() - 1, i);
+		}
+		placed = true;
+	}
+
+	// Whatever wasn't reused is hidden until the window grows again
+	for (auto& row: rows) {
+		if (!row.idx) {
+			releaseRow(row);
+		}
+	}
+
+	if (placed) {
+		onRowsPlaced(widened);
+	}
+}
+
+std::pair<size_t, size_t> UIVirtualList::getVisibleRange() const
+{
+	if (!dataSource || count == 0) {
+		return { 0, 0 };
+	}
+
+	auto visible = getRect();
+	if (const auto* pane = findScrollPane()) {
+		visible = visible.intersection(pane->getRect());
+	} else if (const auto* root = getRoot()) {
+		visible = visible.intersection(root->getRect());
+	}
+
+	const float top = getPosition().y + getInnerBorder().y;
+	const float y0 = std::max(visible.getTop() - top, 0.0f);
+	const float y1 = std::max(visible.getBottom() - top, y0);
+	const auto first = static_cast<size_t>(std::floor(y0 / itemHeight));
+	const auto last = static_cast<size_t>(std::ceil(y1 / itemHeight));
+
+	const size_t end = std::min(count, last + margin);
+	const size_t start = std::min(first > margin ? first - margin : 0, end);
+	return { start, end };
+}
+
+const UIScrollPane* UIVirtualList::findScrollPane() const
+{
+	for (auto* parent = getParent(); parent;) {
+		if (const auto* pane = dynamic_cast<const UIScrollPane*>(parent)) {
+			return pane;
+		}
+		const auto* widget = dynamic_cast<const UIWidget*>(parent);
+		parent = widget ? widget->getParent() : nullptr;
+	}
+	return nullptr;
+}
+
+bool UIVirtualList::assignRow(size_t rowIdx, size_t itemIdx)
+{
+	auto& row = rows[rowIdx];
+	row.idx = itemIdx;
+	row.widget->setActive(true);
+
+	// The list works out its own minimum size, so moving a row only needs it to be placed again, see onRowsPlaced()
+	const float indent = static_cast<float>(dataSource->getItemDepth(itemIdx)) * indentSize;
+	getSizer()[rowIdx].setBorder(Vector4f(indent, static_cast<float>(itemIdx) * itemHeight, 0, 0), false);
+
+	refreshRowSelection(row);
+
+	const float width = row.widget->getLayoutMinimumSize(false).x + indent;
+	if (width > widestItem) {
+		widestItem = width;
+		return true;
+	}
+	return false;
+}
+
+void UIVirtualList::releaseRow(Row& row)
+{
+	row.idx = {};
+	row.widget->setActive(false);
+}
+
+void UIVirtualList::onRowsPlaced(bool widened)
+{
+	if (widened) {
+		markAsNeedingLayout();
+	} else {
+		markLayoutDirty();
+	}
+}
+
+void UIVirtualList::refreshRowSelection(const Row& row) const
+{
+	if (row.idx) {
+		row.widget->sendEventDown(UIEvent(UIEventType::SetSelected, getId(), selected.contains(*row.idx)));
+	}
+}
+
+void UIVirtualList::refreshAllRowSelections() const
+{
+	for (const auto& row: rows) {
+		refreshRowSelection(row);
+	}
+}
+
+std::optional<int> UIVirtualList::getOptionAt(Vector2f mousePos) const
+{
+	const float y = mousePos.y - getPosition().y - getInnerBorder().y;
+	if (y < 0) {
+		return {};
+	}
+	const auto idx = static_cast<size_t>(y / itemHeight);
+	if (idx >= count) {
+		return {};
+	}
+	return static_cast<int>(idx);
+}
+
+bool UIVirtualList::changeSelection(int newOption, SelectionMode mode)
+{
+	const auto option = static_cast<size_t>(newOption);
+	const int prevOption = curOption;
+	bool changed = false;
+
+	switch (mode) {
+	case SelectionMode::Normal:
+		if (selected.size() != 1 || !selected.contains(option)) {
+			selected.clear();
+			selected.insert(option);
+			changed = true;
+		}
+		curOption = newOption;
+		break;
+
+	case SelectionMode::AddToSelect:
+		changed = selected.insert(option).second;
+		curOption = newOption;
+		break;
+
+	case SelectionMode::CtrlSelect:
+		if (selected.contains(option)) {
+			if (selected.size() > 1 || !requiresSelection) {
+				selected.erase(option);
+				changed = true;
+			}
+		} else {
+			selected.insert(option);
+			changed = true;
+		}
+		if (selected.contains(option)) {
+			curOption = newOption;
+		} else if (curOption == newOption) {
+			curOption = selected.empty() ? -1 : static_cast<int>(*std::min_element(selected.begin(), selected.end()));
+		}
+		break;
+
+	case SelectionMode::ShiftSelect:
+		{
+			// Select the range between the current option and the new one, the current option stays as the anchor
+			const int anchor = curOption >= 0 ? curOption : newOption;
+			selected.clear();
+			for (int i = std::min(anchor, newOption); i <= std::max(anchor, newOption); ++i) {
+				selected.insert(static_cast<size_t>(i));
+			}
+			curOption = anchor;
+			changed = true;
+		}
+		break;
+	}
+
+	changed |= curOption != prevOption;
+	if (changed) {
+		refreshAllRowSelections();
+		notifyNewItemSelected();
+	}
+	return changed;
+}
+
+void UIVirtualList::notifyNewItemSelected()
+{
+	const auto itemId = getSelectedOptionId();
+	playStyleSound("selectionChangedSound");
+	sendEvent(UIEvent(UIEventType::ListSelectionChanged, getId(), itemId, curOption));
+
+	if (scrollToSelection && curOption >= 0) {
+		sendEvent(UIEvent(UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+	}
+
+	if (getDataBindFormat() == UIDataBind::Format::String) {
+		notifyDataBind(itemId);
+	} else {
+		notifyDataBind(curOption);
+	}
+}
+
+void UIVirtualList::moveSelection(int delta)
+{
+	if (delta == 0 || count == 0) {
+		return;
+	}
+	setSelectedOption(modulo(curOption + delta, static_cast<int>(count)));
+}
+
+void UIVirtualList::onAccept()
+{
+	playStyleSound("acceptSound");
+	sendEvent(UIEvent(UIEventType::ListAccept, getId(), getSelectedOptionId(), curOption));
+}
+
+void UIVirtualList::onCancel()
+{
+	playStyleSound("cancelSound");
+	sendEvent(UIEvent(UIEventType::ListCancel, getId(), getSelectedOptionId(), curOption));
+}
+
+UIVirtualList::SelectionMode UIVirtualList::getMode(KeyMods keyMods) const
+{
+	const bool shiftHeld = (static_cast<int>(keyMods) & static_cast<int>(KeyMods::Shift)) != 0;
+	const bool ctrlHeld = (static_cast<int>(keyMods) & static_cast<int>(KeyMods::Ctrl)) != 0;
+	return shiftHeld ? SelectionMode::ShiftSelect : (ctrlHeld ? SelectionMode::CtrlSelect : SelectionMode::Normal);
+}
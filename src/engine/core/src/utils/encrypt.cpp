@@ -10,28 +10,48 @@ using namespace Halley;
 
 Bytes Encrypt::encryptAES(AESIV iv, AESKey key, const Bytes& data)
 {
-	// Prepare buffer
-	Bytes result = data;
-	const size_t origSize = result.size();
-	size_t newSize = alignUp(origSize, size_t(AES_BLOCKLEN));
-	if (newSize == origSize) {
-		// Must always add some padding, otherwise PKCS7 can't be undone
-		newSize += AES_BLOCKLEN;
+	Bytes result(getEncryptedSize(data.size()));
+	encryptAES(iv, key, data.byte_span(), result.byte_span());
+	return result;
+}
+
+size_t Encrypt::getEncryptedSize(size_t size)
+{
+	// Must always add some padding, otherwise PKCS7 can't be undone
+	return alignUp(size + 1, size_t(AES_BLOCKLEN));
+}
+
+void Encrypt::encryptAES(AESIV iv, AESKey key, gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst)
+{
+	const size_t origSize = src.size();
+	const size_t newSize = getEncryptedSize(origSize);
+	if (dst.size() != newSize) {
+		throw Exception("Invalid destination size for encryption", HalleyExceptions::Utils);
 	}
 
 	// Pad with PKCS7
-	const unsigned char pad = static_cast<unsigned char>(newSize - origSize);
-	result.resize(newSize);
+	memcpy(dst.data(), src.data(), origSize);
+	const auto pad = static_cast<gsl::byte>(newSize - origSize);
 	for (size_t i = origSize; i < newSize; ++i) {
-		result[i] = pad;
+		dst[i] = pad;
 	}
 
 	// Encrypt
 	AES_ctx ctx;
 	AES_init_ctx_iv(&ctx, key.data(), iv.data());
-	AES_CBC_encrypt_buffer(&ctx, result.data(), uint32_t(result.size()));
+	AES_CBC_encrypt_buffer(&ctx, reinterpret_cast<uint8_t*>(dst.data()), uint32_t(dst.size()));
+}
 
-	return result;
+void Encrypt::decryptAESInPlace(AESIV iv, AESKey key, gsl::span<gsl::byte> data)
+{
+	if (data.size() % AES_BLOCKLEN != 0) {
+		throw Exception("Encrypted block does not have the correct length.", HalleyExceptions::Utils);
+	}
+
+	AES_ctx ctx;
+	std::memset(&ctx, 0, sizeof(ctx));
+	AES_init_ctx_iv(&ctx, key.data(), iv.data());
+	AES_CBC_decrypt_buffer(&ctx, reinterpret_cast<uint8_t*>(data.data()), uint32_t(data.size()));
 }
 
 Bytes Encrypt::decryptAES(AESIV iv, AESKey key, const Bytes& data)
@@ -1,4 +1,5 @@
 #include <systems/script_system.h>
+#include "halley/scripting/script_parallel_updater.h"
 
 using namespace Halley;
 
@@ -216,6 +217,8 @@ public:
 private:
 	Vector<std::pair<EntityId, ScriptMessage>> pendingMessages;
 
+	ScriptParallelUpdater<ScriptEnvironment> parallelUpdater;
+
 	void initializeEnvironment()
 	{
 		getScriptingService().getEnvironment().setScriptTargetRetriever([this] (const String& id) -> EntityId
@@ -279,22 +282,58 @@ private:
 	void updateScripts(Time t)
 	{
 		auto& env = getScriptingService().getEnvironment();
+		if (updateScriptsParallel(t, env)) {
+			return;
+		}
+
 		for (auto& e : scriptableFamily) {
-			e.scriptable.activeStates.terminateMarkedDead(env, e.entityId, e.scriptable.variables);
+			updateEntityScripts(t, env, e);
+		}
+	}
 
-			for (auto& state: e.scriptable.activeStates) {
-				if (!state->getFrameFlag()) {
-					env.update(t, *state, e.entityId, e.scriptable.variables);
-					state->setFrameFlag(true);
-				}
+	void updateEntityScripts(Time t, ScriptEnvironment& env, ScriptableFamily& e)
+	{
+		e.scriptable.activeStates.terminateMarkedDead(env, e.entityId, e.scriptable.variables);
 
-				if (env.hasStopRequests()) {
-					break;
-				}
+		for (auto& state: e.scriptable.activeStates) {
+			if (!state->getFrameFlag()) {
+				env.update(t, *state, e.entityId, e.scriptable.variables);
+				state->setFrameFlag(true);
 			}
 
-			eraseDeadScripts(e);
+			if (env.hasStopRequests()) {
+				break;
+			}
+		}
+
+		eraseDeadScripts(e);
+	}
+
+	bool isParallelSafe(ScriptEnvironment& env, const ScriptableFamily& e) const
+	{
+		for (const auto& state: e.scriptable.activeStates) {
+			const auto* graph = state->getScriptGraphPtr();
+			if (!graph) {
+				return false;
+			}
+			env.assignTypes(*graph);
+			if (!graph->isParallelSafe()) {
+				return false;
+			}
+			if (state->hasStarted() && state->getGraphHash() != graph->getHash()) {
+				// Reloaded script, will have to terminate against the previous version
+				return false;
+			}
 		}
+		return true;
+	}
+
+	bool updateScriptsParallel(Time t, ScriptEnvironment& env)
+	{
+		// Parallel-safe entities update first, on worker threads, and the rest on this one afterwards (see ScriptParallelUpdater)
+		return parallelUpdater.update(env, scriptableFamily.size(),
+			[&] (size_t idx) { return isParallelSafe(env, scriptableFamily[idx]); },
+			[&] (ScriptEnvironment& e, size_t idx) { updateEntityScripts(t, e, scriptableFamily[idx]); });
 	}
 
 	void eraseDeadScripts(ScriptableFamily& e)
@@ -222,6 +222,30 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 	doneLoading();
 }
 
+bool DX11Texture::doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride)
+{
+	// Staging textures can't be updated this way
+	if (!texture || descriptor.canBeReadOnCPU) {
+		return false;
+	}
+
+	D3D11_BOX box;
+	box.left = region.getLeft();
+	box.right = region.getRight();
+	box.top = region.getTop();
+	box.bottom = region.getBottom();
+	box.front = 0;
+	box.back = 1;
+
+	const int bpp = TextureDescriptor::getBytesPerPixel(descriptor.format);
+	video.getDeviceContext().UpdateSubresource(texture, 0, &box, data.data(), stride * bpp, 0);
+
+	if (descriptor.useMipMap) {
+		generateMipMaps();
+	}
+	return true;
+}
+
 void DX11Texture::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<DX11Texture&>(resource));
@@ -18,6 +18,7 @@ namespace Halley
 		DX11Texture& operator=(DX11Texture&& other) noexcept;
 
 		void doLoad(TextureDescriptor& descriptor) override;
+		bool doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride) override;
 		void reload(Resource&& resource) override;
 		void bind(DX11Video& video, int textureUnit, TextureSamplerType samplerType) const;
 		void generateMipMaps() override;
@@ -15,6 +15,7 @@ namespace Halley {
 	public:
 		explicit MetalTexture(MetalVideo& video, Vector2i size);
 		void doLoad(TextureDescriptor& descriptor) override;
+		bool doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride) override;
 		void bind(id<MTLRenderCommandEncoder> encoder, int bindIndex) const;
 
 	private:
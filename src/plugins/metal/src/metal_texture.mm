@@ -81,6 +81,23 @@ void MetalTexture::doLoad(TextureDescriptor& descriptor)
 	doneLoading();
 }
 
+bool MetalTexture::doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride)
+{
+	// Mipmaps are never generated here, so let those go through a full load
+	if (!metalTexture || descriptor.useMipMap) {
+		return false;
+	}
+
+	const MTLRegion mtlRegion = MTLRegionMake2D(region.getLeft(), region.getTop(), region.getWidth(), region.getHeight());
+	const auto bytesPerRow = static_cast<NSUInteger>(stride * TextureDescriptor::getBytesPerPixel(descriptor.format));
+	[metalTexture replaceRegion:mtlRegion
+		mipmapLevel:0
+		withBytes:data.data()
+		bytesPerRow:bytesPerRow
+	];
+	return true;
+}
+
 void MetalTexture::bind(id<MTLRenderCommandEncoder> encoder, int bindIndex) const
 {
 	waitForLoad();
@@ -60,6 +60,31 @@ void TextureOpenGL::doLoad(TextureDescriptor& d)
 	finishLoading();
 }
 
+bool TextureOpenGL::doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride)
+{
+#ifdef GL_UNPACK_ROW_LENGTH
+	waitForOpenGLLoad();
+
+	GLUtils glUtils;
+	glUtils.setTextureUnit(0);
+	glUtils.bindTexture(textureId);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, TextureDescriptor::getBytesPerPixel(descriptor.format) == 4 ? 4 : 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, region.getLeft(), region.getTop(), region.getWidth(), region.getHeight(), getGLPixelFormat(descriptor.format), getGLByteFormat(descriptor.format), data.data());
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glCheckError();
+
+	if (descriptor.useMipMap) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glCheckError();
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
 void TextureOpenGL::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<TextureOpenGL&>(resource));
@@ -21,6 +21,7 @@ namespace Halley
 		unsigned int getNativeId() const;
 
 		void doLoad(TextureDescriptor& descriptor) override;
+		bool doUpdateRegion(Rect4i region, gsl::span<const gsl::byte> data, int stride) override;
 		void reload(Resource&& resource) override;
 
 		void generateMipMaps() override;
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "audio/audio_mixer.h"
+using namespace Halley;
+
+namespace {
+	// Odd sizes so that the scalar tails of the vector kernels also get exercised
+	constexpr size_t testSizes[] = { 1, 7, 16, 33, 256, 1027 };
+
+	Vector<AudioSample> makeSignal(size_t n, uint32_t seed)
+	{
+		Random rng(seed);
+		Vector<AudioSample> result(n);
+		for (auto& s: result) {
+			s = rng.getFloat(-1.0f, 1.0f);
+		}
+		return result;
+	}
+
+	Vector<AudioMixerImplementation> getSupportedImplementations()
+	{
+		Vector<AudioMixerImplementation> result;
+		for (const auto impl: { AudioMixerImplementation::SSE, AudioMixerImplementation::AVX2, AudioMixerImplementation::NEON }) {
+			if (AudioMixer::isImplementationSupported(impl)) {
+				result.push_back(impl);
+			}
+		}
+		return result;
+	}
+
+	class AudioMixerImplementationScope {
+	public:
+		AudioMixerImplementationScope(AudioMixerImplementation impl)
+			: prev(AudioMixer::getImplementation())
+		{
+			AudioMixer::setImplementation(impl);
+		}
+
+		~AudioMixerImplementationScope()
+		{
+			AudioMixer::setImplementation(prev);
+		}
+
+	private:
+		AudioMixerImplementation prev;
+	};
+
+	template <typename F>
+	auto runWith(AudioMixerImplementation impl, F f)
+	{
+		AudioMixerImplementationScope scope(impl);
+		return f();
+	}
+}
+
+TEST(HalleyAudioMixer, MixAudioMatchesScalar)
+{
+	for (const auto impl: getSupportedImplementations()) {
+		for (const size_t n: testSizes) {
+			const auto src = makeSignal(n, 1);
+			const auto dst = makeSignal(n, 2);
+
+			auto mix = [&] (float g0, float g1)
+			{
+				auto result = dst;
+				AudioMixer::mixAudio(AudioSamplesConst(src), AudioSamples(result), g0, g1);
+				return result;
+			};
+
+			for (const auto& [g0, g1]: { std::pair(1.0f, 1.0f), std::pair(0.5f, 0.5f), std::pair(0.0f, 1.0f), std::pair(0.8f, 0.2f) }) {
+				const auto expected = runWith(AudioMixerImplementation::Scalar, [&] { return mix(g0, g1); });
+				const auto actual = runWith(impl, [&] { return mix(g0, g1); });
+				for (size_t i = 0; i < n; ++i) {
+					EXPECT_NEAR(expected[i], actual[i], 0.00001f) << toString(impl) << " n=" << n << " i=" << i;
+				}
+			}
+		}
+	}
+}
+
+TEST(HalleyAudioMixer, CopyWithGainMatchesScalar)
+{
+	for (const auto impl: getSupportedImplementations()) {
+		for (const size_t n: testSizes) {
+			auto src = makeSignal(n, 3);
+
+			auto copy = [&] ()
+			{
+				Vector<AudioSample> result(n);
+				AudioMixer::copy(AudioSamples(result), AudioSamples(src), 0.25f, 1.5f);
+				return result;
+			};
+
+			const auto expected = runWith(AudioMixerImplementation::Scalar, copy);
+			const auto actual = runWith(impl, copy);
+			for (size_t i = 0; i < n; ++i) {
+				EXPECT_NEAR(expected[i], actual[i], 0.00001f) << toString(impl) << " n=" << n << " i=" << i;
+			}
+		}
+	}
+}
+
+TEST(HalleyAudioMixer, CompressAndInterleaveMatchScalar)
+{
+	for (const auto impl: getSupportedImplementations()) {
+		for (const size_t n: testSizes) {
+			AudioBuffer left(n);
+			AudioBuffer right(n);
+			const auto l = makeSignal(n, 4);
+			const auto r = makeSignal(n, 5);
+			for (size_t i = 0; i < n; ++i) {
+				left.samples[i] = l[i] * 2.0f;
+				right.samples[i] = r[i] * 2.0f;
+			}
+			AudioBuffer* srcs[] = { &left, &right };
+
+			auto run = [&] ()
+			{
+				Vector<AudioSample> result(n * 2);
+				AudioMixer::interleaveChannels(AudioSamples(result), srcs);
+				AudioMixer::compressRange(AudioSamples(result));
+				return result;
+			};
+
+			const auto expected = runWith(AudioMixerImplementation::Scalar, run);
+			const auto actual = runWith(impl, run);
+			EXPECT_EQ(expected, actual) << toString(impl) << " n=" << n;
+		}
+	}
+}
+
+TEST(HalleyAudioMixer, IntegerConversionMatchesScalar)
+{
+	for (const auto impl: getSupportedImplementations()) {
+		for (const size_t n: testSizes) {
+			auto src = makeSignal(n, 6);
+			AudioMixer::compressRange(AudioSamples(src));
+
+			auto run = [&] ()
+			{
+				Vector<int16_t> dst16(n);
+				Vector<int32_t> dst32(n);
+				AudioMixer::convertToInt16(AudioSamplesConst(src), dst16);
+				AudioMixer::convertToInt32(AudioSamplesConst(src), dst32);
+				return std::pair(dst16, dst32);
+			};
+
+			const auto expected = runWith(AudioMixerImplementation::Scalar, run);
+			const auto actual = runWith(impl, run);
+			EXPECT_EQ(expected.first, actual.first) << toString(impl) << " n=" << n;
+			EXPECT_EQ(expected.second, actual.second) << toString(impl) << " n=" << n;
+		}
+	}
+}
+
+// Run with --gtest_also_run_disabled_tests to compare throughput of each implementation
+namespace {
+	constexpr size_t benchmarkSamples = 512;
+	constexpr size_t benchmarkIterations = 200000;
+
+	template <typename F>
+	void runBenchmark(const char* kernel, F f)
+	{
+		Vector<AudioMixerImplementation> impls = { AudioMixerImplementation::Scalar };
+		for (const auto impl: getSupportedImplementations()) {
+			impls.push_back(impl);
+		}
+
+		for (const auto impl: impls) {
+			AudioMixerImplementationScope scope(impl);
+			Stopwatch timer;
+			for (size_t i = 0; i < benchmarkIterations; ++i) {
+				f();
+			}
+			const double seconds = timer.elapsedNanoseconds() / 1'000'000'000.0;
+			const double mbPerSec = static_cast<double>(benchmarkSamples * benchmarkIterations * sizeof(AudioSample)) / (1024.0 * 1024.0) / seconds;
+			std::cout << kernel << " " << toString(impl) << ": " << mbPerSec << " MB/s" << std::endl;
+		}
+	}
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkMixAudio)
+{
+	const auto src = makeSignal(benchmarkSamples, 7);
+	auto dst = makeSignal(benchmarkSamples, 8);
+	runBenchmark("mixAudio", [&] ()
+	{
+		AudioMixer::mixAudio(AudioSamplesConst(src), AudioSamples(dst), 0.5f, 0.25f);
+	});
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkCopyWithGain)
+{
+	auto src = makeSignal(benchmarkSamples, 9);
+	auto dst = makeSignal(benchmarkSamples, 10);
+	runBenchmark("copyWithGain", [&] ()
+	{
+		AudioMixer::copy(AudioSamples(dst), AudioSamples(src), 0.25f, 1.5f);
+	});
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkCompressRange)
+{
+	auto src = makeSignal(benchmarkSamples, 11);
+	auto buffer = src;
+	runBenchmark("compressRange", [&] ()
+	{
+		// Bring it back out of range, so every iteration does the same work
+		AudioMixer::copy(AudioSamples(buffer), AudioSamples(src), 2.0f, 2.0f);
+		AudioMixer::compressRange(AudioSamples(buffer));
+	});
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkInterleaveStereo)
+{
+	AudioBuffer left(benchmarkSamples / 2);
+	AudioBuffer right(benchmarkSamples / 2);
+	const auto l = makeSignal(benchmarkSamples / 2, 12);
+	const auto r = makeSignal(benchmarkSamples / 2, 13);
+	for (size_t i = 0; i < benchmarkSamples / 2; ++i) {
+		left.samples[i] = l[i];
+		right.samples[i] = r[i];
+	}
+	AudioBuffer* srcs[] = { &left, &right };
+	Vector<AudioSample> dst(benchmarkSamples);
+	runBenchmark("interleaveStereo", [&] ()
+	{
+		AudioMixer::interleaveChannels(AudioSamples(dst), srcs);
+	});
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkConvertToInt16)
+{
+	const auto src = makeSignal(benchmarkSamples, 14);
+	Vector<int16_t> dst(benchmarkSamples);
+	runBenchmark("convertToInt16", [&] ()
+	{
+		AudioMixer::convertToInt16(AudioSamplesConst(src), dst);
+	});
+}
+
+TEST(HalleyAudioMixer, DISABLED_BenchmarkConvertToInt32)
+{
+	const auto src = makeSignal(benchmarkSamples, 15);
+	Vector<int32_t> dst(benchmarkSamples);
+	runBenchmark("convertToInt32", [&] ()
+	{
+		AudioMixer::convertToInt32(AudioSamplesConst(src), dst);
+	});
+}
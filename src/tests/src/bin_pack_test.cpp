@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/data_structures/bin_pack.h"
+using namespace Halley;
+
+namespace {
+	Vector<BinPackEntry> makeEntries(size_t n, uint32_t seed, bool canRotate)
+	{
+		Random rng(seed);
+		Vector<BinPackEntry> result;
+		for (size_t i = 0; i < n; ++i) {
+			const auto size = Vector2i(rng.getInt(1, 64), rng.getInt(1, 64));
+			result.emplace_back(size, reinterpret_cast<void*>(i + 1), canRotate);
+		}
+		return result;
+	}
+
+	void checkPacking(const Vector<BinPackEntry>& entries, const Vector<BinPackResult>& results, Vector2i binSize)
+	{
+		ASSERT_EQ(entries.size(), results.size());
+
+		HashSet<void*> seen;
+		for (size_t i = 0; i < results.size(); ++i) {
+			const auto& r = results[i];
+			const auto iter = std::find_if(entries.begin(), entries.end(), [&] (const BinPackEntry& e) { return e.data == r.data; });
+			ASSERT_NE(iter, entries.end());
+			EXPECT_TRUE(seen.insert(r.data).second);
+
+			const auto expectedSize = r.rotated ? Vector2i(iter->size.y, iter->size.x) : iter->size;
+			EXPECT_EQ(expectedSize, r.rect.getSize());
+			EXPECT_TRUE(!r.rotated || iter->canRotate);
+
+			EXPECT_GE(r.rect.getLeft(), 0);
+			EXPECT_GE(r.rect.getTop(), 0);
+			EXPECT_LE(r.rect.getRight(), binSize.x);
+			EXPECT_LE(r.rect.getBottom(), binSize.y);
+
+			for (size_t j = i + 1; j < results.size(); ++j) {
+				EXPECT_FALSE(r.rect.overlaps(results[j].rect)) << "Entries " << i << " and " << j << " overlap";
+			}
+		}
+	}
+
+	int64_t getArea(Vector2i size)
+	{
+		return int64_t(size.x) * int64_t(size.y);
+	}
+}
+
+TEST(HalleyBinPack, MaxRectsPacksWithoutOverlaps)
+{
+	for (const bool canRotate: { false, true }) {
+		const auto entries = makeEntries(300, 1, canRotate);
+		const auto binSize = Vector2i(1024, 512);
+		const auto results = BinPack::maxRectsPack(entries, binSize);
+		ASSERT_TRUE(results.has_value());
+		checkPacking(entries, *results, binSize);
+	}
+}
+
+TEST(HalleyBinPack, MaxRectsFailsWhenTooSmall)
+{
+	const auto entries = makeEntries(300, 2, true);
+	EXPECT_FALSE(BinPack::maxRectsPack(entries, Vector2i(128, 128)).has_value());
+}
+
+TEST(HalleyBinPack, PackSmallestRespectsPowerOfTwo)
+{
+	const auto entries = makeEntries(200, 3, false);
+	for (const bool powerOfTwo: { false, true }) {
+		const auto result = BinPack::packSmallest(entries, Vector2i(4096, 4096), powerOfTwo);
+		ASSERT_TRUE(result.has_value());
+		checkPacking(entries, result->results, result->size);
+		if (powerOfTwo) {
+			EXPECT_EQ(nextPowerOf2(result->size.x), result->size.x);
+			EXPECT_EQ(nextPowerOf2(result->size.y), result->size.y);
+		}
+		EXPECT_GT(result->occupancy, 0.0f);
+		EXPECT_LE(result->occupancy, 100.0f);
+	}
+}
+
+TEST(HalleyBinPack, PackSmallestBeatsShelfPacking)
+{
+	const auto entries = makeEntries(500, 4, false);
+	const auto result = BinPack::packSmallest(entries, Vector2i(4096, 4096), false);
+	ASSERT_TRUE(result.has_value());
+
+	// Smallest square the shelf packer manages
+	std::optional<int64_t> shelfArea;
+	for (int size = 64; size <= 4096 && !shelfArea; size += 64) {
+		if (const auto shelf = BinPack::fastPack(entries, Vector2i(size, size))) {
+			Vector2i bounds;
+			for (const auto& r: *shelf) {
+				bounds = Vector2i::max(bounds, r.rect.getBottomRight());
+			}
+			shelfArea = getArea(bounds);
+		}
+	}
+	ASSERT_TRUE(shelfArea.has_value());
+	EXPECT_LE(getArea(result->size), *shelfArea);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/maths/collision_world.h"
+#include <chrono>
+using namespace Halley;
+
+namespace {
+	Polygon makeShape(Random& rng, Vector2f pos)
+	{
+		const auto size = Vector2f(rng.getFloat(4.0f, 40.0f), rng.getFloat(4.0f, 40.0f));
+		if (rng.getInt(0, 1) == 0) {
+			return Polygon(Rect4f(pos, pos + size));
+		}
+
+		// Random convex polygon, from points on an ellipse
+		const int n = rng.getInt(3, 9);
+		VertexList vertices;
+		for (int i = 0; i < n; ++i) {
+			const float angle = static_cast<float>(i) / n * 2.0f * pi();
+			vertices.push_back(pos + size * Vector2f(std::cos(angle), std::sin(angle)));
+		}
+		return Polygon(std::move(vertices));
+	}
+
+	Vector<CollisionWorld::SweepQuery> makeQueries(Random& rng, size_t n, float levelSize)
+	{
+		Vector<CollisionWorld::SweepQuery> result;
+		for (size_t i = 0; i < n; ++i) {
+			CollisionWorld::SweepQuery query;
+			query.pos = Vector2f(rng.getFloat(0, levelSize), rng.getFloat(0, levelSize));
+			const float r = rng.getFloat(2.0f, 12.0f);
+			query.radius = i % 3 == 0 ? Vector2f(r, r * 0.5f) : Vector2f(r, r);
+			query.moveDir = Vector2f(rng.getFloat(-1, 1), rng.getFloat(-1, 1)).normalized();
+			query.moveLen = rng.getFloat(1.0f, 150.0f);
+			result.push_back(query);
+		}
+		return result;
+	}
+
+	CollisionWorld::SweepResult bruteForce(const Vector<Polygon>& polygons, const CollisionWorld::SweepQuery& query)
+	{
+		CollisionWorld::SweepResult result;
+		for (size_t i = 0; i < polygons.size(); ++i) {
+			const auto col = query.radius.x == query.radius.y
+				? polygons[i].getCollisionWithSweepingCircle(query.pos, query.radius.x, query.moveDir, query.moveLen)
+				: polygons[i].getCollisionWithSweepingEllipse(query.pos, query.radius, query.moveDir, query.moveLen);
+			if (col.collided && (!result.collided || col.distance < result.distance)) {
+				result.collided = true;
+				result.distance = col.distance;
+				result.normal = col.normal;
+				result.collider = static_cast<CollisionWorld::ColliderId>(i);
+			}
+		}
+		return result;
+	}
+}
+
+TEST(CollisionWorld, SweepsMatchBruteForce)
+{
+	Random rng(uint32_t(1234));
+	constexpr float levelSize = 2000.0f;
+
+	CollisionWorld world;
+	Vector<Polygon> polygons;
+	for (int i = 0; i < 2000; ++i) {
+		polygons.push_back(makeShape(rng, Vector2f(rng.getFloat(0, levelSize), rng.getFloat(0, levelSize))));
+		world.add(polygons.back(), i % 4 == 0 ? CollisionWorld::ColliderType::Dynamic : CollisionWorld::ColliderType::Static);
+	}
+	world.update();
+
+	// Move the dynamic ones
+	for (int i = 0; i < 2000; i += 4) {
+		const auto offset = Vector2f(rng.getFloat(-50, 50), rng.getFloat(-50, 50));
+		polygons[i].translate(offset);
+		world.translate(static_cast<CollisionWorld::ColliderId>(i), offset);
+	}
+	world.update();
+
+	const auto queries = makeQueries(rng, 500, levelSize);
+	Vector<CollisionWorld::SweepResult> results;
+	world.sweep(queries, results);
+
+	size_t nCollided = 0;
+	for (size_t i = 0; i < queries.size(); ++i) {
+		const auto expected = bruteForce(polygons, queries[i]);
+		ASSERT_EQ(results[i].collided, expected.collided) << i;
+		if (expected.collided) {
+			// Ellipse sweeps rescale by the move length, which gets shortened as closer hits are found
+			EXPECT_NEAR(results[i].distance, expected.distance, 0.001f) << i;
+			++nCollided;
+		}
+	}
+	EXPECT_GT(nCollided, 0);
+}
+
+TEST(CollisionWorld, RemoveAndMask)
+{
+	CollisionWorld world;
+	const auto a = world.add(Polygon(Rect4f(10, -5, 5, 10)), CollisionWorld::ColliderType::Static, 1);
+	const auto b = world.add(Polygon(Rect4f(20, -5, 5, 10)), CollisionWorld::ColliderType::Static, 2);
+	world.update();
+
+	CollisionWorld::SweepQuery query;
+	query.radius = Vector2f(1, 1);
+	query.moveDir = Vector2f(1, 0);
+	query.moveLen = 100;
+
+	EXPECT_EQ(world.sweep(query).collider, a);
+	EXPECT_NEAR(world.sweep(query).distance, 9.0f, 0.001f);
+
+	query.mask = 2;
+	EXPECT_EQ(world.sweep(query).collider, b);
+
+	query.mask = 1;
+	world.remove(a);
+	world.update();
+	EXPECT_FALSE(world.sweep(query).collided);
+	EXPECT_EQ(world.size(), 1);
+}
+
+// Timing only, correctness is covered by SweepsMatchBruteForce. Run with --gtest_also_run_disabled_tests
+TEST(CollisionWorld, DISABLED_Benchmark)
+{
+	// Thousands of bodies sweeping against a large static level
+	Random rng(uint32_t(42));
+	constexpr float levelSize = 20000.0f;
+	constexpr int nStatic = 50000;
+	constexpr int nBodies = 5000;
+	constexpr int nBruteForce = 100;
+
+	CollisionWorld world;
+	Vector<Polygon> polygons;
+	polygons.reserve(nStatic);
+	for (int i = 0; i < nStatic; ++i) {
+		polygons.push_back(makeShape(rng, Vector2f(rng.getFloat(0, levelSize), rng.getFloat(0, levelSize))));
+		world.add(polygons.back(), CollisionWorld::ColliderType::Static);
+	}
+
+	using Clock = std::chrono::steady_clock;
+	const auto t0 = Clock::now();
+	world.update();
+	const auto t1 = Clock::now();
+
+	const auto queries = makeQueries(rng, nBodies, levelSize);
+	Vector<CollisionWorld::SweepResult> results;
+	world.sweep(queries, results);
+	const auto t2 = Clock::now();
+
+	for (int i = 0; i < nBruteForce; ++i) {
+		const auto expected = bruteForce(polygons, queries[i]);
+		EXPECT_EQ(results[i].collided, expected.collided);
+	}
+	const auto t3 = Clock::now();
+
+	auto ms = [] (Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+	std::cout << "Build: " << ms(t1 - t0) << " ms" << std::endl;
+	std::cout << nBodies << " sweeps against " << nStatic << " polygons: " << ms(t2 - t1) << " ms" << std::endl;
+	std::cout << "Brute force, extrapolated: " << ms(t3 - t2) * nBodies / nBruteForce << " ms" << std::endl;
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/data_structures/frame_allocator.h"
+using namespace Halley;
+
+TEST(HalleyFrameAllocator, RewindsEachFrame)
+{
+	FrameAllocator::startFrame();
+
+	const int* first;
+	{
+		auto v = FrameAllocator::makeVector<int>();
+		v.resize(100);
+		first = v.data();
+	}
+	FrameAllocator::startFrame();
+	EXPECT_EQ(FrameAllocator::getLastFrameStats().numAllocations, size_t(1));
+	EXPECT_GE(FrameAllocator::getLastFrameStats().bytesUsed, 100 * sizeof(int));
+
+	auto v = FrameAllocator::makeVector<int>();
+	v.resize(100);
+	EXPECT_EQ(v.data(), first);
+}
+
+TEST(HalleyFrameAllocator, KeepsLiveDataAcrossFrames)
+{
+	FrameAllocator::startFrame();
+
+	auto live = FrameAllocator::makeVector<int>();
+	live.resize(100, 42);
+
+	FrameAllocator::startFrame();
+	auto other = FrameAllocator::makeVector<int>();
+	other.resize(100, 7);
+
+	EXPECT_NE(live.data(), other.data());
+	EXPECT_EQ(live[99], 42);
+}
+
+TEST(HalleyFrameAllocator, AllocatesMoreThanAPage)
+{
+	FrameAllocator::startFrame();
+
+	{
+		// Bigger than a single page, so it needs one of its own
+		auto big = FrameAllocator::makeVector<int>();
+		big.resize(512 * 1024, 42);
+		auto small = FrameAllocator::makeVector<int>();
+		small.resize(100, 7);
+		EXPECT_EQ(big.back(), 42);
+		EXPECT_EQ(small.back(), 7);
+	}
+
+	FrameAllocator::startFrame();
+	const auto stats = FrameAllocator::getLastFrameStats();
+	EXPECT_GE(stats.bytesUsed, 512 * 1024 * sizeof(int));
+	EXPECT_GT(stats.bytesReserved, 512 * 1024 * sizeof(int));
+
+	{
+		// The oversize page is kept, so the next frame doesn't need another one
+		auto again = FrameAllocator::makeVector<int>();
+		again.resize(512 * 1024, 1);
+	}
+	FrameAllocator::startFrame();
+	EXPECT_EQ(FrameAllocator::getLastFrameStats().bytesReserved, stats.bytesReserved);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/file_formats/hlif_file.h"
+using namespace Halley;
+
+namespace {
+	// Smooth gradients with some noise, so that every line filter gets picked somewhere
+	Image makeImage(Vector2i size, Image::Format format, uint32_t seed, int numColours = 0)
+	{
+		Random rng(seed);
+		Image image(format, size, false);
+
+		Vector<int> palette;
+		for (int i = 0; i < numColours; ++i) {
+			palette.push_back(static_cast<int>(rng.getInt(0u, 0xFFFFFFFFu)));
+		}
+
+		for (int y = 0; y < size.y; ++y) {
+			for (int x = 0; x < size.x; ++x) {
+				const int i = y * size.x + x;
+				if (format == Image::Format::SingleChannel) {
+					image.getPixels1BPP()[i] = static_cast<unsigned char>(x + y * 3 + rng.getInt(0, 3));
+				} else if (!palette.empty()) {
+					image.getPixels4BPP()[i] = palette[(x / 4 + y / 3 + rng.getInt(0, 1)) % palette.size()];
+				} else {
+					image.getPixels4BPP()[i] = Image::convertRGBAToInt(static_cast<uint8_t>(x * 2 + rng.getInt(0, 8)), static_cast<uint8_t>(y + x), static_cast<uint8_t>(y * 3), static_cast<uint8_t>(255 - rng.getInt(0, 2)));
+				}
+			}
+		}
+		return image;
+	}
+
+	void testRoundTrip(const Image& image, HLIFFile::Version version)
+	{
+		const auto encoded = HLIFFile::encode(image, "test", false, version);
+		EXPECT_EQ(HLIFFile::getVersion(encoded.byte_span()), version);
+
+		Image decoded;
+		HLIFFile::decode(decoded, encoded.byte_span());
+		ASSERT_EQ(decoded.getSize(), image.getSize());
+		ASSERT_EQ(decoded.getFormat(), image.getFormat());
+		EXPECT_TRUE(std::equal(image.getPixelBytes().begin(), image.getPixelBytes().end(), decoded.getPixelBytes().begin()));
+	}
+}
+
+TEST(HalleyHLIF, RoundTripRGBA)
+{
+	for (const auto version: { HLIFFile::Version::V1, HLIFFile::Version::V2 }) {
+		for (const auto size: { Vector2i(1, 1), Vector2i(33, 7), Vector2i(300, 37), Vector2i(256, 700) }) {
+			testRoundTrip(makeImage(size, Image::Format::RGBA, 1), version);
+			testRoundTrip(makeImage(size, Image::Format::RGBAPremultiplied, 2), version);
+		}
+	}
+}
+
+TEST(HalleyHLIF, RoundTripPaletted)
+{
+	for (const auto version: { HLIFFile::Version::V1, HLIFFile::Version::V2 }) {
+		// With more colours, palette boundaries can fall in the middle of a tile
+		testRoundTrip(makeImage(Vector2i(300, 200), Image::Format::RGBA, 3, 40), version);
+		testRoundTrip(makeImage(Vector2i(512, 700), Image::Format::RGBA, 4, 600), version);
+	}
+}
+
+TEST(HalleyHLIF, RoundTripSingleChannel)
+{
+	for (const auto version: { HLIFFile::Version::V1, HLIFFile::Version::V2 }) {
+		testRoundTrip(makeImage(Vector2i(1000, 333), Image::Format::SingleChannel, 5), version);
+	}
+}
+
+// Run with --gtest_also_run_disabled_tests to compare decode throughput of each version
+TEST(HalleyHLIF, DISABLED_DecodeBenchmark)
+{
+	std::unique_ptr<Executors> executors;
+	std::unique_ptr<ThreadPool> threadPool;
+	if (!Executors::hasInstance()) {
+		executors = std::make_unique<Executors>();
+		Executors::setInstance(*executors);
+		threadPool = std::make_unique<ThreadPool>("CPU", executors->getCPU(), std::max(1u, std::thread::hardware_concurrency()), [] (String name, std::function<void()> f) { return std::thread(std::move(f)); });
+	}
+
+	constexpr int iterations = 20;
+	for (const int numColours: { 0, 200 }) {
+		const auto image = makeImage(Vector2i(2048, 2048), Image::Format::RGBA, 6, numColours);
+		for (const auto version: { HLIFFile::Version::V1, HLIFFile::Version::V2 }) {
+			const auto encoded = HLIFFile::encode(image, "benchmark", true, version);
+
+			Image decoded;
+			Stopwatch timer;
+			for (int i = 0; i < iterations; ++i) {
+				HLIFFile::decode(decoded, encoded.byte_span());
+			}
+			const double seconds = timer.elapsedNanoseconds() / 1'000'000'000.0;
+			const double mbPerSec = static_cast<double>(image.getPixelBytes().size() * iterations) / (1024.0 * 1024.0) / seconds;
+			std::cout << (version == HLIFFile::Version::V1 ? "v1" : "v2") << (numColours > 0 ? " paletted" : "") << ": " << mbPerSec << " MB/s (" << encoded.size() << " bytes)" << std::endl;
+		}
+	}
+}
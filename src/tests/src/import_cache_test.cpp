@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/file/filesystem.h"
+using namespace Halley;
+
+namespace {
+	// A checkout of the same project somewhere else on disk, with its own copy of the tools
+	struct Checkout {
+		Path root;
+		Path binary;
+		Path assetsSrc;
+
+		Checkout(const Path& root, const Bytes& binaryContents)
+			: root(root)
+			, binary(root / "bin" / "halley-editor")
+			, assetsSrc(root / "assets_src")
+		{
+			FileSystem::writeFile(binary, binaryContents);
+			FileSystem::writeFile(assetsSrc / "shared" / "palette.yaml", String("colours: [red, green]"));
+		}
+
+		uint64_t getBuildId() const
+		{
+			return ImportCache::computeBuildId(gsl::span<const Path>(&binary, 1));
+		}
+	};
+
+	struct ImportCacheFixture {
+		Path tmp = FileSystem::getTemporaryPath();
+		Bytes binaryContents = Bytes(3 * 1024 * 1024, 0x5a);
+
+		~ImportCacheFixture()
+		{
+			FileSystem::remove(tmp);
+		}
+
+		ImportCache::Entry makeEntry(const Checkout& checkout) const
+		{
+			ImportCache::Entry entry;
+			AssetResource resource;
+			resource.name = "sprite";
+			resource.type = AssetType::Sprite;
+			entry.out.push_back(resource);
+			entry.outFiles.emplace_back(Path("sprite/sprite.dat"), Bytes(16, 1));
+			const auto input = checkout.assetsSrc / "shared" / "palette.yaml";
+			entry.additionalInputs.push_back(TimestampedPath(input, FileSystem::getLastWriteTime(input)));
+			return entry;
+		}
+	};
+}
+
+TEST(HalleyImportCache, BuildIdOnlyDependsOnContents)
+{
+	ImportCacheFixture f;
+	const Checkout a(f.tmp / "a", f.binaryContents);
+	const Checkout b(f.tmp / "some" / "other" / "b", f.binaryContents);
+	EXPECT_EQ(a.getBuildId(), b.getBuildId());
+
+	f.binaryContents.back() = 0;
+	const Checkout c(f.tmp / "c", f.binaryContents);
+	EXPECT_NE(a.getBuildId(), c.getBuildId());
+}
+
+TEST(HalleyImportCache, CheckoutsShareHits)
+{
+	ImportCacheFixture f;
+	const auto cacheDir = f.tmp / "cache";
+	const Checkout a(f.tmp / "a", f.binaryContents);
+	const Checkout b(f.tmp / "b", f.binaryContents);
+
+	const ImportCache cacheA(cacheDir, a.getBuildId(), 1024 * 1024);
+	const ImportCache cacheB(cacheDir, b.getBuildId(), 1024 * 1024);
+	const uint64_t key = 0x1234567890abcdefull;
+
+	EXPECT_FALSE(cacheB.load(key, { b.assetsSrc }));
+	cacheA.store(key, f.makeEntry(a), { a.assetsSrc });
+
+	// Checkout b gets a hit from what a stored, with the shared input resolved inside b
+	const auto entry = cacheB.load(key, { b.assetsSrc });
+	ASSERT_TRUE(entry);
+	ASSERT_EQ(entry->out.size(), size_t(1));
+	EXPECT_EQ(entry->out[0].name, "sprite");
+	ASSERT_EQ(entry->outFiles.size(), size_t(1));
+	EXPECT_EQ(entry->outFiles[0].first.getString(), "sprite/sprite.dat");
+	ASSERT_EQ(entry->additionalInputs.size(), size_t(1));
+	EXPECT_EQ(entry->additionalInputs[0].first.getString(), (b.assetsSrc / "shared" / "palette.yaml").getString());
+
+	// But not once its copy of the input differs
+	FileSystem::writeFile(b.assetsSrc / "shared" / "palette.yaml", String("colours: [blue]"));
+	EXPECT_FALSE(cacheB.load(key, { b.assetsSrc }));
+	EXPECT_TRUE(cacheA.load(key, { a.assetsSrc }));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/graphics/material/material_intern_cache.h"
+using namespace Halley;
+
+namespace {
+	std::shared_ptr<MaterialDefinition> makeDefinition()
+	{
+		auto uniform = MaterialUniform("u_value", ShaderParameterType::Float, ShaderParameterSemanticType::Number);
+		auto block = MaterialUniformBlock("MaterialBlock", { uniform });
+		block.offset = 16;
+
+		auto definition = std::make_shared<MaterialDefinition>();
+		definition->setName("test");
+		definition->setUniformBlocks({ block });
+		return definition;
+	}
+
+	std::shared_ptr<const Material> makeMaterial(const std::shared_ptr<const MaterialDefinition>& definition, float value)
+	{
+		auto material = std::make_shared<Material>(definition);
+		material->getParameter("u_value").set(value);
+		return material;
+	}
+}
+
+TEST(HalleyMaterialInternCache, IdenticalMaterialsShareOneInstance)
+{
+	auto& cache = MaterialInternCache::get();
+	cache.clear();
+	const auto definition = makeDefinition();
+	const auto before = cache.getStats();
+
+	const auto a = cache.intern(makeMaterial(definition, 1.0f));
+	const auto b = cache.intern(makeMaterial(definition, 1.0f));
+	const auto c = cache.intern(makeMaterial(definition, 2.0f));
+
+	EXPECT_EQ(a, b);
+	EXPECT_NE(a, c);
+
+	const auto stats = cache.getStats();
+	EXPECT_EQ(stats.internCalls - before.internCalls, size_t(3));
+	EXPECT_EQ(stats.hits - before.hits, size_t(1));
+	EXPECT_EQ(stats.uniqueMaterials, size_t(2));
+	EXPECT_EQ(stats.references, size_t(3));
+}
+
+TEST(HalleyMaterialInternCache, ReleasedMaterialsExpire)
+{
+	auto& cache = MaterialInternCache::get();
+	cache.clear();
+	const auto definition = makeDefinition();
+
+	auto a = cache.intern(makeMaterial(definition, 1.0f));
+	EXPECT_EQ(cache.getStats().uniqueMaterials, size_t(1));
+
+	a.reset();
+	EXPECT_EQ(cache.getStats().uniqueMaterials, size_t(0));
+
+	// A new equivalent material becomes the shared instance
+	const auto b = cache.intern(makeMaterial(definition, 1.0f));
+	const auto c = cache.intern(makeMaterial(definition, 1.0f));
+	EXPECT_EQ(b, c);
+	EXPECT_EQ(cache.getStats().uniqueMaterials, size_t(1));
+}
+
+TEST(HalleyMaterialInternCache, UpdaterOnlyInternsWhenAsked)
+{
+	auto& cache = MaterialInternCache::get();
+	cache.clear();
+	const auto definition = makeDefinition();
+	const auto shared = cache.intern(makeMaterial(definition, 2.0f));
+	const auto callsBefore = cache.getStats().internCalls;
+
+	// Plain updates (e.g. per frame parameters) don't go through the cache
+	std::shared_ptr<const Material> material = cache.intern(makeMaterial(definition, 1.0f));
+	const auto original = material;
+	MaterialUpdater(material).set("u_value", 2.0f);
+	EXPECT_NE(material, original);
+	EXPECT_NE(material, shared);
+	EXPECT_EQ(cache.getStats().internCalls, callsBefore + 1);
+
+	// Updating to the same value doesn't clone or intern anything
+	const auto beforeNoop = material;
+	MaterialUpdater(material).intern().set("u_value", 2.0f);
+	EXPECT_EQ(material, beforeNoop);
+	EXPECT_EQ(cache.getStats().internCalls, callsBefore + 1);
+
+	// Asking for it shares the result with identical materials
+	material = original;
+	MaterialUpdater(material).intern().set("u_value", 2.0f);
+	EXPECT_EQ(material, shared);
+	EXPECT_EQ(cache.getStats().internCalls, callsBefore + 2);
+
+	// The interned material was never written to
+	EXPECT_TRUE(original->getParameter("u_value").isEqual(1.0f));
+}
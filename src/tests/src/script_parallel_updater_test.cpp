@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/scripting/script_parallel_updater.h"
+using namespace Halley;
+
+namespace {
+	// Stands in for ScriptEnvironment, recording what each entity sent
+	class TestEnvironment {
+	public:
+		struct Outbox {
+			Vector<int> values;
+		};
+
+		TestEnvironment(bool canReplicate = true)
+			: canReplicate(canReplicate)
+		{}
+
+		std::unique_ptr<TestEnvironment> makeWorkerEnvironment()
+		{
+			++workersMade;
+			return canReplicate ? std::make_unique<TestEnvironment>() : std::unique_ptr<TestEnvironment>();
+		}
+
+		void copySettingsTo(TestEnvironment& worker) const {}
+
+		Outbox takeOutbox()
+		{
+			return Outbox{ std::move(outbox) };
+		}
+
+		void appendOutbox(Outbox other)
+		{
+			outbox.insert(outbox.end(), other.values.begin(), other.values.end());
+		}
+
+		Vector<int> outbox;
+		int workersMade = 0;
+
+	private:
+		bool canReplicate;
+	};
+
+	// Starts a CPU thread pool, which stays up for the remaining tests
+	void startWorkerThreads()
+	{
+		static Executors executors;
+		Executors::setInstance(executors);
+		static ThreadPool pool("Test", Executors::getCPU(), 4, [] (String name, std::function<void()> f) { return std::thread(std::move(f)); });
+		while (Executors::getCPU().threadCount() < 4) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+TEST(HalleyScriptParallelUpdater, MergesOutboxesInFamilyOrder)
+{
+	startWorkerThreads();
+	constexpr size_t nEntities = 200;
+	auto isSafe = [] (size_t idx) { return idx % 7 != 3; };
+	size_t nSafe = 0;
+	for (size_t i = 0; i < nEntities; ++i) {
+		nSafe += isSafe(i) ? 1 : 0;
+	}
+
+	TestEnvironment env;
+	ScriptParallelUpdater<TestEnvironment> updater;
+
+	for (int run = 0; run < 3; ++run) {
+		env.outbox = { -1 };
+		Vector<TestEnvironment*> updatedBy(nEntities, nullptr);
+		std::atomic<size_t> parallelDone = 0;
+		bool unsafeRanAfterSafe = true;
+
+		const bool parallel = updater.update(env, nEntities, isSafe, [&] (TestEnvironment& e, size_t idx)
+		{
+			updatedBy[idx] = &e;
+			if (isSafe(idx)) {
+				// Uneven work, so tasks finish in whatever order
+				std::this_thread::sleep_for(std::chrono::microseconds((idx * 37) % 200));
+				++parallelDone;
+			} else if (parallelDone != nSafe) {
+				unsafeRanAfterSafe = false;
+			}
+			e.outbox.push_back(static_cast<int>(idx));
+		});
+		ASSERT_TRUE(parallel);
+
+		for (size_t i = 0; i < nEntities; ++i) {
+			ASSERT_NE(updatedBy[i], nullptr);
+			if (isSafe(i)) {
+				EXPECT_NE(updatedBy[i], &env);
+			} else {
+				EXPECT_EQ(updatedBy[i], &env);
+			}
+		}
+		EXPECT_TRUE(unsafeRanAfterSafe);
+
+		// Whatever was pending comes first, then everything in entity order
+		ASSERT_EQ(env.outbox.size(), nEntities + 1);
+		EXPECT_EQ(env.outbox[0], -1);
+		for (size_t i = 0; i < nEntities; ++i) {
+			EXPECT_EQ(env.outbox[i + 1], static_cast<int>(i));
+		}
+	}
+}
+
+TEST(HalleyScriptParallelUpdater, FallsBackWithoutWorkers)
+{
+	startWorkerThreads();
+	size_t safetyChecks = 0;
+	size_t updates = 0;
+	auto isSafe = [&] (size_t idx) { ++safetyChecks; return true; };
+	auto update = [&] (TestEnvironment& e, size_t idx) { ++updates; };
+
+	// Environments that can't be replicated are only asked once, and never get their scripts scanned
+	TestEnvironment unsupported(false);
+	ScriptParallelUpdater<TestEnvironment> updater;
+	EXPECT_FALSE(updater.update(unsupported, 100, isSafe, update));
+	EXPECT_FALSE(updater.update(unsupported, 100, isSafe, update));
+	EXPECT_EQ(unsupported.workersMade, 1);
+	EXPECT_EQ(safetyChecks, size_t(0));
+
+	// Not enough parallel-safe entities
+	TestEnvironment env;
+	ScriptParallelUpdater<TestEnvironment> smallUpdater;
+	EXPECT_FALSE(smallUpdater.update(env, ScriptParallelUpdater<TestEnvironment>::minParallelEntities - 1, isSafe, update));
+	EXPECT_FALSE(smallUpdater.update(env, 100, [] (size_t idx) { return idx < 10; }, update));
+
+	EXPECT_EQ(updates, size_t(0));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/scripting/script_value.h"
+#include "halley/scripting/script_variables.h"
+using namespace Halley;
+
+namespace {
+	Vector<ConfigNode> makeSamples()
+	{
+		Vector<ConfigNode> result;
+		result.emplace_back();
+		result.emplace_back(true);
+		result.emplace_back(false);
+		result.emplace_back(3);
+		result.emplace_back(-7);
+		result.emplace_back(int64_t(3));
+		result.emplace_back(int64_t(1) << 40);
+		result.emplace_back(3.0f);
+		result.emplace_back(2.5f);
+		result.emplace_back(Vector2i(1, 2));
+		result.emplace_back(Vector2f(1.0f, 2.0f));
+		result.emplace_back(EntityId(42));
+		result.emplace_back(String("hello"));
+		return result;
+	}
+
+	constexpr std::array<MathRelOp, 6> relOps = { MathRelOp::Equal, MathRelOp::Different, MathRelOp::Less, MathRelOp::LessOrEqual, MathRelOp::Greater, MathRelOp::GreaterOrEqual };
+	constexpr std::array<MathOp, 5> mathOps = { MathOp::Add, MathOp::Subtract, MathOp::Multiply, MathOp::Max, MathOp::Min };
+}
+
+TEST(ScriptValue, RoundTrip)
+{
+	for (const auto& sample: makeSamples()) {
+		const auto value = ScriptValue(sample);
+		EXPECT_EQ(value.isUnboxed(), sample.getType() != ConfigNodeType::String);
+		EXPECT_EQ(value.toConfigNode().getType(), sample.getType());
+		EXPECT_TRUE(value.toConfigNode() == sample);
+	}
+}
+
+TEST(ScriptValue, CompareMatchesConfigNode)
+{
+	const auto samples = makeSamples();
+	for (const auto& a: samples) {
+		for (const auto& b: samples) {
+			for (const auto op: relOps) {
+				EXPECT_EQ(ScriptValue(a).compareTo(op, ScriptValue(b)), a.compareTo(op, b)) << toString(a.getType()) << " " << toString(op) << " " << toString(b.getType());
+			}
+		}
+	}
+}
+
+TEST(ScriptValue, ArithmeticMatchesConfigNode)
+{
+	const auto samples = makeSamples();
+	for (const auto& a: samples) {
+		for (const auto& b: samples) {
+			for (const auto op: mathOps) {
+				const auto result = ScriptValue::tryApply(op, ScriptValue(a), ScriptValue(b));
+				if (!result) {
+					continue;
+				}
+
+				const auto type = ConfigNode::getPromotedType(std::array<ConfigNodeType, 2>{ a.getType(), b.getType() }, true);
+				const auto resultNode = result->toConfigNode();
+				EXPECT_EQ(resultNode.getType(), type) << toString(a.getType()) << " " << toString(op) << " " << toString(b.getType());
+				if (type == ConfigNodeType::Float) {
+					EXPECT_FLOAT_EQ(resultNode.asFloat(), MathOps::apply(op, a.asFloat(0), b.asFloat(0)));
+				} else if (type == ConfigNodeType::Int64) {
+					EXPECT_EQ(resultNode.asInt64(), MathOps::apply(op, a.asInt64(0), b.asInt64(0)));
+				} else if (type == ConfigNodeType::Int) {
+					EXPECT_EQ(resultNode.asInt(), MathOps::apply(op, a.asInt(0), b.asInt(0)));
+				} else if (type == ConfigNodeType::Float2) {
+					EXPECT_EQ(resultNode.asVector2f(), MathOps::apply(op, a.asVector2f({}), b.asVector2f({})));
+				} else if (type == ConfigNodeType::Int2) {
+					EXPECT_EQ(resultNode.asVector2i(), MathOps::apply(op, a.asVector2i({}), b.asVector2i({})));
+				}
+			}
+		}
+	}
+}
+
+TEST(ScriptVariables, SlotsAndNames)
+{
+	ScriptVariables vars;
+	EXPECT_TRUE(vars.empty());
+
+	vars.setVariable("zeta", ConfigNode(1));
+	vars.setVariable("alpha", ConfigNode(2));
+	vars.setVariable(ScriptVariableSlots::getSlot("zeta"), ConfigNode(3));
+
+	EXPECT_EQ(vars.getVariable("zeta").asInt(), 3);
+	EXPECT_EQ(vars.getVariable(ScriptVariableSlots::getSlot("alpha")).asInt(), 2);
+	EXPECT_TRUE(vars.hasVariable("alpha"));
+	EXPECT_FALSE(vars.hasVariable("scriptValueTestUnknownVariable"));
+	EXPECT_EQ(vars.getVariable("scriptValueTestUnknownVariable").getType(), ConfigNodeType::Undefined);
+	EXPECT_EQ(ScriptVariableSlots::getName(ScriptVariableSlots::getSlot("alpha")), "alpha");
+	EXPECT_EQ(ScriptVariableSlots::getSlot("alpha"), ScriptVariableSlots::getSlot("alpha"));
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/data_structures/spatial_index.h"
+using namespace Halley;
+
+namespace {
+	Vector<std::pair<EntityId, Rect4f>> makeRects(size_t n, Random& rng)
+	{
+		Vector<std::pair<EntityId, Rect4f>> result;
+		for (size_t i = 0; i < n; ++i) {
+			const auto pos = Vector2f(rng.getFloat(-2000.0f, 2000.0f), rng.getFloat(-2000.0f, 2000.0f));
+			// Mostly small, with some larger than a cell and some zero-sized
+			const float maxSize = i % 10 == 0 ? 1000.0f : 100.0f;
+			const auto size = i % 7 == 0 ? Vector2f() : Vector2f(rng.getFloat(0.0f, maxSize), rng.getFloat(0.0f, maxSize));
+			result.emplace_back(EntityId(static_cast<int64_t>(i + 1)), Rect4f(pos, pos + size));
+		}
+		return result;
+	}
+
+	Vector<EntityId> bruteForce(const Vector<std::pair<EntityId, Rect4f>>& rects, Rect4f query)
+	{
+		Vector<EntityId> result;
+		for (const auto& [id, rect]: rects) {
+			if (rect.getLeft() <= query.getRight() && query.getLeft() <= rect.getRight() && rect.getTop() <= query.getBottom() && query.getTop() <= rect.getBottom()) {
+				result.push_back(id);
+			}
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	Vector<EntityId> sorted(Vector<EntityId> ids)
+	{
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+}
+
+TEST(SpatialIndex, RectQueriesMatchBruteForce)
+{
+	Random rng(uint32_t(1234));
+	auto rects = makeRects(2000, rng);
+
+	SpatialIndex index(128.0f);
+	for (const auto& [id, rect]: rects) {
+		index.set(id, rect);
+	}
+
+	// Move half of them around, and remove some
+	for (size_t i = 0; i < rects.size(); i += 2) {
+		rects[i].second += Vector2f(rng.getFloat(-500.0f, 500.0f), rng.getFloat(-500.0f, 500.0f));
+		index.set(rects[i].first, rects[i].second);
+	}
+	for (size_t i = 0; i < rects.size(); i += 5) {
+		EXPECT_TRUE(index.remove(rects[i].first));
+	}
+	std_ex::erase_if(rects, [&] (const auto& e) { return !index.contains(e.first); });
+	EXPECT_EQ(index.size(), rects.size());
+
+	for (int i = 0; i < 100; ++i) {
+		const auto pos = Vector2f(rng.getFloat(-2500.0f, 2500.0f), rng.getFloat(-2500.0f, 2500.0f));
+		const auto query = Rect4f(pos, pos + Vector2f(rng.getFloat(0.0f, 800.0f), rng.getFloat(0.0f, 800.0f)));
+
+		Vector<EntityId> results;
+		index.queryRect(query, results);
+		EXPECT_EQ(sorted(results), bruteForce(rects, query));
+	}
+}
+
+TEST(SpatialIndex, CircleAndRayQueries)
+{
+	SpatialIndex index(64.0f);
+	index.set(EntityId(1), Rect4f(0, 0, 10, 10));
+	index.set(EntityId(2), Rect4f(100, 0, 10, 10));
+	index.set(EntityId(3), Rect4f(200, 0, 500, 10));
+	index.set(EntityId(4), Rect4f(50, 50, 0, 0));
+
+	Vector<EntityId> results;
+	index.queryCircle(Vector2f(55, 55), 10.0f, results);
+	EXPECT_EQ(sorted(results), Vector<EntityId>({ EntityId(4) }));
+
+	results.clear();
+	index.queryCircle(Vector2f(20, 5), 10.0f, results);
+	EXPECT_EQ(sorted(results), Vector<EntityId>({ EntityId(1) }));
+
+	// Rays are sorted by distance
+	results.clear();
+	index.queryRay(Ray(Vector2f(1000, 5), Vector2f(-1, 0)), 2000.0f, results);
+	EXPECT_EQ(results, Vector<EntityId>({ EntityId(3), EntityId(2), EntityId(1) }));
+
+	results.clear();
+	index.queryRay(Ray(Vector2f(1000, 5), Vector2f(-1, 0)), 850.0f, results);
+	EXPECT_EQ(results, Vector<EntityId>({ EntityId(3) }));
+}
+
+TEST(SpatialIndex, BatchedQueries)
+{
+	Random rng(uint32_t(42));
+	const auto rects = makeRects(500, rng);
+
+	SpatialIndex index;
+	for (const auto& [id, rect]: rects) {
+		index.set(id, rect);
+	}
+
+	Vector<SpatialIndex::Query> queries;
+	for (int i = 0; i < 64; ++i) {
+		const auto pos = Vector2f(rng.getFloat(-2000.0f, 2000.0f), rng.getFloat(-2000.0f, 2000.0f));
+		queries.push_back(SpatialIndex::Query::makeRect(Rect4f(pos, pos + Vector2f(300, 300))));
+	}
+
+	Vector<Vector<EntityId>> results;
+	index.query(queries, results);
+	ASSERT_EQ(results.size(), queries.size());
+	for (size_t i = 0; i < queries.size(); ++i) {
+		EXPECT_EQ(sorted(results[i]), bruteForce(rects, queries[i].rect));
+	}
+}
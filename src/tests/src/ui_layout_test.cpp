@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	struct LayoutFixture {
+		std::shared_ptr<UIWidget> root;
+		std::shared_ptr<UIWidget> a;
+		std::shared_ptr<UIWidget> b;
+		std::shared_ptr<UIWidget> c;
+
+		LayoutFixture()
+		{
+			root = std::make_shared<UIWidget>("root", Vector2f(), UISizer(UISizerType::Vertical, 0.0f));
+			a = std::make_shared<UIWidget>("a", Vector2f(10, 10));
+			b = std::make_shared<UIWidget>("b", Vector2f(20, 10));
+			c = std::make_shared<UIWidget>("c", Vector2f(5, 5));
+
+			auto row = std::make_shared<UISizer>(UISizerType::Horizontal, 0.0f);
+			row->add(a);
+			row->add(b);
+			root->add(row);
+			root->add(c);
+			root->layout();
+		}
+	};
+}
+
+TEST(HalleyUILayout, NestedSizers)
+{
+	LayoutFixture f;
+	EXPECT_EQ(f.root->getSize(), Vector2f(30, 15));
+	EXPECT_EQ(f.b->getPosition(), Vector2f(10, 0));
+	EXPECT_EQ(f.c->getPosition(), Vector2f(0, 10));
+}
+
+TEST(HalleyUILayout, CleanLayoutKeepsPlacement)
+{
+	LayoutFixture f;
+	EXPECT_FALSE(f.root->isLayoutDirty());
+
+	f.root->layout();
+	EXPECT_EQ(f.root->getSize(), Vector2f(30, 15));
+	EXPECT_EQ(f.b->getPosition(), Vector2f(10, 0));
+	EXPECT_EQ(f.c->getPosition(), Vector2f(0, 10));
+}
+
+TEST(HalleyUILayout, MinSizeChangeInvalidatesNestedSizers)
+{
+	LayoutFixture f;
+
+	f.a->setMinSize(Vector2f(15, 20));
+	EXPECT_TRUE(f.root->isLayoutDirty());
+
+	f.root->layout();
+	EXPECT_EQ(f.root->getSize(), Vector2f(35, 25));
+	EXPECT_EQ(f.b->getPosition(), Vector2f(15, 0));
+	EXPECT_EQ(f.c->getPosition(), Vector2f(0, 20));
+	EXPECT_FALSE(f.root->isLayoutDirty());
+}
+
+TEST(HalleyUILayout, DeactivatingWidgetRelaysSiblings)
+{
+	LayoutFixture f;
+
+	f.a->setActive(false);
+	f.root->layout();
+	EXPECT_EQ(f.b->getPosition(), Vector2f(0, 0));
+	EXPECT_EQ(f.root->getSize(), Vector2f(20, 15));
+}
+
+TEST(HalleyUILayout, MovingParentMovesCleanSubtree)
+{
+	LayoutFixture f;
+
+	f.root->setPosition(Vector2f(100, 50));
+	f.root->layout();
+	EXPECT_EQ(f.b->getPosition(), Vector2f(110, 50));
+	EXPECT_EQ(f.c->getPosition(), Vector2f(100, 60));
+}
+
+TEST(HalleyUILayout, EntrySettersInvalidateLayout)
+{
+	LayoutFixture f;
+
+	auto& rowEntry = f.root->getSizer()[0];
+	auto& row = dynamic_cast<UISizer&>(*rowEntry.getPointer());
+
+	row[0].setBorder(Vector4f(5, 0, 0, 0));
+	EXPECT_TRUE(f.root->isLayoutDirty());
+	f.root->layout();
+	EXPECT_EQ(f.root->getSize(), Vector2f(35, 15));
+	EXPECT_EQ(f.a->getPosition(), Vector2f(5, 0));
+
+	f.root->setMinSize(Vector2f(50, 15));
+	f.root->layout();
+	EXPECT_EQ(f.b->getPosition(), Vector2f(15, 0));
+
+	row[1].setProportion(1);
+	EXPECT_TRUE(f.root->isLayoutDirty());
+	f.root->layout();
+	EXPECT_EQ(f.b->getPosition(), Vector2f(15, 0));
+	EXPECT_EQ(f.b->getSize(), Vector2f(35, 10));
+}
+
+namespace {
+	class VirtualListSource : public IUIVirtualListDataSource {
+	public:
+		size_t getNumItems() const override { return 1000; }
+		String getItemId(size_t idx) const override { return "item" + toString(idx); }
+		std::shared_ptr<UIWidget> makeItem(size_t idx) override
+		{
+			++made;
+			return std::make_shared<UIWidget>(getItemId(idx), Vector2f(50, 10));
+		}
+		void updateItem(UIWidget& widget, size_t idx) override {}
+
+		size_t made = 0;
+	};
+
+	class TestVirtualList : public UIVirtualList {
+	public:
+		using UIVirtualList::UIVirtualList;
+		using UIVirtualList::update;
+
+		// Row widgets are recycled, so look them up by position
+		std::shared_ptr<UIWidget> findRowAt(float y) const
+		{
+			for (const auto& c: getChildren()) {
+				if (c->isActive() && std::abs(c->getPosition().y - y) < 0.5f) {
+					return c;
+				}
+			}
+			return {};
+		}
+	};
+
+	// Counts minimum size queries, which happen on every placement, and again whenever cached minimum sizes are invalidated
+	class LayoutProbe : public IUIElement {
+	public:
+		Vector2f getLayoutMinimumSize(bool force) const override { ++calls; return Vector2f(1, 1); }
+		void setRect(Rect4f rect, IUIElementListener* listener) override {}
+		bool isActive() const override { return true; }
+
+		mutable size_t calls = 0;
+	};
+
+	struct VirtualListFixture {
+		std::shared_ptr<UIScrollPane> pane;
+		std::shared_ptr<TestVirtualList> list;
+		std::shared_ptr<VirtualListSource> source;
+		std::shared_ptr<LayoutProbe> probe;
+
+		VirtualListFixture()
+		{
+			pane = std::make_shared<UIScrollPane>("pane", Vector2f(50, 100), UISizer(UISizerType::Vertical, 0.0f));
+			list = std::make_shared<TestVirtualList>("list", 10.0f, 2);
+			source = std::make_shared<VirtualListSource>();
+			probe = std::make_shared<LayoutProbe>();
+
+			list->setDataSource(source);
+			pane->add(list);
+			pane->add(probe);
+			pane->layout();
+			step();
+		}
+
+		// What a frame does: layout, then update, then new rows get adopted and the layout picks up what the update changed
+		void step()
+		{
+			pane->layout();
+			list->update(0, true);
+			pane->forceAddChildren(UIInputType::Undefined, true);
+			pane->layout();
+		}
+
+		void scrollTo(float y)
+		{
+			pane->scrollTo(Vector2f(0, y));
+			step();
+		}
+	};
+}
+
+TEST(HalleyUILayout, VirtualListOnlyInstantiatesVisibleRows)
+{
+	VirtualListFixture f;
+
+	// 10 visible rows, plus a margin of 2 below
+	EXPECT_EQ(f.list->getNumInstantiatedItems(), size_t(12));
+	EXPECT_EQ(f.list->getLayoutMinimumSize(false), Vector2f(50, 10000));
+	ASSERT_TRUE(f.list->findRowAt(50));
+	EXPECT_EQ(f.list->findRowAt(50)->getId(), "item5");
+}
+
+TEST(HalleyUILayout, VirtualListRecyclesRowsWhenScrolling)
+{
+	VirtualListFixture f;
+	f.scrollTo(200);
+	const auto made = f.source->made;
+	EXPECT_EQ(f.list->getNumInstantiatedItems(), size_t(14));
+
+	f.scrollTo(5000);
+	EXPECT_EQ(f.source->made, made);
+	EXPECT_EQ(f.list->getNumInstantiatedItems(), size_t(14));
+
+	// Item 503 is 30 pixels below the top of the pane
+	EXPECT_EQ(f.list->getPosition(), Vector2f(0, -5000));
+	EXPECT_TRUE(f.list->findRowAt(30));
+	EXPECT_FALSE(f.list->findRowAt(-100));
+	EXPECT_FALSE(f.list->findRowAt(200));
+}
+
+TEST(HalleyUILayout, VirtualListScrollingDoesntInvalidateMinimumSizes)
+{
+	VirtualListFixture f;
+	f.scrollTo(200);
+
+	// Baseline: re-placing the pane's contents, with cached minimum sizes
+	f.pane->markLayoutDirty();
+	f.probe->calls = 0;
+	f.pane->layout();
+	const auto placementCalls = f.probe->calls;
+
+	// Scrolling recycles rows, which should only re-place the list
+	f.pane->scrollTo(Vector2f(0, 600));
+	f.pane->layout();
+	f.list->update(0, true);
+	f.pane->forceAddChildren(UIInputType::Undefined, true);
+	EXPECT_TRUE(f.list->isLayoutDirty());
+	f.probe->calls = 0;
+	f.pane->layout();
+	EXPECT_EQ(f.probe->calls, placementCalls);
+	EXPECT_TRUE(f.list->findRowAt(0));
+}
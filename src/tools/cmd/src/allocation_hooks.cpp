@@ -0,0 +1,40 @@
+#include <cstdlib>
+#include <new>
+#include <halley/tools/benchmark/allocation_counter.h>
+
+// Replaces the global allocation functions so that "halley-cmd benchmark" can count allocations.
+// Kept out of halley-tools, so the editor and other tools linking it aren't affected.
+
+void* operator new(std::size_t size)
+{
+	Halley::AllocationCounter::onAllocation(size);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
@@ -145,11 +145,14 @@ void AudioExpressionEditorExpression::onMakeUI()
 				auto& expr = parent.getExpressionTerm(idx);
 				if (!std_ex::contains(switchConf->getValues(), expr.value)) {
 					expr.value = switchConf->getValues().empty() ? "" : switchConf->getValues().front();
+					expr.updateIds();
 					getWidgetAs<UIDropdown>("switchValue")->setSelectedOption(expr.value);
 				}
 			} else {
 				getWidgetAs<UIDropdown>("switchValue")->clear();
-				parent.getExpressionTerm(idx).value = "";
+				auto& expr = parent.getExpressionTerm(idx);
+				expr.value = "";
+				expr.updateIds();
 			}
 		};
 
@@ -160,6 +163,7 @@ void AudioExpressionEditorExpression::onMakeUI()
 			updateSwitchValues(value);
 			auto& expression = parent.getExpressionTerm(idx);
 			expression.id = std::move(value);
+			expression.updateIds();
 			parent.markModified(idx);
 		});
 
@@ -174,6 +178,7 @@ void AudioExpressionEditorExpression::onMakeUI()
 		{
 			auto& expression = parent.getExpressionTerm(idx);
 			expression.value = std::move(value);
+			expression.updateIds();
 			parent.markModified(idx);
 		});
 
@@ -206,6 +211,7 @@ void AudioExpressionEditorExpression::onMakeUI()
 			updateVariableProps(value);
 			auto& expr = parent.getExpressionTerm(idx);
 			expr.id = std::move(value);
+			expr.updateIds();
 			parent.markModified(idx);
 		});
 
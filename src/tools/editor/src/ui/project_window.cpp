@@ -513,6 +513,34 @@ void ProjectWindow::setupConsole(Game& game)
 		reloadDLL();
 		return "Reloading DLL";
 	});
+	debugConsoleCommands->addCommand("profilerStream", [=](Vector<String> args) -> String
+	{
+		if (profilerListener) {
+			profilerListener.reset();
+			return "Stopped profiler stream";
+		}
+
+		auto* devConServer = project.getDevConServer();
+		if (!devConServer) {
+			return "DevCon server not available";
+		}
+
+		const Time interval = args.empty() ? 1.0 : args[0].toDouble();
+		profilerListener = std::make_unique<DevConProfilerListener>(*devConServer, [] (size_t connId, const DevConProfilerSample& sample)
+		{
+			auto systems = sample.systemTimes;
+			std::sort(systems.begin(), systems.end(), [] (const auto& a, const auto& b) { return a.second > b.second; });
+			Vector<String> topSystems;
+			for (size_t i = 0; i < std::min(systems.size(), size_t(3)); ++i) {
+				topSystems.push_back(systems[i].first + " " + toString(systems[i].second / 1'000'000.0, 2) + " ms");
+			}
+
+			Logger::logInfo("[Profiler " + toString(connId) + "] " + toString(sample.numFrames) + " frames, avg " + toString(sample.averageFrameTime / 1'000'000.0, 2)
+				+ " ms, max " + toString(sample.maxFrameTime / 1'000'000.0, 2) + " ms, RAM " + toString(sample.ramUsage / (1024 * 1024)) + " MB"
+				+ (topSystems.empty() ? String() : ", " + String::concatList(topSystems, ", ")));
+		}, interval);
+		return "Streaming profiler data from connected games every " + toString(interval, 2) + "s, run again to stop";
+	});
 	try {
 		game.attachToEditorDebugConsole(*debugConsoleCommands, project.getGameResources(), project);
 		debugConsoleController->addCommands(*debugConsoleCommands);
@@ -532,6 +560,7 @@ void ProjectWindow::destroyConsole()
 		debugConsoleController.reset();
 	}
 	debugConsoleCommands.reset();
+	profilerListener.reset();
 }
 
 void ProjectWindow::reloadProject()
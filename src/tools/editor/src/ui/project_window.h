@@ -150,6 +150,7 @@ namespace Halley {
     	std::shared_ptr<UIDebugConsoleController> debugConsoleController;
     	std::shared_ptr<UIDebugConsoleCommands> debugConsoleCommands;
         std::shared_ptr<UIDebugConsole> debugConsole;
+        std::unique_ptr<DevConProfilerListener> profilerListener;
         
     	std::map<EditorSettingType, std::unique_ptr<SettingsStorage>> settings;
     	Time timeSinceSettingsSaved = 0;
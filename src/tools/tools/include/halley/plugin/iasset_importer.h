@@ -101,6 +101,9 @@ namespace Halley
 		virtual void import(const ImportingAsset&, IAssetCollector&) {}
 		virtual int dropFrontCount() const { return importByExtension ? 0 : 1; }
 
+		// Bump when the output of this importer changes for the same input, to invalidate cached imports
+		virtual int getVersion() const { return 0; }
+
 		virtual String getAssetId(const Path& file, const std::optional<Metadata>& metadata) const
 		{
 			return file.dropFront(dropFrontCount()).string();
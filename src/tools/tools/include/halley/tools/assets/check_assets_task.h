@@ -56,6 +56,7 @@ namespace Halley
 		std::condition_variable condition;
 
 		std::optional<ReimportType> pendingReimport;
+		bool bypassImportCache = false;
 
 		using AssetTable = HashMap<std::pair<ImportAssetType, String>, ImportAssetsDatabaseEntry>;
 
@@ -136,6 +136,8 @@ namespace Halley
 		void deserialize(Deserializer& s);
 
 		void setPlatforms(Vector<String> platforms);
+		const Vector<String>& getPlatforms() const;
+		int getVersion() const;
 
 	private:
 		Vector<String> platforms;
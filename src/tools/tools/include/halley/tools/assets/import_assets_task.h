@@ -23,7 +23,7 @@ namespace Halley
 		};
 		using MetadataFetchCallback = std::function<std::optional<Metadata>(const Path&)>;
 		
-		ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter);
+		ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter, bool useImportCache);
 
 	protected:
 		void run() override;
@@ -34,6 +34,7 @@ namespace Halley
 		Path assetsPath;
 		Project& project;
 		const bool packAfter;
+		const bool useImportCache;
 
 		Vector<ImportAssetsDatabaseEntry> files;
 		Vector<String> deletedAssets;
@@ -43,6 +44,10 @@ namespace Halley
 		std::atomic<size_t> assetsImported{};
 		size_t assetsToImport{};
 
+		std::atomic<size_t> cacheHits{};
+		std::atomic<size_t> cacheMisses{};
+		std::atomic<int64_t> cacheTimeSaved{};
+
 		std::mutex mutex;
 		
 		std::string curFileLabel;
@@ -51,6 +56,7 @@ namespace Halley
 
 		Vector<Path> loadFont(const ImportAssetsDatabaseEntry& asset, Path dstDir);
 		Vector<Path> genericImporter(const ImportAssetsDatabaseEntry& asset, Path dstDir);
-		ImportResult importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter = {});
+		ImportingAsset loadAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher);
+		ImportResult importAsset(ImportingAsset importingAsset, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter = {});
 	};
 }
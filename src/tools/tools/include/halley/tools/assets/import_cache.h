@@ -0,0 +1,51 @@
+#pragma once
+#include "halley/file/path.h"
+#include "halley/plugin/iasset_importer.h"
+
+namespace Halley
+{
+	class AssetImporter;
+	class ImportAssetsDatabase;
+
+	// Content-addressed store of import results.
+	// Entries are keyed by a hash of everything that goes into an import (input bytes, metadata, importer type, versions and options),
+	// and are stored as plain files named after that key, so the same directory can be shared between checkouts and branches.
+	// The key also includes a build id hashed from the contents of the binaries holding the importers, so changing the tools or a plugin
+	// invalidates everything, while separate checkouts running the same binaries still share entries.
+	// Hits refresh the entry's timestamp, and trim() evicts the least recently used entries once the directory goes over its size limit.
+	class ImportCache
+	{
+	public:
+		struct Entry
+		{
+			Vector<AssetResource> out;
+			Vector<std::pair<Path, Bytes>> outFiles;
+			Vector<TimestampedPath> additionalInputs;
+			int64_t importTime = 0; // Nanoseconds taken by the import that produced this entry
+		};
+
+		ImportCache(Path directory, uint64_t buildId, uint64_t maxSize);
+
+		// Hashes the contents of each binary, in the order given
+		static uint64_t computeBuildId(gsl::span<const Path> binaries);
+
+		const Path& getDirectory() const;
+
+		uint64_t computeKey(const ImportingAsset& asset, const AssetImporter& importer, const ImportAssetsDatabase& db) const;
+
+		// Returns nothing if the entry is missing, unreadable, or if any of the files it read through the collector have changed since
+		// Files read through the collector are stored relative to whichever of assetsSrc contains them, and resolved against it again on load
+		std::optional<Entry> load(uint64_t key, const Vector<Path>& assetsSrc) const;
+		void store(uint64_t key, const Entry& entry, const Vector<Path>& assetsSrc) const;
+
+		void clear() const;
+		void trim() const;
+
+	private:
+		Path directory;
+		uint64_t buildId = 0;
+		uint64_t maxSize = 0;
+
+		Path getEntryPath(uint64_t key) const;
+	};
+}
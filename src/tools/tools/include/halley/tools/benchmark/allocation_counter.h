@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace Halley
+{
+	// Counts calls to the global operator new, for benchmarking.
+	// Nothing is counted unless the executable replaces operator new and calls onAllocation (halley-cmd does).
+	// Note that on Windows this won't see allocations made inside a game DLL, as each module has its own allocator.
+	class AllocationCounter
+	{
+	public:
+		struct Stats {
+			uint64_t count = 0;
+			uint64_t bytes = 0;
+		};
+
+		static void onAllocation(size_t size) noexcept;
+		static Stats getStats() noexcept;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "halley/tools/cli_tool.h"
+#include "halley/tools/benchmark/allocation_counter.h"
+#include "halley/file_formats/json_forward.h"
+#include "halley/data_structures/hash_map.h"
+
+namespace Halley
+{
+	// Runs a scene from a game DLL headless for a fixed number of ticks, and writes a JSON report with per-system timings,
+	// entity counts, allocations and peak memory. If given a baseline report, fails when any timing regressed past the tolerance.
+	class BenchmarkTool : public CommandLineTool
+	{
+	public:
+		int runRaw(int argc, char* argv[]) override;
+
+	protected:
+		struct Tolerance {
+			double relative = 0.1;
+			double minDeltaMs = 0.05;
+			double minDeltaAllocations = 1;
+		};
+
+		struct Arguments {
+			Vector<String> positional;
+			HashMap<String, String> options;
+			Vector<String> gameArgs;
+
+			std::optional<String> get(const String& key) const;
+		};
+
+		// Options in toolOptions are for the tool, any other --options are passed to the game
+		static Arguments parseArguments(int argc, char* argv[], gsl::span<const String> toolOptions);
+		static Tolerance getTolerance(const Arguments& args);
+
+		// Drives Core directly instead of through MainLoop, so it never waits for the clock. Returns the allocations done between
+		// the start of tick warmupTicks and the end of tick warmupTicks + ticks - 1, or nothing if the game didn't run that long.
+		static std::optional<AllocationCounter::Stats> runHeadless(const String& dllName, const Vector<String>& coreArgs, int warmupTicks, int ticks, int& exitCode);
+
+		// Adds the allocations, which can only be counted from here, to the report written by the game
+		static bool addAllocations(const Path& reportPath, const AllocationCounter::Stats& allocations, int ticks, JSONValue& report);
+
+		// Compares every timing in the baseline (any object with a "p50", at the top level or one level down)
+		static int compareToBaseline(const JSONValue& report, const JSONValue& baseline, const Tolerance& tolerance);
+		static int compareToBaseline(const JSONValue& report, const Arguments& args);
+	};
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "benchmark_tool.h"
+
+namespace Halley
+{
+	// Replays a render snapshot saved with --capture-snapshot through the game's headless Painter, and reports the CPU cost of
+	// submitting it. Uses the same report format and baseline comparison as "halley-cmd benchmark".
+	class ReplaySnapshotTool : public BenchmarkTool
+	{
+	public:
+		int runRaw(int argc, char* argv[]) override;
+	};
+}
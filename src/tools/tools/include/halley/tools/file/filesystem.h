@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <gsl/gsl>
 #include "halley/utils/utils.h"
 #include "halley/data_structures/vector.h"
@@ -18,6 +19,7 @@ namespace Halley {
 		static bool createParentDir(const Path& p);
 
 		static int64_t getLastWriteTime(const Path& p);
+		static bool touch(const Path& p);
 		static bool isFile(const Path& p);
 		static bool isDirectory(const Path& p);
 
@@ -38,10 +40,32 @@ namespace Halley {
 		static size_t fileSize(const Path& path);
 
 		static Path getTemporaryPath();
+		static Path getExecutablePath();
 
 		static int runCommand(const String& command);
 	};
 
+	// Writes a file incrementally, for outputs that are too large to build in memory first
+	class FileWriter final {
+	public:
+		FileWriter(const Path& path);
+		~FileWriter();
+
+		FileWriter(const FileWriter& other) = delete;
+		FileWriter& operator=(const FileWriter& other) = delete;
+
+		bool isOpen() const;
+		bool write(gsl::span<const gsl::byte> data);
+		bool writeAt(size_t pos, gsl::span<const gsl::byte> data);
+		size_t getPosition() const;
+		bool close();
+
+	private:
+		FILE* fp = nullptr;
+		size_t pos = 0;
+		bool ok = true;
+	};
+
 	class ScopedTemporaryFile final {
 	public:
 		ScopedTemporaryFile();
@@ -58,5 +58,6 @@ namespace Halley {
         DirEntry& getDirectory(const Path& path);
         DirEntry* tryGetDirectory(const Path& path);
         void readDirFromFilesystem(const Path& rootDir);
+        void rescanDirectory(const Path& rootDir);
     };
 }
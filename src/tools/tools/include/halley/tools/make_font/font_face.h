@@ -38,7 +38,9 @@ namespace Halley
 		float getAscender() const;
 
 		Vector<int> getCharCodes() const;
+		bool hasGlyph(int charCode) const;
 		Vector2i getGlyphSize(int charCode) const;
+		Vector2i getMaxGlyphSize() const;
 		
 		void drawGlyph(Image& image, int charcode, Vector2i pos) const;
 		FontMetrics getMetrics(int charcode, float scale = 1.0f) const;
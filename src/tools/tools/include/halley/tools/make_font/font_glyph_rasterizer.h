@@ -0,0 +1,30 @@
+#pragma once
+
+#include <mutex>
+#include "font_face.h"
+#include "halley/graphics/text/font_glyph_rasterizer.h"
+#include "halley/utils/utils.h"
+
+namespace Halley
+{
+	// Rasterizes glyphs for dynamic fonts with msdfgen, laid out exactly like the ones baked by FontGenerator
+	class FontGlyphRasterizer : public IFontGlyphRasterizer
+	{
+	public:
+		FontGlyphRasterizer(Bytes fontFile, float fontSize, float radius, float ascenderAdjustment = 0, float lineSpacing = 0, bool floorGlyphPosition = false);
+
+		FontInfo getFontInfo() const override;
+		std::optional<GlyphMetrics> getMetrics(int charcode) const override;
+		std::unique_ptr<Image> rasterize(int charcode) const override;
+
+	private:
+		Bytes fontFile; // FreeType reads from it for as long as the face is alive
+		std::unique_ptr<FontFace> font;
+		mutable std::mutex mutex;
+
+		float radius;
+		int border;
+		float padding;
+		FontInfo info;
+	};
+}
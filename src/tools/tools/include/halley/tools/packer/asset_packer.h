@@ -56,5 +56,8 @@ namespace Halley {
 		static std::map<String, AssetPackListing> sortIntoPacks(const AssetPackManifest& manifest, const AssetDatabase& srcAssetDb, std::optional<std::set<String>> assetsToPack, const Vector<String>& deletedAssets);
 		static void generatePacks(Project& project, std::map<String, AssetPackListing> packs, const Path& src, const Path& dst, ProgressCallback progress, Vector<String>& packed);
 		static void generatePack(Project& project, const String& packId, const AssetPackListing& pack, const Path& src, const Path& dst, ProgressCallback progress);
+
+		static Bytes makeKeyCheckValue(Encrypt::AESKey key);
+		static Path getKeyCheckPath(const Project& project, const Path& dstPack);
 	};
 }
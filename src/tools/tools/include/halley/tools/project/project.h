@@ -21,6 +21,7 @@ namespace Halley
 	class IHalleyEntryPoint;
 	class ProjectLoader;
 	class ImportAssetsDatabase;
+	class ImportCache;
 
 	class HalleyStatics;
 	class IHalleyPlugin;
@@ -88,6 +89,7 @@ namespace Halley
 		ImportAssetsDatabase& getImportAssetsDatabase() const;
 		ImportAssetsDatabase& getCodegenDatabase() const;
 		ImportAssetsDatabase& getSharedCodegenDatabase() const;
+		ImportCache* getImportCache() const;
 		ECSData& getECSData();
 		ImportAssetType getImportAssetType(const Path& filePath) override;
 
@@ -197,6 +199,7 @@ namespace Halley
 		std::unique_ptr<ImportAssetsDatabase> importAssetsDatabase;
 		std::unique_ptr<ImportAssetsDatabase> codegenDatabase;
 		std::unique_ptr<ImportAssetsDatabase> sharedCodegenDatabase;
+		std::unique_ptr<ImportCache> importCache;
 		std::shared_ptr<AssetImporter> assetImporter;
 
 		std::unique_ptr<ProjectProperties> properties;
@@ -231,6 +234,8 @@ namespace Halley
 		std::map<std::pair<AssetType, String>, AssetPreviewCache> previewCache;
 
 		Path getDLLPath() const;
+		Path getImportCachePath() const;
+		uint64_t computeImporterBuildId() const;
 		void loadECSData();
 		void loadGameEditorData() const;
 	};
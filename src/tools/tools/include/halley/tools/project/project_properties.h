@@ -31,6 +31,13 @@ namespace Halley {
     	void setDefaultZoom(float zoom);
 		float getDefaultZoom() const;
 
+		bool getUseImportCache() const;
+		void setUseImportCache(bool enabled);
+		const String& getImportCachePath() const;
+		void setImportCachePath(String path);
+		uint64_t getImportCacheMaxSize() const;
+		void setImportCacheMaxSize(uint64_t bytes);
+
 		const I18NLanguage& getOriginalLanguage() const;
 		const Vector<I18NLanguage>& getLanguages() const;
 
@@ -44,6 +51,9 @@ namespace Halley {
         Vector<I18NLanguage> languages;
     	bool importByExtension = false;
     	float defaultZoom = 1.0f;
+		bool useImportCache = true;
+		String importCachePath;
+		uint64_t importCacheMaxSizeMB = 4096;
     	Vector<String> platforms;
 
     	bool dirty = false;
@@ -4,6 +4,7 @@
 #include "halley/tools/assets/import_assets_task.h"
 #include "halley/tools/project/project.h"
 #include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/assets/import_cache.h"
 #include "halley/tools/assets/delete_assets_task.h"
 #include "halley/tools/file/filesystem.h"
 #include "halley/tools/assets/metadata_importer.h"
@@ -122,9 +123,14 @@ void CheckAssetsTask::run()
 			if (hasAssets) {
 				if (curPendingReimport == ReimportType::ReimportAll) {
 					project.getImportAssetsDatabase().clear();
+					if (auto* cache = project.getImportCache()) {
+						cache->clear();
+					}
+					bypassImportCache = true;
 				}
 				const float rangeStart = hasCodeGen ? 0.1f : 0.0f;
 				importing |= importAll(project.getImportAssetsDatabase(), { project.getAssetsSrcPath(), project.getSharedAssetsSrcPath() }, true, project.getUnpackedAssetsPath(), "Importing assets", true, Range(rangeStart, 1.0f));
+				bypassImportCache = false;
 			}
 			setVisible(false);
 			while (hasPendingTasks()) {
@@ -373,7 +379,7 @@ bool CheckAssetsTask::requestImport(ImportAssetsDatabase& db, AssetTable assets,
 	const bool hasImport = hasAssetsToImport(db, assets);
 	if (hasImport || !deletedAssets.empty()) {
 		auto toImport = hasImport ? getAssetsToImport(db, assets) : Vector<ImportAssetsDatabaseEntry>();
-		addPendingTask(std::make_unique<ImportAssetsTask>(taskName, db, projectAssetImporter, dstPath, std::move(toImport), std::move(deletedAssets), project, packAfter));
+		addPendingTask(std::make_unique<ImportAssetsTask>(taskName, db, projectAssetImporter, dstPath, std::move(toImport), std::move(deletedAssets), project, packAfter, !bypassImportCache));
 		return true;
 	}
 	return false;
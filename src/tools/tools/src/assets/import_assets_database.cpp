@@ -623,6 +623,16 @@ void ImportAssetsDatabase::setPlatforms(Vector<String> platforms)
 	}
 }
 
+const Vector<String>& ImportAssetsDatabase::getPlatforms() const
+{
+	return platforms;
+}
+
+int ImportAssetsDatabase::getVersion() const
+{
+	return version;
+}
+
 const ImportAssetsDatabase::AssetEntry* ImportAssetsDatabase::findEntry(AssetType type, const String& id) const
 {
 	if (indexDirty) {
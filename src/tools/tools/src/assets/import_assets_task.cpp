@@ -3,6 +3,7 @@
 #include "halley/tools/assets/check_assets_task.h"
 #include "halley/tools/project/project.h"
 #include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/assets/import_cache.h"
 #include "halley/tools/file/filesystem.h"
 #include "halley/tools/assets/asset_collector.h"
 #include "halley/concurrency/concurrent.h"
@@ -14,13 +15,14 @@
 
 using namespace Halley;
 
-ImportAssetsTask::ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter)
+ImportAssetsTask::ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter, bool useImportCache)
 	: Task(std::move(taskName), true, !files.empty(), { files.size() == 1 && files[0].assetId == ":codegen" ? "code" : "assets" })
 	, db(db)
 	, importer(std::move(importer))
 	, assetsPath(std::move(assetsPath))
 	, project(project)
 	, packAfter(packAfter)
+	, useImportCache(useImportCache)
 	, files(std::move(files))
 	, deletedAssets(std::move(deletedAssets))
 	, totalImportTime(0)
@@ -34,6 +36,9 @@ void ImportAssetsTask::run()
 
 	assetsImported = 0;
 	assetsToImport = files.size();
+	cacheHits = 0;
+	cacheMisses = 0;
+	cacheTimeSaved = 0;
 	Vector<Future<void>> tasks;
 
 	constexpr bool parallelImport = !Debug::isDebug();
@@ -94,6 +99,13 @@ void ImportAssetsTask::run()
 	const Time realTime = timer.elapsedNanoseconds() / 1000000000.0;
 	const Time importTime = totalImportTime / 1000000000.0;
 	logInfo("Import took " + toString(realTime) + " seconds, on which " + toString(importTime) + " seconds of work were performed (" + toString(importTime / realTime) + "x realtime)");
+	if (cacheHits > 0 || cacheMisses > 0) {
+		const Time timeSaved = cacheTimeSaved / 1000000000.0;
+		logInfo("Import cache: " + toString(cacheHits.load()) + " hits, " + toString(cacheMisses.load()) + " misses, saved " + toString(timeSaved) + " seconds of import work");
+	}
+	if (auto* cache = project.getImportCache(); cache && cacheMisses > 0) {
+		cache->trim();
+	}
 }
 
 bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
@@ -101,7 +113,45 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	auto& fs = project.getFileSystemCache();
 	Stopwatch timer;
 
-	auto result = importAsset(asset, [&] (const Path& path) { return db.getMetadata(path); }, *importer, assetsPath, [=] (float, const String&) -> bool { return !isCancelled(); });
+	auto importingAsset = loadAsset(asset, [&] (const Path& path) { return db.getMetadata(path); });
+
+	// Codegen writes its output directly and is always run as a single asset, so it doesn't go through the cache
+	// When bypassing the cache (Re-Import All), the results are still stored, replacing whatever was there
+	auto* cache = asset.assetType != ImportAssetType::Codegen ? project.getImportCache() : nullptr;
+	const auto cacheKey = cache ? std::optional<uint64_t>(cache->computeKey(importingAsset, *importer, db)) : std::nullopt;
+	auto cached = cacheKey && useImportCache ? cache->load(*cacheKey, importer->getAssetsSrc()) : std::nullopt;
+
+	ImportResult result;
+	if (cached) {
+		result.out = std::move(cached->out);
+		for (auto& [path, data]: cached->outFiles) {
+			result.outFiles.emplace_back(std::move(path), std::move(data));
+		}
+		result.additionalInputs = std::move(cached->additionalInputs);
+		result.success = true;
+
+		++cacheHits;
+		cacheTimeSaved += cached->importTime;
+	} else {
+		Stopwatch importTimer;
+		result = importAsset(std::move(importingAsset), *importer, assetsPath, [=] (float, const String&) -> bool { return !isCancelled(); });
+		importTimer.pause();
+
+		if (cacheKey) {
+			++cacheMisses;
+			if (result.success && !isCancelled()) {
+				ImportCache::Entry entry;
+				entry.out = result.out;
+				entry.additionalInputs = result.additionalInputs;
+				entry.importTime = importTimer.elapsedNanoseconds();
+				for (const auto& [path, data]: result.outFiles) {
+					// Files without data were written directly by the importer
+					entry.outFiles.emplace_back(path, data ? *data : FileSystem::readFile(assetsPath / path));
+				}
+				cache->store(*cacheKey, entry, importer->getAssetsSrc());
+			}
+		}
+	}
 	
 	if (!result.success) {
 		logError("\"" + asset.assetId + "\" - " + result.errorMsg);
@@ -162,33 +212,36 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	return true;
 }
 
-ImportAssetsTask::ImportResult ImportAssetsTask::importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter)
+ImportingAsset ImportAssetsTask::loadAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher)
+{
+	ImportingAsset importingAsset;
+	importingAsset.assetId = asset.assetId;
+	importingAsset.assetType = asset.assetType;
+	for (const auto& f: asset.inputFiles) {
+		auto meta = metadataFetcher(f.getPath());
+		auto data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+		if (data.empty()) {
+			// Give it a bit and try again if it was empty
+			using namespace std::chrono_literals;
+			std::this_thread::sleep_for(5ms);
+			data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+
+			if (data.empty()) {
+				logError("Data for \"" + toString(asset.srcDir / f.getPath()) + "\" is empty.");
+			}
+		}
+		importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
+	}
+	return importingAsset;
+}
+
+ImportAssetsTask::ImportResult ImportAssetsTask::importAsset(ImportingAsset importingAsset, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter)
 {
 	ImportResult result;
 	
 	try {
 		// Create queue
 		std::list<ImportingAsset> toLoad;
-
-		// Load files from disk
-		ImportingAsset importingAsset;
-		importingAsset.assetId = asset.assetId;
-		importingAsset.assetType = asset.assetType;
-		for (const auto& f: asset.inputFiles) {
-			auto meta = metadataFetcher(f.getPath());
-			auto data = FileSystem::readFile(asset.srcDir / f.getDataPath());
-			if (data.empty()) {
-				// Give it a bit and try again if it was empty
-				using namespace std::chrono_literals;
-				std::this_thread::sleep_for(5ms);
-				data = FileSystem::readFile(asset.srcDir / f.getDataPath());
-
-				if (data.empty()) {
-					logError("Data for \"" + toString(asset.srcDir / f.getPath()) + "\" is empty.");
-				}
-			}
-			importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
-		}
 		toLoad.emplace_back(std::move(importingAsset));
 
 		// Import
@@ -0,0 +1,297 @@
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/assets/asset_importer.h"
+#include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/maths/uuid.h"
+#include "halley/support/logger.h"
+#include "halley/utils/hash.h"
+#include <fstream>
+#include <typeinfo>
+
+using namespace Halley;
+
+namespace {
+	constexpr int cacheFormatVersion = 1;
+
+	struct CachedInput {
+		int root = -1; // Index into the importer's assets src directories, or -1 if path is absolute
+		String path;
+		uint64_t hash = 0;
+
+		void serialize(Serializer& s) const
+		{
+			s << root;
+			s << path;
+			s << hash;
+		}
+
+		void deserialize(Deserializer& s)
+		{
+			s >> root;
+			s >> path;
+			s >> hash;
+		}
+	};
+
+	struct CachedEntry {
+		int formatVersion = cacheFormatVersion;
+		Vector<AssetResource> out;
+		Vector<std::pair<String, Bytes>> outFiles;
+		Vector<CachedInput> additionalInputs;
+		int64_t importTime = 0;
+
+		void serialize(Serializer& s) const
+		{
+			s << formatVersion;
+			s << out;
+			s << outFiles;
+			s << additionalInputs;
+			s << importTime;
+		}
+
+		void deserialize(Deserializer& s)
+		{
+			s >> formatVersion;
+			if (formatVersion != cacheFormatVersion) {
+				return;
+			}
+			s >> out;
+			s >> outFiles;
+			s >> additionalInputs;
+			s >> importTime;
+		}
+	};
+
+	// ConfigNode maps are unordered, so they're hashed in key order to keep the key stable across runs
+	void feedConfigNode(Hash::Hasher& hasher, const ConfigNode& node)
+	{
+		hasher.feed(node.getType());
+
+		switch (node.getType()) {
+		case ConfigNodeType::Map:
+			{
+				Vector<const String*> keys;
+				for (const auto& [k, v]: node.asMap()) {
+					keys.push_back(&k);
+				}
+				std::sort(keys.begin(), keys.end(), [] (const String* a, const String* b) { return *a < *b; });
+				for (const auto* k: keys) {
+					hasher.feed(*k);
+					feedConfigNode(hasher, node[*k]);
+				}
+			}
+			break;
+
+		case ConfigNodeType::Sequence:
+			hasher.feed(node.asSequence().size());
+			for (const auto& e: node.asSequence()) {
+				feedConfigNode(hasher, e);
+			}
+			break;
+
+		case ConfigNodeType::Undefined:
+			break;
+
+		default:
+			hasher.feedBytes(Serializer::toBytes(node).byte_span());
+		}
+	}
+
+	std::pair<int, Path> makeRelativeInput(const Path& path, const Vector<Path>& assetsSrc)
+	{
+		for (size_t i = 0; i < assetsSrc.size(); ++i) {
+			if (assetsSrc[i].isPrefixOf(path)) {
+				return { static_cast<int>(i), path.makeRelativeTo(assetsSrc[i]) };
+			}
+		}
+		return { -1, path };
+	}
+}
+
+ImportCache::ImportCache(Path directory, uint64_t buildId, uint64_t maxSize)
+	: directory(std::move(directory))
+	, buildId(buildId)
+	, maxSize(maxSize)
+{
+}
+
+uint64_t ImportCache::computeBuildId(gsl::span<const Path> binaries)
+{
+	// Only the contents go into the id, so checkouts with identical binaries share entries regardless of where they live or when they were copied
+	Hash::Hasher hasher;
+	Vector<char> buffer(1024 * 1024);
+	for (const auto& binary: binaries) {
+		std::ifstream fp(binary.string(), std::ios::binary | std::ios::in);
+		hasher.feed(fp.is_open());
+		while (fp) {
+			fp.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			const auto n = static_cast<size_t>(fp.gcount());
+			hasher.feed(n);
+			hasher.feedBytes(gsl::as_bytes(gsl::span<const char>(buffer.data(), n)));
+		}
+	}
+	return hasher.digest();
+}
+
+const Path& ImportCache::getDirectory() const
+{
+	return directory;
+}
+
+uint64_t ImportCache::computeKey(const ImportingAsset& asset, const AssetImporter& importer, const ImportAssetsDatabase& db) const
+{
+	Hash::Hasher hasher;
+	hasher.feed(cacheFormatVersion);
+	hasher.feed(buildId);
+	hasher.feed(db.getVersion());
+	for (const auto& platform: db.getPlatforms()) {
+		hasher.feed(platform);
+	}
+	feedConfigNode(hasher, importer.getImporterOptions());
+
+	hasher.feed(asset.assetType);
+	hasher.feed(asset.assetId);
+	for (const auto& assetImporter: importer.getImporters(asset.assetType)) {
+		hasher.feed(std::string_view(typeid(assetImporter.get()).name()));
+		hasher.feed(assetImporter.get().getVersion());
+	}
+	feedConfigNode(hasher, asset.options);
+
+	hasher.feed(asset.inputFiles.size());
+	for (const auto& file: asset.inputFiles) {
+		hasher.feed(file.name.getString());
+		hasher.feed(file.data.size());
+		hasher.feedBytes(file.data.byte_span());
+		feedConfigNode(hasher, file.metadata.getEntries());
+	}
+
+	return hasher.digest();
+}
+
+std::optional<ImportCache::Entry> ImportCache::load(uint64_t key, const Vector<Path>& assetsSrc) const
+{
+	const auto path = getEntryPath(key);
+	if (!FileSystem::exists(path)) {
+		return {};
+	}
+
+	CachedEntry cached;
+	try {
+		Deserializer::fromBytes(cached, FileSystem::readFile(path));
+	} catch (const std::exception& e) {
+		Logger::logWarning("Ignoring corrupted import cache entry \"" + path.getString() + "\": " + e.what());
+		return {};
+	}
+	if (cached.formatVersion != cacheFormatVersion) {
+		return {};
+	}
+
+	Entry entry;
+	for (const auto& input: cached.additionalInputs) {
+		if (input.root >= static_cast<int>(assetsSrc.size())) {
+			return {};
+		}
+		const auto inputPath = input.root >= 0 ? assetsSrc[input.root] / input.path : Path(input.path);
+		if (!FileSystem::exists(inputPath) || Hash::hash(FileSystem::readFile(inputPath)) != input.hash) {
+			return {};
+		}
+		entry.additionalInputs.push_back(TimestampedPath(inputPath, FileSystem::getLastWriteTime(inputPath)));
+	}
+
+	entry.out = std::move(cached.out);
+	entry.outFiles.reserve(cached.outFiles.size());
+	for (auto& [filePath, data]: cached.outFiles) {
+		entry.outFiles.emplace_back(Path(filePath), std::move(data));
+	}
+	entry.importTime = cached.importTime;
+
+	// Used as the last access time when trimming
+	FileSystem::touch(path);
+
+	return entry;
+}
+
+void ImportCache::store(uint64_t key, const Entry& entry, const Vector<Path>& assetsSrc) const
+{
+	CachedEntry cached;
+	cached.out = entry.out;
+	cached.importTime = entry.importTime;
+
+	cached.outFiles.reserve(entry.outFiles.size());
+	for (const auto& [filePath, data]: entry.outFiles) {
+		cached.outFiles.emplace_back(filePath.getString(), data);
+	}
+
+	for (const auto& [inputPath, timestamp]: entry.additionalInputs) {
+		const auto [root, path] = makeRelativeInput(inputPath, assetsSrc);
+		cached.additionalInputs.push_back(CachedInput{ root, path.getString(), Hash::hash(FileSystem::readFile(inputPath)) });
+	}
+
+	// Write to a temporary file first, so that concurrent importers (or other checkouts) never see a partial entry
+	const auto path = getEntryPath(key);
+	const auto tmpPath = Path(path.getString() + ".tmp-" + UUID::generate().toString());
+	if (FileSystem::writeFile(tmpPath, Serializer::toBytes(cached))) {
+		if (!FileSystem::rename(tmpPath, path)) {
+			FileSystem::remove(tmpPath);
+		}
+	} else {
+		Logger::logWarning("Unable to write import cache entry \"" + path.getString() + "\"");
+	}
+}
+
+void ImportCache::clear() const
+{
+	for (const auto& file: FileSystem::enumerateDirectory(directory)) {
+		if (file.getExtension() == ".cache") {
+			FileSystem::remove(directory / file);
+		}
+	}
+}
+
+void ImportCache::trim() const
+{
+	struct CacheFile {
+		Path path;
+		int64_t lastAccess;
+		uint64_t size;
+	};
+
+	Vector<CacheFile> files;
+	uint64_t totalSize = 0;
+	for (const auto& file: FileSystem::enumerateDirectory(directory)) {
+		if (file.getExtension() == ".cache") {
+			auto path = directory / file;
+			const auto size = static_cast<uint64_t>(FileSystem::fileSize(path));
+			const auto lastAccess = FileSystem::getLastWriteTime(path);
+			totalSize += size;
+			files.push_back(CacheFile{ std::move(path), lastAccess, size });
+		}
+	}
+
+	if (totalSize <= maxSize) {
+		return;
+	}
+
+	// Evict down to 90% of the limit, so it doesn't have to trim again on the next import
+	const uint64_t target = maxSize / 10 * 9;
+	std::sort(files.begin(), files.end(), [] (const CacheFile& a, const CacheFile& b) { return a.lastAccess < b.lastAccess; });
+	size_t nRemoved = 0;
+	for (const auto& file: files) {
+		if (totalSize <= target) {
+			break;
+		}
+		// Another process might have already removed it, which is fine
+		FileSystem::remove(file.path);
+		totalSize -= file.size;
+		++nRemoved;
+	}
+
+	Logger::logInfo("Import cache: evicted " + toString(nRemoved) + " entries, now using " + String::prettySize(totalSize));
+}
+
+Path ImportCache::getEntryPath(uint64_t key) const
+{
+	const auto name = toString(key, 16, 16);
+	return directory / name.substr(0, 2) / (name + ".cache");
+}
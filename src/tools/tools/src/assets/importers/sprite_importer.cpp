@@ -45,6 +45,7 @@ void SpriteImporter::import(const ImportingAsset& asset, IAssetCollector& collec
 		slices.w = gsl::narrow<short, int>(meta.getInt("slice_bottom", 0));
 		const bool trim = meta.getBool("trim", true);
 		const int padding = meta.getInt("padding", 0);
+		const bool allowRotation = meta.getBool("allowRotation", false);
 
 		// Palette
 		auto thisPalette = meta.getString("palette", "");
@@ -94,10 +95,11 @@ void SpriteImporter::import(const ImportingAsset& asset, IAssetCollector& collec
 		auto oneAtlas = meta.getString("atlas", "");
 		
 		for (auto& frames : groupedFrames) {
-			// Update frames with pivot and slices
+			// Update frames with pivot, slices and rotation
 			for (auto& f : frames.second) {
 				f.pivot = pivot;
 				f.slices = slices;
+				f.allowRotation = allowRotation;
 			}
 
 			// Split into a grid
@@ -301,6 +303,7 @@ Vector<SpriteImporter::ImageData> SpriteImporter::splitImagesInGrid(const Vector
 					dst.sequenceName = src.sequenceName + suffix;
 					dst.img = std::move(img);
 					dst.clip = Rect4i({}, grid);
+					dst.allowRotation = src.allowRotation;
 				}
 			}
 		}
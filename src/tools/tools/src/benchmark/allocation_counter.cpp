@@ -0,0 +1,24 @@
+#include "halley/tools/benchmark/allocation_counter.h"
+#include <atomic>
+
+using namespace Halley;
+
+namespace {
+	// Plain globals rather than function statics, as these can be hit before main() and during static destruction
+	std::atomic<uint64_t> allocationCount = 0;
+	std::atomic<uint64_t> allocationBytes = 0;
+}
+
+void AllocationCounter::onAllocation(size_t size) noexcept
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocationBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+AllocationCounter::Stats AllocationCounter::getStats() noexcept
+{
+	Stats result;
+	result.count = allocationCount.load(std::memory_order_relaxed);
+	result.bytes = allocationBytes.load(std::memory_order_relaxed);
+	return result;
+}
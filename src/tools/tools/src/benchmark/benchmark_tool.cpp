@@ -0,0 +1,253 @@
+#include "halley/tools/benchmark/benchmark_tool.h"
+#include "halley/tools/runner/dynamic_loader.h"
+#include "halley/entity/benchmark_stage.h"
+#include "halley/file_formats/json/json.h"
+#include "halley/game/core.h"
+#include "halley/support/console.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+namespace {
+	bool isRegression(double current, double baseline, double relative, double minDelta)
+	{
+		return current > baseline * (1.0 + relative) && current - baseline > minDelta;
+	}
+}
+
+int BenchmarkTool::runRaw(int argc, char* argv[])
+{
+	const auto args = parseArguments(argc, argv, std::array<String, 9>{ "ticks", "warmup", "seed", "stage", "tag", "output", "baseline", "tolerance", "min-delta" });
+
+	if (args.positional.size() != 2) {
+		std::cout << "Usage: halley-cmd benchmark <dllname> <scene> [--ticks=600] [--warmup=60] [--seed=0] [--stage=stages/game_world] [--tag=systemTag]" << std::endl;
+		std::cout << "                                              [--output=benchmark.json] [--baseline=baseline.json] [--tolerance=0.1] [--min-delta=0.05]" << std::endl;
+		std::cout << "Any other --options are passed to the game." << std::endl;
+		return 1;
+	}
+
+	BenchmarkStage::Options benchmark;
+	benchmark.scene = args.positional[1];
+	if (const auto ticks = args.get("ticks")) {
+		benchmark.ticks = std::max(ticks->toInteger(), 1);
+	}
+	if (const auto warmup = args.get("warmup")) {
+		benchmark.warmupTicks = std::max(warmup->toInteger(), 0);
+	}
+	if (const auto seed = args.get("seed")) {
+		benchmark.seed = static_cast<uint32_t>(seed->toInteger64());
+	}
+	if (const auto stage = args.get("stage")) {
+		benchmark.stage = *stage;
+	}
+	benchmark.systemTag = args.get("tag");
+	if (const auto output = args.get("output")) {
+		benchmark.output = Path(*output);
+	}
+
+	Vector<String> coreArgs = benchmark.toArguments();
+	coreArgs.insert(coreArgs.end(), args.gameArgs.begin(), args.gameArgs.end());
+
+	std::cout << "Benchmarking \"" << benchmark.scene << "\" from DLL \"" << args.positional[0] << "\"..." << std::endl;
+
+	int exitCode = 0;
+	const auto allocations = runHeadless(args.positional[0], coreArgs, benchmark.warmupTicks, benchmark.ticks, exitCode);
+	if (!allocations) {
+		return exitCode;
+	}
+
+	Json::Value report;
+	if (!addAllocations(benchmark.output, *allocations, benchmark.ticks, report)) {
+		return 1;
+	}
+
+	std::cout << "Tick p50: " << report["tick"]["p50"].asDouble() << " ms, p99: " << report["tick"]["p99"].asDouble() << " ms, "
+		<< report["entities"]["max"].asUInt64() << " entities, " << report["allocations"]["perTick"].asDouble() << " allocations per tick, "
+		<< (report["peakMemory"].asUInt64() / (1024 * 1024)) << " MB peak memory." << std::endl;
+	std::cout << "Report written to " << benchmark.output << std::endl;
+
+	return compareToBaseline(report, args);
+}
+
+std::optional<String> BenchmarkTool::Arguments::get(const String& key) const
+{
+	const auto iter = options.find(key);
+	return iter != options.end() ? std::optional<String>(iter->second) : std::nullopt;
+}
+
+BenchmarkTool::Arguments BenchmarkTool::parseArguments(int argc, char* argv[], gsl::span<const String> toolOptions)
+{
+	Arguments result;
+	for (int i = 2; i < argc; ++i) {
+		const String arg = argv[i];
+		if (arg.startsWith("--")) {
+			const auto eq = arg.find('=');
+			const auto key = arg.mid(2, eq == String::npos ? String::npos : eq - 2);
+			if (std_ex::contains(toolOptions, key)) {
+				result.options[key] = eq == String::npos ? String() : arg.mid(eq + 1);
+			} else {
+				result.gameArgs.push_back(arg);
+			}
+		} else {
+			result.positional.push_back(arg);
+		}
+	}
+	return result;
+}
+
+BenchmarkTool::Tolerance BenchmarkTool::getTolerance(const Arguments& args)
+{
+	Tolerance tolerance;
+	if (const auto relative = args.get("tolerance")) {
+		tolerance.relative = relative->toDouble();
+	}
+	if (const auto minDelta = args.get("min-delta")) {
+		tolerance.minDeltaMs = minDelta->toDouble();
+	}
+	return tolerance;
+}
+
+std::optional<AllocationCounter::Stats> BenchmarkTool::runHeadless(const String& dllName, const Vector<String>& coreArgs, int warmupTicks, int ticks, int& exitCode)
+{
+	// Same layout as "halley-cmd run": the DLL stands in for the program path
+	Vector<std::string> args;
+	args.push_back(dllName.cppStr());
+	args.push_back("--headless");
+	for (const auto& arg: coreArgs) {
+		args.push_back(arg.cppStr());
+	}
+
+	// Each tick is one frame of the benchmark stage
+	AllocationCounter::Stats allocStart;
+	std::optional<AllocationCounter::Stats> allocEnd;
+	{
+		DynamicGameLoader loader(dllName.cppStr());
+		auto core = loader.createCore(args);
+		loader.setCore(*core);
+
+		core->getAPI().system->runGame([&] ()
+		{
+			core->init();
+
+			const int endTick = warmupTicks + ticks;
+			for (int tick = 0; core->isRunning(); ++tick) {
+				core->transitionStage();
+				if (tick == warmupTicks) {
+					allocStart = AllocationCounter::getStats();
+				} else if (tick == endTick) {
+					allocEnd = AllocationCounter::getStats();
+				}
+				core->onTick(0);
+			}
+		});
+
+		exitCode = core->getExitCode();
+	}
+
+	if (exitCode != 0 || !allocEnd) {
+		std::cout << ConsoleColour(Console::RED) << "Benchmark run failed with exit code " << exitCode << ConsoleColour() << std::endl;
+		if (exitCode == 0) {
+			exitCode = 1;
+		}
+		return std::nullopt;
+	}
+
+	AllocationCounter::Stats result;
+	result.count = allocEnd->count - allocStart.count;
+	result.bytes = allocEnd->bytes - allocStart.bytes;
+	return result;
+}
+
+bool BenchmarkTool::addAllocations(const Path& reportPath, const AllocationCounter::Stats& allocations, int ticks, JSONValue& report)
+{
+	if (!Json::Reader().parse(Path::readFileString(reportPath).cppStr(), report)) {
+		std::cout << ConsoleColour(Console::RED) << "Unable to read benchmark report at " << reportPath << ConsoleColour() << std::endl;
+		return false;
+	}
+
+	Json::Value result(Json::objectValue);
+	result["count"] = static_cast<Json::UInt64>(allocations.count);
+	result["bytes"] = static_cast<Json::UInt64>(allocations.bytes);
+	result["perTick"] = static_cast<double>(allocations.count) / static_cast<double>(ticks);
+	report["allocations"] = result;
+	Path::writeFile(reportPath, String(Json::StyledWriter().write(report)));
+	return true;
+}
+
+int BenchmarkTool::compareToBaseline(const JSONValue& report, const Arguments& args)
+{
+	const auto baselineOption = args.get("baseline");
+	if (!baselineOption) {
+		return 0;
+	}
+
+	Json::Value baseline;
+	const auto baselinePath = Path(*baselineOption);
+	if (!Json::Reader().parse(Path::readFileString(baselinePath).cppStr(), baseline)) {
+		std::cout << ConsoleColour(Console::RED) << "Unable to read baseline at " << baselinePath << ConsoleColour() << std::endl;
+		return 1;
+	}
+	return compareToBaseline(report, baseline, getTolerance(args));
+}
+
+int BenchmarkTool::compareToBaseline(const JSONValue& report, const JSONValue& baseline, const Tolerance& tolerance)
+{
+	int nRegressions = 0;
+
+	auto isTiming = [] (const JSONValue& value)
+	{
+		return value.isObject() && value.isMember("p50");
+	};
+
+	auto compareTimes = [&] (const String& name, const JSONValue& current, const JSONValue& base)
+	{
+		for (const char* key: { "p50", "p90" }) {
+			if (!current.isMember(key) || !base.isMember(key)) {
+				continue;
+			}
+			const double cur = current[key].asDouble();
+			const double prev = base[key].asDouble();
+			if (isRegression(cur, prev, tolerance.relative, tolerance.minDeltaMs)) {
+				std::cout << ConsoleColour(Console::RED) << "Regression: " << name << " " << key << " went from " << prev << " ms to " << cur << " ms" << ConsoleColour() << std::endl;
+				++nRegressions;
+			}
+		}
+	};
+
+	for (const auto& name: baseline.getMemberNames()) {
+		const auto& base = baseline[name];
+		if (isTiming(base)) {
+			compareTimes(name, report[name], base);
+		} else if (base.isObject()) {
+			// Groups of timings, e.g. per system
+			const auto& current = report[name];
+			for (const auto& subName: base.getMemberNames()) {
+				if (!isTiming(base[subName])) {
+					continue;
+				}
+				if (current.isObject() && current.isMember(subName)) {
+					compareTimes(subName, current[subName], base[subName]);
+				} else {
+					std::cout << ConsoleColour(Console::YELLOW) << subName << " is in the baseline but didn't run." << ConsoleColour() << std::endl;
+				}
+			}
+		}
+	}
+
+	if (baseline.isMember("allocations")) {
+		const double cur = report["allocations"]["perTick"].asDouble();
+		const double prev = baseline["allocations"]["perTick"].asDouble();
+		if (isRegression(cur, prev, tolerance.relative, tolerance.minDeltaAllocations)) {
+			std::cout << ConsoleColour(Console::RED) << "Regression: allocations per tick went from " << prev << " to " << cur << ConsoleColour() << std::endl;
+			++nRegressions;
+		}
+	}
+
+	if (nRegressions > 0) {
+		std::cout << ConsoleColour(Console::RED) << nRegressions << " regression(s) against baseline." << ConsoleColour() << std::endl;
+		return 3;
+	}
+
+	std::cout << ConsoleColour(Console::GREEN) << "No regressions against baseline." << ConsoleColour() << std::endl;
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include "halley/tools/benchmark/replay_snapshot_tool.h"
+#include "halley/diagnostics/render_snapshot_benchmark_stage.h"
+#include "halley/file_formats/json/json.h"
+
+using namespace Halley;
+
+int ReplaySnapshotTool::runRaw(int argc, char* argv[])
+{
+	const auto args = parseArguments(argc, argv, std::array<String, 7>{ "frames", "warmup", "batched", "output", "baseline", "tolerance", "min-delta" });
+
+	if (args.positional.size() != 2) {
+		std::cout << "Usage: halley-cmd replay-snapshot <dllname> <snapshot> [--frames=600] [--warmup=60] [--batched]" << std::endl;
+		std::cout << "                                                    [--output=snapshot_benchmark.json] [--baseline=baseline.json] [--tolerance=0.1] [--min-delta=0.05]" << std::endl;
+		std::cout << "--batched resubmits draws through Painter::draw, so batching is measured too." << std::endl;
+		std::cout << "Any other --options are passed to the game." << std::endl;
+		return 1;
+	}
+
+	RenderSnapshotBenchmarkStage::Options replay;
+	replay.snapshot = Path(args.positional[1]);
+	if (const auto frames = args.get("frames")) {
+		replay.frames = std::max(frames->toInteger(), 1);
+	}
+	if (const auto warmup = args.get("warmup")) {
+		replay.warmupFrames = std::max(warmup->toInteger(), 0);
+	}
+	replay.batched = args.get("batched").has_value();
+	if (const auto output = args.get("output")) {
+		replay.output = Path(*output);
+	}
+
+	Vector<String> coreArgs = replay.toArguments();
+	coreArgs.insert(coreArgs.end(), args.gameArgs.begin(), args.gameArgs.end());
+
+	std::cout << "Replaying \"" << replay.snapshot.getString() << "\" with DLL \"" << args.positional[0] << "\"..." << std::endl;
+
+	int exitCode = 0;
+	const auto allocations = runHeadless(args.positional[0], coreArgs, replay.warmupFrames, replay.frames, exitCode);
+	if (!allocations) {
+		return exitCode;
+	}
+
+	Json::Value report;
+	if (!addAllocations(replay.output, *allocations, replay.frames, report)) {
+		return 1;
+	}
+
+	std::cout << report["drawCalls"].asUInt64() << " draw calls, replay p50: " << report["replay"]["p50"].asDouble() << " ms, p99: " << report["replay"]["p99"].asDouble() << " ms, "
+		<< report["allocations"]["perTick"].asDouble() << " allocations per frame." << std::endl;
+	std::cout << "Report written to " << replay.output.getString() << std::endl;
+
+	return compareToBaseline(report, args);
+}
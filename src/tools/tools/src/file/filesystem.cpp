@@ -8,6 +8,8 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
 #endif
 
 using namespace Halley;
@@ -49,6 +51,13 @@ int64_t FileSystem::getLastWriteTime(const Path& p)
 	return result.time_since_epoch().count();
 }
 
+bool FileSystem::touch(const Path& p)
+{
+	std::error_code ec;
+	last_write_time(getNative(p), file_time_type::clock::now(), ec);
+	return !ec;
+}
+
 bool FileSystem::isFile(const Path& p)
 {
 	return is_regular_file(getNative(p));
@@ -210,11 +219,96 @@ Path FileSystem::getTemporaryPath()
 	return Path(temp_directory_path().string()) / Path(String(name.data(), name.size()));
 }
 
+Path FileSystem::getExecutablePath()
+{
+#if defined(_WIN32)
+	WCHAR buffer[MAX_PATH];
+	const auto len = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+	return len > 0 ? Path(String(buffer)) : Path();
+#elif defined(__APPLE__)
+	char buffer[2048];
+	uint32_t bufSize = sizeof(buffer);
+	return _NSGetExecutablePath(buffer, &bufSize) == 0 ? Path(String(buffer)) : Path();
+#else
+	std::error_code ec;
+	const auto result = read_symlink("/proc/self/exe", ec);
+	return ec ? Path() : Path(result.string());
+#endif
+}
+
 int FileSystem::runCommand(const String& command)
 {
 	return OS::get().runCommand(command);
 }
 
+FileWriter::FileWriter(const Path& path)
+{
+	FileSystem::createParentDir(path);
+
+#ifdef WIN32
+	_wfopen_s(&fp, path.getNativeString().getUTF16().c_str(), L"wb");
+#else
+	fp = fopen(path.getNativeString().c_str(), "wb");
+#endif
+}
+
+FileWriter::~FileWriter()
+{
+	close();
+}
+
+bool FileWriter::isOpen() const
+{
+	return fp != nullptr;
+}
+
+bool FileWriter::write(gsl::span<const gsl::byte> data)
+{
+	if (!fp) {
+		return false;
+	}
+	const auto written = fwrite(data.data(), 1, data.size(), fp);
+	pos += written;
+	ok = ok && written == size_t(data.size());
+	return ok;
+}
+
+bool FileWriter::writeAt(size_t writePos, gsl::span<const gsl::byte> data)
+{
+	if (!fp) {
+		return false;
+	}
+
+#ifdef WIN32
+	const bool seekOk = _fseeki64(fp, static_cast<int64_t>(writePos), SEEK_SET) == 0;
+#else
+	const bool seekOk = fseeko(fp, static_cast<off_t>(writePos), SEEK_SET) == 0;
+#endif
+	if (!seekOk) {
+		ok = false;
+		return false;
+	}
+
+	const auto written = fwrite(data.data(), 1, data.size(), fp);
+	ok = ok && written == size_t(data.size());
+	pos = writePos + written;
+	return ok;
+}
+
+size_t FileWriter::getPosition() const
+{
+	return pos;
+}
+
+bool FileWriter::close()
+{
+	if (fp) {
+		ok = fclose(fp) == 0 && ok;
+		fp = nullptr;
+	}
+	return ok;
+}
+
 ScopedTemporaryFile::ScopedTemporaryFile()
 {
 	path = FileSystem::getTemporaryPath();
@@ -266,6 +266,14 @@ void FileSystemCache::readDirFromFilesystem(const Path& rootDir)
 	}
 }
 
+void FileSystemCache::rescanDirectory(const Path& rootDir)
+{
+	// Forget everything cached under this directory, as the monitor can't tell us what changed there
+	lastDirCache = {};
+	std_ex::erase_if_key(dirs, [&] (const Path& dir) { return rootDir == dir || rootDir.isPrefixOf(dir); });
+	readDirFromFilesystem(rootDir);
+}
+
 void FileSystemCache::DirEntry::addFile(const Path& fullPath)
 {
 	const auto name = fullPath.getFilenameStr();
@@ -307,6 +315,11 @@ void FileSystemCache::DirEntry::removeDir(const String& name)
 void FileSystemCache::notifyChanges(gsl::span<const DirectoryMonitor::Event> events)
 {
 	for (const auto& event: events) {
+		if (event.type == DirectoryMonitor::ChangeType::Unknown) {
+			rescanDirectory(Path(event.name) / ".");
+			continue;
+		}
+
 		const auto filePath = Path(event.name);
 		if (event.isDir) {
 			const auto& name = filePath.getFilename().getString(false);
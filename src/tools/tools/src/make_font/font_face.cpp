@@ -101,6 +101,11 @@ Vector<int> FontFace::getCharCodes() const
 	return result;
 }
 
+bool FontFace::hasGlyph(int charCode) const
+{
+	return charCode == 0 || FT_Get_Char_Index(pimpl->face, charCode) != 0;
+}
+
 Vector2i FontFace::getGlyphSize(int charCode) const
 {
 	int index = charCode == 0 ? 0 : FT_Get_Char_Index(pimpl->face, charCode);
@@ -112,6 +117,18 @@ Vector2i FontFace::getGlyphSize(int charCode) const
 	return Vector2i(metrics.width, metrics.height) / 64;
 }
 
+Vector2i FontFace::getMaxGlyphSize() const
+{
+	const auto& bbox = pimpl->face->bbox;
+	if (pimpl->face->units_per_EM > 0) {
+		const float scale = size / pimpl->face->units_per_EM;
+		return Vector2i(Vector2f(float(bbox.xMax - bbox.xMin), float(bbox.yMax - bbox.yMin)) * scale + Vector2f(1, 1));
+	} else {
+		const auto& metrics = pimpl->face->size->metrics;
+		return Vector2i(metrics.max_advance, metrics.height) / 64 + Vector2i(1, 1);
+	}
+}
+
 void FontFace::drawGlyph(Image& image, int charcode, Vector2i pos) const
 {
 	auto glyph = pimpl->face->glyph;
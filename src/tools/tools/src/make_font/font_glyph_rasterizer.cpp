@@ -0,0 +1,51 @@
+#include "halley/tools/make_font/font_glyph_rasterizer.h"
+#include "halley/tools/distance_field/distance_field_generator.h"
+#include <halley/file_formats/image.h>
+
+using namespace Halley;
+
+FontGlyphRasterizer::FontGlyphRasterizer(Bytes data, float fontSize, float radius, float ascenderAdjustment, float lineSpacing, bool floorGlyphPosition)
+	: fontFile(std::move(data))
+	, radius(radius)
+	, border(static_cast<int>(ceil(radius)))
+	, padding(floor(radius))
+{
+	font = std::make_unique<FontFace>(gsl::as_bytes(gsl::span<const Byte>(fontFile)));
+	font->setSize(fontSize);
+
+	const int glyphPadding = 2 * border + 1;
+	info.ascender = font->getAscender() + ascenderAdjustment;
+	info.height = font->getHeight() + lineSpacing;
+	info.sizePt = font->getSize();
+	info.smoothRadius = radius;
+	info.cellSize = font->getMaxGlyphSize() + Vector2i(glyphPadding, glyphPadding);
+	info.floorGlyphPosition = floorGlyphPosition;
+}
+
+IFontGlyphRasterizer::FontInfo FontGlyphRasterizer::getFontInfo() const
+{
+	return info;
+}
+
+std::optional<IFontGlyphRasterizer::GlyphMetrics> FontGlyphRasterizer::getMetrics(int charcode) const
+{
+	std::unique_lock lock(mutex);
+	if (charcode == 0 || !font->hasGlyph(charcode)) {
+		return {};
+	}
+
+	const auto metrics = font->getMetrics(charcode);
+	GlyphMetrics result;
+	result.horizontalBearing = metrics.bearingHorizontal + Vector2f(-padding, padding);
+	result.verticalBearing = metrics.bearingVertical + Vector2f(-padding, padding);
+	result.advance = metrics.advance;
+	return result;
+}
+
+std::unique_ptr<Image> FontGlyphRasterizer::rasterize(int charcode) const
+{
+	std::unique_lock lock(mutex);
+	const int glyphPadding = 2 * border + 1;
+	const auto size = font->getGlyphSize(charcode) + Vector2i(glyphPadding, glyphPadding);
+	return DistanceFieldGenerator::generateMSDF(DistanceFieldGenerator::Type::MTSDF, *font, font->getSize(), charcode, size, radius);
+}
@@ -24,9 +24,10 @@ void AssetPackInspector::parse(const Bytes& bytes)
 	s >> headerSpan;
 	dataStartPos = header.dataStartPos;
 
-	Bytes tableData(header.dataStartPos - header.assetDbStartPos);
-	auto tableSpan = gsl::as_writable_bytes(gsl::span<Byte>(tableData.data(), tableData.size()));
-	s >> tableSpan;
+	// Chunked packs have the asset table at the end, after the data
+	const size_t tableStart = header.assetDbStartPos;
+	const size_t tableEnd = header.isChunked() ? bytes.size() : header.dataStartPos;
+	Bytes tableData(bytes.begin() + tableStart, bytes.begin() + tableEnd);
 
 	rawTableSize = tableData.size();
 	auto rawTableData = Compression::decompress(tableData);
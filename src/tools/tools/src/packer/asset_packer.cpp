@@ -10,6 +10,7 @@
 #include "halley/tools/assets/import_assets_database.h"
 #include "halley/tools/file/filesystem_cache.h"
 #include "halley/utils/algorithm.h"
+#include "halley/utils/hash.h"
 using namespace Halley;
 
 
@@ -199,86 +200,159 @@ void AssetPacker::generatePacks(Project& project, std::map<String, AssetPackList
 
 void AssetPacker::generatePack(Project& project, const String& packId, const AssetPackListing& packListing, const Path& src, const Path& dst, ProgressCallback progress)
 {
-	AssetPack pack;
-	AssetDatabase& db = pack.getAssetDatabase();
-	Bytes& data = pack.getData();
+	AssetDatabase db;
 	auto& fs = project.getFileSystemCache();
-
-	// Read old version of this pack, if available
+	const auto key = packListing.getEncryptionKey();
+	const auto keyCheck = key ? makeKeyCheckValue(*key) : Bytes();
+	const auto keyCheckPath = getKeyCheckPath(project, dst);
+	const size_t ivOffset = key ? AssetPack::chunkIVSize : 0;
+
+	// Open old version of this pack, if available
+	// Its chunks are copied over verbatim (still encrypted) when the asset didn't change, so it's only usable if it was chunked with the same key
+	// The pack itself doesn't say which key that was, the packer keeps a check value for it on the build side
 	std::unique_ptr<AssetPack> oldPack;
 	auto reader = std::make_unique<ResourceDataReaderFileSystem>(dst);
 	if (reader->size() > 0) {
 		try {
-			oldPack = std::make_unique<AssetPack>(std::move(reader), packListing.getEncryptionKey(), true);
+			oldPack = std::make_unique<AssetPack>(std::move(reader), std::nullopt, false);
+			if (!oldPack->isChunked() || oldPack->isEncrypted() != key.has_value() || (key && FileSystem::readFile(keyCheckPath) != keyCheck)) {
+				oldPack = {};
+			}
 		} catch (...) {
 			// Just ignore it if it fails to load asset pack for whatever reason
+			oldPack = {};
 		}
 	}
 	reader = {};
 
-	const size_t n = packListing.getEntries().size();
-	size_t i = 0;
-
-	for (auto& entry: packListing.getEntries()) {
-		// Read original file
-		// Priority:
-		// 1. Cache
-		// 2. Old pack
-		// 3. Filesystem (via cache)
-		Bytes fileData;
-		if (entry.modified || fs.hasCached(src / entry.path) || !oldPack) {
-			// Read from cache or filesystem
-			fileData = fs.readFileCopy(src / entry.path);
-		} else {
-			// Read from pack
-			auto oldData = oldPack->getData(entry.name, entry.type, false);
-			if (oldData) {
-				auto data = dynamic_cast<ResourceDataStatic*>(oldData.get())->getSpan();
-				fileData = Bytes(reinterpret_cast<const Byte*>(data.data()), reinterpret_cast<const Byte*>(data.data()) + data.size());
+	auto getOldChunk = [&] (const AssetPackListing::Entry& entry) -> std::optional<AssetPack::ChunkInfo>
+	{
+		if (!oldPack || !oldPack->getAssetDatabase().hasDatabase(entry.type)) {
+			return {};
+		}
+		const auto* oldEntry = oldPack->getAssetDatabase().getDatabase(entry.type).tryGet(entry.name);
+		if (!oldEntry) {
+			return {};
+		}
+		auto chunk = AssetPack::parseChunkPath(oldEntry->path);
+		if (!chunk.hash || chunk.pos < ivOffset) {
+			return {};
+		}
+		return chunk;
+	};
+
+	// Write to a temporary file, so the old pack stays readable until the new one is complete
+	const auto tmpDst = Path(dst.getString() + ".tmp");
+	AssetPackHeader header;
+	size_t dataSize = 0;
+	size_t nReused = 0;
+	size_t reusedSize = 0;
+	Bytes chunkData;
+
+	{
+		FileWriter writer(tmpDst);
+		if (!writer.isOpen()) {
+			throw Exception("Unable to write pack file " + tmpDst.getNativeString(), HalleyExceptions::Tools);
+		}
+
+		// Placeholder, rewritten once the data size is known
+		header.initChunked(0, key.has_value());
+		writer.write(gsl::as_bytes(gsl::span<const AssetPackHeader>(&header, 1)));
+
+		const size_t n = packListing.getEntries().size();
+		size_t i = 0;
+
+		for (auto& entry: packListing.getEntries()) {
+			const auto oldChunk = getOldChunk(entry);
+			std::optional<AssetPack::ChunkInfo> reuse;
+			size_t size = 0;
+			uint64_t hash = 0;
+
+			// Unmodified files which aren't in the cache can be taken from the old pack without reading the original
+			if (oldChunk && !entry.modified && !fs.hasCached(src / entry.path)) {
+				reuse = oldChunk;
+				size = oldChunk->size;
+				hash = *oldChunk->hash;
 			} else {
-				// Read from cache after all...
-				fileData = fs.readFileCopy(src / entry.path);
+				const auto fileData = fs.readFileCopy(src / entry.path);
+				size = fileData.size();
+				if (size == 0) {
+					Logger::logError("Unable to pack: \"" + (src / entry.path) + "\". File not found or empty.");
+					continue;
+				}
+
+				hash = Hash::hash(fileData);
+				if (oldChunk && oldChunk->hash == hash && oldChunk->size == size) {
+					reuse = oldChunk;
+				} else {
+					chunkData = AssetPack::makeChunk(fileData.byte_span(), key);
+				}
 			}
-		}
 
-		const size_t size = fileData.size();
-		if (size == 0) {
-			Logger::logError("Unable to pack: \"" + (src / entry.path) + "\". File not found or empty.");
-			continue;
+			if (reuse) {
+				chunkData.resize(AssetPack::getChunkSize(reuse->size, key.has_value()));
+				oldPack->readData(reuse->pos - ivOffset, chunkData.byte_span());
+				++nReused;
+				reusedSize += chunkData.size();
+			}
+
+			if (!writer.write(chunkData.byte_span())) {
+				throw Exception("Unable to write pack file " + tmpDst.getNativeString(), HalleyExceptions::Tools);
+			}
+			db.addAsset(entry.name, entry.type, AssetDatabase::Entry(AssetPack::makeChunkPath(dataSize + ivOffset, size, hash), entry.metadata));
+			dataSize += chunkData.size();
+
+			progress(float(i) / float(n), packId);
+			i++;
 		}
-		
-		// Read data into pack data
-		const size_t pos = data.size();
-		data.reserve(nextPowerOf2(pos + size));
-		data.resize(pos + size);
-		memcpy(data.data() + pos, fileData.data(), size);
 
-		db.addAsset(entry.name, entry.type, AssetDatabase::Entry(toString(pos) + ":" + toString(size), entry.metadata));
+		// Asset database goes at the end
+		const auto assetDbBytes = AssetPack::serializeAssetDatabase(db);
+		writer.write(assetDbBytes.byte_span());
 
-		progress(float(i) / float(n), packId);
-		i++;
+		header.initChunked(dataSize, key.has_value());
+		writer.writeAt(0, gsl::as_bytes(gsl::span<const AssetPackHeader>(&header, 1)));
+
+		if (!writer.close()) {
+			throw Exception("Unable to write pack file " + tmpDst.getNativeString(), HalleyExceptions::Tools);
+		}
 	}
 
 	oldPack = {}; // Release file handle!
 
-	if (packListing.getEncryptionKey().has_value()) {
-		Logger::logInfo("- Encrypting \"" + packId + "\"...");
-		pack.encrypt(*packListing.getEncryptionKey());
-	}
-
-	// Write pack
-	const auto packData = pack.writeOut();
-	bool packed = FileSystem::writeFile(dst, packData);
+	// Replace pack, with no key check value in between, so an interrupted build can't pair it with the wrong pack
+	FileSystem::remove(keyCheckPath);
+	bool packed = FileSystem::rename(tmpDst, dst);
 	if (!packed) {
 		// Try again
 		using namespace std::chrono_literals;
 		std::this_thread::sleep_for(200ms);
-		packed = FileSystem::writeFile(dst, packData);
+		FileSystem::remove(dst);
+		packed = FileSystem::rename(tmpDst, dst);
+	}
+
+	if (packed && key) {
+		FileSystem::writeFile(keyCheckPath, keyCheck);
 	}
 
 	if (packed) {
-		Logger::logInfo("- Packed " + toString(packListing.getEntries().size()) + " entries on \"" + packId + "\" (" + String::prettySize(data.size()) + ").");
+		Logger::logInfo("- Packed " + toString(packListing.getEntries().size()) + " entries on \"" + packId + "\" (" + String::prettySize(dataSize) + ", reused " + toString(nReused) + " entries totalling " + String::prettySize(reusedSize) + ").");
 	} else {
+		FileSystem::remove(tmpDst);
 		throw Exception("Unable to write pack file " + dst.getNativeString(), HalleyExceptions::Tools);
 	}
 }
+
+Bytes AssetPacker::makeKeyCheckValue(Encrypt::AESKey key)
+{
+	// The key encrypting a block of zeroes, which tells keys apart without revealing anything about them
+	std::array<uint8_t, 16> iv;
+	iv.fill(0);
+	return Encrypt::encryptAES(iv, key, Bytes(16, 0));
+}
+
+Path AssetPacker::getKeyCheckPath(const Project& project, const Path& dstPack)
+{
+	// Kept with the unpacked assets, as the packed assets directory is what gets shipped
+	return project.getUnpackedAssetsPath() / ".packer" / (dstPack.makeRelativeTo(project.getRootPath()).getString() + ".key");
+}
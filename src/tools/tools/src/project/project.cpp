@@ -1,5 +1,6 @@
 #include <utility>
 #include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/assets/import_cache.h"
 #include "halley/tools/project/project.h"
 
 #include "halley/api/halley_api.h"
@@ -26,7 +27,7 @@
 
 using namespace Halley;
 
-constexpr static int currentAssetVersion = 160;
+constexpr static int currentAssetVersion = 161;
 constexpr static int currentCodegenVersion = Codegen::currentCodegenVersion;
 
 Project::Project(Path projectRootPath, Path halleyRootPath, Vector<String> disabledPlatforms)
@@ -49,6 +50,10 @@ Project::Project(Path projectRootPath, Path halleyRootPath, Vector<String> disab
 	importAssetsDatabase = std::make_unique<ImportAssetsDatabase>(getUnpackedAssetsPath(), getUnpackedAssetsPath() / "import.db", getUnpackedAssetsPath() / "assets.db", platforms, currentAssetVersion);
 	codegenDatabase = std::make_unique<ImportAssetsDatabase>(getGenPath(), getGenPath() / "import.db", getGenPath() / "assets.db", Vector<String>{ "" }, currentCodegenVersion + currentAssetVersion);
 	sharedCodegenDatabase = std::make_unique<ImportAssetsDatabase>(getSharedGenPath(), getSharedGenPath() / "import.db", getSharedGenPath() / "assets.db", Vector<String>{ "" }, currentCodegenVersion + currentAssetVersion);
+
+	if (properties->getUseImportCache()) {
+		importCache = std::make_unique<ImportCache>(getImportCachePath(), computeImporterBuildId(), properties->getImportCacheMaxSize());
+	}
 }
 
 Project::~Project()
@@ -227,6 +232,40 @@ ImportAssetType Project::getImportAssetType(const Path& filePath)
 	return assetImporter->getImportAssetType(filePath, false);
 }
 
+ImportCache* Project::getImportCache() const
+{
+	return importCache.get();
+}
+
+uint64_t Project::computeImporterBuildId() const
+{
+	// Importers live in the tools executable and in the plugins
+	Vector<Path> binaries;
+	binaries.push_back(FileSystem::getExecutablePath());
+	const auto pluginPath = halleyRootPath / "plugins";
+	auto plugins = FileSystem::enumerateDirectory(pluginPath);
+	std::sort(plugins.begin(), plugins.end());
+	for (const auto& file: plugins) {
+		binaries.push_back(pluginPath / file);
+	}
+	return ImportCache::computeBuildId(binaries);
+}
+
+Path Project::getImportCachePath() const
+{
+	// The environment variable lets build agents point every checkout at the same cache
+	if (const char* envPath = std::getenv("HALLEY_IMPORT_CACHE"); envPath && envPath[0] != 0) {
+		return Path(envPath);
+	}
+
+	const auto& path = properties->getImportCachePath();
+	if (!path.isEmpty()) {
+		return Path(path).isAbsolute() ? Path(path) : rootPath / path;
+	}
+
+	return Path(OS::get().getUserDataDir()) / "Halley" / "import_cache";
+}
+
 const std::shared_ptr<AssetImporter>& Project::getAssetImporter() const
 {
 	return assetImporter;
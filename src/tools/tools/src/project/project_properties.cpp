@@ -83,6 +83,39 @@ float ProjectProperties::getDefaultZoom() const
 	return defaultZoom;
 }
 
+bool ProjectProperties::getUseImportCache() const
+{
+	return useImportCache;
+}
+
+void ProjectProperties::setUseImportCache(bool enabled)
+{
+	useImportCache = enabled;
+	dirty = true;
+}
+
+const String& ProjectProperties::getImportCachePath() const
+{
+	return importCachePath;
+}
+
+void ProjectProperties::setImportCachePath(String path)
+{
+	importCachePath = std::move(path);
+	dirty = true;
+}
+
+uint64_t ProjectProperties::getImportCacheMaxSize() const
+{
+	return importCacheMaxSizeMB * 1024 * 1024;
+}
+
+void ProjectProperties::setImportCacheMaxSize(uint64_t bytes)
+{
+	importCacheMaxSizeMB = bytes / (1024 * 1024);
+	dirty = true;
+}
+
 const I18NLanguage& ProjectProperties::getOriginalLanguage() const
 {
 	return originalLanguage;
@@ -101,6 +134,9 @@ void ProjectProperties::loadDefaults()
 	binName = "";
 	importByExtension = false;
 	defaultZoom = 1.0f;
+	useImportCache = true;
+	importCachePath = "";
+	importCacheMaxSizeMB = 4096;
 	platforms = {"pc"};
 	originalLanguage = I18NLanguage("en");
 	languages.clear();
@@ -134,6 +170,15 @@ void ProjectProperties::load()
 		if (node.hasKey("defaultZoom")) {
 			defaultZoom = node["defaultZoom"].asFloat();
 		}
+		if (node.hasKey("useImportCache")) {
+			useImportCache = node["useImportCache"].asBool();
+		}
+		if (node.hasKey("importCachePath")) {
+			importCachePath = node["importCachePath"].asString();
+		}
+		if (node.hasKey("importCacheMaxSizeMB")) {
+			importCacheMaxSizeMB = node["importCacheMaxSizeMB"].asInt64();
+		}
 		if (node.hasKey("platforms")) {
 			platforms = node["platforms"].asVector<String>();
 		}
@@ -156,6 +201,11 @@ void ProjectProperties::save()
 	node["binName"] = binName;
 	node["importByExtension"] = importByExtension;
 	node["defaultZoom"] = defaultZoom;
+	node["useImportCache"] = useImportCache;
+	if (!importCachePath.isEmpty()) {
+		node["importCachePath"] = importCachePath;
+	}
+	node["importCacheMaxSizeMB"] = static_cast<int64_t>(importCacheMaxSizeMB);
 	node["platforms"] = platforms;
 	node["originalLanguage"] = originalLanguage;
 	node["languages"] = languages;
@@ -12,6 +12,8 @@
 #include "halley/tools/packer/asset_pack_inspector.h"
 #include "halley/tools/project/write_version_tool.h"
 #include "halley/tools/runner/runner_tool.h"
+#include "halley/tools/benchmark/benchmark_tool.h"
+#include "halley/tools/benchmark/replay_snapshot_tool.h"
 
 using namespace Halley;
 
@@ -25,6 +27,8 @@ CommandLineTools::CommandLineTools()
 	factories["pack-inspector"] = []() { return std::make_unique<AssetPackInspectorTool>(); };
 	factories["vs_project"] = []() { return std::make_unique<VSProjectTool>(); };
 	factories["run"] = []() { return std::make_unique<RunnerTool>(); };
+	factories["benchmark"] = []() { return std::make_unique<BenchmarkTool>(); };
+	factories["replay-snapshot"] = []() { return std::make_unique<ReplaySnapshotTool>(); };
 	factories["write_version"] = []() { return std::make_unique<WriteVersionTool>(); };
 	factories["write_code_version"] = []() { return std::make_unique<WriteCodeVersionTool>(); };
 }